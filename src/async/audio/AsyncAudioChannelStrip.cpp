@@ -0,0 +1,208 @@
+/**
+@file   AsyncAudioChannelStrip.cpp
+@brief  Run gain, filter and clipper stages in one audio pipe element
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioFilter.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioChannelStrip.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioChannelStrip::~AudioChannelStrip(void)
+{
+  for (auto& stage : stages)
+  {
+    delete stage.filter;
+    stage.filter = nullptr;
+  }
+} /* AudioChannelStrip::~AudioChannelStrip */
+
+
+void AudioChannelStrip::addGain(float gain_db)
+{
+  const float gain = powf(10, gain_db / 20);
+  Stage& stage = gainClipStage();
+  stage.gain *= gain;
+  stage.clip_level *= gain;
+} /* AudioChannelStrip::addGain */
+
+
+void AudioChannelStrip::addFilter(AudioFilter *filter)
+{
+  Stage stage;
+  stage.filter = filter;
+  stage.gain = 1.0f;
+  stage.clip_level = std::numeric_limits<float>::infinity();
+  stages.push_back(stage);
+} /* AudioChannelStrip::addFilter */
+
+
+void AudioChannelStrip::addClipper(float clip_level)
+{
+  Stage& stage = gainClipStage();
+  stage.clip_level = std::min(stage.clip_level, clip_level);
+} /* AudioChannelStrip::addClipper */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+void AudioChannelStrip::processSamples(float *dest, const float *src,
+                                       int count)
+{
+  if (stages.empty())
+  {
+    if (dest != src)
+    {
+      std::memcpy(dest, src, count * sizeof(*dest));
+    }
+    return;
+  }
+
+  const float *in = src;
+  for (const auto& stage : stages)
+  {
+    if (stage.filter != nullptr)
+    {
+      stage.filter->processSamples(dest, in, count);
+    }
+    else
+    {
+      const float gain = stage.gain;
+      const float clip_level = stage.clip_level;
+      for (int i=0; i<count; ++i)
+      {
+        dest[i] = std::max(-clip_level, std::min(in[i] * gain, clip_level));
+      }
+    }
+    in = dest;
+  }
+} /* AudioChannelStrip::processSamples */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+AudioChannelStrip::Stage& AudioChannelStrip::gainClipStage(void)
+{
+  if (stages.empty() || (stages.back().filter != nullptr))
+  {
+    Stage stage;
+    stage.filter = nullptr;
+    stage.gain = 1.0f;
+    stage.clip_level = std::numeric_limits<float>::infinity();
+    stages.push_back(stage);
+  }
+  return stages.back();
+} /* AudioChannelStrip::gainClipStage */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,205 @@
+/**
+@file   AsyncAudioChannelStrip.h
+@brief  Run gain, filter and clipper stages in one audio pipe element
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef ASYNC_AUDIO_CHANNEL_STRIP_INCLUDED
+#define ASYNC_AUDIO_CHANNEL_STRIP_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioProcessor.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioFilter;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Run gain, filter and clipper stages in one audio pipe element
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class replace a chain of AudioAmp, AudioFilter and AudioClipper objects
+that are directly connected to each other. Each element in an audio pipe has
+its own output buffer and flow control, so passing audio through many small
+elements cost more than the processing itself. The channel strip process a
+whole block through all its stages in one go.
+
+Stages are run in the order they are added. Consecutive gain and clipper
+stages are merged into a single pass that first apply the combined gain and
+then clip to the combined clip level, which give the same result as running
+them one by one. Filter stages are run in place on the output buffer.
+*/
+class AudioChannelStrip : public AudioProcessor
+{
+  public:
+    /**
+     * @brief   Default constructor
+     */
+    AudioChannelStrip(void) {}
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    AudioChannelStrip(const AudioChannelStrip&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    AudioChannelStrip& operator=(const AudioChannelStrip&) = delete;
+
+    /**
+     * @brief   Destructor
+     *
+     * All filters added to the channel strip are deleted.
+     */
+    ~AudioChannelStrip(void);
+
+    /**
+     * @brief   Add a gain stage
+     * @param   gain_db The gain in dB
+     */
+    void addGain(float gain_db);
+
+    /**
+     * @brief   Add a filter stage
+     * @param   filter The filter to add
+     *
+     * The channel strip take ownership of the filter. The filter must not be
+     * connected to any other part of the audio pipe.
+     */
+    void addFilter(AudioFilter *filter);
+
+    /**
+     * @brief   Add a clipper stage
+     * @param   clip_level The level to clip at
+     */
+    void addClipper(float clip_level=1.0f);
+
+    /**
+     * @brief   Check if any stages have been added
+     * @return  Returns \em true if there are no stages in the channel strip
+     */
+    bool isEmpty(void) const { return stages.empty(); }
+
+  protected:
+    /**
+     * @brief   Process incoming samples and put them into the output buffer
+     * @param   dest  Destination buffer
+     * @param   src   Source buffer
+     * @param   count Number of samples in the source buffer
+     */
+    virtual void processSamples(float *dest, const float *src, int count);
+
+  private:
+    struct Stage
+    {
+      AudioFilter*  filter;
+      float         gain;
+      float         clip_level;
+    };
+
+    std::vector<Stage> stages;
+
+    Stage& gainClipStage(void);
+
+};  /* class AudioChannelStrip */
+
+
+} /* namespace Async */
+
+#endif /* ASYNC_AUDIO_CHANNEL_STRIP_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
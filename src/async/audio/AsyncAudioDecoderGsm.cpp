@@ -32,6 +32,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <cstring>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -111,40 +113,47 @@ using namespace Async;
  ****************************************************************************/
 
 AudioDecoderGsm::AudioDecoderGsm(void)
-  : gsmh(0), frame_len(0)
+  : frame_len(0)
 {
-  gsmh = gsm_create();
 } /* AudioDecoderGsm::AudioDecoderGsm */
 
 
 AudioDecoderGsm::~AudioDecoderGsm(void)
 {
-  gsm_destroy(gsmh);
-  gsmh = 0;
 } /* AudioDecoderGsm::~AudioDecoderGsm */
 
 
 void AudioDecoderGsm::writeEncodedSamples(void *buf, int size)
 {
-  unsigned char *ptr = (unsigned char *)buf;
-  
-  for (int i=0; i<size; ++i)
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(buf);
+
+    // Complete a frame left over from the previous call
+  if (frame_len > 0)
   {
-    frame[frame_len++] = ptr[i];
-    if (frame_len == sizeof(frame))
+    int cnt = min(FRAME_SIZE - frame_len, size);
+    memcpy(frame + frame_len, ptr, cnt);
+    frame_len += cnt;
+    ptr += cnt;
+    size -= cnt;
+    if (frame_len < FRAME_SIZE)
     {
-      gsm_signal s16_samples[FRAME_SAMPLE_CNT];
-      gsm_decode(gsmh, frame, s16_samples);
-    
-      float samples[FRAME_SAMPLE_CNT];
-      for (int j=0; j<FRAME_SAMPLE_CNT; ++j)
-      {
-        samples[j] = static_cast<float>(s16_samples[j]) / 32768.0;
-      }
-      sinkWriteSamples(samples, FRAME_SAMPLE_CNT);
-      frame_len = 0;
+      return;
     }
+    decodeFrames(frame, 1);
+    frame_len = 0;
+  }
+
+    // Decode whole frames directly from the buffer, a batch at a time
+  while (size >= FRAME_SIZE)
+  {
+    int frame_cnt = min(size / FRAME_SIZE, MAX_BATCH_FRAMES);
+    decodeFrames(ptr, frame_cnt);
+    ptr += frame_cnt * FRAME_SIZE;
+    size -= frame_cnt * FRAME_SIZE;
   }
+
+  memcpy(frame, ptr, size);
+  frame_len = size;
 } /* AudioDecoderGsm::writeEncodedSamples */
 
 
@@ -163,6 +172,12 @@ void AudioDecoderGsm::writeEncodedSamples(void *buf, int size)
  *
  ****************************************************************************/
 
+void AudioDecoderGsm::decodeFrames(const uint8_t *buf, int frame_cnt)
+{
+  codec.decode(buf, frame_cnt * FRAME_SIZE, frame_cnt, samples);
+  sinkWriteSamples(samples, frame_cnt * FRAME_SAMPLE_CNT);
+} /* AudioDecoderGsm::decodeFrames */
+
 
 
 /*
@@ -34,9 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-extern "C" {
-#include <gsm.h>
-}
+#include <stdint.h>
 
 
 
@@ -47,6 +45,7 @@ extern "C" {
  ****************************************************************************/
 
 #include <AsyncAudioDecoder.h>
+#include <AsyncAudioFrameCodecGsm.h>
 
 
 /****************************************************************************
@@ -149,11 +148,16 @@ class AudioDecoderGsm : public AudioDecoder
   protected:
     
   private:
-    static const int FRAME_SAMPLE_CNT = 160;
-    
-    gsm       gsmh;
-    gsm_frame frame;
-    int       frame_len;
+    static const int FRAME_SAMPLE_CNT = AudioFrameCodecGsm::FRAME_SAMPLE_CNT;
+    static const int FRAME_SIZE       = AudioFrameCodecGsm::FRAME_SIZE;
+    static const int MAX_BATCH_FRAMES = 4;
+
+    AudioFrameCodecGsm  codec;
+    uint8_t             frame[FRAME_SIZE];
+    int                 frame_len;
+    float               samples[MAX_BATCH_FRAMES * FRAME_SAMPLE_CNT];
+
+    void decodeFrames(const uint8_t *buf, int frame_cnt);
     
     AudioDecoderGsm(const AudioDecoderGsm&);
     AudioDecoderGsm& operator=(const AudioDecoderGsm&);
@@ -33,7 +33,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <cstring>
-#include <cmath>
 #include <algorithm>
 
 
@@ -115,44 +114,24 @@ using namespace Async;
 
 AudioDelayLine::AudioDelayLine(int length_ms)
   : size(length_ms * INTERNAL_SAMPLE_RATE / 1000), ptr(0), flush_cnt(0),
-    is_muted(false), mute_cnt(0), last_clear(0), fade_gain(0), fade_len(0),
-    fade_pos(0), fade_dir(0)
+    is_muted(false), mute_cnt(0), last_clear(0)
 {
   buf = new float[size];
   memset(buf, 0, size * sizeof(*buf));
-  clear();
   setFadeTime(DEFAULT_FADE_TIME);
+  clear();
 } /* AudioDelayLine::AudioDelayLine */
 
 
 AudioDelayLine::~AudioDelayLine(void)
 {
-  delete [] fade_gain;
   delete [] buf;
 } /* AudioDelayLine::~AudioDelayLine */
 
 
 void AudioDelayLine::setFadeTime(int time_ms)
 {
-  delete [] fade_gain;
-  fade_gain = 0;
-  
-  if (time_ms <= 0)
-  {
-    fade_len = 0;
-    fade_pos = 0;
-    fade_dir = 0;
-    return;
-  }
-
-  fade_len = time_ms * INTERNAL_SAMPLE_RATE / 1000;
-  fade_pos = min(fade_pos, fade_len-1);
-  fade_gain = new float[fade_len];
-  for (int i=0; i<fade_len-1; ++i)
-  {
-    fade_gain[i] = pow(2.0f, -15.0f * (static_cast<float>(i) / fade_len));
-  }
-  fade_gain[fade_len-1] = 0;
+  fade.setLength(max(0, time_ms * INTERNAL_SAMPLE_RATE / 1000));
 } /* AudioDelayLine::setFadeTime  */
 
 
@@ -166,14 +145,9 @@ void AudioDelayLine::mute(bool do_mute, int time_ms)
 
   if (do_mute)
   {
-    fade_pos = 0; // Reset fade gain
-    fade_dir = 1; // Fade out
-    ptr = (ptr + size - mute_ext) % size;
-    for (int i=0; i<mute_ext; ++i)
-    {
-      ptr = (ptr < size-1) ? ptr+1 : 0;
-      buf[ptr] *= currentFadeGain();
-    }
+    fade.setUnity(); // Reset fade gain
+    fade.fadeOut();
+    fadeBuffer(mute_ext);
     is_muted = true;
     mute_cnt = 0;
   }
@@ -181,7 +155,7 @@ void AudioDelayLine::mute(bool do_mute, int time_ms)
   {
     if (mute_ext == 0)
     {
-      fade_dir = -1; // Fade in
+      fade.fadeIn();
       is_muted = false;
     }
     else
@@ -204,21 +178,15 @@ void AudioDelayLine::clear(int time_ms)
     count = min(size, time_ms * INTERNAL_SAMPLE_RATE / 1000);
   }
 
-  //fade_pos = 0; // Reset fade gain
-  fade_dir = 1; // Fade out
-  ptr = (ptr + size - count) % size;
-  for (int i=0; i<count; ++i)
-  {
-    ptr = (ptr < size-1) ? ptr+1 : 0;
-    buf[ptr] *= currentFadeGain();
-  }
+  fade.fadeOut();
+  fadeBuffer(count);
 
   if (!is_muted)
   {
-    fade_dir = -1; // Fade in again when new samples arrive
+    fade.fadeIn(); // Fade in again when new samples arrive
   }
 
-  last_clear = max(0, count - fade_len);
+  last_clear = max(0, count - fade.length());
   
 } /* AudioDelayLine::clear */
 
@@ -230,24 +198,34 @@ int AudioDelayLine::writeSamples(const float *samples, int count)
   
   count = min(count, size);
   float output[count];
-  int out_ptr = ptr;
-  for (int i=0; i<count; ++i)
-  {
-    output[i] = buf[out_ptr];
-    out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
-  }
+  int first = min(count, size - ptr);
+  memcpy(output, buf + ptr, first * sizeof(*buf));
+  memcpy(output + first, buf, (count - first) * sizeof(*buf));
 
   int written = sinkWriteSamples(output, count);
 
-  for (int i=0; i<written; ++i)
+    // Store the written samples in the delay line in blocks. A block ends
+    // where the buffer wraps or where a pending unmute should take effect.
+  int pos = 0;
+  while (pos < written)
   {
-    buf[ptr] = samples[i] * currentFadeGain();
-    if (is_muted && (mute_cnt > 0) && (--mute_cnt == 0))
+    int len = min(written - pos, size - ptr);
+    bool unmute = false;
+    if (is_muted && (mute_cnt > 0))
+    {
+      len = min(len, mute_cnt);
+      mute_cnt -= len;
+      unmute = (mute_cnt == 0);
+    }
+    memcpy(buf + ptr, samples + pos, len * sizeof(*buf));
+    fade.process(buf + ptr, len);
+    if (unmute)
     {
-      fade_dir = -1; // Fade in
+      fade.fadeIn();
       is_muted = false;
     }
-    ptr = (ptr < size-1) ? ptr+1 : 0;
+    ptr = (ptr + len < size) ? ptr + len : 0;
+    pos += len;
   }
   
   return written;
@@ -312,21 +290,16 @@ void AudioDelayLine::writeRemainingSamples(void)
   while ((written > 0) && (flush_cnt > 0))
   {
     int count = min(512, flush_cnt);
-    
-    int out_ptr = ptr;
-    for (int i=0; i<count; ++i)
-    {
-      output[i] = buf[out_ptr];
-      out_ptr = (out_ptr < size-1) ? out_ptr+1 : 0;
-    }
+    int first = min(count, size - ptr);
+    memcpy(output, buf + ptr, first * sizeof(*buf));
+    memcpy(output + first, buf, (count - first) * sizeof(*buf));
 
     written = sinkWriteSamples(output, count);
 
-    for (int i=0; i<written; ++i)
-    {
-      buf[ptr] = 0;
-      ptr = (ptr < size-1) ? ptr+1 : 0;
-    }
+    first = min(written, size - ptr);
+    fill(buf + ptr, buf + ptr + first, 0.0f);
+    fill(buf, buf + written - first, 0.0f);
+    ptr = (ptr + written) % size;
 
     flush_cnt -= written;
   }
@@ -338,6 +311,17 @@ void AudioDelayLine::writeRemainingSamples(void)
 } /* AudioDelayLine::writeRemainingSamples */
 
 
+void AudioDelayLine::fadeBuffer(int count)
+{
+    // Apply the fade to the last count samples written to the delay line,
+    // oldest sample first
+  int start = (ptr + size - count) % size;
+  int first = min(count, size - start);
+  fade.process(buf + start, first);
+  fade.process(buf, count - first);
+} /* AudioDelayLine::fadeBuffer */
+
+
 
 /*
  * This file has not been truncated
@@ -45,6 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <AsyncAudioSink.h>
 #include <AsyncAudioSource.h>
+#include <AsyncAudioFade.h>
 
 
 /****************************************************************************
@@ -216,39 +217,13 @@ class AudioDelayLine : public Async::AudioSink, public Async::AudioSource
     bool	is_muted;
     int		mute_cnt;
     int		last_clear;
-    float	*fade_gain;
-    int		fade_len;
-    int		fade_pos;
-    int		fade_dir;
+    AudioFade	fade;
     
     AudioDelayLine(const AudioDelayLine&);
     AudioDelayLine& operator=(const AudioDelayLine&);
     void writeRemainingSamples(void);
-
-    inline float currentFadeGain(void)
-    {
-      if (fade_gain == 0)
-      {
-        return 1.0f;
-      }
-      
-      float gain = fade_gain[fade_pos];
-      fade_pos += fade_dir;
-      
-      if ((fade_dir > 0) && (fade_pos >= fade_len-1))
-      {
-        fade_dir = 0;
-        fade_pos = fade_len-1;
-      }
-      else if ((fade_dir < 0) && (fade_pos <= 0))
-      {
-        fade_dir = 0;
-        fade_pos = 0;
-      }
-      
-      return gain;
-      
-    } /* AudioDelayLine::currentFadeGain  */
+    void fadeBuffer(int count);
+    
 
 };  /* class AudioDelayLine */
 
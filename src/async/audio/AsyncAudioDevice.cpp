@@ -59,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "AsyncAudioIO.h"
 #include "AsyncAudioDevice.h"
 #include "AsyncAudioDeviceFactory.h"
+#include "AsyncAudioSampleConv.h"
 
 
 /****************************************************************************
@@ -266,21 +267,32 @@ AudioDevice::~AudioDevice(void)
 void AudioDevice::putBlocks(int16_t *buf, size_t frame_cnt)
 {
   //printf("putBlocks: frame_cnt=%zu\n", frame_cnt);
-  float samples[frame_cnt];
+
+    // Only convert the channels that some AudioIO object is listening to.
+    // All used channels are converted in one go.
+  float samples[channels][frame_cnt];
+  float *dest[channels];
   for (size_t ch=0; ch<channels; ch++)
   {
-    for (size_t i=0; i<frame_cnt; i++)
+    dest[ch] = 0;
+  }
+  list<AudioIO*>::iterator it;
+  for (it=aios.begin(); it!=aios.end(); ++it)
+  {
+    size_t ch = (*it)->channel();
+    if (ch < channels)
     {
-        // no divisions in index calculation (embedded system performance !!!)
-      samples[i] = static_cast<float>(buf[i * channels + ch]) / 32768.0;
+      dest[ch] = samples[ch];
     }
-    list<AudioIO*>::iterator it;
-    for (it=aios.begin(); it!=aios.end(); ++it)
+  }
+  AudioSampleConv::deinterleave(dest, buf, frame_cnt, channels);
+
+  for (it=aios.begin(); it!=aios.end(); ++it)
+  {
+    size_t ch = (*it)->channel();
+    if (ch < channels)
     {
-      if ((*it)->channel() == ch)
-      {
-        (*it)->audioRead(samples, frame_cnt);
-      }
+      (*it)->audioRead(samples[ch], frame_cnt);
     }
   }
 } /* AudioDevice::putBlocks */
@@ -354,23 +366,8 @@ size_t AudioDevice::getBlocks(int16_t *buf, size_t block_cnt)
       float tmp[frames_to_write];
       int samples_read = (*it)->readSamples(tmp, frames_to_write);
       assert(samples_read >= 0);
-      for (size_t i=0; i<static_cast<size_t>(samples_read); ++i)
-      {
-	int buf_pos = i * channels + channel;
-	float sample = 32767.0 * tmp[i] + buf[buf_pos];
-	if (sample > 32767)
-	{
-	  buf[buf_pos] = 32767;
-	}
-	else if (sample < -32767)
-	{
-	  buf[buf_pos] = -32767;
-	}
-	else
-	{
-	  buf[buf_pos] = static_cast<int16_t>(sample);
-	}
-      }
+      AudioSampleConv::mixIntoChannel(buf, tmp, samples_read, channels,
+                                      channel);
     }
   }  
       
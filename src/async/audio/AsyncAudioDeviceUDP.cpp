@@ -44,6 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstdlib>
 #include <vector>
 #include <sstream>
+#include <algorithm>
 
 
 
@@ -328,14 +329,27 @@ void AudioDeviceUDP::closeDevice(void)
 void AudioDeviceUDP::audioReadHandler(const IpAddress &ip, uint16_t port,
                                       void *buf, int count)
 {
-  for (unsigned i=0; i < count / (channels * sizeof(int16_t)); ++i)
+  int16_t *samples = reinterpret_cast<int16_t *>(buf);
+  size_t frames_left = count / (channels * sizeof(int16_t));
+  while (frames_left > 0)
   {
-    for (size_t ch=0; ch < channels; ++ch)
+      // Whole blocks in the packet are handed over directly without first
+      // copying them to the read buffer.
+    if ((read_buf_pos == 0) && (frames_left >= block_size))
     {
-      read_buf[read_buf_pos * channels + ch] =
-              ((int16_t *)buf)[i * channels + ch];
+      putBlocks(samples, block_size);
+      samples += block_size * channels;
+      frames_left -= block_size;
+      continue;
     }
-    if (++read_buf_pos == block_size)
+
+    size_t frame_cnt = min(frames_left, block_size - read_buf_pos);
+    memcpy(read_buf + read_buf_pos * channels, samples,
+           frame_cnt * channels * sizeof(int16_t));
+    samples += frame_cnt * channels;
+    frames_left -= frame_cnt;
+    read_buf_pos += frame_cnt;
+    if (read_buf_pos == block_size)
     {
       putBlocks(read_buf, block_size);
       read_buf_pos = 0;
@@ -358,7 +372,7 @@ void AudioDeviceUDP::audioWriteHandler(void)
     if (zerofill_on_underflow)
     {
       frags_read = 1;
-      std::memset(buf, 0, block_size * channels);
+      std::memset(buf, 0, frag_size);
     }
     else
     {
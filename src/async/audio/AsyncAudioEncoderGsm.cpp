@@ -34,6 +34,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <stdint.h>
 
+#include <cstring>
+#include <algorithm>
+
 
 /****************************************************************************
  *
@@ -112,52 +115,37 @@ using namespace Async;
  ****************************************************************************/
 
 AudioEncoderGsm::AudioEncoderGsm(void)
-  : gsmh(0), gsm_buf_len(0)
+  : gsm_buf_len(0)
 {
-  gsmh = gsm_create();
 } /* AsyncAudioEncoderGsm::AsyncAudioEncoderGsm */
 
 
 AudioEncoderGsm::~AudioEncoderGsm(void)
 {
-  gsm_destroy(gsmh);
-  gsmh = 0;
 } /* AsyncAudioEncoderGsm::~AsyncAudioEncoderGsm */
 
 
 int AudioEncoderGsm::writeSamples(const float *samples, int count)
 {
-  for (int i=0; i<count; ++i)
+  int samples_read = 0;
+  while (samples_read < count)
   {
-    float sample = samples[i];
-    if (sample > 1.0)
-    {
-      gsm_buf[gsm_buf_len++] = 32767;
-    }
-    else if (sample < -1.0)
-    {
-      gsm_buf[gsm_buf_len++] = -32767;
-    }
-    else
-    {
-      gsm_buf[gsm_buf_len++] = static_cast<gsm_signal>(sample * 32767.0);
-    }
-    
+    int read_cnt = min(GSM_BUF_SIZE - gsm_buf_len, count - samples_read);
+    memcpy(gsm_buf + gsm_buf_len, samples + samples_read,
+           read_cnt * sizeof(*samples));
+    gsm_buf_len += read_cnt;
+    samples_read += read_cnt;
+
     if (gsm_buf_len == GSM_BUF_SIZE)
     {
       gsm_buf_len = 0;
 
-      gsm_frame frame[FRAME_COUNT];
-      for (int frameno=0; frameno<FRAME_COUNT; ++frameno)
-      {
-        gsm_encode(gsmh, gsm_buf + frameno * FRAME_SAMPLE_CNT, frame[frameno]);
-      }
-      
-      writeEncodedSamples(frame, FRAME_COUNT * sizeof(gsm_frame));
+      uint8_t frames[FRAME_COUNT * AudioFrameCodecGsm::FRAME_SIZE];
+      int len = codec.encode(gsm_buf, FRAME_COUNT, frames, sizeof(frames));
+      writeEncodedSamples(frames, len);
     }
   }
   
-  
   return count;
   
 } /* AudioEncoderGsm::writeSamples */
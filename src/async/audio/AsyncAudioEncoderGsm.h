@@ -35,7 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 extern "C" {
-#include <gsm.h>
+
 }
 
 
@@ -47,6 +47,7 @@ extern "C" {
  ****************************************************************************/
 
 #include <AsyncAudioEncoder.h>
+#include <AsyncAudioFrameCodecGsm.h>
 
 
 /****************************************************************************
@@ -160,9 +161,9 @@ class AudioEncoderGsm : public AudioEncoder
     static const int FRAME_COUNT      = 4;
     static const int GSM_BUF_SIZE     = FRAME_COUNT * FRAME_SAMPLE_CNT;
     
-    gsm         gsmh;
-    gsm_signal  gsm_buf[GSM_BUF_SIZE];
-    int         gsm_buf_len;
+    AudioFrameCodecGsm  codec;
+    float               gsm_buf[GSM_BUF_SIZE];
+    int                 gsm_buf_len;
     
     AudioEncoderGsm(const AudioEncoderGsm&);
     AudioEncoderGsm& operator=(const AudioEncoderGsm&);
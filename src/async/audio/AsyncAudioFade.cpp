@@ -0,0 +1,252 @@
+/**
+@file   AsyncAudioFade.cpp
+@brief  A block based fade in/out ramp
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioFade.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+// The attenuation in the last step of the fade curve before going to zero
+static const double FADE_CURVE_ATTENUATION = 15.0;
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void AudioFade::setLength(int len)
+{
+  if (len <= 0)
+  {
+    m_curve = 0;
+    m_len = 0;
+    m_pos = 0;
+    m_dir = 0;
+    return;
+  }
+
+    // At least one step with unity gain and one with zero gain is needed
+  len = max(len, 2);
+  m_curve = curve(len);
+  m_len = len;
+  m_pos = max(0, min(m_pos, m_len - 1));
+} /* AudioFade::setLength */
+
+
+void AudioFade::apply(float *samples, int count) const
+{
+  if (m_curve == 0)
+  {
+    return;
+  }
+
+  int pos = m_pos;
+  int ramp_len = 0;
+  if (m_dir > 0)
+  {
+    ramp_len = min(count, m_len - 1 - pos);
+    const float *gain = m_curve + pos;
+    for (int i=0; i<ramp_len; ++i)
+    {
+      samples[i] *= gain[i];
+    }
+    pos += ramp_len;
+  }
+  else if (m_dir < 0)
+  {
+    ramp_len = min(count, pos);
+    const float *gain = m_curve + pos;
+    for (int i=0; i<ramp_len; ++i)
+    {
+      samples[i] *= gain[-i];
+    }
+    pos -= ramp_len;
+  }
+
+    // The rest of the block, if any, have constant gain
+  samples += ramp_len;
+  count -= ramp_len;
+  const float gain = m_curve[pos];
+  if (gain == 0.0f)
+  {
+    fill(samples, samples + count, 0.0f);
+  }
+  else if (gain != 1.0f)
+  {
+    for (int i=0; i<count; ++i)
+    {
+      samples[i] *= gain;
+    }
+  }
+} /* AudioFade::apply */
+
+
+void AudioFade::advance(int count)
+{
+  if (m_curve == 0)
+  {
+    return;
+  }
+
+  if (m_dir > 0)
+  {
+    m_pos = min(m_pos + count, m_len - 1);
+    if (m_pos == m_len - 1)
+    {
+      m_dir = 0;
+    }
+  }
+  else if (m_dir < 0)
+  {
+    m_pos = max(m_pos - count, 0);
+    if (m_pos == 0)
+    {
+      m_dir = 0;
+    }
+  }
+} /* AudioFade::advance */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+const float *AudioFade::curve(int len)
+{
+    // The curves are kept for the lifetime of the application. There
+    // normally only are one or two different fade lengths in use.
+  static map<int, vector<float> > curve_cache;
+
+  vector<float>& table = curve_cache[len];
+  if (table.empty())
+  {
+      // The curve is the geometric series 2^(-15*i/len) so it can be
+      // computed using one multiplication per step.
+    table.resize(len);
+    const double ratio = pow(2.0, -FADE_CURVE_ATTENUATION / len);
+    double gain = 1.0;
+    for (int i=0; i<len-1; ++i)
+    {
+      table[i] = static_cast<float>(gain);
+      gain *= ratio;
+    }
+    table[len-1] = 0.0f;
+  }
+  return &table[0];
+} /* AudioFade::curve */
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,266 @@
+/**
+@file   AsyncAudioFade.h
+@brief  A block based fade in/out ramp
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_FADE_INCLUDED
+#define ASYNC_AUDIO_FADE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A fade in/out ramp that is applied to blocks of samples
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class keeps track of the state of a fade in/out ramp and apply it to
+blocks of samples. The fade curve is exponential and goes from unity gain
+down to silence. The curve tables are cached and shared between all objects
+using the same fade length so that setting up a fade is cheap.
+
+The gain is applied using simple multiplication loops over whole blocks,
+which the compiler is able to vectorize. When no fade is in progress the
+gain is constant so unity gain is a no-op and full attenuation is a fill
+with zeros.
+
+To support sinks that do not accept all samples, applying the gain and
+advancing the ramp are separate operations. Call apply() on a block, write
+it and then call advance() with the number of samples actually written.
+*/
+class AudioFade
+{
+  public:
+    /**
+     * @brief 	Default constuctor
+     *
+     * The fade is disabled by default, that is the gain is always one.
+     */
+    AudioFade(void) : m_curve(0), m_len(0), m_pos(0), m_dir(0) {}
+
+    /**
+     * @brief   Set the length of the fade ramp
+     * @param   len The length of the ramp in samples. 0 = disabled.
+     *
+     * If a fade is in progress it will continue at the same position in the
+     * new ramp or end if the new ramp is shorter.
+     */
+    void setLength(int len);
+
+    /**
+     * @brief   Get the length of the fade ramp
+     * @return  Returns the length of the fade ramp in samples
+     */
+    int length(void) const { return m_len; }
+
+    /**
+     * @brief   Check if the fade is enabled
+     * @return  Returns \em true if a fade length have been set
+     */
+    bool isEnabled(void) const { return m_curve != 0; }
+
+    /**
+     * @brief   Start fading out from the current gain
+     */
+    void fadeOut(void) { m_dir = 1; }
+
+    /**
+     * @brief   Start fading in from the current gain
+     */
+    void fadeIn(void) { m_dir = -1; }
+
+    /**
+     * @brief   Immediately go to unity gain without fading
+     */
+    void setUnity(void) { m_pos = 0; m_dir = 0; }
+
+    /**
+     * @brief   Immediately go to full attenuation without fading
+     */
+    void setMuted(void)
+    {
+      m_pos = (m_len > 0) ? m_len - 1 : 0;
+      m_dir = 0;
+    }
+
+    /**
+     * @brief   Check if the gain is one and no fade is in progress
+     * @return  Returns \em true if the gain is one
+     */
+    bool isUnity(void) const
+    {
+      return (m_curve == 0) || ((m_dir == 0) && (m_pos == 0));
+    }
+
+    /**
+     * @brief   Check if the audio is fully attenuated
+     * @return  Returns \em true if the fade out is complete
+     */
+    bool isMuted(void) const
+    {
+      return (m_curve != 0) && (m_dir == 0) && (m_pos == m_len - 1);
+    }
+
+    /**
+     * @brief   Get the number of samples left until the ramp is done
+     * @return  Returns the number of samples left of an ongoing fade
+     */
+    int remaining(void) const
+    {
+      if (m_curve == 0)
+      {
+        return 0;
+      }
+      return (m_dir > 0) ? (m_len - 1 - m_pos) : ((m_dir < 0) ? m_pos : 0);
+    }
+
+    /**
+     * @brief   Apply the gain ramp to a block of samples
+     * @param   samples The samples to apply the gain to
+     * @param   count The number of samples
+     *
+     * The ramp state is not changed. Use advance() after the samples have
+     * been taken care of.
+     */
+    void apply(float *samples, int count) const;
+
+    /**
+     * @brief   Advance the ramp
+     * @param   count The number of samples to advance the ramp
+     */
+    void advance(int count);
+
+    /**
+     * @brief   Apply the gain ramp to a block of samples and advance
+     * @param   samples The samples to apply the gain to
+     * @param   count The number of samples
+     */
+    void process(float *samples, int count)
+    {
+      apply(samples, count);
+      advance(count);
+    }
+
+  private:
+    const float * m_curve;
+    int           m_len;
+    int           m_pos;
+    int           m_dir;
+
+    static const float *curve(int len);
+
+};  /* class AudioFade */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FADE_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
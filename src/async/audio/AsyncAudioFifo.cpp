@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstring>
 #include <algorithm>
 #include <cassert>
+#include <iomanip>
 
 
 /****************************************************************************
@@ -82,6 +83,77 @@ using namespace Async;
  *
  ****************************************************************************/
 
+namespace {
+
+/**
+ * A pool of equally sized sample chunks that is shared by all FIFOs. Freed
+ * chunks are kept for reuse, up to MAX_FREE_CHUNKS, to avoid allocating
+ * memory in the audio path.
+ */
+class ChunkPool
+{
+  public:
+    static const size_t MAX_FREE_CHUNKS = 64;
+
+    ChunkPool(void) : allocated(0) {}
+    ~ChunkPool(void)
+    {
+      for (vector<float*>::iterator it = free_chunks.begin();
+           it != free_chunks.end(); ++it)
+      {
+        delete [] *it;
+      }
+    }
+
+    float *get(void)
+    {
+      if (free_chunks.empty())
+      {
+        ++allocated;
+        return new float[AudioFifo::CHUNK_SIZE];
+      }
+      float *chunk = free_chunks.back();
+      free_chunks.pop_back();
+      return chunk;
+    }
+
+    void put(float *chunk)
+    {
+      if (free_chunks.size() < MAX_FREE_CHUNKS)
+      {
+        free_chunks.push_back(chunk);
+      }
+      else
+      {
+        --allocated;
+        delete [] chunk;
+      }
+    }
+
+    size_t allocatedChunks(void) const { return allocated; }
+    size_t freeChunks(void) const { return free_chunks.size(); }
+
+  private:
+    vector<float*>  free_chunks;
+    size_t          allocated;
+};
+
+
+ChunkPool& chunkPool(void)
+{
+  static ChunkPool pool;
+  return pool;
+}
+
+
+vector<AudioFifo*>& fifoRegistry(void)
+{
+  static vector<AudioFifo*> fifos;
+  return fifos;
+}
+
+}; /* End of anonymous namespace */
+
 
 
 /****************************************************************************
@@ -108,6 +180,7 @@ using namespace Async;
  ****************************************************************************/
 
 static const unsigned  MAX_WRITE_SIZE = 800;
+static const unsigned  SPLICE_LEN = 32;
 
 
 /****************************************************************************
@@ -116,32 +189,84 @@ static const unsigned  MAX_WRITE_SIZE = 800;
  *
  ****************************************************************************/
 
+vector<AudioFifo::Info> AudioFifo::fifoInfo(void)
+{
+  vector<Info> info;
+  const vector<AudioFifo*>& fifos = fifoRegistry();
+  for (vector<AudioFifo*>::const_iterator it = fifos.begin();
+       it != fifos.end(); ++it)
+  {
+    const AudioFifo *fifo = *it;
+    Info fi;
+    fi.name = fifo->fifo_name;
+    fi.size = fifo->fifo_size;
+    fi.depth = fifo->samplesInFifo(true);
+    fi.budget = fifo->latency_budget;
+    fi.allocated = 0;
+    for (size_t i=0; i<fifo->chunks.size(); ++i)
+    {
+      if (fifo->chunks[i] != 0)
+      {
+        fi.allocated += fifo->chunk_size;
+      }
+    }
+    fi.discarded = fifo->discarded;
+    info.push_back(fi);
+  }
+  return info;
+} /* AudioFifo::fifoInfo */
+
+
+void AudioFifo::printFifoInfo(ostream& os)
+{
+  vector<Info> info = fifoInfo();
+  for (vector<Info>::const_iterator it = info.begin(); it != info.end(); ++it)
+  {
+    os << setw(24) << left << (it->name.empty() ? "(unnamed)" : it->name)
+       << right
+       << " depth=" << it->depth << "/" << it->size
+       << " budget=" << it->budget
+       << " allocated=" << it->allocated
+       << " discarded=" << it->discarded
+       << endl;
+  }
+  const ChunkPool& pool = chunkPool();
+  os << "Chunk pool: " << pool.allocatedChunks() << " chunks allocated, "
+     << pool.freeChunks() << " free, "
+     << pool.allocatedChunks() * CHUNK_SIZE * sizeof(float) << " bytes"
+     << endl;
+} /* AudioFifo::printFifoInfo */
+
 
 AudioFifo::AudioFifo(unsigned fifo_size)
-  : fifo_size(fifo_size), head(0), tail(0),
+  : chunk_size(0), fifo_size(fifo_size), head(0), tail(0),
     do_overwrite(false), output_stopped(false), prebuf_samples(0),
     prebuf(false), is_flushing(false), is_full(false), buffering_enabled(true),
-    disable_buffering_when_flushed(false), is_idle(true), input_stopped(false)
+    disable_buffering_when_flushed(false), is_idle(true), input_stopped(false),
+    latency_budget(0), budget_policy(BUDGET_DROP), discarded(0)
 {
   assert(fifo_size > 0);
-  fifo = new float[fifo_size];
+  allocStorage();
+  fifoRegistry().push_back(this);
 } /* AudioFifo */
 
 
 AudioFifo::~AudioFifo(void)
 {
-  delete [] fifo;
+  vector<AudioFifo*>& fifos = fifoRegistry();
+  fifos.erase(remove(fifos.begin(), fifos.end(), this), fifos.end());
+  releaseStorage(true);
 } /* ~AudioFifo */
 
 
 void AudioFifo::setSize(unsigned new_size)
 {
-  assert(fifo_size > 0);
+  assert(new_size > 0);
   if (new_size != fifo_size)
   {
-    delete [] fifo;
+    releaseStorage(true);
     fifo_size = new_size;
-    fifo = new float[fifo_size];
+    allocStorage();
   }
   clear();
 } /* AudioFifo::setSize */
@@ -171,6 +296,7 @@ void AudioFifo::clear(void)
   
   is_full = false;
   tail = head = 0;
+  releaseStorage(false);
   prebuf = (prebuf_samples > 0);
   output_stopped = false;
   
@@ -222,6 +348,19 @@ void AudioFifo::enableBuffering(bool enable)
 } /* AudioFifo::enableBuffering */
 
 
+void AudioFifo::setLatencyBudget(unsigned budget, BudgetPolicy policy)
+{
+  latency_budget = budget;
+  budget_policy = policy;
+  applyLatencyBudget(0);
+  if (input_stopped && !full())
+  {
+    input_stopped = false;
+    sourceResumeOutput();
+  }
+} /* AudioFifo::setLatencyBudget */
+
+
 int AudioFifo::writeSamples(const float *samples, int count)
 {
   /*
@@ -252,23 +391,36 @@ int AudioFifo::writeSamples(const float *samples, int count)
   
   if (buffering_enabled)
   {
+    int samples_buffered = samples_written;
     while (!is_full && (samples_written < count))
     {
       while (!is_full && (samples_written < count))
       {
-	fifo[head] = samples[samples_written++];
-	head = (head < fifo_size-1) ? head + 1 : 0;
-	if (head == tail)
-	{
-	  if (do_overwrite)
-	  {
-      	    tail = (tail < fifo_size-1) ? tail + 1 : 0;
-	  }
-	  else
-	  {
-	    is_full = true;
-	  }
-	}
+        unsigned cnt = min(static_cast<unsigned>(count - samples_written),
+                           contiguous(head));
+        unsigned samples_in_buffer = samplesInFifo(true);
+        if (!do_overwrite)
+        {
+          cnt = min(cnt, fifo_size - samples_in_buffer);
+        }
+        else if (samples_in_buffer + cnt >= fifo_size)
+        {
+            // The FIFO hold at most fifo_size-1 samples in overwrite mode so
+            // make room by throwing away the oldest samples
+          advanceTail(samples_in_buffer + cnt - (fifo_size - 1));
+        }
+        memcpy(writePtr(head), samples + samples_written,
+               cnt * sizeof(*samples));
+        samples_written += cnt;
+        head += cnt;
+        if (head == fifo_size)
+        {
+          head = 0;
+        }
+        if (!do_overwrite && (head == tail))
+        {
+          is_full = true;
+        }
       }
       
       if (prebuf && (samplesInFifo() > 0))
@@ -277,6 +429,8 @@ int AudioFifo::writeSamples(const float *samples, int count)
       }
 
       writeSamplesFromFifo();
+      applyLatencyBudget(samples_written - samples_buffered);
+      samples_buffered = samples_written;
     }
   }
   else
@@ -377,7 +531,9 @@ void AudioFifo::writeSamplesFromFifo(void)
     int samples_to_write = min(MAX_WRITE_SIZE, samplesInFifo(true));
     int to_end_of_fifo = fifo_size - tail;
     samples_to_write = min(samples_to_write, to_end_of_fifo);
-    samples_written = sinkWriteSamples(fifo+tail, samples_to_write);
+    samples_to_write = min(samples_to_write,
+                           static_cast<int>(contiguous(tail)));
+    samples_written = sinkWriteSamples(samplePtr(tail), samples_to_write);
     //printf("AudioFifo::writeSamplesFromFifo(%s): samples_to_write=%d "
     //  	   "samples_written=%d\n", debug_name.c_str(), samples_to_write,
 	//   samples_written);
@@ -386,7 +542,7 @@ void AudioFifo::writeSamplesFromFifo(void)
       is_full = false;
       was_full = false;
     }
-    tail = (tail + samples_written) % fifo_size;
+    advanceTail(samples_written);
   } while((samples_written > 0) && !empty());
   
   if (samples_written == 0)
@@ -408,6 +564,125 @@ void AudioFifo::writeSamplesFromFifo(void)
 } /* writeSamplesFromFifo */
 
 
+void AudioFifo::allocStorage(void)
+{
+  if (fifo_size > CHUNK_SIZE)
+  {
+    chunk_size = CHUNK_SIZE;
+    chunks.assign((fifo_size + CHUNK_SIZE - 1) / CHUNK_SIZE, 0);
+  }
+  else
+  {
+      // Small FIFOs use a private buffer, allocated on the first write
+    chunk_size = fifo_size;
+    chunks.assign(1, 0);
+  }
+} /* AudioFifo::allocStorage */
+
+
+void AudioFifo::releaseStorage(bool release_all)
+{
+  if (chunks.size() == 1)
+  {
+    if (release_all)
+    {
+      delete [] chunks[0];
+      chunks[0] = 0;
+    }
+    return;
+  }
+
+  for (size_t i=0; i<chunks.size(); ++i)
+  {
+    if (chunks[i] != 0)
+    {
+      chunkPool().put(chunks[i]);
+      chunks[i] = 0;
+    }
+  }
+} /* AudioFifo::releaseStorage */
+
+
+float *AudioFifo::writePtr(unsigned idx)
+{
+  float *&chunk = chunks[idx / chunk_size];
+  if (chunk == 0)
+  {
+    chunk = (chunks.size() == 1) ? new float[chunk_size] : chunkPool().get();
+  }
+  return chunk + idx % chunk_size;
+} /* AudioFifo::writePtr */
+
+
+void AudioFifo::advanceTail(unsigned count)
+{
+  while (count > 0)
+  {
+    unsigned cnt = min(count, contiguous(tail));
+    unsigned chunk_idx = tail / chunk_size;
+    tail += cnt;
+    if (tail == fifo_size)
+    {
+      tail = 0;
+    }
+    count -= cnt;
+
+      // Give a pooled chunk back when all samples in it have been read.
+      // If the head is in the same chunk it still contain samples, or
+      // will be written to next.
+    if ((chunks.size() > 1) && (tail / chunk_size != chunk_idx) &&
+        (head / chunk_size != chunk_idx))
+    {
+      chunkPool().put(chunks[chunk_idx]);
+      chunks[chunk_idx] = 0;
+    }
+  }
+} /* AudioFifo::advanceTail */
+
+
+void AudioFifo::applyLatencyBudget(unsigned written)
+{
+  if (latency_budget == 0)
+  {
+    return;
+  }
+  unsigned budget = max(latency_budget, prebuf_samples);
+  unsigned samples_in_buffer = samplesInFifo(true);
+  if (samples_in_buffer <= budget)
+  {
+    return;
+  }
+
+  unsigned excess = samples_in_buffer - budget;
+  if ((budget_policy == BUDGET_COMPRESS) && (budget >= SPLICE_LEN) &&
+      (samples_in_buffer < 2 * budget))
+  {
+      // Splice out samples after the oldest ones, crossfading over the
+      // splice point to avoid clicks. The crossfade is not made longer than
+      // the number of samples removed since the faded out and the faded in
+      // regions would then overlap.
+    unsigned cnt = min(excess, written / 4);
+    if (cnt == 0)
+    {
+      return;
+    }
+    const unsigned fade_len = min(cnt, SPLICE_LEN);
+    for (unsigned i=0; i<fade_len; ++i)
+    {
+      float gain = static_cast<float>(i + 1) / (fade_len + 1);
+      float *src = samplePtr((tail + i) % fifo_size);
+      float *dst = samplePtr((tail + cnt + i) % fifo_size);
+      *dst = (1.0f - gain) * *src + gain * *dst;
+    }
+    excess = cnt;
+  }
+
+  is_full = false;
+  advanceTail(excess);
+  discarded += excess;
+} /* AudioFifo::applyLatencyBudget */
+
+
 
 /*
  * This file has not been truncated
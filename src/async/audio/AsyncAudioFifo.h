@@ -37,6 +37,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <ostream>
 
 
 /****************************************************************************
@@ -115,10 +119,63 @@ some additional features. Output can be started or stopped and it can be
 instructed to buffer some samples before starting to output audio.
 Samples can be automatically output using the normal audio pipe infrastructure
 or samples could be read on demand using the readSamples method.
+
+The storage for FIFOs larger than CHUNK_SIZE samples is allocated lazily, in
+chunks of CHUNK_SIZE samples, from a pool shared by all FIFOs. Chunks are
+given back to the pool as soon as they have been read out so the memory used
+depend on how full the FIFOs are rather than on their maximum size.
+
+A latency budget can be set to limit the delay that a FIFO may add. When the
+number of buffered samples exceed the budget, the oldest samples are either
+dropped or spliced out using a short crossfade, depending on the selected
+budget policy. All existing FIFOs, their current depth and budget can be
+listed using the fifoInfo and printFifoInfo functions.
 */
 class AudioFifo : public AudioSink, public AudioSource
 {
   public:
+    /**
+     * @brief   The size in samples of the chunks allocated from the pool
+     */
+    static const unsigned CHUNK_SIZE = 1024;
+
+    /**
+     * @brief   What to do when the latency budget is exceeded
+     */
+    typedef enum
+    {
+      BUDGET_DROP,      ///< Drop the oldest samples
+      BUDGET_COMPRESS   ///< Gradually splice out samples using crossfades
+    } BudgetPolicy;
+
+    /**
+     * @brief   Information about a FIFO, as returned by fifoInfo
+     */
+    struct Info
+    {
+      std::string   name;           ///< The name set using setName
+      unsigned      size;           ///< The maximum size in samples
+      unsigned      depth;          ///< The number of buffered samples
+      unsigned      budget;         ///< The latency budget, 0 if not set
+      unsigned      allocated;      ///< The number of allocated samples
+      unsigned long discarded;      ///< Samples discarded due to the budget
+    };
+
+    /**
+     * @brief   Get information about all existing FIFOs
+     * @return  Returns a vector with one entry per FIFO
+     */
+    static std::vector<Info> fifoInfo(void);
+
+    /**
+     * @brief   Print information about all existing FIFOs
+     * @param   os The stream to print to
+     *
+     * One line is printed per FIFO followed by a summary line showing the
+     * memory usage of the shared chunk pool.
+     */
+    static void printFifoInfo(std::ostream& os);
+
     /**
      * @brief 	Constuctor
      * @param   fifo_size This is the size of the fifo expressed in number
@@ -225,6 +282,49 @@ class AudioFifo : public AudioSink, public AudioSource
      * @return  Returns \em true if buffering is enabled or else \em false
      */
     bool bufferingEnabled(void) const { return buffering_enabled; }
+
+    /**
+     * @brief   Set a name for this FIFO
+     * @param   name The name to set
+     *
+     * The name is only used to identify the FIFO in the information returned
+     * by fifoInfo and printFifoInfo.
+     */
+    void setName(const std::string& name) { fifo_name = name; }
+
+    /**
+     * @brief   Get the name of this FIFO
+     * @return  Returns the name set using setName
+     */
+    const std::string& name(void) const { return fifo_name; }
+
+    /**
+     * @brief   Set the maximum number of samples to buffer
+     * @param   budget The latency budget in samples, 0 to disable
+     * @param   policy What to do when the budget is exceeded
+     *
+     * If more than the given number of samples is buffered, samples are
+     * discarded to get back within the budget. Using BUDGET_DROP, the oldest
+     * samples are dropped immediately. Using BUDGET_COMPRESS, at most a
+     * quarter of each written block is spliced out using a short crossfade
+     * so that the delay is reduced gradually. If the FIFO still grow to twice
+     * the budget, the oldest samples are dropped.
+     * The budget never cause pre-buffered samples to be discarded.
+     */
+    void setLatencyBudget(unsigned budget,
+                          BudgetPolicy policy=BUDGET_DROP);
+
+    /**
+     * @brief   Get the latency budget
+     * @return  Returns the latency budget in samples, 0 if not set
+     */
+    unsigned latencyBudget(void) const { return latency_budget; }
+
+    /**
+     * @brief   Get the number of samples discarded due to the latency budget
+     * @return  Returns the number of discarded samples
+     */
+    unsigned long discardedSamples(void) const { return discarded; }
     
     /**
      * @brief 	Write samples into the FIFO
@@ -270,7 +370,8 @@ class AudioFifo : public AudioSink, public AudioSource
     
     
   private:    
-    float     	*fifo;
+    std::vector<float*> chunks;
+    unsigned    chunk_size;
     unsigned    fifo_size;
     unsigned    head, tail;
     bool      	do_overwrite;
@@ -283,8 +384,27 @@ class AudioFifo : public AudioSink, public AudioSource
     bool      	disable_buffering_when_flushed;
     bool      	is_idle;
     bool      	input_stopped;
+    std::string fifo_name;
+    unsigned    latency_budget;
+    BudgetPolicy budget_policy;
+    unsigned long discarded;
     
+    AudioFifo(const AudioFifo&);
+    AudioFifo& operator=(const AudioFifo&);
     void writeSamplesFromFifo(void);
+    void allocStorage(void);
+    void releaseStorage(bool release_all);
+    unsigned contiguous(unsigned idx) const
+    {
+      return std::min(chunk_size - idx % chunk_size, fifo_size - idx);
+    }
+    float *samplePtr(unsigned idx) const
+    {
+      return chunks[idx / chunk_size] + idx % chunk_size;
+    }
+    float *writePtr(unsigned idx);
+    void advanceTail(unsigned count);
+    void applyLatencyBudget(unsigned written);
 
 };  /* class AudioFifo */
 
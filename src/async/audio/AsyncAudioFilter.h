@@ -81,6 +81,7 @@ namespace Async
  ****************************************************************************/
 
 class FidVars;
+class AudioChannelStrip;
   
 
 /****************************************************************************
@@ -198,6 +199,8 @@ class AudioFilter : public AudioProcessor
     AudioFilter& operator=(const AudioFilter&);
     void deleteFilter(void);
 
+    friend class AudioChannelStrip;
+
 };  /* class AudioFilter */
 
 
@@ -0,0 +1,182 @@
+/**
+@file   AsyncAudioFrameCodec.cpp
+@brief  Base class for codecs that encode and decode whole frames of audio
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioFrameCodec.h"
+#include "AsyncAudioFrameCodecGsm.h"
+#ifdef SPEEX_MAJOR
+#include "AsyncAudioFrameCodecSpeex.h"
+#endif
+#include "AsyncAudioSampleConv.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioFrameCodec *AudioFrameCodec::create(const std::string& name)
+{
+  if (name == "GSM")
+  {
+    return new AudioFrameCodecGsm;
+  }
+  else if (name == "GSM-WAV49")
+  {
+    return new AudioFrameCodecGsm(true);
+  }
+#ifdef SPEEX_MAJOR
+  else if (name == "SPEEX")
+  {
+    return new AudioFrameCodecSpeex;
+  }
+#endif
+  return 0;
+} /* AudioFrameCodec::create */
+
+
+int AudioFrameCodec::encode(const float *samples, int frame_cnt,
+                            uint8_t *buf, size_t buf_size)
+{
+  size_t count = frame_cnt * frameSampleCount();
+  int16_t *s16_samples = s16Buffer(count);
+  AudioSampleConv::floatToS16(s16_samples, samples, count);
+  return encodeS16(s16_samples, frame_cnt, buf, buf_size);
+} /* AudioFrameCodec::encode */
+
+
+int AudioFrameCodec::decode(const uint8_t *buf, size_t len, int frame_cnt,
+                            float *samples)
+{
+  size_t count = frame_cnt * frameSampleCount();
+  int16_t *s16_samples = s16Buffer(count);
+  int decoded_cnt = decodeS16(buf, len, frame_cnt, s16_samples);
+  AudioSampleConv::s16ToFloat(samples, s16_samples, count);
+  return decoded_cnt;
+} /* AudioFrameCodec::decode */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/*
+ * This file has not been truncated
+ */
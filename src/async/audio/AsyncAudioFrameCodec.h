@@ -0,0 +1,258 @@
+/**
+@file   AsyncAudioFrameCodec.h
+@brief  Base class for codecs that encode and decode whole frames of audio
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_FRAME_CODEC_INCLUDED
+#define ASYNC_AUDIO_FRAME_CODEC_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Base class for codecs that encode and decode whole frames of audio
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This is the codec layer used by the network protocols that handle their own
+packetization, like EchoLink and FRN, and by the audio encoder and decoder
+classes. In contrast to the AudioEncoder and AudioDecoder classes, which are
+audio pipe elements, objects of this class is just wrapping the codec state
+and convert a number of frames per call.
+
+The encoder and decoder states are allocated when the object is created.
+Any number of frames can be encoded or decoded in one call, which is how
+multi-frame network packets should be handled. The conversion between
+floating point and 16 bit samples is done for all frames at once using the
+functions in AudioSampleConv.
+
+Use the create function to create a codec object given its name.
+*/
+class AudioFrameCodec
+{
+  public:
+    /**
+     * @brief   Create a codec object given its name
+     * @param   name The name of the codec (e.g. GSM, GSM-WAV49, SPEEX)
+     * @return  Returns a new codec object or 0 if the codec is not available
+     */
+    static AudioFrameCodec *create(const std::string& name);
+
+    /**
+     * @brief   Constructor
+     */
+    AudioFrameCodec(void) {}
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    AudioFrameCodec(const AudioFrameCodec&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    AudioFrameCodec& operator=(const AudioFrameCodec&) = delete;
+
+    /**
+     * @brief   Destructor
+     */
+    virtual ~AudioFrameCodec(void) {}
+
+    /**
+     * @brief   Get the name of the codec
+     * @return  Returns the name of the codec
+     */
+    virtual const char *name(void) const = 0;
+
+    /**
+     * @brief   Get the number of samples in one frame
+     * @return  Returns the number of samples per frame
+     */
+    virtual int frameSampleCount(void) const = 0;
+
+    /**
+     * @brief   Encode a number of frames of 16 bit samples
+     * @param   samples   frame_cnt * frameSampleCount() samples to encode
+     * @param   frame_cnt The number of frames to encode
+     * @param   buf       The buffer to write the encoded data to
+     * @param   buf_size  The size of the buffer
+     * @return  Returns the number of bytes written or -1 on failure
+     */
+    virtual int encodeS16(const int16_t *samples, int frame_cnt,
+                          uint8_t *buf, size_t buf_size) = 0;
+
+    /**
+     * @brief   Decode a number of frames to 16 bit samples
+     * @param   buf       The encoded data
+     * @param   len       The length of the encoded data
+     * @param   frame_cnt The number of frames to decode
+     * @param   samples   Room for frame_cnt * frameSampleCount() samples
+     * @return  Returns the number of successfully decoded frames
+     *
+     * The samples for frames that could not be decoded are set to zero.
+     */
+    virtual int decodeS16(const uint8_t *buf, size_t len, int frame_cnt,
+                          int16_t *samples) = 0;
+
+    /**
+     * @brief   Encode a number of frames of floating point samples
+     * @param   samples   frame_cnt * frameSampleCount() samples to encode
+     * @param   frame_cnt The number of frames to encode
+     * @param   buf       The buffer to write the encoded data to
+     * @param   buf_size  The size of the buffer
+     * @return  Returns the number of bytes written or -1 on failure
+     */
+    int encode(const float *samples, int frame_cnt, uint8_t *buf,
+               size_t buf_size);
+
+    /**
+     * @brief   Decode a number of frames to floating point samples
+     * @param   buf       The encoded data
+     * @param   len       The length of the encoded data
+     * @param   frame_cnt The number of frames to decode
+     * @param   samples   Room for frame_cnt * frameSampleCount() samples
+     * @return  Returns the number of successfully decoded frames
+     *
+     * The samples for frames that could not be decoded are set to zero.
+     */
+    int decode(const uint8_t *buf, size_t len, int frame_cnt, float *samples);
+
+  protected:
+    /**
+     * @brief   Get a scratch buffer for 16 bit samples
+     * @param   count The minimum number of samples in the buffer
+     * @return  Returns a pointer to the buffer
+     *
+     * The buffer is only reallocated when a larger buffer than ever before
+     * is requested.
+     */
+    int16_t *s16Buffer(size_t count)
+    {
+      if (m_s16_buf.size() < count)
+      {
+        m_s16_buf.resize(count);
+      }
+      return &m_s16_buf[0];
+    }
+
+  private:
+    std::vector<int16_t> m_s16_buf;
+
+};  /* class AudioFrameCodec */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FRAME_CODEC_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
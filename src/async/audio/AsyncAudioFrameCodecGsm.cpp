@@ -0,0 +1,226 @@
+/**
+@file   AsyncAudioFrameCodecGsm.cpp
+@brief  A GSM 06.10 full rate frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <gsm.h>
+
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioFrameCodecGsm.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioFrameCodecGsm::AudioFrameCodecGsm(bool wav49)
+  : m_enc(gsm_create()), m_dec(gsm_create()), m_wav49(wav49)
+{
+  if (m_wav49)
+  {
+    int one = 1;
+    if ((gsm_option(m_enc, GSM_OPT_WAV49, &one) == -1) ||
+        (gsm_option(m_dec, GSM_OPT_WAV49, &one) == -1))
+    {
+      cerr << "*** ERROR: The GSM library does not support the WAV49 format"
+           << endl;
+    }
+  }
+} /* AudioFrameCodecGsm::AudioFrameCodecGsm */
+
+
+AudioFrameCodecGsm::~AudioFrameCodecGsm(void)
+{
+  gsm_destroy(m_enc);
+  gsm_destroy(m_dec);
+} /* AudioFrameCodecGsm::~AudioFrameCodecGsm */
+
+
+int AudioFrameCodecGsm::encodeS16(const int16_t *samples, int frame_cnt,
+                                  uint8_t *buf, size_t buf_size)
+{
+  if ((m_wav49 && (frame_cnt % 2 != 0)) ||
+      (encodedSize(frame_cnt) > buf_size))
+  {
+    return -1;
+  }
+
+    // The gsm_encode function does not modify the samples but its
+    // prototype is not const
+  gsm_signal *src = const_cast<gsm_signal*>(samples);
+  gsm_byte *dst = buf;
+  if (m_wav49)
+  {
+      // In WAV49 mode, alternating frames of 32 and 33 bytes are produced
+    for (int i=0; i<frame_cnt; i+=2)
+    {
+      gsm_encode(m_enc, src, dst);
+      gsm_encode(m_enc, src + FRAME_SAMPLE_CNT, dst + 32);
+      src += 2 * FRAME_SAMPLE_CNT;
+      dst += WAV49_FRAME_PAIR_SIZE;
+    }
+  }
+  else
+  {
+    for (int i=0; i<frame_cnt; ++i)
+    {
+      gsm_encode(m_enc, src, dst);
+      src += FRAME_SAMPLE_CNT;
+      dst += FRAME_SIZE;
+    }
+  }
+  return dst - buf;
+} /* AudioFrameCodecGsm::encodeS16 */
+
+
+int AudioFrameCodecGsm::decodeS16(const uint8_t *buf, size_t len,
+                                  int frame_cnt, int16_t *samples)
+{
+  int decoded_cnt = 0;
+  int avail_cnt = min(frame_cnt, static_cast<int>(
+        m_wav49 ? 2 * (len / WAV49_FRAME_PAIR_SIZE) : len / FRAME_SIZE));
+  gsm_byte *src = const_cast<gsm_byte*>(buf);
+  gsm_signal *dst = samples;
+  for (int i=0; i<avail_cnt; ++i)
+  {
+      // In WAV49 mode, alternating frames of 33 and 32 bytes are consumed
+    if (gsm_decode(m_dec, src, dst) == 0)
+    {
+      ++decoded_cnt;
+    }
+    else
+    {
+      memset(dst, 0, FRAME_SAMPLE_CNT * sizeof(*dst));
+    }
+    src += (m_wav49 && (i % 2 == 0)) ? 33 : (m_wav49 ? 32 : FRAME_SIZE);
+    dst += FRAME_SAMPLE_CNT;
+  }
+  memset(dst, 0, (frame_cnt - avail_cnt) * FRAME_SAMPLE_CNT * sizeof(*dst));
+  return decoded_cnt;
+} /* AudioFrameCodecGsm::decodeS16 */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,219 @@
+/**
+@file   AsyncAudioFrameCodecGsm.h
+@brief  A GSM 06.10 full rate frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_FRAME_CODEC_GSM_INCLUDED
+#define ASYNC_AUDIO_FRAME_CODEC_GSM_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioFrameCodec.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+struct gsm_state;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A GSM 06.10 full rate frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class wrap one GSM encoder and one GSM decoder state. Frames are 160
+samples and encode to 33 bytes each. In WAV49 mode, which is used by the
+FRN protocol, frames are handled in pairs encoding to 65 bytes so the frame
+count given to the encode and decode functions must then be even.
+*/
+class AudioFrameCodecGsm : public AudioFrameCodec
+{
+  public:
+    /**
+     * @brief   The number of samples in one frame
+     */
+    static const int FRAME_SAMPLE_CNT     = 160;
+
+    /**
+     * @brief   The size of one encoded frame
+     */
+    static const int FRAME_SIZE           = 33;
+
+    /**
+     * @brief   The size of one encoded pair of frames in WAV49 mode
+     */
+    static const int WAV49_FRAME_PAIR_SIZE = 65;
+
+    /**
+     * @brief   Constructor
+     * @param   wav49 Set to \em true to use the WAV49 frame format
+     */
+    explicit AudioFrameCodecGsm(bool wav49=false);
+
+    /**
+     * @brief   Destructor
+     */
+    virtual ~AudioFrameCodecGsm(void);
+
+    /**
+     * @brief   Get the name of the codec
+     * @return  Returns the name of the codec
+     */
+    virtual const char *name(void) const
+    {
+      return m_wav49 ? "GSM-WAV49" : "GSM";
+    }
+
+    /**
+     * @brief   Get the number of samples in one frame
+     * @return  Returns the number of samples per frame
+     */
+    virtual int frameSampleCount(void) const { return FRAME_SAMPLE_CNT; }
+
+    /**
+     * @brief   Get the size of a number of encoded frames
+     * @param   frame_cnt The number of frames
+     * @return  Returns the number of bytes that frame_cnt frames encode to
+     */
+    size_t encodedSize(int frame_cnt) const
+    {
+      return m_wav49 ? (frame_cnt / 2) * WAV49_FRAME_PAIR_SIZE
+                     : frame_cnt * FRAME_SIZE;
+    }
+
+    /**
+     * @brief   Encode a number of frames of 16 bit samples
+     * @param   samples   frame_cnt * FRAME_SAMPLE_CNT samples to encode
+     * @param   frame_cnt The number of frames to encode
+     * @param   buf       The buffer to write the encoded data to
+     * @param   buf_size  The size of the buffer
+     * @return  Returns the number of bytes written or -1 on failure
+     */
+    virtual int encodeS16(const int16_t *samples, int frame_cnt,
+                          uint8_t *buf, size_t buf_size);
+
+    /**
+     * @brief   Decode a number of frames to 16 bit samples
+     * @param   buf       The encoded data
+     * @param   len       The length of the encoded data
+     * @param   frame_cnt The number of frames to decode
+     * @param   samples   Room for frame_cnt * FRAME_SAMPLE_CNT samples
+     * @return  Returns the number of successfully decoded frames
+     *
+     * The samples for frames that could not be decoded, or did not fit in
+     * the given data, are set to zero.
+     */
+    virtual int decodeS16(const uint8_t *buf, size_t len, int frame_cnt,
+                          int16_t *samples);
+
+  private:
+    struct gsm_state* m_enc;
+    struct gsm_state* m_dec;
+    bool              m_wav49;
+
+};  /* class AudioFrameCodecGsm */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FRAME_CODEC_GSM_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
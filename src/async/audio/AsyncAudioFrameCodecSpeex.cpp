@@ -0,0 +1,226 @@
+/**
+@file   AsyncAudioFrameCodecSpeex.cpp
+@brief  A Speex narrowband frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <speex/speex.h>
+
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioFrameCodecSpeex.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioFrameCodecSpeex::AudioFrameCodecSpeex(void)
+  : m_enc_bits(new SpeexBits), m_dec_bits(new SpeexBits),
+    m_enc_state(speex_encoder_init(&speex_nb_mode)),
+    m_dec_state(speex_decoder_init(&speex_nb_mode))
+{
+  speex_bits_init(m_enc_bits);
+  speex_bits_init(m_dec_bits);
+} /* AudioFrameCodecSpeex::AudioFrameCodecSpeex */
+
+
+AudioFrameCodecSpeex::~AudioFrameCodecSpeex(void)
+{
+  speex_bits_destroy(m_enc_bits);
+  speex_bits_destroy(m_dec_bits);
+  delete m_enc_bits;
+  delete m_dec_bits;
+  speex_encoder_destroy(m_enc_state);
+  speex_decoder_destroy(m_dec_state);
+} /* AudioFrameCodecSpeex::~AudioFrameCodecSpeex */
+
+
+void AudioFrameCodecSpeex::setBitrate(int bitrate)
+{
+  speex_encoder_ctl(m_enc_state, SPEEX_SET_BITRATE, &bitrate);
+} /* AudioFrameCodecSpeex::setBitrate */
+
+
+void AudioFrameCodecSpeex::setQuality(int quality)
+{
+  speex_encoder_ctl(m_enc_state, SPEEX_SET_QUALITY, &quality);
+} /* AudioFrameCodecSpeex::setQuality */
+
+
+void AudioFrameCodecSpeex::setComplexity(int complexity)
+{
+  speex_encoder_ctl(m_enc_state, SPEEX_SET_COMPLEXITY, &complexity);
+} /* AudioFrameCodecSpeex::setComplexity */
+
+
+int AudioFrameCodecSpeex::encodeS16(const int16_t *samples, int frame_cnt,
+                                    uint8_t *buf, size_t buf_size)
+{
+    // The encoder may modify the input samples in place so work on a copy
+    // unless the samples already are in the scratch buffer, which is the
+    // case when called from encode()
+  size_t count = frame_cnt * FRAME_SAMPLE_CNT;
+  spx_int16_t *src = s16Buffer(count);
+  if (src != samples)
+  {
+    memcpy(src, samples, count * sizeof(*src));
+  }
+  for (int i=0; i<frame_cnt; ++i)
+  {
+    speex_encode_int(m_enc_state, src + i * FRAME_SAMPLE_CNT, m_enc_bits);
+  }
+  speex_bits_insert_terminator(m_enc_bits);
+  int nbytes = -1;
+  size_t nsize = speex_bits_nbytes(m_enc_bits);
+  if (nsize <= buf_size)
+  {
+    nbytes = speex_bits_write(m_enc_bits, reinterpret_cast<char*>(buf), nsize);
+  }
+  speex_bits_reset(m_enc_bits);
+  return nbytes;
+} /* AudioFrameCodecSpeex::encodeS16 */
+
+
+int AudioFrameCodecSpeex::decodeS16(const uint8_t *buf, size_t len,
+                                    int frame_cnt, int16_t *samples)
+{
+  speex_bits_read_from(m_dec_bits,
+                       reinterpret_cast<char*>(const_cast<uint8_t*>(buf)),
+                       len);
+  int decoded_cnt = 0;
+  while (decoded_cnt < frame_cnt)
+  {
+    if (speex_decode_int(m_dec_state, m_dec_bits,
+                         samples + decoded_cnt * FRAME_SAMPLE_CNT) != 0)
+    {
+      break;
+    }
+    ++decoded_cnt;
+  }
+  memset(samples + decoded_cnt * FRAME_SAMPLE_CNT, 0,
+         (frame_cnt - decoded_cnt) * FRAME_SAMPLE_CNT * sizeof(*samples));
+  return decoded_cnt;
+} /* AudioFrameCodecSpeex::decodeS16 */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+
+
+/*
+ * This file has not been truncated
+ */
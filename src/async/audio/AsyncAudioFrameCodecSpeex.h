@@ -0,0 +1,219 @@
+/**
+@file   AsyncAudioFrameCodecSpeex.h
+@brief  A Speex narrowband frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_FRAME_CODEC_SPEEX_INCLUDED
+#define ASYNC_AUDIO_FRAME_CODEC_SPEEX_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioFrameCodec.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+struct SpeexBits;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A Speex narrowband frame codec
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class wrap one Speex narrowband encoder and one decoder state. Frames are
+160 samples. All frames given to one call to the encode function are packed
+into one bit stream, ended by a terminator, and all frames given to one call
+to the decode function are read from one bit stream. This is how Speex is
+transported in EchoLink audio packets.
+*/
+class AudioFrameCodecSpeex : public AudioFrameCodec
+{
+  public:
+    /**
+     * @brief   The number of samples in one frame
+     */
+    static const int FRAME_SAMPLE_CNT = 160;
+
+    /**
+     * @brief   Constructor
+     */
+    AudioFrameCodecSpeex(void);
+
+    /**
+     * @brief   Destructor
+     */
+    virtual ~AudioFrameCodecSpeex(void);
+
+    /**
+     * @brief   Get the name of the codec
+     * @return  Returns the name of the codec
+     */
+    virtual const char *name(void) const { return "SPEEX"; }
+
+    /**
+     * @brief   Get the number of samples in one frame
+     * @return  Returns the number of samples per frame
+     */
+    virtual int frameSampleCount(void) const { return FRAME_SAMPLE_CNT; }
+
+    /**
+     * @brief   Set the encoder bitrate
+     * @param   bitrate The bitrate in bits per second
+     */
+    void setBitrate(int bitrate);
+
+    /**
+     * @brief   Set the encoder quality
+     * @param   quality The quality, 0 to 10
+     */
+    void setQuality(int quality);
+
+    /**
+     * @brief   Set the encoder complexity
+     * @param   complexity The complexity, 1 to 10
+     */
+    void setComplexity(int complexity);
+
+    /**
+     * @brief   Encode a number of frames of 16 bit samples
+     * @param   samples   frame_cnt * FRAME_SAMPLE_CNT samples to encode
+     * @param   frame_cnt The number of frames to encode
+     * @param   buf       The buffer to write the encoded data to
+     * @param   buf_size  The size of the buffer
+     * @return  Returns the number of bytes written or -1 on failure
+     *
+     * The encoded data must be smaller than the buffer size, or else the
+     * encoding fail.
+     */
+    virtual int encodeS16(const int16_t *samples, int frame_cnt,
+                          uint8_t *buf, size_t buf_size);
+
+    /**
+     * @brief   Decode a number of frames to 16 bit samples
+     * @param   buf       The encoded data
+     * @param   len       The length of the encoded data
+     * @param   frame_cnt The number of frames to decode
+     * @param   samples   Room for frame_cnt * FRAME_SAMPLE_CNT samples
+     * @return  Returns the number of successfully decoded frames
+     *
+     * Decoding stop at the first frame that cannot be decoded, either
+     * because there are too few frames in the bit stream or because it is
+     * corrupt. The samples for that frame and the following ones are set
+     * to zero.
+     */
+    virtual int decodeS16(const uint8_t *buf, size_t len, int frame_cnt,
+                          int16_t *samples);
+
+  private:
+    SpeexBits*  m_enc_bits;
+    SpeexBits*  m_dec_bits;
+    void*       m_enc_state;
+    void*       m_dec_state;
+
+};  /* class AudioFrameCodecSpeex */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FRAME_CODEC_SPEEX_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -117,43 +117,6 @@ namespace Async
   
   }; /* AudioFsf::CombFilter */
 
-
-  class AudioFsf::Resonator
-  {
-    public:
-      Resonator(const size_t N, const size_t k, const float r, const float H)
-        : gain(H), coeff1(2.0*r*cos(2.0*M_PI*k/N)), coeff2(-r*r),
-          z1(0.0), z2(0.0)
-      {
-        gain /= N;
-        if ((k == 0) || (k == N/2))
-        {
-          gain /= 2.0;
-        }
-        if (k % 2 == 1)
-        {
-          gain = -gain;
-        }
-        //std::cout << "### Resonator: N=" << N << " k=" << k << " r=" << r
-        //          << " H=" << H << " gain=" << gain
-        //          << " coeff1=" << coeff1 << " coeff2=" << coeff2 << std::endl;
-      }
-
-      inline float processSample(const float& src)
-      {
-        float dest = src + z1*coeff1 + z2*coeff2;
-        z2 = z1;
-        z1 = dest;
-        return dest * gain;
-      }
-
-    private:
-      float       gain;
-      const float coeff1;
-      const float coeff2;
-      float       z1;
-      float       z2;
-  };
 };
 
 
@@ -198,22 +161,28 @@ AudioFsf::AudioFsf(const size_t N, const float *coeff, const float r)
     float H = coeff[k];
     if (H > 0.0f)
     {
-      Resonator *res = new Resonator(N, k, r, H);
-      m_resonators.push_back(res);
+      float gain = H;
+      gain /= N;
+      if ((k == 0) || (k == N/2))
+      {
+        gain /= 2.0;
+      }
+      if (k % 2 == 1)
+      {
+        gain = -gain;
+      }
+      m_res_gain.push_back(gain);
+      m_res_coeff1.push_back(2.0*r*cos(2.0*M_PI*k/N));
+      m_res_coeff2.push_back(-r*r);
     }
   }
+  m_res_z1.assign(m_res_gain.size(), 0.0f);
+  m_res_z2.assign(m_res_gain.size(), 0.0f);
 } /* AudioFsf::AudioFsf */
 
 
 AudioFsf::~AudioFsf(void)
 {
-  for (std::vector<Resonator*>::iterator it=m_resonators.begin();
-       it!=m_resonators.end();
-       ++it)
-  {
-    delete *it;
-  }
-  m_resonators.clear();
   delete m_comb2;
   m_comb2 = 0;
   delete m_combN;
@@ -229,18 +198,34 @@ AudioFsf::~AudioFsf(void)
 
 void AudioFsf::processSamples(float *dest, const float *src, int count)
 {
+    // Run the comb filters for the whole block first. This also makes it
+    // safe for dest and src to point to the same buffer.
+  m_comb_out.resize(count);
   for (int i=0; i<count; ++i)
   {
-    float destN = m_combN->processSample(src[i]);
-    float dest2 = m_comb2->processSample(destN);
-    dest[i] = 0.0f;
-    for (std::vector<Resonator*>::iterator it=m_resonators.begin();
-         it!=m_resonators.end();
-         ++it)
-    {
-      dest[i] += (*it)->processSample(dest2);
-    }
+    m_comb_out[i] = m_comb2->processSample(m_combN->processSample(src[i]));
   }
+
+    // The resonators are run in groups over the whole block. Within a group
+    // the resonators are independent of each other so the compiler can
+    // vectorize the state update. The resonator outputs are added in the
+    // same order for each sample as when running the resonators one by one
+    // so the grouping does not change the numerical result.
+  m_acc.assign(count, 0.0f);
+  const size_t res_cnt = m_res_gain.size();
+  size_t r = 0;
+  for (; r+RES_GROUP_SIZE<=res_cnt; r+=RES_GROUP_SIZE)
+  {
+    runResonators<RES_GROUP_SIZE>(r, count);
+  }
+  switch (res_cnt - r)
+  {
+    case 3: runResonators<3>(r, count); break;
+    case 2: runResonators<2>(r, count); break;
+    case 1: runResonators<1>(r, count); break;
+    default: break;
+  }
+  std::memcpy(dest, m_acc.data(), count * sizeof(*dest));
 } /* AudioFsf::processSamples */
 
 
@@ -250,6 +235,44 @@ void AudioFsf::processSamples(float *dest, const float *src, int count)
  *
  ****************************************************************************/
 
+template <size_t L>
+void AudioFsf::runResonators(size_t first, int count)
+{
+  float gain[L], coeff1[L], coeff2[L], z1[L], z2[L];
+  for (size_t l=0; l<L; ++l)
+  {
+    gain[l] = m_res_gain[first+l];
+    coeff1[l] = m_res_coeff1[first+l];
+    coeff2[l] = m_res_coeff2[first+l];
+    z1[l] = m_res_z1[first+l];
+    z2[l] = m_res_z2[first+l];
+  }
+
+  const float *x = m_comb_out.data();
+  float *acc = m_acc.data();
+  for (int i=0; i<count; ++i)
+  {
+    float y[L];
+    for (size_t l=0; l<L; ++l)
+    {
+      y[l] = x[i] + z1[l]*coeff1[l] + z2[l]*coeff2[l];
+      z2[l] = z1[l];
+      z1[l] = y[l];
+      y[l] *= gain[l];
+    }
+    for (size_t l=0; l<L; ++l)
+    {
+      acc[i] += y[l];
+    }
+  }
+
+  for (size_t l=0; l<L; ++l)
+  {
+    m_res_z1[first+l] = z1[l];
+    m_res_z2[first+l] = z2[l];
+  }
+} /* AudioFsf::runResonators */
+
 
 
 /*
@@ -203,15 +203,23 @@ class AudioFsf : public Async::AudioProcessor
     virtual void processSamples(float *dest, const float *src, int count);
 
   private:
+    static const size_t RES_GROUP_SIZE = 4;
+
     class CombFilter;
-    class Resonator;
 
-    CombFilter *            m_combN;
-    CombFilter *            m_comb2;
-    std::vector<Resonator*> m_resonators;
+    CombFilter *        m_combN;
+    CombFilter *        m_comb2;
+    std::vector<float>  m_res_gain;
+    std::vector<float>  m_res_coeff1;
+    std::vector<float>  m_res_coeff2;
+    std::vector<float>  m_res_z1;
+    std::vector<float>  m_res_z2;
+    std::vector<float>  m_comb_out;
+    std::vector<float>  m_acc;
 
     AudioFsf(const AudioFsf&);
     AudioFsf& operator=(const AudioFsf&);
+    template <size_t L> void runResonators(size_t first, int count);
 
 };  /* class AudioFsf */
 
@@ -90,6 +90,7 @@ class Async::AudioMixer::MixerSrc : public AudioSink
     MixerSrc(AudioMixer *mixer)
       : fifo(FIFO_SIZE), mixer(mixer), is_flushed(true), do_flush(false)
     {
+      fifo.setName("AudioMixer/Source");
       AudioSink::setHandler(&fifo);
       fifo.registerSink(&reader);
     }
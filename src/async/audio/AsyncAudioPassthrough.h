@@ -113,14 +113,22 @@ It can be used standalone but maybe is of more use when inheriting from it.
 For example if you want to snoop in on an audio streem without affecting it,
 just reimplement the writeSamples method and you have access to the samples.
 Just remember to call the sinkWriteSamples method to forward the samples.
+
+An AudioPassthrough created as transparent is bypassed, so sources writing to
+it will write directly to the sink after it. Classes inheriting from
+AudioPassthrough normally reimplement writeSamples so they must not be created
+as transparent.
 */
 class AudioPassthrough : public AudioSink, public AudioSource
 {
   public:
     /**
      * @brief 	Default constuctor
+     * @param   transparent Set to \em true to let written samples bypass
+     *                      this object
      */
-    AudioPassthrough(void) {}
+    explicit AudioPassthrough(bool transparent=false)
+      : m_transparent(transparent) {}
   
     /**
      * @brief 	Destructor
@@ -179,10 +187,22 @@ class AudioPassthrough : public AudioSink, public AudioSource
     {
       sourceAllSamplesFlushed();
     }
+
+    /**
+     * @brief   Find out if written samples may bypass this sink
+     * @return  Returns the source part of this object if it is transparent
+     *          or else 0
+     */
+    virtual AudioSource *bypassSource(void)
+    {
+      return m_transparent ? this : 0;
+    }
     
   protected:
     
   private:
+    const bool m_transparent;
+
     AudioPassthrough(const AudioPassthrough&);
     AudioPassthrough& operator=(const AudioPassthrough&);
     
@@ -0,0 +1,354 @@
+/**
+@file	 AsyncAudioSampleConv.cpp
+@brief   Conversion between fixed point and floating point sample formats
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioSampleConv.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+const float S16_TO_FLOAT = 1.0f / 32768.0f;
+const float FLOAT_TO_S16 = 32767.0f;
+const float S16_MAX = 32767.0f;
+
+  /*
+   * Branch free clipping and truncation. Written using min/max so that the
+   * compiler can map it onto SIMD min/max instructions.
+   */
+inline int16_t clipS16(float sample)
+{
+  return static_cast<int16_t>(std::min(std::max(sample, -S16_MAX), S16_MAX));
+}
+
+
+  /*
+   * The loops below take the channel count as a template parameter so that
+   * the stride is a compile time constant, which is what the auto vectorizer
+   * need to turn the strided accesses into SIMD shuffles. A channel count
+   * of zero means that the stride is given at runtime.
+   */
+template <size_t CH>
+void deinterleaveN(float * const *dest, const int16_t *src, size_t frame_cnt,
+                   size_t channels)
+{
+  const size_t stride = (CH > 0) ? CH : channels;
+  for (size_t ch=0; ch<stride; ++ch)
+  {
+    float *d = dest[ch];
+    if (d == 0)
+    {
+      continue;
+    }
+    const int16_t *s = src + ch;
+    for (size_t i=0; i<frame_cnt; ++i)
+    {
+      d[i] = static_cast<float>(s[i * stride]) * S16_TO_FLOAT;
+    }
+  }
+} /* deinterleaveN */
+
+
+template <size_t CH>
+void interleaveN(int16_t *dest, const float * const *src, size_t frame_cnt,
+                 size_t channels)
+{
+  const size_t stride = (CH > 0) ? CH : channels;
+  for (size_t ch=0; ch<stride; ++ch)
+  {
+    const float *s = src[ch];
+    int16_t *d = dest + ch;
+    if (s == 0)
+    {
+      for (size_t i=0; i<frame_cnt; ++i)
+      {
+        d[i * stride] = 0;
+      }
+      continue;
+    }
+    for (size_t i=0; i<frame_cnt; ++i)
+    {
+      d[i * stride] = clipS16(FLOAT_TO_S16 * s[i]);
+    }
+  }
+} /* interleaveN */
+
+
+template <size_t CH>
+void mixIntoChannelN(int16_t *dest, const float *src, size_t frame_cnt,
+                     size_t channels)
+{
+  const size_t stride = (CH > 0) ? CH : channels;
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    dest[i * stride] = clipS16(FLOAT_TO_S16 * src[i] + dest[i * stride]);
+  }
+} /* mixIntoChannelN */
+
+
+void interleaveDither(int16_t *dest, const float * const *src,
+                      size_t frame_cnt, size_t channels,
+                      AudioSampleConv::Dither &dither)
+{
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    for (size_t ch=0; ch<channels; ++ch)
+    {
+      const float *s = src[ch];
+      *dest++ = (s != 0)
+        ? clipS16(FLOAT_TO_S16 * s[i] + dither.next())
+        : 0;
+    }
+  }
+} /* interleaveDither */
+
+
+void mixIntoChannelDither(int16_t *dest, const float *src, size_t frame_cnt,
+                          size_t channels, AudioSampleConv::Dither &dither)
+{
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    dest[i * channels] = clipS16(
+        FLOAT_TO_S16 * src[i] + dest[i * channels] + dither.next());
+  }
+} /* mixIntoChannelDither */
+
+
+}; /* End of anonymous namespace */
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void AudioSampleConv::s16ToFloat(float *dest, const int16_t *src, size_t count)
+{
+  for (size_t i=0; i<count; ++i)
+  {
+    dest[i] = static_cast<float>(src[i]) * S16_TO_FLOAT;
+  }
+} /* AudioSampleConv::s16ToFloat */
+
+
+void AudioSampleConv::floatToS16(int16_t *dest, const float *src,
+                                 size_t count, Dither *dither)
+{
+  if (dither != 0)
+  {
+    for (size_t i=0; i<count; ++i)
+    {
+      dest[i] = clipS16(FLOAT_TO_S16 * src[i] + dither->next());
+    }
+    return;
+  }
+
+  for (size_t i=0; i<count; ++i)
+  {
+    dest[i] = clipS16(FLOAT_TO_S16 * src[i]);
+  }
+} /* AudioSampleConv::floatToS16 */
+
+
+void AudioSampleConv::deinterleave(float * const *dest, const int16_t *src,
+                                   size_t frame_cnt, size_t channels)
+{
+  switch (channels)
+  {
+    case 1:
+      if (dest[0] != 0)
+      {
+        s16ToFloat(dest[0], src, frame_cnt);
+      }
+      break;
+    case 2: deinterleaveN<2>(dest, src, frame_cnt, channels); break;
+    case 3: deinterleaveN<3>(dest, src, frame_cnt, channels); break;
+    case 4: deinterleaveN<4>(dest, src, frame_cnt, channels); break;
+    case 5: deinterleaveN<5>(dest, src, frame_cnt, channels); break;
+    case 6: deinterleaveN<6>(dest, src, frame_cnt, channels); break;
+    case 7: deinterleaveN<7>(dest, src, frame_cnt, channels); break;
+    case 8: deinterleaveN<8>(dest, src, frame_cnt, channels); break;
+    default: deinterleaveN<0>(dest, src, frame_cnt, channels); break;
+  }
+} /* AudioSampleConv::deinterleave */
+
+
+void AudioSampleConv::interleave(int16_t *dest, const float * const *src,
+                                 size_t frame_cnt, size_t channels,
+                                 Dither *dither)
+{
+  if (dither != 0)
+  {
+    interleaveDither(dest, src, frame_cnt, channels, *dither);
+    return;
+  }
+
+  switch (channels)
+  {
+    case 1:
+      if (src[0] != 0)
+      {
+        floatToS16(dest, src[0], frame_cnt);
+      }
+      else
+      {
+        std::fill_n(dest, frame_cnt, 0);
+      }
+      break;
+    case 2: interleaveN<2>(dest, src, frame_cnt, channels); break;
+    case 3: interleaveN<3>(dest, src, frame_cnt, channels); break;
+    case 4: interleaveN<4>(dest, src, frame_cnt, channels); break;
+    case 5: interleaveN<5>(dest, src, frame_cnt, channels); break;
+    case 6: interleaveN<6>(dest, src, frame_cnt, channels); break;
+    case 7: interleaveN<7>(dest, src, frame_cnt, channels); break;
+    case 8: interleaveN<8>(dest, src, frame_cnt, channels); break;
+    default: interleaveN<0>(dest, src, frame_cnt, channels); break;
+  }
+} /* AudioSampleConv::interleave */
+
+
+void AudioSampleConv::mixIntoChannel(int16_t *dest, const float *src,
+                                     size_t frame_cnt, size_t channels,
+                                     size_t channel, Dither *dither)
+{
+  dest += channel;
+  if (dither != 0)
+  {
+    mixIntoChannelDither(dest, src, frame_cnt, channels, *dither);
+    return;
+  }
+
+  switch (channels)
+  {
+    case 1: mixIntoChannelN<1>(dest, src, frame_cnt, channels); break;
+    case 2: mixIntoChannelN<2>(dest, src, frame_cnt, channels); break;
+    case 3: mixIntoChannelN<3>(dest, src, frame_cnt, channels); break;
+    case 4: mixIntoChannelN<4>(dest, src, frame_cnt, channels); break;
+    case 5: mixIntoChannelN<5>(dest, src, frame_cnt, channels); break;
+    case 6: mixIntoChannelN<6>(dest, src, frame_cnt, channels); break;
+    case 7: mixIntoChannelN<7>(dest, src, frame_cnt, channels); break;
+    case 8: mixIntoChannelN<8>(dest, src, frame_cnt, channels); break;
+    default: mixIntoChannelN<0>(dest, src, frame_cnt, channels); break;
+  }
+} /* AudioSampleConv::mixIntoChannel */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
+
@@ -0,0 +1,248 @@
+/**
+@file	 AsyncAudioSampleConv.h
+@brief   Conversion between fixed point and floating point sample formats
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+This file contains a collection of functions for converting between the
+interleaved signed 16 bit samples used by audio hardware and network protocols
+and the per channel floating point samples used inside the audio pipe.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_SAMPLE_CONV_INCLUDED
+#define ASYNC_AUDIO_SAMPLE_CONV_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdint>
+#include <cstddef>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Sample format conversion functions
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class contain static functions for converting between signed 16 bit
+samples and the floating point samples used in the audio pipe. Fixed point
+samples are scaled by 1/32768 when converted to floating point. Floating
+point samples are scaled by 32767 and clipped to the range [-32767, 32767]
+when converted to fixed point, which is the same conversion that has always
+been used throughout SvxLink.
+
+The inner loops are branch free and specialized for one to eight interleaved
+channels so that the compiler is able to vectorize them using whatever SIMD
+instructions the target CPU have. More than eight channels are handled by a
+generic, somewhat slower, loop.
+*/
+class AudioSampleConv
+{
+  public:
+    /**
+     * @brief   The maximum number of channels handled by specialized loops
+     */
+    static const size_t MAX_FAST_CHANNELS = 8;
+
+    /**
+     * @brief   Triangular (TPDF) dither generator
+     *
+     * Pass an object of this class to the float to fixed point conversion
+     * functions to add +-1 LSB of triangular dither before truncation. The
+     * object keep its own state so use one object per audio stream.
+     */
+    class Dither
+    {
+      public:
+        /**
+         * @brief   Constructor
+         * @param   seed The seed for the pseudo random number generator
+         */
+        explicit Dither(uint32_t seed=0x12345678) : m_state(seed) {}
+
+        /**
+         * @brief   Get the next dither value
+         * @return  Returns a value in the range (-1, 1), in LSB units
+         */
+        float next(void)
+        {
+          float r1 = nextUniform();
+          float r2 = nextUniform();
+          return r1 - r2;
+        }
+
+      private:
+        uint32_t m_state;
+
+        float nextUniform(void)
+        {
+          m_state = m_state * 1664525 + 1013904223;
+          return static_cast<float>(m_state >> 8) * (1.0f / 16777216.0f);
+        }
+    };
+
+    /**
+     * @brief   Convert signed 16 bit samples to floating point samples
+     * @param   dest  The destination buffer
+     * @param   src   The source buffer
+     * @param   count The number of samples to convert
+     */
+    static void s16ToFloat(float *dest, const int16_t *src, size_t count);
+
+    /**
+     * @brief   Convert floating point samples to signed 16 bit samples
+     * @param   dest    The destination buffer
+     * @param   src     The source buffer
+     * @param   count   The number of samples to convert
+     * @param   dither  Dither generator to use or 0 for no dithering
+     */
+    static void floatToS16(int16_t *dest, const float *src, size_t count,
+                           Dither *dither=0);
+
+    /**
+     * @brief   Split interleaved 16 bit samples into floating point channels
+     * @param   dest      One destination buffer per channel
+     * @param   src       The interleaved source buffer
+     * @param   frame_cnt The number of frames (samples per channel)
+     * @param   channels  The number of interleaved channels
+     *
+     * A destination buffer pointer may be set to 0 to indicate that the
+     * channel is not used. It will then not be converted at all.
+     */
+    static void deinterleave(float * const *dest, const int16_t *src,
+                             size_t frame_cnt, size_t channels);
+
+    /**
+     * @brief   Join floating point channels into interleaved 16 bit samples
+     * @param   dest      The interleaved destination buffer
+     * @param   src       One source buffer per channel
+     * @param   frame_cnt The number of frames (samples per channel)
+     * @param   channels  The number of interleaved channels
+     * @param   dither    Dither generator to use or 0 for no dithering
+     *
+     * A source buffer pointer may be set to 0 to write silence to that
+     * channel.
+     */
+    static void interleave(int16_t *dest, const float * const *src,
+                           size_t frame_cnt, size_t channels,
+                           Dither *dither=0);
+
+    /**
+     * @brief   Mix floating point samples into one interleaved channel
+     * @param   dest      The interleaved destination buffer
+     * @param   src       The source buffer
+     * @param   frame_cnt The number of frames (samples in the source buffer)
+     * @param   channels  The number of interleaved channels in dest
+     * @param   channel   The channel in dest to mix into
+     * @param   dither    Dither generator to use or 0 for no dithering
+     *
+     * The scaled source samples are added to the samples already in the
+     * destination buffer. The result is clipped to the 16 bit range.
+     */
+    static void mixIntoChannel(int16_t *dest, const float *src,
+                               size_t frame_cnt, size_t channels,
+                               size_t channel, Dither *dither=0);
+
+  private:
+    AudioSampleConv(void);
+
+};  /* class AudioSampleConv */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_SAMPLE_CONV_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
+
@@ -33,6 +33,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <algorithm>
+#include <cassert>
 
 
 /****************************************************************************
@@ -71,6 +73,11 @@ using namespace Async;
  *
  ****************************************************************************/
 
+// Default crossfade time in milliseconds used when switching branches
+static const int DEFAULT_XFADE_TIME = 5;
+
+// Size of the stack buffer used when applying the crossfade
+static const int XFADE_BUF_SIZE = 64;
 
 
 /****************************************************************************
@@ -82,24 +89,48 @@ using namespace Async;
 class Async::AudioSelector::Branch : public AudioSink
 {
   public:
-    Branch(AudioSelector *selector)
-      : m_selector(selector), m_auto_select(false), m_prio(0),
-        m_stream_state(STATE_IDLE), m_flush_wait(true)
+    Branch(AudioSelector *selector, AudioSource *source)
+      : m_selector(selector), m_source(source), m_auto_select(false),
+        m_prio(0), m_stream_state(STATE_IDLE), m_flush_wait(true),
+        m_indexed(false), m_stats()
     {
       assert(selector != 0);
     }
 
+    ~Branch(void)
+    {
+      unindex();
+    }
+
+    AudioSource *source(void) const { return m_source; }
     StreamState streamState(void) const { return m_stream_state; }
-    void setSelectionPrio(int prio) { m_prio = prio; }
     int selectionPrio(void) const { return m_prio; }
-    void enableAutoSelect(void) { m_auto_select = true; }
     bool autoSelectEnabled(void) const { return m_auto_select; }
     void setFlushWait(bool flush_wait) { m_flush_wait = flush_wait; }
     bool flushWait(void) const { return m_flush_wait; }
+    const BranchStats& stats(void) const { return m_stats; }
+    void countSelection(void) { m_stats.selections += 1; }
+
+    void setSelectionPrio(int prio)
+    {
+      if (prio != m_prio)
+      {
+        unindex();
+        m_prio = prio;
+        updateIndex();
+      }
+    }
+
+    void enableAutoSelect(void)
+    {
+      m_auto_select = true;
+      updateIndex();
+    }
 
     void disableAutoSelect(void)
     {
       m_auto_select = false;
+      updateIndex();
       if (isSelected())
       {
         m_selector->selectHighestPrioActiveBranch(true);
@@ -111,10 +142,23 @@ class Async::AudioSelector::Branch : public AudioSink
       return (m_selector->selectedBranch() == this);
     }
 
+    void unindex(void)
+    {
+      if (m_indexed)
+      {
+        m_selector->m_active_index.erase(m_index_pos);
+        m_indexed = false;
+      }
+    }
+
     virtual int writeSamples(const float *samples, int count)
     {
       assert(count > 0);
-      m_stream_state = STATE_WRITING;
+      if ((m_stream_state == STATE_IDLE) || (m_stream_state == STATE_FLUSHING))
+      {
+        m_stats.activations += 1;
+      }
+      setStreamState(STATE_WRITING);
       if (m_auto_select && !isSelected())
       {
 	const Branch *selected_branch = m_selector->selectedBranch();
@@ -128,11 +172,16 @@ class Async::AudioSelector::Branch : public AudioSink
       if (isSelected())
       {
         ret = m_selector->branchWriteSamples(samples, count);
+        m_stats.samples_written += ret;
         if (ret == 0)
         {
-          m_stream_state = STATE_STOPPED;
+          setStreamState(STATE_STOPPED);
         }
       }
+      else
+      {
+        m_stats.samples_dropped += count;
+      }
       return ret;
     }
 
@@ -148,12 +197,12 @@ class Async::AudioSelector::Branch : public AudioSink
         case STATE_STOPPED:
           if (isSelected())
           {
-            m_stream_state = STATE_FLUSHING;
+            setStreamState(STATE_FLUSHING);
             m_selector->branchFlushSamples();
           }
           else
           {
-            m_stream_state = STATE_IDLE;
+            setStreamState(STATE_IDLE);
             sourceAllSamplesFlushed();
           }
           break;
@@ -167,7 +216,7 @@ class Async::AudioSelector::Branch : public AudioSink
     {
       if (m_stream_state == STATE_STOPPED)
       {
-        m_stream_state = STATE_WRITING;
+        setStreamState(STATE_WRITING);
         sourceResumeOutput();
       }
     }
@@ -176,7 +225,7 @@ class Async::AudioSelector::Branch : public AudioSink
     {
       if (m_stream_state == STATE_FLUSHING)
       {
-        m_stream_state = STATE_IDLE;
+        setStreamState(STATE_IDLE);
         if (m_auto_select)
         {
           m_selector->selectBranch(0);
@@ -194,23 +243,52 @@ class Async::AudioSelector::Branch : public AudioSink
           break;
 
         case STATE_STOPPED:
-          m_stream_state = STATE_WRITING;
+          setStreamState(STATE_WRITING);
           sourceResumeOutput();
           break;
 
         case STATE_FLUSHING:
-          m_stream_state = STATE_IDLE;
+          setStreamState(STATE_IDLE);
           sourceAllSamplesFlushed();
           break;
       }
     }
 
   private:
-    AudioSelector * m_selector;
-    bool            m_auto_select;
-    int             m_prio;
-    StreamState     m_stream_state;
-    bool            m_flush_wait;
+    AudioSelector *         m_selector;
+    AudioSource *           m_source;
+    bool                    m_auto_select;
+    int                     m_prio;
+    StreamState             m_stream_state;
+    bool                    m_flush_wait;
+    bool                    m_indexed;
+    ActiveIndex::iterator   m_index_pos;
+    BranchStats             m_stats;
+
+    void setStreamState(StreamState state)
+    {
+      m_stream_state = state;
+      updateIndex();
+    }
+
+      // Keep the branch in the active index of the selector if, and only if,
+      // it is a candidate for auto selection. The index is ordered on
+      // priority so the best candidate is always found first.
+    void updateIndex(void)
+    {
+      bool active = m_auto_select && ((m_stream_state == STATE_WRITING) ||
+                                      (m_stream_state == STATE_STOPPED));
+      if (active && !m_indexed)
+      {
+        m_index_pos = m_selector->m_active_index.insert(
+            ActiveIndex::value_type(m_prio, this));
+        m_indexed = true;
+      }
+      else if (!active)
+      {
+        unindex();
+      }
+    }
 
 }; /* class Async::AudioSelector::Branch */
 
@@ -247,8 +325,10 @@ class Async::AudioSelector::Branch : public AudioSink
  ****************************************************************************/
 
 AudioSelector::AudioSelector(void)
-  : m_selected_branch(0), m_stream_state(STATE_IDLE)
+  : m_selected_branch(0), m_stream_state(STATE_IDLE), m_xfade_len(0),
+    m_xfade_pos(0), m_xfade_from(0.0f), m_last_sample(0.0f)
 {
+  setCrossfadeTime(DEFAULT_XFADE_TIME);
 } /* AudioSelector::AudioSelector */
 
 
@@ -267,7 +347,7 @@ void AudioSelector::addSource(Async::AudioSource *source)
 {
   assert(source != 0);
   assert(m_branch_map.find(source) == m_branch_map.end());
-  Branch *branch = new Branch(this);
+  Branch *branch = new Branch(this, source);
   source->registerSink(branch);
   m_branch_map[source] = branch;
 } /* AudioSelector::addSource */
@@ -280,6 +360,7 @@ void AudioSelector::removeSource(AudioSource *source)
   Branch *branch = (*it).second;
   m_branch_map.erase(it);
   assert(m_branch_map.find(source) == m_branch_map.end());
+  branch->unindex();
   if (branch == selectedBranch())
   {
     selectHighestPrioActiveBranch(true);
@@ -290,18 +371,13 @@ void AudioSelector::removeSource(AudioSource *source)
 
 void AudioSelector::setSelectionPrio(AudioSource *source, int prio)
 {
-  BranchMap::iterator it = m_branch_map.find(source);
-  assert(it != m_branch_map.end());
-  Branch *branch = (*it).second;
-  branch->setSelectionPrio(prio);
+  findBranch(source)->setSelectionPrio(prio);
 } /* AudioSelector::setAutoSelectPrio */
 
 
 void AudioSelector::enableAutoSelect(AudioSource *source, int prio)
 {
-  BranchMap::iterator it = m_branch_map.find(source);
-  assert(it != m_branch_map.end());
-  Branch *branch = (*it).second;
+  Branch *branch = findBranch(source);
   branch->setSelectionPrio(prio);
   branch->enableAutoSelect();
 } /* AudioSelector::enableAutoSelect */
@@ -309,20 +385,13 @@ void AudioSelector::enableAutoSelect(AudioSource *source, int prio)
 
 void AudioSelector::disableAutoSelect(AudioSource *source)
 {
-  BranchMap::iterator it = m_branch_map.find(source);
-  assert(it != m_branch_map.end());
-  Branch *branch = (*it).second;
-  branch->disableAutoSelect();
+  findBranch(source)->disableAutoSelect();
 } /* AudioSelector::disableAutoSelect */
 
 
 bool AudioSelector::autoSelectEnabled(const AudioSource *source) const
 {
-  BranchMap::const_iterator it = m_branch_map.find(
-      const_cast<AudioSource*>(source));
-  assert(it != m_branch_map.end());
-  const Branch *branch = (*it).second;
-  return branch->autoSelectEnabled();
+  return findBranch(source)->autoSelectEnabled();
 } /* AudioSelector::autoSelectEnabled */
 
 
@@ -331,9 +400,7 @@ void AudioSelector::selectSource(AudioSource *source)
   Branch *branch = 0;
   if (source != 0)
   {
-    BranchMap::iterator it = m_branch_map.find(source);
-    assert(it != m_branch_map.end());
-    branch = (*it).second;
+    branch = findBranch(source);
   }
   selectBranch(branch);
 } /* AudioSelector::selectSource */
@@ -341,27 +408,30 @@ void AudioSelector::selectSource(AudioSource *source)
 
 AudioSource *AudioSelector::selectedSource(void) const
 {
-  for (BranchMap::const_iterator it = m_branch_map.begin();
-       it != m_branch_map.end(); ++it)
-  {
-    if (it->second == selectedBranch())
-    {
-      return it->first;
-    }
-  }
-  return 0;
+  return (m_selected_branch != 0) ? m_selected_branch->source() : 0;
 } /* AudioSelector::selectedSource */
 
 
 void AudioSelector::setFlushWait(AudioSource *source, bool flush_wait)
 {
-  BranchMap::iterator it = m_branch_map.find(source);
-  assert(it != m_branch_map.end());
-  Branch *branch = (*it).second;
-  branch->setFlushWait(flush_wait);
+  findBranch(source)->setFlushWait(flush_wait);
 } /* AudioSelector::setFlushWait */
 
 
+const AudioSelector::BranchStats& AudioSelector::branchStats(
+    const AudioSource *source) const
+{
+  return findBranch(source)->stats();
+} /* AudioSelector::branchStats */
+
+
+void AudioSelector::setCrossfadeTime(int time_ms)
+{
+  m_xfade_len = max(0, time_ms * INTERNAL_SAMPLE_RATE / 1000);
+  m_xfade_pos = m_xfade_len;
+} /* AudioSelector::setCrossfadeTime */
+
+
 void AudioSelector::resumeOutput(void)
 {
   if (m_stream_state == STATE_STOPPED)
@@ -398,11 +468,55 @@ void AudioSelector::allSamplesFlushed(void)
  *
  ****************************************************************************/
 
+AudioSelector::Branch *AudioSelector::findBranch(
+    const AudioSource *source) const
+{
+  BranchMap::const_iterator it = m_branch_map.find(source);
+  assert(it != m_branch_map.end());
+  return (*it).second;
+} /* AudioSelector::findBranch */
+
+
 int AudioSelector::branchWriteSamples(const float *samples, int count)
 {
   m_stream_state = STATE_WRITING;
-  int ret = sinkWriteSamples(samples, count);
-  assert(ret >= 0);
+
+    // While a crossfade is in progress the samples are ramped from the last
+    // sample written before the switch. This is done in small chunks on the
+    // stack so that no extra buffering stage is needed.
+  int ret = 0;
+  bool sink_full = false;
+  while (!sink_full && (ret < count) && (m_xfade_pos < m_xfade_len))
+  {
+    float buf[XFADE_BUF_SIZE];
+    int len = min(count - ret, min(m_xfade_len - m_xfade_pos, XFADE_BUF_SIZE));
+    for (int i=0; i<len; ++i)
+    {
+      float gain = static_cast<float>(m_xfade_pos + i + 1) / (m_xfade_len + 1);
+      buf[i] = m_xfade_from + gain * (samples[ret + i] - m_xfade_from);
+    }
+    int written = sinkWriteSamples(buf, len);
+    assert(written >= 0);
+    if (written > 0)
+    {
+      m_last_sample = buf[written - 1];
+    }
+    m_xfade_pos += written;
+    ret += written;
+    sink_full = (written < len);
+  }
+
+  if (!sink_full && (ret < count))
+  {
+    int written = sinkWriteSamples(samples + ret, count - ret);
+    assert(written >= 0);
+    ret += written;
+    if (written > 0)
+    {
+      m_last_sample = samples[ret - 1];
+    }
+  }
+
   if (ret == 0)
   {
     m_stream_state = STATE_STOPPED;
@@ -454,6 +568,10 @@ void AudioSelector::selectBranch(Branch *branch)
   {
     prev_branch->unselect();
   }
+  if (m_selected_branch != 0)
+  {
+    m_selected_branch->countSelection();
+  }
 
   assert((m_selected_branch == 0) ||
          (m_selected_branch->streamState() == STATE_IDLE) ||
@@ -473,6 +591,13 @@ void AudioSelector::selectBranch(Branch *branch)
         m_stream_state = STATE_FLUSHING;
         sinkFlushSamples();
       }
+      else if (prev_branch != 0)
+      {
+          // Switching directly between two writing branches so the output
+          // stream continues. Crossfade to avoid a discontinuity.
+        m_xfade_from = m_last_sample;
+        m_xfade_pos = 0;
+      }
       break;
   }
 } /* AudioSelector::selectBranch */
@@ -481,20 +606,9 @@ void AudioSelector::selectBranch(Branch *branch)
 void AudioSelector::selectHighestPrioActiveBranch(bool clear_if_no_active)
 {
   Branch *new_branch = 0;
-  for (BranchMap::iterator it = m_branch_map.begin();
-       it != m_branch_map.end(); ++it)
+  if (!m_active_index.empty())
   {
-    Branch *branch = (*it).second;
-    if (branch->autoSelectEnabled())
-    {
-      if (((branch->streamState() == STATE_WRITING) ||
-           (branch->streamState() == STATE_STOPPED)) &&
-          ((new_branch == 0) ||
-          (branch->selectionPrio() > new_branch->selectionPrio())))
-      {
-        new_branch = branch;
-      }
-    }
+    new_branch = m_active_index.begin()->second;
   }
   if ((new_branch != 0) || clear_if_no_active)
   {
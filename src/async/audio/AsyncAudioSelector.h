@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <map>
+#include <functional>
 
 
 /****************************************************************************
@@ -110,10 +111,30 @@ namespace Async
 
 This class is used to select one of many incoming audio streams. Incoming
 samples on non-selected branches will be thrown away.
+
+Branches that have auto select enabled and are currently writing audio are
+kept in an index ordered on priority, so finding the best branch to switch
+to does not require a scan of all branches. When switching between two
+active branches, a short crossfade is applied. Activity counters for each
+branch can be read using the branchStats function.
 */
 class AudioSelector : public AudioSource
 {
   public:
+    /**
+     * @brief   Activity counters for a branch
+     *
+     * The counters are kept for each added source and can be read using the
+     * branchStats function. They are intended for diagnostics.
+     */
+    struct BranchStats
+    {
+      unsigned long activations;      ///< Times the branch started writing
+      unsigned long selections;       ///< Times the branch got selected
+      unsigned long samples_written;  ///< Samples passed on to the sink
+      unsigned long samples_dropped;  ///< Samples thrown away, not selected
+    };
+
     /**
      * @brief 	Default constuctor
      */
@@ -191,6 +212,25 @@ class AudioSelector : public AudioSource
      */
     void setFlushWait(AudioSource *source, bool flush_wait);
 
+    /**
+     * @brief   Get the activity counters for the given source
+     * @param   source The audio source
+     * @return  Returns a reference to the counters for the source
+     */
+    const BranchStats& branchStats(const AudioSource *source) const;
+
+    /**
+     * @brief   Set the length of the crossfade applied when switching
+     * @param   time_ms The crossfade time in milliseconds. 0 = no crossfade.
+     *
+     * When the selection is switched from one source to another while audio
+     * is being written to the sink, the first samples from the new source
+     * are faded in from the last sample written by the previous source. That
+     * removes the click otherwise caused by the discontinuity. No extra
+     * buffering is needed so no delay is introduced. The default is 5ms.
+     */
+    void setCrossfadeTime(int time_ms);
+
     /**
      * @brief Resume audio output to the sink
      *
@@ -210,16 +250,23 @@ class AudioSelector : public AudioSource
     } StreamState;
 
     class Branch;
-    typedef std::map<Async::AudioSource *, Branch *> BranchMap;
-    
+    typedef std::map<const Async::AudioSource *, Branch *> BranchMap;
+    typedef std::multimap<int, Branch *, std::greater<int> > ActiveIndex;
+
     BranchMap 	m_branch_map;
+    ActiveIndex m_active_index;
     Branch *    m_selected_branch;
     StreamState m_stream_state;
+    int         m_xfade_len;
+    int         m_xfade_pos;
+    float       m_xfade_from;
+    float       m_last_sample;
     
     AudioSelector(const AudioSelector&);
     AudioSelector& operator=(const AudioSelector&);
     void selectBranch(Branch *branch);
     Branch *selectedBranch(void) const { return m_selected_branch; }
+    Branch *findBranch(const AudioSource *source) const;
     void selectHighestPrioActiveBranch(bool clear_if_no_active);
     int branchWriteSamples(const float *samples, int count);
     void branchFlushSamples(void);
@@ -131,6 +131,7 @@ void AudioSink::unregisterSource(void)
     return;
   }
   
+  AudioSource::invalidateLinks();
   AudioSource *source = m_source;
   m_source = 0;
   
@@ -187,6 +188,7 @@ void AudioSink::sourceAllSamplesFlushed(void)
 bool AudioSink::setHandler(AudioSink *handler)
 {
   clearHandler();
+  AudioSource::invalidateLinks();
   
   if (handler == 0)
   {
@@ -253,6 +255,7 @@ bool AudioSink::registerSourceInternal(AudioSource *source, bool reg_sink)
     return m_source == source;
   }
   
+  AudioSource::invalidateLinks();
   m_source = source;
   m_auto_unreg_sink = reg_sink;
   if (reg_sink)
@@ -180,6 +180,31 @@ class AudioSink
       assert(m_handler != 0);
       m_handler->flushSamples();    
     }
+
+    /**
+     * @brief   Find out if written samples may bypass this sink
+     * @return  Returns the source part of this object if it is transparent
+     *          or else 0
+     *
+     * A sink that at the moment just forward all written samples unmodified
+     * to its own sink may return its source part here. Sources upstream will
+     * then write directly to the sink after this one. Flushes and all calls
+     * from the downstream sink still pass through this object. If the
+     * returned value change, AudioSource::invalidateLinks must be called.
+     */
+    virtual AudioSource *bypassSource(void) { return 0; }
+
+    /**
+     * @brief   Notify a bypassed sink about the state of the stream
+     * @param   stopped \em true if the sink after this one did not accept
+     *                  any samples, \em false if samples are written again
+     *                  after a flush or after the audio graph was changed
+     *
+     * This function is called for sinks that have been bypassed, see
+     * bypassSource, to make it possible to keep track of the stream state.
+     * It is only called on state changes, not for every block of samples.
+     */
+    virtual void bypassedWrite(bool stopped) {}
     
     
   protected:
@@ -71,6 +71,21 @@ using namespace Async;
 
 
 
+// Protect against loops in the audio graph
+static const unsigned MAX_BYPASS_DEPTH = 16;
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+unsigned long AudioSource::link_generation = 1;
+
+
+
 /****************************************************************************
  *
  * Local class definitions
@@ -168,10 +183,24 @@ int AudioSource::sinkWriteSamples(const float *samples, int len)
   assert(len > 0);
 
   is_flushing = false;
+
+  if (m_link_generation != link_generation)
+  {
+    updateLink();
+  }
   
-  if (m_sink != 0)
+  if (m_write_sink != 0)
   {
-    len = m_sink->writeSamples(samples, len);
+    if (m_link_notify)
+    {
+      m_link_notify = false;
+      notifyBypassed(false);
+    }
+    len = m_write_sink->writeSamples(samples, len);
+    if ((len == 0) && (m_link_generation == link_generation))
+    {
+      notifyBypassed(true);
+    }
   }
   
   return len;
@@ -184,6 +213,7 @@ void AudioSource::sinkFlushSamples(void)
   if (m_sink != 0)
   {
     is_flushing = true;
+    m_link_notify = true;
     m_sink->flushSamples();
   }
   else
@@ -196,6 +226,7 @@ void AudioSource::sinkFlushSamples(void)
 bool AudioSource::setHandler(AudioSource *handler)
 {
   clearHandler();
+  invalidateLinks();
   
   if (handler == 0)
   {
@@ -223,6 +254,8 @@ void AudioSource::clearHandler(void)
   {
     return;
   }
+
+  invalidateLinks();
   
   if (m_sink != 0)
   {
@@ -263,6 +296,7 @@ bool AudioSource::registerSinkInternal(AudioSink *sink, bool managed, bool reg)
     return m_sink == sink;
   }
   
+  invalidateLinks();
   m_sink = sink;
   m_auto_unreg_source = reg;
   if (reg)
@@ -301,6 +335,7 @@ void AudioSource::unregisterSinkInternal(bool is_being_destroyed)
     return;
   }
   
+  invalidateLinks();
   AudioSink *sink = m_sink;
   m_sink = 0;
   
@@ -331,6 +366,39 @@ void AudioSource::unregisterSinkInternal(bool is_being_destroyed)
 } /* AudioSource::unregisterSinkInternal */
 
 
+void AudioSource::updateLink(void)
+{
+  m_link_generation = link_generation;
+  m_link_notify = true;
+  m_bypassed.clear();
+  m_write_sink = m_sink;
+  while ((m_write_sink != 0) && (m_bypassed.size() < MAX_BYPASS_DEPTH))
+  {
+    AudioSource *source = m_write_sink->bypassSource();
+    if ((source == 0) || (source->m_sink == 0) || (source->m_handler != 0))
+    {
+      break;
+    }
+    m_bypassed.push_back(std::make_pair(m_write_sink, source));
+    m_write_sink = source->m_sink;
+  }
+} /* AudioSource::updateLink */
+
+
+void AudioSource::notifyBypassed(bool stopped)
+{
+  for (BypassList::iterator it = m_bypassed.begin();
+       it != m_bypassed.end(); ++it)
+  {
+    if (!stopped)
+    {
+      it->second->is_flushing = false;
+    }
+    it->first->bypassedWrite(stopped);
+  }
+} /* AudioSource::notifyBypassed */
+
+
 
 
 
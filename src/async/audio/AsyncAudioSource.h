@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <cassert>
+#include <vector>
+#include <utility>
 
 
 /****************************************************************************
@@ -110,6 +112,12 @@ class AudioSink;
 
 This is the base class for an audio source. An audio source is a class that
 can produce audio.
+
+Samples written using sinkWriteSamples will go directly to the first sink
+down the chain that is not transparent, skipping sinks that just forward the
+samples unmodified (see AudioSink::bypassSource). The direct link is set up
+when the first samples are written after the audio graph has changed so it
+is automatically updated when sinks are registered or unregistered.
 */
 class AudioSource
 {
@@ -119,7 +127,8 @@ class AudioSource
      */
     AudioSource(void)
       : m_sink(0), m_sink_managed(false), m_handler(0),
-        m_auto_unreg_source(false), is_flushing(false)
+        m_auto_unreg_source(false), is_flushing(false), m_write_sink(0),
+        m_link_generation(link_generation - 1), m_link_notify(false)
     {
     }
   
@@ -165,6 +174,16 @@ class AudioSource
      */
     bool sinkManaged(void) const { return m_sink_managed; }
 
+    /**
+     * @brief   Tell all sources that the audio graph have changed
+     *
+     * This function must be called when a sink change the value returned
+     * by AudioSink::bypassSource. All direct links will be set up again
+     * before the next samples are written. Registering and unregistering
+     * sinks and sources will automatically call this function.
+     */
+    static void invalidateLinks(void) { link_generation += 1; }
+
     /**
      * @brief The registered sink has flushed all samples
      *
@@ -259,14 +278,24 @@ class AudioSource
     
     
   private:
-    AudioSink 	*m_sink;
-    bool      	m_sink_managed;
-    AudioSource *m_handler;
-    bool      	m_auto_unreg_source;
-    bool      	is_flushing;
+    typedef std::vector<std::pair<AudioSink *, AudioSource *> > BypassList;
+
+    static unsigned long link_generation;
+
+    AudioSink 	  *m_sink;
+    bool      	  m_sink_managed;
+    AudioSource   *m_handler;
+    bool      	  m_auto_unreg_source;
+    bool      	  is_flushing;
+    AudioSink     *m_write_sink;
+    unsigned long m_link_generation;
+    bool          m_link_notify;
+    BypassList    m_bypassed;
     
     bool registerSinkInternal(AudioSink *sink, bool managed, bool reg);
     void unregisterSinkInternal(bool is_being_destroyed);
+    void updateLink(void);
+    void notifyBypassed(bool stopped);
 
 };  /* class AudioSource */
 
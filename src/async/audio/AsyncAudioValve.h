@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <algorithm>
 
 
 /****************************************************************************
@@ -45,6 +46,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <AsyncAudioSink.h>
 #include <AsyncAudioSource.h>
+#include <AsyncAudioFade.h>
 
 
 
@@ -112,6 +114,10 @@ namespace Async
 This class implements a "valve" for audio. That is, the audio stream can be
 turned on or off. It's named "valve" since the whole Async audio concept is
 called audio pipe.
+
+Optionally the audio can be faded in and out when the valve is opened and
+closed, see setFadeTime. When closing, audio is passed through for the
+duration of the fade out before the valve actually closes.
 */
 class AudioValve : public Async::AudioSink, public Async::AudioSource
 {
@@ -121,7 +127,8 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
      */
     explicit AudioValve(void)
       : block_when_closed(false), is_open(true),
-	is_idle(true), is_flushing(false), input_stopped(false)
+	is_idle(true), is_flushing(false), input_stopped(false),
+        is_closing(false)
     {
     }
   
@@ -147,9 +154,12 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
       }
       
       is_open = do_open;
+      AudioSource::invalidateLinks();
       
       if (do_open)
       {
+        is_closing = false;
+        fade.fadeIn();
       	if (input_stopped)
 	{
 	  input_stopped = false;
@@ -158,22 +168,34 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
       }
       else
       {
-	if (!is_idle && !is_flushing)
-	{
-      	  sinkFlushSamples();
-	}
-	if (!block_when_closed && input_stopped)
-	{
-	  input_stopped = false;
-	  sourceResumeOutput();
-	}
-	if (is_flushing)
-	{
-	  is_idle = true;
-	  is_flushing = false;
-	  sourceAllSamplesFlushed();
-	}
+        if (fade.isEnabled() && !is_idle && !is_flushing)
+        {
+            // Keep passing audio through until it has been faded out
+          is_closing = true;
+          fade.fadeOut();
+          return;
+        }
+        fade.setMuted();
+        closeOutput();
+      }
+    }
+
+    /**
+     * @brief   Set the fade in/out time used when opening and closing
+     * @param   time_ms The time in milliseconds for the fade in/out
+     *
+     * When a fade time is set, the audio stream will be faded in and out
+     * when the valve is opened and closed to avoid popping sounds due to
+     * discontinuities in the sample stream. The default is 0, no fading.
+     */
+    void setFadeTime(int time_ms)
+    {
+      fade.setLength(time_ms * INTERNAL_SAMPLE_RATE / 1000);
+      if (!is_open && !is_closing)
+      {
+        fade.setMuted();
       }
+      AudioSource::invalidateLinks();
     }
 
     /**
@@ -235,7 +257,11 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
       int ret = 0;
       is_idle = false;
       is_flushing = false;
-      if (is_open)
+      if ((is_open || is_closing) && !fade.isUnity())
+      {
+        ret = writeFadedSamples(samples, count);
+      }
+      else if (is_open)
       {
       	ret = sinkWriteSamples(samples, count);
       }
@@ -262,6 +288,12 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
      */
     void flushSamples(void)
     {
+      if (is_closing)
+      {
+        is_closing = false;
+        fade.setMuted();
+        closeOutput();
+      }
       if (is_open)
       {
       	is_flushing = true;
@@ -285,7 +317,7 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
      */
     void resumeOutput(void)
     {
-      if (is_open)
+      if (is_open || is_closing)
       {
       	if (input_stopped)
 	{
@@ -312,6 +344,33 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
       	sourceAllSamplesFlushed();
       }
     }
+
+    /**
+     * @brief   Find out if written samples may bypass the valve
+     * @return  Returns the source part of the valve when it is open and no
+     *          fade is in progress or else 0
+     */
+    virtual AudioSource *bypassSource(void)
+    {
+      return (is_open && !is_closing && fade.isUnity()) ? this : 0;
+    }
+
+    /**
+     * @brief   Update the stream state when the valve have been bypassed
+     * @param   stopped \em true if the sink did not accept any samples
+     */
+    virtual void bypassedWrite(bool stopped)
+    {
+      if (stopped)
+      {
+        input_stopped = true;
+      }
+      else
+      {
+        is_idle = false;
+        is_flushing = false;
+      }
+    }
     
     
   protected:
@@ -325,6 +384,75 @@ class AudioValve : public Async::AudioSink, public Async::AudioSource
     bool is_idle;
     bool is_flushing;
     bool input_stopped;
+    bool is_closing;
+    AudioFade fade;
+
+    void closeOutput(void)
+    {
+      if (!is_idle && !is_flushing)
+      {
+        sinkFlushSamples();
+      }
+      if (!block_when_closed && input_stopped)
+      {
+        input_stopped = false;
+        sourceResumeOutput();
+      }
+      if (is_flushing)
+      {
+        is_idle = true;
+        is_flushing = false;
+        sourceAllSamplesFlushed();
+      }
+    }
+
+    int writeFadedSamples(const float *samples, int count)
+    {
+      float buf[256];
+      int ret = 0;
+      bool sink_full = false;
+      for (;;)
+      {
+        if (is_closing && fade.isMuted())
+        {
+            // The fade out is done so now really close the valve. The rest
+            // of the samples are handled as if the valve was closed.
+          is_closing = false;
+          closeOutput();
+          if (!block_when_closed)
+          {
+            ret = count;
+          }
+          else if ((ret > 0) && (ret < count))
+          {
+            input_stopped = true;
+          }
+          break;
+        }
+        if (sink_full || (ret == count))
+        {
+          break;
+        }
+
+        int len = std::min(count - ret, 256);
+        if (is_closing)
+        {
+          len = std::min(len, fade.remaining());
+        }
+        std::copy(samples + ret, samples + ret + len, buf);
+        fade.apply(buf, len);
+        int written = sinkWriteSamples(buf, len);
+        fade.advance(written);
+        ret += written;
+        sink_full = (written < len);
+      }
+      if (is_open && fade.isUnity())
+      {
+          // The fade in is done so the valve may be bypassed again
+        AudioSource::invalidateLinks();
+      }
+      return ret;
+    }
     
 };  /* class AudioValve */
 
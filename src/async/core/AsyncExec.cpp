@@ -38,7 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/resource.h>
-#include <sys/types.h>
+#include <sys/syscall.h>
+#include <spawn.h>
 
 #include <cstring>
 #include <cassert>
@@ -54,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncApplication.h>
 
 
 /****************************************************************************
@@ -91,6 +93,44 @@ using namespace Async;
  *
  ****************************************************************************/
 
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+int pidfdOpen(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+  return syscall(SYS_pidfd_open, pid, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+} /* pidfdOpen */
+
+
+bool pidfdSupported(void)
+{
+  static int supported = -1;
+  if (supported < 0)
+  {
+    int fd = pidfdOpen(getpid());
+    supported = (fd >= 0) ? 1 : 0;
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+  }
+  return supported == 1;
+} /* pidfdSupported */
+
+
+}; /* End of anonymous namespace */
+
 
 
 /****************************************************************************
@@ -99,6 +139,8 @@ using namespace Async;
  *
  ****************************************************************************/
 
+extern char **environ;
+
 
 
 /****************************************************************************
@@ -129,40 +171,16 @@ struct sigaction  Exec::old_sigact;
 
 Exec::Exec(const std::string &cmd)
   : pid(-1), stdout_watch(0), stderr_watch(0), stdin_fd(-1),
-    status(0), nice_value(0), timeout_timer(0), pending_term(false)
+    status(0), nice_value(0), timeout_timer(0), pending_term(false),
+    pid_watch(0), stdin_watch(0), stdin_close_pending(false)
 {
   setCommandLine(cmd);
 
-    // Set up SIGCHLD signal handling on first usage of the class
-  if (sigchld_watch == 0)
+    // Use a pidfd to get notified when the subprocess exits if the kernel
+    // support it. Otherwise fall back to SIGCHLD signal handling.
+  if (!pidfdSupported())
   {
-    int ret = pipe(sigchld_pipe);
-    if (ret == -1)
-    {
-      cerr << "*** ERROR: Could not set up SIGCHLD pipe for Async::Exec: "
-        << strerror(errno) << endl;
-      exit(1);
-    }
-    sigchld_watch = new FdWatch(sigchld_pipe[0], FdWatch::FD_WATCH_RD);
-    sigchld_watch->activity.connect(
-        sigc::hide(sigc::ptr_fun(Exec::sigchldReceived)));
-
-    struct sigaction act;
-    memset(&act, 0, sizeof(act));
-    act.sa_sigaction = &handleSigChld;
-    act.sa_flags = SA_RESTART|SA_NOCLDSTOP|SA_SIGINFO;
-    if (sigaction(SIGCHLD, &act, &old_sigact) == -1)
-    {
-      cout << "*** ERROR: Could not set up SIGCHLD signal handler\n";
-      exit(1);
-    }
-    /*
-    cout << "### handler=" << old_sigact.sa_handler
-        //<< " mask=" << old_sigact.sa_mask
-      << " flags=" << old_sigact.sa_flags
-      << " sigaction=" << old_sigact.sa_sigaction
-      << endl;
-    */
+    setupSigChld();
   }
 } /* Exec::Exec */
 
@@ -175,10 +193,8 @@ Exec::~Exec(void)
     execs.erase(pid);
   }
 
-  if (stdin_fd != -1)
-  {
-    close(stdin_fd);
-  }
+  closeStdinPipe();
+  delete stdin_watch;
 
   if (stdout_watch != 0)
   {
@@ -192,6 +208,12 @@ Exec::~Exec(void)
     delete stderr_watch;
   }
 
+  if (pid_watch != 0)
+  {
+    close(pid_watch->fd());
+    delete pid_watch;
+  }
+
   delete timeout_timer;
 } /* Exec::~Exec */
 
@@ -241,9 +263,13 @@ void Exec::setTimeout(int time_s)
 
 bool Exec::run(void)
 {
-    // Create pipe file descriptor pair for handling stdin to subprocess
+    // Create pipe file descriptor pair for handling stdin to subprocess.
+    // All pipe file descriptors are created with the close-on-exec flag set
+    // so that they are not inherited by the subprocess. The ends used by the
+    // subprocess are duplicated to stdin, stdout and stderr which clear the
+    // flag on the duplicates.
   int in_filedes[2];
-  int ret = pipe(in_filedes);
+  int ret = pipe2(in_filedes, O_CLOEXEC);
   if (ret == -1)
   {
     cerr << "*** ERROR: Could not set up stdin pipe for subprocess "
@@ -253,108 +279,181 @@ bool Exec::run(void)
 
     // Create pipe file descriptor pair for handling stdout from subprocess
   int out_filedes[2];
-  ret = pipe(out_filedes);
+  ret = pipe2(out_filedes, O_CLOEXEC);
   if (ret == -1)
   {
     cerr << "*** ERROR: Could not set up stdout pipe for subprocess "
          << args[0] << ": " << strerror(errno) << endl;
+    close(in_filedes[0]);
+    close(in_filedes[1]);
     return false;
   }
 
     // Create pipe file descriptor pair for handling stderr from subprocess
   int err_filedes[2];
-  ret = pipe(err_filedes);
+  ret = pipe2(err_filedes, O_CLOEXEC);
   if (ret == -1)
   {
     cerr << "*** ERROR: Could not set up stderr pipe for subprocess "
          << args[0] << ": " << strerror(errno) << endl;
+    close(in_filedes[0]);
+    close(in_filedes[1]);
+    close(out_filedes[0]);
+    close(out_filedes[1]);
     return false;
   }
 
-  pid = fork();
-  if (pid == -1)
+    // Start the subprocess using posix_spawn. In contrast to fork, this does
+    // not copy the page tables of the parent process so the time it takes
+    // is independent of the memory size of the parent process.
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, in_filedes[0], STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, out_filedes[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, err_filedes[1], STDERR_FILENO);
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (size_t i=0; i<args.size(); ++i)
   {
-    cerr << "*** ERROR: The fork system call failed for subprocess "
-         << args[0] << ": " << strerror(errno) << endl;
-    return false;
+    argv.push_back(const_cast<char*>(args[i].c_str()));
   }
+  argv.push_back(0);
+  pid_t child_pid = -1;
+  int spawn_err = posix_spawn(&child_pid, argv[0], &actions, 0, &argv[0],
+                              environ);
+  posix_spawn_file_actions_destroy(&actions);
 
-    // If pid is non-zero we're in the parent process
-  if (pid != 0)
-  {
-      // Set up priority for child if specified
-    if (nice_value != 0)
-    {
-      nice(0);
-    }
-
-      // Add the new child to the global map
-    execs[pid] = this;
-
-      // Set up handling for subprocess stdin
-    close(in_filedes[0]);
-    stdin_fd = in_filedes[1];
+  close(in_filedes[0]);
+  close(out_filedes[1]);
+  closeStdinPipe();
 
-      // Set up handling for subprocess stdout
-    close(out_filedes[1]);
-    stdout_watch = new FdWatch(out_filedes[0], FdWatch::FD_WATCH_RD);
-    stdout_watch->activity.connect(mem_fun(*this, &Exec::stdoutActivity));
+    // Set up handling for subprocess stdout
+  if (stdout_watch != 0)
+  {
+    close(stdout_watch->fd());
+    delete stdout_watch;
+  }
+  stdout_watch = new FdWatch(out_filedes[0], FdWatch::FD_WATCH_RD);
+  stdout_watch->activity.connect(mem_fun(*this, &Exec::stdoutActivity));
 
-      // Set up handling for subprocess stderr
-    close(err_filedes[1]);
-    stderr_watch = new FdWatch(err_filedes[0], FdWatch::FD_WATCH_RD);
-    stderr_watch->activity.connect(mem_fun(*this, &Exec::stderrActivity));
+    // Set up handling for subprocess stderr
+  if (stderr_watch != 0)
+  {
+    close(stderr_watch->fd());
+    delete stderr_watch;
+  }
+  stderr_watch = new FdWatch(err_filedes[0], FdWatch::FD_WATCH_RD);
+  stderr_watch->activity.connect(mem_fun(*this, &Exec::stderrActivity));
 
-    if (timeout_timer != 0)
+  if (spawn_err != 0)
+  {
+      // Report the error in the same way as if the command could not be
+      // executed in the subprocess, through the stderr pipe and an exit
+      // code of 255 that is reported asynchronously.
+    ostringstream ss;
+    ss << "*** ERROR: Failed to exec " << args[0]
+       << ": " << strerror(spawn_err) << endl;
+    if (write(err_filedes[1], ss.str().c_str(), ss.str().size()) == -1)
     {
-      timeout_timer->setEnable(true);
+      cerr << ss.str();
     }
-
+    close(err_filedes[1]);
+    close(in_filedes[1]);
+    status = 255 << 8;
+    Application::app().runTask(mem_fun(*this, &Exec::subprocessExited));
     return true;
   }
+  close(err_filedes[1]);
+  pid = child_pid;
 
-  /* From this point we are in the child process */
-
-    // Set up stdin pipe
-  close(in_filedes[1]);
-  dup2(in_filedes[0], STDIN_FILENO);
-  close(in_filedes[0]);
+    // Set up priority for child if specified
+  if (nice_value != 0)
+  {
+    nice(0);
+  }
 
-    // Set up stdout pipe
-  close(out_filedes[0]);
-  dup2(out_filedes[1], STDOUT_FILENO);
-  close(out_filedes[1]);
+    // Set up notification for when the subprocess exits
+  if (pidfdSupported())
+  {
+    int pidfd = pidfdOpen(pid);
+    if (pidfd >= 0)
+    {
+      if (pid_watch != 0)
+      {
+        close(pid_watch->fd());
+        delete pid_watch;
+      }
+      pid_watch = new FdWatch(pidfd, FdWatch::FD_WATCH_RD);
+      pid_watch->activity.connect(mem_fun(*this, &Exec::pidfdActivity));
+    }
+    else
+    {
+      cerr << "*** WARNING: Could not open pidfd for subprocess " << args[0]
+           << ": " << strerror(errno) << ". Falling back to SIGCHLD." << endl;
+      setupSigChld();
+      execs[pid] = this;
+        // The subprocess may already have exited so poll it once
+      if (write(sigchld_pipe[1], "C", 1) == -1)
+      {
+        cerr << "*** ERROR: Could not write SIGCHLD notification to pipe\n";
+      }
+    }
+  }
+  else
+  {
+    execs[pid] = this;
+  }
 
-    // Set up stderr pipe
-  close(err_filedes[0]);
-  dup2(err_filedes[1], STDERR_FILENO);
-  close(err_filedes[1]);
+    // Set up handling for subprocess stdin. Writes are non-blocking and
+    // data that cannot be written directly is buffered.
+  stdin_fd = in_filedes[1];
+  fcntl(stdin_fd, F_SETFL, fcntl(stdin_fd, F_GETFL) | O_NONBLOCK);
+  delete stdin_watch;
+  stdin_watch = new FdWatch(stdin_fd, FdWatch::FD_WATCH_WR);
+  stdin_watch->setEnabled(false);
+  stdin_watch->activity.connect(mem_fun(*this, &Exec::stdinActivity));
 
-  char *cmd[args.size()+1];
-  for (size_t i=0; i<args.size(); ++i)
+  if (timeout_timer != 0)
   {
-    cmd[i] = strdup(args[i].c_str());
+    timeout_timer->setEnable(true);
   }
-  cmd[args.size()] = 0;
-  ret = execv(cmd[0], cmd);
-  assert (ret == -1);
 
-  cerr << "*** ERROR: Failed to exec " << args[0]
-       << ": " << strerror(errno) << endl;
-
-  exit(255);
+  return true;
 } /* Exec::run */
 
 
 bool Exec::writeStdin(const char *buf, int cnt)
 {
-  int ret = write(stdin_fd, buf, cnt);
-  if (ret < 0)
+  if (stdin_fd < 0)
   {
     cerr << "*** ERROR: Could not write to stdin pipe for subprocess "
-         << args[0] << ": " << strerror(errno) << endl;
+         << args[0] << ": The pipe is not open" << endl;
     return false;
   }
+
+  if (stdin_buf.empty())
+  {
+    int ret = write(stdin_fd, buf, cnt);
+    if (ret < 0)
+    {
+      if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+      {
+        cerr << "*** ERROR: Could not write to stdin pipe for subprocess "
+             << args[0] << ": " << strerror(errno) << endl;
+        return false;
+      }
+      ret = 0;
+    }
+    buf += ret;
+    cnt -= ret;
+  }
+
+  if (cnt > 0)
+  {
+    stdin_buf.append(buf, cnt);
+    stdin_watch->setEnabled(true);
+  }
+
   return true;
 } /* Exec::writeStdin */
 
@@ -388,7 +487,16 @@ bool Exec::kill(int sig)
 
 bool Exec::closeStdin(void)
 {
-  return (close(stdin_fd) == 0);
+  if (stdin_fd < 0)
+  {
+    return false;
+  }
+  if (!stdin_buf.empty())
+  {
+    stdin_close_pending = true;
+    return true;
+  }
+  return closeStdinPipe();
 } /* Exec::closeStdin */
 
 
@@ -473,6 +581,110 @@ void Exec::stderrActivity(Async::FdWatch *w)
 } /* Exec::stderrActivity */
 
 
+void Exec::stdinActivity(Async::FdWatch *w)
+{
+  int ret = write(stdin_fd, stdin_buf.data(), stdin_buf.size());
+  if (ret < 0)
+  {
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+    {
+      return;
+    }
+    cerr << "*** ERROR: Could not write to stdin pipe for subprocess "
+         << args[0] << ": " << strerror(errno) << endl;
+    stdin_buf.clear();
+  }
+  else
+  {
+    stdin_buf.erase(0, ret);
+  }
+
+  if (stdin_buf.empty())
+  {
+    w->setEnabled(false);
+    if (stdin_close_pending)
+    {
+      closeStdinPipe();
+    }
+  }
+} /* Exec::stdinActivity */
+
+
+bool Exec::closeStdinPipe(void)
+{
+    // The watch is only disabled since this function may be called from
+    // the watch activity handler. It is deleted on the next run or when this
+    // object is destroyed.
+  if (stdin_watch != 0)
+  {
+    stdin_watch->setEnabled(false);
+  }
+  stdin_buf.clear();
+  stdin_close_pending = false;
+  if (stdin_fd < 0)
+  {
+    return false;
+  }
+  int ret = close(stdin_fd);
+  stdin_fd = -1;
+  return (ret == 0);
+} /* Exec::closeStdinPipe */
+
+
+void Exec::pidfdActivity(Async::FdWatch *w)
+{
+  int status = 0;
+  pid_t ret = waitpid(pid, &status, WNOHANG);
+  if (ret == -1)
+  {
+    cerr << "*** ERROR: Could not poll status of process " << command()
+         << ": " << strerror(errno) << endl;
+  }
+  if (ret != 0)
+  {
+    w->setEnabled(false);
+    this->status = status;
+    subprocessExited();
+  }
+} /* Exec::pidfdActivity */
+
+
+void Exec::setupSigChld(void)
+{
+    // Set up SIGCHLD signal handling on first usage
+  if (sigchld_watch == 0)
+  {
+    int ret = pipe(sigchld_pipe);
+    if (ret == -1)
+    {
+      cerr << "*** ERROR: Could not set up SIGCHLD pipe for Async::Exec: "
+        << strerror(errno) << endl;
+      exit(1);
+    }
+    sigchld_watch = new FdWatch(sigchld_pipe[0], FdWatch::FD_WATCH_RD);
+    sigchld_watch->activity.connect(
+        sigc::hide(sigc::ptr_fun(Exec::sigchldReceived)));
+
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_sigaction = &handleSigChld;
+    act.sa_flags = SA_RESTART|SA_NOCLDSTOP|SA_SIGINFO;
+    if (sigaction(SIGCHLD, &act, &old_sigact) == -1)
+    {
+      cout << "*** ERROR: Could not set up SIGCHLD signal handler\n";
+      exit(1);
+    }
+    /*
+    cout << "### handler=" << old_sigact.sa_handler
+        //<< " mask=" << old_sigact.sa_mask
+      << " flags=" << old_sigact.sa_flags
+      << " sigaction=" << old_sigact.sa_sigaction
+      << endl;
+    */
+  }
+} /* Exec::setupSigChld */
+
+
 void Exec::handleSigChld(int signal_number, siginfo_t *info, void *context)
 {
     // Tell the SIGCHLD handler that we have received a signal
@@ -123,8 +123,14 @@ This class is used to execute external commands. It essentially wraps the
 exec system call together with commonly used infrastructure in a convenient
 class.
 
-This class depends on the SIGCHLD UNIX signal so it must not be used by
-another part of the application.
+The subprocess is started using posix_spawn so starting a subprocess does not
+take longer when the parent process use a lot of memory. On Linux 5.3 and
+later a pidfd is used to get notified when the subprocess exits. On older
+kernels this class depends on the SIGCHLD UNIX signal so it must not be used
+by another part of the application.
+
+Writes to stdin of the subprocess never block. Data that cannot be written
+directly is buffered and written when the subprocess is ready to receive it.
 
 \include AsyncExec_demo.cpp
 */
@@ -193,10 +199,10 @@ class Exec : public sigc::trackable
      *
      * This method is used to run the command specified using the constructor,
      * setCommandLine and appendArgument. This function will return success as
-     * long as the fork call succeeds. If the command cannot be run for some
-     * reason, this function will still return success. Errors that occurr
-     * after the fork call will be handled through the "exited" signal. If the
-     * command cannot run for some reason, the exit code will be 255.
+     * long as the pipes to the subprocess can be set up. If the command cannot
+     * be run for some reason, this function will still return success. The
+     * error will then be reported on stderr and through the "exited" signal
+     * with an exit code of 255.
      */
     bool run(void);
 
@@ -228,7 +234,9 @@ class Exec : public sigc::trackable
      *
      * This method is used to close the pipe from the parent process to the
      * subprocess. This will indicate to the subprocess that the parent
-     * process is done sending data to it.
+     * process is done sending data to it. If there is buffered data that
+     * have not yet been written, the pipe is closed when all data have been
+     * written.
      */
     bool closeStdin(void);
 
@@ -330,7 +338,12 @@ class Exec : public sigc::trackable
     int                       nice_value;
     Async::Timer              *timeout_timer;
     bool                      pending_term;
+    Async::FdWatch            *pid_watch;
+    Async::FdWatch            *stdin_watch;
+    std::string               stdin_buf;
+    bool                      stdin_close_pending;
 
+    static void setupSigChld(void);
     static void handleSigChld(int signal_number, siginfo_t *info,
                               void *context);
     static void sigchldReceived(void);
@@ -339,6 +352,9 @@ class Exec : public sigc::trackable
     Exec& operator=(const Exec&);
     void stdoutActivity(Async::FdWatch *w);
     void stderrActivity(Async::FdWatch *w);
+    void stdinActivity(Async::FdWatch *w);
+    bool closeStdinPipe(void);
+    void pidfdActivity(Async::FdWatch *w);
     void subprocessExited(void);
     void handleTimeout(void);
     
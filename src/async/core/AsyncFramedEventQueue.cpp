@@ -0,0 +1,361 @@
+/**
+@file   AsyncFramedEventQueue.cpp
+@brief  A queue for batching, filtering and framing of published events
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncFramedEventQueue.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+void appendBigEndian(std::string& buf, uint64_t val, size_t bytes)
+{
+  for (size_t i=bytes; i>0; --i)
+  {
+    buf.push_back(static_cast<char>((val >> (8 * (i - 1))) & 0xff));
+  }
+} /* appendBigEndian */
+
+
+}; /* End of anonymous namespace */
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+bool FramedEventQueue::parseFraming(const std::string& name, Framing& framing)
+{
+  if (name == "TEXT")
+  {
+    framing = FRAMING_TEXT;
+  }
+  else if (name == "BINARY")
+  {
+    framing = FRAMING_LENGTH_PREFIXED;
+  }
+  else if (name == "JSON")
+  {
+    framing = FRAMING_JSON_LINES;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+} /* FramedEventQueue::parseFraming */
+
+
+FramedEventQueue::Filter FramedEventQueue::parseFilter(const std::string& spec)
+{
+  Filter filter;
+  std::string::size_type pos = 0;
+  while (pos < spec.size())
+  {
+    pos = spec.find_first_not_of(", \t\r\n", pos);
+    if (pos == std::string::npos)
+    {
+      break;
+    }
+    std::string::size_type end = spec.find_first_of(", \t\r\n", pos);
+    if (end == std::string::npos)
+    {
+      end = spec.size();
+    }
+    filter.push_back(spec.substr(pos, end - pos));
+    pos = end;
+  }
+  return filter;
+} /* FramedEventQueue::parseFilter */
+
+
+bool FramedEventQueue::filterMatches(const Filter& filter,
+                                     const std::string& type)
+{
+  if (filter.empty())
+  {
+    return true;
+  }
+  for (const auto& prefix : filter)
+  {
+    if (type.compare(0, prefix.size(), prefix) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+} /* FramedEventQueue::filterMatches */
+
+
+FramedEventQueue::FramedEventQueue(void)
+  : m_flush_timer(0, Timer::TYPE_ONESHOT, false)
+{
+  m_flush_timer.expired.connect(sigc::hide(
+        sigc::mem_fun(*this, &FramedEventQueue::flush)));
+} /* FramedEventQueue::FramedEventQueue */
+
+
+FramedEventQueue::~FramedEventQueue(void)
+{
+} /* FramedEventQueue::~FramedEventQueue */
+
+
+void FramedEventQueue::queueEvent(const std::string& type,
+                                  const std::string& msg)
+{
+  Event event;
+  gettimeofday(&event.tv, NULL);
+  event.type = type;
+  event.msg = msg;
+
+  if (m_coalesce)
+  {
+    event.source = eventSource(msg);
+    auto it = std::find_if(m_events.begin(), m_events.end(),
+        [&](const Event& e)
+        {
+          return (e.type == type) && (e.source == event.source);
+        });
+    if (it != m_events.end())
+    {
+        // Keep the order of the events by queueing the new state last
+      m_events.erase(it);
+    }
+  }
+
+  m_events.push_back(std::move(event));
+  m_flush_timer.setEnable(true);
+} /* FramedEventQueue::queueEvent */
+
+
+size_t FramedEventQueue::encodeBatch(std::string& buf, Framing framing,
+                                     const Filter& filter) const
+{
+  size_t cnt = 0;
+  for (const auto& event : m_events)
+  {
+    if (filterMatches(filter, event.type))
+    {
+      encodeEvent(buf, framing, event);
+      ++cnt;
+    }
+  }
+  return cnt;
+} /* FramedEventQueue::encodeBatch */
+
+
+void FramedEventQueue::flush(void)
+{
+  m_flush_timer.setEnable(false);
+  if (m_events.empty())
+  {
+    return;
+  }
+  batchReady();
+  m_events.clear();
+} /* FramedEventQueue::flush */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void FramedEventQueue::encodeEvent(std::string& buf, Framing framing,
+                                   const Event& event)
+{
+  char timestamp[32];
+  snprintf(timestamp, sizeof(timestamp), "%ld.%03ld",
+           static_cast<long>(event.tv.tv_sec),
+           static_cast<long>(event.tv.tv_usec / 1000));
+
+  switch (framing)
+  {
+    case FRAMING_TEXT:
+      buf += timestamp;
+      buf += ' ';
+      buf += event.type;
+      buf += ' ';
+      buf += event.msg;
+      buf += '\n';
+      break;
+
+    case FRAMING_LENGTH_PREFIXED:
+    {
+      uint64_t ms = static_cast<uint64_t>(event.tv.tv_sec) * 1000 +
+                    event.tv.tv_usec / 1000;
+      size_t type_len = std::min(event.type.size(), size_t(0xffff));
+      appendBigEndian(buf, 8 + 2 + type_len + event.msg.size(), 4);
+      appendBigEndian(buf, ms, 8);
+      appendBigEndian(buf, type_len, 2);
+      buf.append(event.type, 0, type_len);
+      buf += event.msg;
+      break;
+    }
+
+    case FRAMING_JSON_LINES:
+      buf += "{\"time\":";
+      buf += timestamp;
+      buf += ",\"event\":";
+      appendJsonString(buf, event.type);
+      buf += ",\"msg\":";
+      appendJsonString(buf, event.msg);
+      buf += "}\n";
+      break;
+  }
+} /* FramedEventQueue::encodeEvent */
+
+
+void FramedEventQueue::appendJsonString(std::string& buf,
+                                        const std::string& str)
+{
+  buf += '"';
+  for (const char& ch : str)
+  {
+    switch (ch)
+    {
+      case '"':  buf += "\\\""; break;
+      case '\\': buf += "\\\\"; break;
+      case '\n': buf += "\\n";  break;
+      case '\r': buf += "\\r";  break;
+      case '\t': buf += "\\t";  break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20)
+        {
+          char esc[8];
+          snprintf(esc, sizeof(esc), "\\u%04x", static_cast<unsigned>(ch));
+          buf += esc;
+        }
+        else
+        {
+          buf += ch;
+        }
+        break;
+    }
+  }
+  buf += '"';
+} /* FramedEventQueue::appendJsonString */
+
+
+std::string FramedEventQueue::eventSource(const std::string& msg)
+{
+  if (!msg.empty() && (msg[0] == '{'))
+  {
+    static const std::string name_tag("\"name\":\"");
+    size_t pos = msg.find(name_tag);
+    if (pos != std::string::npos)
+    {
+      pos += name_tag.size();
+      return msg.substr(pos, msg.find('"', pos) - pos);
+    }
+    return "";
+  }
+  if (msg.empty() || (msg[0] == '['))
+  {
+    return "";
+  }
+  size_t pos = msg.find(' ');
+  return (pos != std::string::npos) ? msg.substr(0, pos) : "";
+} /* FramedEventQueue::eventSource */
+
+
+/*
+ * This file has not been truncated
+ */
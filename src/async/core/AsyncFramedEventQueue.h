@@ -0,0 +1,286 @@
+/**
+@file   AsyncFramedEventQueue.h
+@brief  A queue for batching, filtering and framing of published events
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This file contains a class that collect events published during one main loop
+iteration so that they can be written to consumers, like a PTY or a UNIX
+domain socket, in one go. The events can be framed in a couple of different
+formats and consumers may filter out only the events they are interested in.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_FRAMED_EVENT_QUEUE_INCLUDED
+#define ASYNC_FRAMED_EVENT_QUEUE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/time.h>
+#include <sigc++/sigc++.h>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Batch, filter and frame published events
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+Events, consisting of an event type and an event message, are queued using the
+queueEvent function. At the end of the current main loop iteration the
+batchReady signal is emitted. Handlers connected to that signal use the
+encodeBatch function to build one buffer containing all events matching a
+filter, framed in the requested format, so that the whole batch can be
+written using a single system call. After the signal has been emitted the
+queue is cleared.
+
+If coalescing is enabled, an event that is queued while an event of the same
+type from the same source is already waiting in the queue will remove the
+waiting event and be queued last. This is useful for state events where only
+the latest state is of interest. The source is the value of the "name" member
+for JSON object messages or the leading word of plain text messages, so that
+for example Rx:sql_state events from different receivers do not replace each
+other. Events where no source can be found, like JSON arrays holding the state
+of all sources, are coalesced on the event type alone.
+
+The following framing formats are available:
+
+- FRAMING_TEXT: One line per event, "<sec>.<msec> <type> <msg>\n". This is
+  the format that has always been used for the SvxLink state PTY.
+- FRAMING_LENGTH_PREFIXED: Binary framing. Each event start with a 32 bit
+  big endian length, counting the rest of the frame. It is followed by a 64
+  bit big endian timestamp in milliseconds, a 16 bit big endian length of the
+  type string, the type string and at last the event message.
+- FRAMING_JSON_LINES: One JSON object per line on the form
+  {"time":<sec>.<msec>,"event":"<type>","msg":"<msg>"}
+*/
+class FramedEventQueue : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The available framing formats
+     */
+    typedef enum
+    {
+      FRAMING_TEXT,             ///< Space separated text lines
+      FRAMING_LENGTH_PREFIXED,  ///< Binary length prefixed frames
+      FRAMING_JSON_LINES        ///< One JSON object per line
+    } Framing;
+
+    /**
+     * @brief   An event filter, a list of event type prefixes
+     *
+     * An empty filter match all events.
+     */
+    typedef std::vector<std::string> Filter;
+
+    /**
+     * @brief   Parse a framing format name
+     * @param   name The name of the format (TEXT, BINARY or JSON)
+     * @param   framing Set to the parsed framing format on success
+     * @return  Returns \em true on success or \em false if the name is unknown
+     */
+    static bool parseFraming(const std::string& name, Framing& framing);
+
+    /**
+     * @brief   Parse a filter specification
+     * @param   spec A comma or space separated list of event type prefixes
+     * @return  Returns the parsed filter
+     */
+    static Filter parseFilter(const std::string& spec);
+
+    /**
+     * @brief   Check if an event type match a filter
+     * @param   filter The filter to check
+     * @param   type The event type to check
+     * @return  Returns \em true if the event type should pass the filter
+     */
+    static bool filterMatches(const Filter& filter, const std::string& type);
+
+    /**
+     * @brief   Default constructor
+     */
+    FramedEventQueue(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    FramedEventQueue(const FramedEventQueue&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    FramedEventQueue& operator=(const FramedEventQueue&) = delete;
+
+    /**
+     * @brief   Destructor
+     */
+    ~FramedEventQueue(void);
+
+    /**
+     * @brief   Enable or disable coalescing of events of the same type
+     * @param   enable Set to \em true to enable coalescing
+     */
+    void setCoalesce(bool enable) { m_coalesce = enable; }
+
+    /**
+     * @brief   Check if coalescing is enabled
+     * @return  Returns \em true if coalescing of events is enabled
+     */
+    bool coalesce(void) const { return m_coalesce; }
+
+    /**
+     * @brief   Queue an event for publishing
+     * @param   type The event type, e.g. "Rx:sql_state"
+     * @param   msg The event message
+     */
+    void queueEvent(const std::string& type, const std::string& msg);
+
+    /**
+     * @brief   Encode all queued events matching the given filter
+     * @param   buf The buffer to append the encoded events to
+     * @param   framing The framing format to use
+     * @param   filter Only events matching this filter are encoded
+     * @return  Returns the number of encoded events
+     *
+     * This function should be called from a handler connected to the
+     * batchReady signal.
+     */
+    size_t encodeBatch(std::string& buf, Framing framing,
+                       const Filter& filter=Filter()) const;
+
+    /**
+     * @brief   Flush the queue immediately
+     *
+     * Emit the batchReady signal directly instead of waiting for the end of
+     * the main loop iteration.
+     */
+    void flush(void);
+
+    /**
+     * @brief   A signal that is emitted when a batch of events is ready
+     *
+     * The signal is emitted at the end of the main loop iteration in which
+     * the first event in the batch was queued.
+     */
+    sigc::signal<void> batchReady;
+
+  private:
+    struct Event
+    {
+      struct timeval  tv;
+      std::string     type;
+      std::string     source;
+      std::string     msg;
+    };
+    typedef std::vector<Event> EventList;
+
+    EventList   m_events;
+    Timer       m_flush_timer;
+    bool        m_coalesce = false;
+
+    static void encodeEvent(std::string& buf, Framing framing,
+                            const Event& event);
+    static void appendJsonString(std::string& buf, const std::string& str);
+    static std::string eventSource(const std::string& msg);
+
+};  /* class FramedEventQueue */
+
+
+} /* namespace Async */
+
+#endif /* ASYNC_FRAMED_EVENT_QUEUE_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
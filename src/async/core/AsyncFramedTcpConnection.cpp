@@ -114,7 +114,7 @@ using namespace Async;
 
 FramedTcpConnection::FramedTcpConnection(size_t recv_buf_len)
   : TcpConnection(recv_buf_len), m_max_frame_size(DEFAULT_MAX_FRAME_SIZE),
-    m_size_received(false)
+    m_size_received(false), m_txq_bytes(0), m_corked(false)
 {
   TcpConnection::sendBufferFull.connect(
       sigc::mem_fun(*this, &FramedTcpConnection::onSendBufferFull));
@@ -125,7 +125,8 @@ FramedTcpConnection::FramedTcpConnection(
     int sock, const IpAddress& remote_addr, uint16_t remote_port,
     size_t recv_buf_len)
   : TcpConnection(sock, remote_addr, remote_port, recv_buf_len),
-    m_max_frame_size(DEFAULT_MAX_FRAME_SIZE), m_size_received(false)
+    m_max_frame_size(DEFAULT_MAX_FRAME_SIZE), m_size_received(false),
+    m_txq_bytes(0), m_corked(false)
 {
   TcpConnection::sendBufferFull.connect(
       sigc::mem_fun(*this, &FramedTcpConnection::onSendBufferFull));
@@ -165,6 +166,15 @@ TcpConnection& FramedTcpConnection::operator=(TcpConnection&& other_base)
   m_txq.swap(other.m_txq);
   other.m_txq.clear();
 
+  m_txq_bytes = other.m_txq_bytes;
+  other.m_txq_bytes = 0;
+
+  m_corked = other.m_corked;
+  other.m_corked = false;
+
+  m_cork_buf.swap(other.m_cork_buf);
+  other.m_cork_buf.clear();
+
   return *this;
 } /* FramedTcpConnection::operator=(TcpConnection&&) */
 
@@ -182,39 +192,41 @@ int FramedTcpConnection::write(const void *buf, int count)
     return -1;
   }
 
-  QueueItem *qi = new QueueItem(buf, count);
-  if (m_txq.empty())
+  if (m_corked)
   {
-    int ret = TcpConnection::write(qi->m_buf, qi->m_size);
-    //cout << "###   count=" << (qi->m_size-qi->m_pos) << " ret=" << ret << endl;
-    if (ret < 0)
-    {
-      delete qi;
-      qi = 0;
-      return -1;
-    }
-    if (ret >= qi->m_size)
-    {
-      delete qi;
-      qi = 0;
-    }
-    else
-    {
-      //cout << "### Not all bytes were sent: count=" << count
-      //     << " ret=" << ret << endl;
-      qi->m_pos += ret;
-    }
+    const char header[4] = {
+      static_cast<char>(static_cast<uint32_t>(count) >> 24),
+      static_cast<char>((static_cast<uint32_t>(count) >> 16) & 0xff),
+      static_cast<char>((static_cast<uint32_t>(count) >> 8) & 0xff),
+      static_cast<char>(static_cast<uint32_t>(count) & 0xff)
+    };
+    m_cork_buf.append(header, sizeof(header));
+    m_cork_buf.append(reinterpret_cast<const char*>(buf), count);
+    return count;
   }
 
-  if (qi != 0)
+  if (sendQueueItem(new QueueItem(buf, count)) < 0)
   {
-    m_txq.push_back(qi);
+    return -1;
   }
 
   return count;
 } /* FramedTcpConnection::write */
 
 
+int FramedTcpConnection::uncork(void)
+{
+  m_corked = false;
+  if (m_cork_buf.empty())
+  {
+    return 0;
+  }
+  QueueItem *qi = new QueueItem(m_cork_buf);
+  m_cork_buf.clear();
+  return sendQueueItem(qi);
+} /* FramedTcpConnection::uncork */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -289,11 +301,39 @@ int FramedTcpConnection::onDataReceived(void *buf, int count)
  *
  ****************************************************************************/
 
+int FramedTcpConnection::sendQueueItem(QueueItem *qi)
+{
+  if (m_txq.empty())
+  {
+    int ret = TcpConnection::write(qi->m_buf, qi->m_size);
+    //cout << "###   count=" << (qi->m_size-qi->m_pos) << " ret=" << ret << endl;
+    if (ret < 0)
+    {
+      delete qi;
+      return -1;
+    }
+    if (ret >= qi->m_size)
+    {
+      delete qi;
+      return 0;
+    }
+    //cout << "### Not all bytes were sent: size=" << qi->m_size
+    //     << " ret=" << ret << endl;
+    qi->m_pos += ret;
+  }
+
+  m_txq.push_back(qi);
+  m_txq_bytes += qi->m_size - qi->m_pos;
+
+  return 0;
+} /* FramedTcpConnection::sendQueueItem */
+
+
 void FramedTcpConnection::onSendBufferFull(bool is_full)
 {
   //cout << "### FramedTcpConnection::onSendBufferFull: is_full="
   //     << is_full << "\n";
-  if (!is_full)
+  if (!is_full && !m_txq.empty())
   {
     while (!m_txq.empty())
     {
@@ -305,14 +345,16 @@ void FramedTcpConnection::onSendBufferFull(bool is_full)
         return;
       }
       qi->m_pos += ret;
+      m_txq_bytes -= ret;
       if (qi->m_pos < qi->m_size)
       {
-        break;
+        return;
       }
       m_txq.pop_front();
       delete qi;
       qi = 0;
     }
+    sendQueueEmpty(this);
   }
 } /* FramedTcpConnection::onSendBufferFull */
 
@@ -324,6 +366,9 @@ void FramedTcpConnection::disconnectCleanup(void)
     delete *it;
   }
   m_txq.clear();
+  m_txq_bytes = 0;
+  m_corked = false;
+  m_cork_buf.clear();
 } /* FramedTcpConnection::disconnectCleanup */
 
 
@@ -46,6 +46,7 @@ An example of how to use the FramedTcpConnection class in a server
 #include <stdint.h>
 #include <vector>
 #include <deque>
+#include <string>
 #include <cstring>
 
 
@@ -187,6 +188,40 @@ class FramedTcpConnection : public TcpConnection
      */
     virtual int write(const void *buf, int count) override;
 
+    /**
+     * @brief   Hold back written frames so that they can be sent in one go
+     *
+     * While the connection is corked, frames given to the write function are
+     * collected in a buffer instead of being handed over to the operating
+     * system one by one. Call the uncork function to send all collected
+     * frames using as few system calls as possible.
+     */
+    void cork(void) { m_corked = true; }
+
+    /**
+     * @brief   Send all frames collected while the connection was corked
+     * @return  Returns 0 on success or -1 on failure
+     */
+    int uncork(void);
+
+    /**
+     * @brief   Check if the connection is corked
+     * @return  Returns \em true if the connection is corked
+     */
+    bool isCorked(void) const { return m_corked; }
+
+    /**
+     * @brief   Get the number of bytes not yet handed to the OS
+     * @return  Returns the number of bytes waiting to be sent
+     *
+     * This function return the number of bytes, including frame headers,
+     * that have been written to the connection but that have not yet been
+     * accepted by the operating system. This include bytes collected while
+     * the connection is corked. It can be used to limit how much data that
+     * is written to a slow receiver.
+     */
+    size_t txQueueSize(void) const { return m_txq_bytes + m_cork_buf.size(); }
+
     /**
      * @brief 	A signal that is emitted when a connection has been terminated
      * @param 	con   	The connection object
@@ -205,6 +240,15 @@ class FramedTcpConnection : public TcpConnection
     sigc::signal<void, FramedTcpConnection *,
                  std::vector<uint8_t>&> frameReceived;
 
+    /**
+     * @brief   A signal that is emitted when the transmit queue is drained
+     * @param   con The connection object
+     *
+     * This signal is emitted when all data that had to be queued, due to the
+     * operating system send buffer being full, have been sent.
+     */
+    sigc::signal<void, FramedTcpConnection *> sendQueueEmpty;
+
   protected:
     sigc::signal<int, TcpConnection*, void*, int> dataReceived;
     sigc::signal<void, bool> sendBufferFull;
@@ -272,6 +316,12 @@ class FramedTcpConnection : public TcpConnection
         *ptr++ = (static_cast<uint32_t>(count)) & 0xff;
         std::memcpy(ptr, buf, count);
       }
+      explicit QueueItem(const std::string& frames)
+        : m_buf(0), m_size(frames.size()), m_pos(0)
+      {
+        m_buf = new char[m_size];
+        std::memcpy(m_buf, frames.data(), m_size);
+      }
       ~QueueItem(void) { delete [] m_buf; }
     };
     typedef std::deque<QueueItem*> TxQueue;
@@ -281,9 +331,13 @@ class FramedTcpConnection : public TcpConnection
     uint32_t              m_frame_size;
     std::vector<uint8_t>  m_frame;
     TxQueue               m_txq;
+    size_t                m_txq_bytes;
+    bool                  m_corked;
+    std::string           m_cork_buf;
 
     FramedTcpConnection(const FramedTcpConnection&);
     FramedTcpConnection& operator=(const FramedTcpConnection&);
+    int sendQueueItem(QueueItem *qi);
     void onSendBufferFull(bool is_full);
     void disconnectCleanup(void);
 
@@ -127,6 +127,7 @@ Pty::Pty(const std::string &slave_link)
   pollhup_timer.setEnable(false);
   pollhup_timer.expired.connect(
       sigc::hide(mem_fun(*this, &Pty::checkIfSlaveEndOpen)));
+  m_event_queue.batchReady.connect(mem_fun(*this, &Pty::writeEventBatch));
 } /* Pty::Pty */
 
 
@@ -381,6 +382,24 @@ void Pty::checkIfSlaveEndOpen(void)
 } /* Pty::checkIfSlaveEndOpen */
 
 
+/**
+ * @brief Write all events queued during the last main loop iteration
+ */
+void Pty::writeEventBatch(void)
+{
+  if (!isOpen())
+  {
+    return;
+  }
+  m_event_buf.clear();
+  if (m_event_queue.encodeBatch(m_event_buf, m_event_framing,
+                                m_event_filter) > 0)
+  {
+    write(m_event_buf.data(), m_event_buf.size());
+  }
+} /* Pty::writeEventBatch */
+
+
 
 /*
  * This file has not been truncated
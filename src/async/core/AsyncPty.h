@@ -47,6 +47,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncFramedEventQueue.h>
 
 
 /****************************************************************************
@@ -120,6 +121,12 @@ continuously polled to detect when it is opened.  When the slave end of the PTY
 is open, an FdWatch will be used to check for activity instead of polling.
 
 Data written to the master end will be discarded if the slave end is not open.
+
+Besides writing raw data, typed events can be written using the writeEvent
+function. Events written during one main loop iteration are coalesced into a
+single write at the end of the iteration, framed in the format selected using
+setEventFraming. An event filter can be set up so that only events of
+interest to the reader is written to the PTY.
 */
 class Pty : public sigc::trackable
 {
@@ -180,6 +187,46 @@ class Pty : public sigc::trackable
      */
     ssize_t write(const void *buf, size_t count);
 
+    /**
+     * @brief   Set the framing format used for events
+     * @param   framing The framing format to use
+     *
+     * The framing only apply to data written using the writeEvent function.
+     * The default is FramedEventQueue::FRAMING_TEXT.
+     */
+    void setEventFraming(FramedEventQueue::Framing framing)
+    {
+      m_event_framing = framing;
+    }
+
+    /**
+     * @brief   Set a filter deciding which events to write to the PTY
+     * @param   filter A list of event type prefixes, empty to write all
+     */
+    void setEventFilter(const FramedEventQueue::Filter& filter)
+    {
+      m_event_filter = filter;
+    }
+
+    /**
+     * @brief   Only write the latest event of each type per loop iteration
+     * @param   enable Set to \em true to enable coalescing
+     */
+    void setCoalesceEvents(bool enable) { m_event_queue.setCoalesce(enable); }
+
+    /**
+     * @brief   Write an event to the PTY
+     * @param   type The event type
+     * @param   msg The event message
+     *
+     * The event is queued and written, together with all other events
+     * written in the same main loop iteration, at the end of the iteration.
+     */
+    void writeEvent(const std::string& type, const std::string& msg)
+    {
+      m_event_queue.queueEvent(type, msg);
+    }
+
     /**
      * @brief   Check if the PTY is open or not
      * @return  Returns \em true if the PTY has been successfully opened
@@ -204,6 +251,11 @@ class Pty : public sigc::trackable
     Async::Timer    pollhup_timer;
     bool            m_is_line_buffered = false;
     std::string     m_line_buffer;
+    FramedEventQueue            m_event_queue;
+    FramedEventQueue::Framing   m_event_framing =
+                                  FramedEventQueue::FRAMING_TEXT;
+    FramedEventQueue::Filter    m_event_filter;
+    std::string                 m_event_buf;
 
     Pty(const Pty&);
     Pty& operator=(const Pty&);
@@ -211,6 +263,7 @@ class Pty : public sigc::trackable
     void charactersReceived(void);
     short pollMaster(void);
     void checkIfSlaveEndOpen(void);
+    void writeEventBatch(void);
 
 };  /* class Pty */
 
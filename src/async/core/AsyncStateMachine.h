@@ -1,6 +1,6 @@
 /**
 @file   AsyncStateMachine.h
-@brief  A_brief_description_for_this_file
+@brief  A hierarchial state machine without heap allocations or RTTI
 @author Tobias Blomberg / SM0SVX
 @date   2022-03-19
 
@@ -38,8 +38,11 @@ An example of how to use the StateMachine class
  *
  ****************************************************************************/
 
-#include <typeinfo>
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 
 /****************************************************************************
@@ -93,6 +96,11 @@ template <class ContextT, class TopStateT> class StateTopBase;
  *
  ****************************************************************************/
 
+/**
+ * @brief   A type used to uniquely identify a state class
+ */
+typedef const void* StateIdT;
+
 
 
 /****************************************************************************
@@ -109,6 +117,23 @@ template <class ContextT, class TopStateT> class StateTopBase;
  *
  ****************************************************************************/
 
+/**
+@brief  Provide a unique identity for a state class
+@param  T The state class
+
+The address of the static member is used as a cheap identity for the state
+class so that no RTTI is needed to compare states.
+*/
+template <class T>
+struct StateId
+{
+  static char id;
+  static StateIdT get(void) { return &id; }
+}; /* StateId */
+
+template <class T> char StateId<T>::id = 0;
+
+
 /**
 @brief  Implements a hierarchial state machine
 @author Tobias Blomberg / SM0SVX
@@ -148,6 +173,15 @@ A class that implements a Hierarchial Finite State Machine.
 The NAME constant is only needed for state transition debugging. To enable
 debugging, define ASYNC_STATE_MACHINE_DEBUG before including this file.
 
+State objects are constructed in place in a small number of fixed size slots
+inside the state machine object so no memory is allocated on state
+transitions. State objects are created on each transition so they should not
+store any data of their own. Data that need to survive a transition belong in
+the context object. The size of a state object is checked at compile time.
+A std::variant is not used to hold the states since it require C++17, which
+the build does not select, and since each state machine would then have to
+list all of its states.
+
 Full example below.
 
 \include AsyncStateMachine_demo.cpp
@@ -156,6 +190,19 @@ template <class ContextT, class StateTopT>
 class StateMachine
 {
   public:
+    /**
+     * @brief   The maximum size of a state object
+     */
+    static constexpr size_t STATE_SLOT_SIZE = 64;
+
+    /**
+     * @brief   The maximum number of state objects alive at the same time
+     *
+     * During a transition the old state, the target state and the substates
+     * selected by nested init functions are all alive at the same time.
+     */
+    static constexpr unsigned STATE_SLOT_COUNT = 6;
+
     /**
      * @brief   A type alias simplifying access to the top state base type
      */
@@ -198,8 +245,11 @@ class StateMachine
      */
     ~StateMachine(void)
     {
-      delete m_state;
-      m_state = nullptr;
+      if (m_state != nullptr)
+      {
+        freeState(m_state);
+        m_state = nullptr;
+      }
     }
 
     /**
@@ -225,32 +275,38 @@ class StateMachine
 
     /**
      * @brief   Switch to the given state
-     * @param   A state object to switch to
+     * @param   args Arguments to pass on to the init function of the state
      *
      * Use this function to switch to the given state. The state to switch to
-     * is best given as a template argument to the function. E.g.
+     * is given as a template argument to the function. E.g.
      *
      *   setState<NextState>();
      *
+     * Any arguments given are passed on to the init function of the new
+     * state, which then must take matching arguments. E.g.
+     *
+     *   setState<NextState>(42);
+     *
      * NOTE: The state machine implementation cannot handle state switching
      * loops right now. It's ok to set the same state as the current one since
      * it will just be ignored. Switching to the current state via other
      * states init functions, will cause an infinite loop.
      */
-    template <class NewStateT>
-    void setState(NewStateT* state=new NewStateT)
+    template <class NewStateT, typename... Args>
+    void setState(Args&&... args)
     {
-      state->setMachine(this);
       StateTopT* old_state = m_state;
-      if ((old_state != nullptr) && (typeid(NewStateT) == old_state->typeId()))
+      if ((old_state != nullptr) &&
+          (old_state->stateId() == StateId<NewStateT>::get()))
       {
-        delete state;
         return;
       }
-      static_cast<StateTopBaseT*>(state)->initHandler();
+      NewStateT* state = allocState<NewStateT>();
+      state->setMachine(this);
+      state->init(std::forward<Args>(args)...);
       if (old_state != m_state)
       {
-        delete state;
+        freeState(state);
         return;
       }
 #ifdef ASYNC_STATE_MACHINE_DEBUG
@@ -264,7 +320,10 @@ class StateMachine
       }
       m_state = state;
       static_cast<StateTopBaseT*>(m_state)->entryHandler(old_state);
-      delete old_state;
+      if (old_state != nullptr)
+      {
+        freeState(old_state);
+      }
     }
 
     /**
@@ -280,7 +339,7 @@ class StateMachine
     template <class T>
     bool isActive(void) const
     {
-      return typeid(T) == m_state->typeId();
+      return StateId<T>::get() == m_state->stateId();
     }
 
     /**
@@ -349,10 +408,50 @@ class StateMachine
     }
 
   private:
+    typedef typename std::aligned_storage<
+        STATE_SLOT_SIZE, alignof(std::max_align_t)>::type StateSlot;
+
     StateTopT*  m_state     = nullptr;
     ContextT*   m_ctx       = nullptr;
     Timer       m_timer     = -1;
     AtTimer     m_at_timer;
+    StateSlot   m_slots[STATE_SLOT_COUNT];
+    StateTopT*  m_slot_state[STATE_SLOT_COUNT] = {};
+
+    template <class T>
+    T* allocState(void)
+    {
+      static_assert(sizeof(T) <= STATE_SLOT_SIZE,
+          "Async::StateMachine: State object too big. "
+          "Move state data to the context object.");
+      static_assert(alignof(T) <= alignof(std::max_align_t),
+          "Async::StateMachine: Unsupported state object alignment");
+      for (unsigned i=0; i<STATE_SLOT_COUNT; ++i)
+      {
+        if (m_slot_state[i] == nullptr)
+        {
+          T* state = new (&m_slots[i]) T;
+          m_slot_state[i] = state;
+          return state;
+        }
+      }
+      assert(!"Async::StateMachine: Too deeply nested state transitions");
+      return nullptr;
+    }
+
+    void freeState(StateTopT* state)
+    {
+      for (unsigned i=0; i<STATE_SLOT_COUNT; ++i)
+      {
+        if (m_slot_state[i] == state)
+        {
+          state->~StateTopT();
+          m_slot_state[i] = nullptr;
+          return;
+        }
+      }
+      assert(!"Async::StateMachine: Freeing unknown state object");
+    }
 }; /* StateMachine */
 
 
@@ -382,35 +481,37 @@ class StateBase : public ParentT
 {
   public:
     /**
-     * @brief   Get the typeid for this state
-     * @return  Returns the typeid for this state
+     * @brief   Get the identity of this state
+     * @return  Returns the identity of this state
      */
-    virtual const std::type_info& typeId(void) const override
+    virtual StateIdT stateId(void) const override
     {
-      return typeid(T);
+      return StateId<T>::get();
     }
 
-    virtual const char* name(void) const { return T::NAME; }
-
-  protected:
     /**
-     * @brief   Handle calling the init function on state transitions
+     * @brief   Check if this state is the given state or one of its substates
+     * @param   id The identity of the state to check
+     * @return  Returns \em true if this state is or is below the given state
      */
-    virtual void initHandler(void) override
+    virtual bool isA(StateIdT id) const override
     {
-      dynamic_cast<T*>(this)->init();
+      return (id == StateId<T>::get()) || ParentT::isA(id);
     }
 
+    virtual const char* name(void) const { return T::NAME; }
+
+  protected:
     /**
      * @brief   Handle calling the entry function on state transitions
      * @param   from The state that we transition from
      */
     virtual void entryHandler(typename ParentT::StateT* from) override
     {
-      if (dynamic_cast<T*>(from) == nullptr)
+      if ((from == nullptr) || !from->isA(StateId<T>::get()))
       {
         ParentT::entryHandler(from);
-        dynamic_cast<T*>(this)->entry();
+        static_cast<T*>(this)->entry();
       }
     }
 
@@ -420,9 +521,9 @@ class StateBase : public ParentT
      */
     virtual void exitHandler(typename ParentT::StateT* to) override
     {
-      if (dynamic_cast<T*>(to) == nullptr)
+      if ((to == nullptr) || !to->isA(StateId<T>::get()))
       {
-        dynamic_cast<T*>(this)->exit();
+        static_cast<T*>(this)->exit();
         ParentT::exitHandler(to);
       }
     }
@@ -436,6 +537,8 @@ class StateBase : public ParentT
      * state is activated.
      *
      * The init function will only be called in the specific target state.
+     * A state may declare an init function taking arguments. The arguments
+     * are then given in the call to setState.
      */
     void init(void) {}
 
@@ -486,6 +589,7 @@ class StateBase : public ParentT
       assert(!"Async::StateBase: Unhandled timeoutAtEvent");
     }
 
+    template <class, class> friend class StateMachine;
 }; /* StateBase */
 
 
@@ -539,14 +643,28 @@ class StateTopBase
      */
     ContextT& ctx(void) { return m_sm->ctx(); }
 
+    /**
+     * @brief   Get the identity of this state
+     */
+    virtual StateIdT stateId(void) const = 0;
+
+    /**
+     * @brief   Check if this state is the given state or one of its substates
+     * @param   id The identity of the state to check
+     */
+    virtual bool isA(StateIdT id) const { return false; }
+
   protected:
     /**
      * @brief   Transition to the given state
      *
      * See \ref Async::StateMachine::setState.
      */
-    template <class NewStateT>
-    void setState(void) { m_sm->setState(new NewStateT); }
+    template <class NewStateT, typename... Args>
+    void setState(Args&&... args)
+    {
+      m_sm->template setState<NewStateT>(std::forward<Args>(args)...);
+    }
 
     /**
      * @brief   Set a timeout after which the timeoutEvent is issued
@@ -588,15 +706,6 @@ class StateTopBase
      */
     void clearTimeoutAt(void) { m_sm->clearTimeoutAt(); }
 
-    /**
-     * @brief   Get the typeid for this state
-     */
-    virtual const std::type_info& typeId(void) const = 0;
-
-    /**
-     * @brief   Run the init functon in a state
-     */
-    virtual void initHandler(void) = 0;
 
     /**
      * @brief   Run all entry handlers in the state hierarchy, top to bottom
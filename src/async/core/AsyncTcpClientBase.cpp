@@ -126,7 +126,7 @@ using namespace Async;
 
 
 TcpClientBase::TcpClientBase(TcpConnection *con)
-  : con(con), sock(-1)
+  : con(con), sock(-1), sock_rcvbuf_size(0)
 {
   wr_watch.activity.connect(mem_fun(*this, &TcpClientBase::connectHandler));
   dns.resultsReady.connect(mem_fun(*this, &TcpClientBase::dnsResultsReady));
@@ -135,7 +135,7 @@ TcpClientBase::TcpClientBase(TcpConnection *con)
 
 TcpClientBase::TcpClientBase(TcpConnection *con, const string& remote_host,
                              uint16_t remote_port)
-  : con(con), sock(-1)
+  : con(con), sock(-1), sock_rcvbuf_size(0)
 {
   IpAddress ip_addr(remote_host);
   if (!ip_addr.isEmpty())
@@ -154,7 +154,7 @@ TcpClientBase::TcpClientBase(TcpConnection *con, const string& remote_host,
 
 TcpClientBase::TcpClientBase(TcpConnection *con, const IpAddress& remote_ip,
                              uint16_t remote_port)
-  : con(con), sock(-1)
+  : con(con), sock(-1), sock_rcvbuf_size(0)
 {
   con->setRemoteAddr(remote_ip);
   con->setRemotePort(remote_port);
@@ -184,6 +184,9 @@ TcpClientBase& TcpClientBase::operator=(TcpClientBase&& other)
   bind_ip = other.bind_ip;
   other.bind_ip.clear();
 
+  sock_rcvbuf_size = other.sock_rcvbuf_size;
+  other.sock_rcvbuf_size = 0;
+
   return *this;
 } /* TcpClientBase::operator= */
 
@@ -314,6 +317,18 @@ void TcpClientBase::connectToRemote(void)
     return;
   }
 
+    /* The receive buffer size must be set before connecting */
+  if ((sock_rcvbuf_size > 0) &&
+      (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &sock_rcvbuf_size,
+                  sizeof(sock_rcvbuf_size)) == -1))
+  {
+    int errno_tmp = errno;
+    closeConnection();
+    errno = errno_tmp;
+    con->onDisconnected(TcpConnection::DR_SYSTEM_ERROR);
+    return;
+  }
+
   if (!bind_ip.isEmpty())
   {
     struct sockaddr_in addr = { 0 };
@@ -200,6 +200,16 @@ class TcpClientBase : virtual public sigc::trackable
      */
     const IpAddress& bindIp(void) const { return bind_ip; }
 
+    /**
+     * @brief   Set the size of the kernel socket receive buffer
+     * @param   size The size in bytes, 0 to use the system default
+     *
+     * The size is applied to the socket before connecting, which is needed
+     * for the TCP window scaling to allow a large receive window. It will
+     * take effect on the next connection attempt.
+     */
+    void setSocketRecvBufSize(int size) { sock_rcvbuf_size = size; }
+
     /**
      * @brief 	Connect to the remote host
      * @param 	remote_host   The hostname of the remote host
@@ -294,6 +304,7 @@ class TcpClientBase : virtual public sigc::trackable
     int       	      sock;
     FdWatch           wr_watch;
     Async::IpAddress  bind_ip;
+    int               sock_rcvbuf_size;
 
     void dnsResultsReady(DnsLookup& dns_lookup);
     void connectToRemote(void);
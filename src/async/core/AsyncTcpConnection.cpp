@@ -35,6 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <assert.h>
@@ -241,6 +243,19 @@ void TcpConnection::setRecvBufLen(size_t recv_buf_len)
 } /* TcpConnection::setRecvBufLen */
 
 
+bool TcpConnection::setNoDelay(bool enable)
+{
+  if (sock == -1)
+  {
+    errno = ENOTCONN;
+    return false;
+  }
+  int flag = enable ? 1 : 0;
+  return setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &flag,
+                    sizeof(flag)) == 0;
+} /* TcpConnection::setNoDelay */
+
+
 int TcpConnection::write(const void *buf, int count)
 {
   assert(sock >= 0);
@@ -192,6 +192,19 @@ class TcpConnection : virtual public sigc::trackable
      */
     void setRecvBufLen(size_t recv_buf_len);
 
+    /**
+     * @brief   Enable or disable the Nagle algorithm on the connection
+     * @param   enable Set to \em true to disable the Nagle algorithm
+     * @return  Returns \em true on success or else \em false
+     *
+     * Setting TCP_NODELAY will make the operating system send small writes
+     * immediately instead of waiting for more data to coalesce. This is
+     * suitable for latency sensitive message based protocols that already
+     * batch their writes. The connection must be established for this
+     * function to succeed.
+     */
+    bool setNoDelay(bool enable);
+
     /**
      * @brief 	Disconnect from the remote host
      *
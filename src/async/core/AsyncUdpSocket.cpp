@@ -153,7 +153,8 @@ class UdpPacket
  * Bugs:      
  *------------------------------------------------------------------------
  */
-UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip)
+UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip,
+                     bool reuse_port)
   : sock(-1), rd_watch(0), wr_watch(0), send_buf(0)
 {
   struct sockaddr_in addr;
@@ -175,6 +176,25 @@ UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip)
     return;
   }
   
+    // Let other sockets bind to the same address and port if requested
+  if (reuse_port)
+  {
+#ifdef SO_REUSEPORT
+    int on = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == -1)
+    {
+      perror("setsockopt(sock, SO_REUSEPORT)");
+      cleanup();
+      return;
+    }
+#else
+    errno = ENOTSUP;
+    perror("SO_REUSEPORT");
+    cleanup();
+    return;
+#endif
+  }
+
     // Bind the socket to a local port if one was specified
   if (local_port > 0)
   {
@@ -130,8 +130,14 @@ class UdpSocket : public sigc::trackable
      *	      	      	    local port will be used.
      * @param  	bind_ip     Bind to the interface with the given IP address.
      *	      	            If left empty, bind to all interfaces.
+     * @param   reuse_port  Set to \em true to allow more sockets to bind to
+     *                      the same address and port (SO_REUSEPORT)
+     *
+     * When reuse_port is set, the operating system will distribute incoming
+     * datagrams between all sockets bound to the same address and port.
      */
-    UdpSocket(uint16_t local_port=0, const IpAddress &bind_ip=IpAddress());
+    UdpSocket(uint16_t local_port=0, const IpAddress &bind_ip=IpAddress(),
+              bool reuse_port=false);
   
     /**
      * @brief 	Destructor
@@ -0,0 +1,393 @@
+/**
+@file   AsyncUnixEventServer.cpp
+@brief  Publish events to multiple readers through a UNIX domain socket
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncUnixEventServer.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+bool setNonBlocking(int fd)
+{
+  int flags = fcntl(fd, F_GETFL, 0);
+  return (flags != -1) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1);
+} /* setNonBlocking */
+
+
+}; /* End of anonymous namespace */
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+UnixEventServer::UnixEventServer(const std::string& path)
+  : m_path(path)
+{
+  m_event_queue.batchReady.connect(
+      sigc::mem_fun(*this, &UnixEventServer::writeEventBatch));
+} /* UnixEventServer::UnixEventServer */
+
+
+UnixEventServer::~UnixEventServer(void)
+{
+  close();
+} /* UnixEventServer::~UnixEventServer */
+
+
+bool UnixEventServer::open(void)
+{
+  close();
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (m_path.empty() || (m_path.size() >= sizeof(addr.sun_path)))
+  {
+    cerr << "*** ERROR: Illegal UNIX socket path \"" << m_path << "\"" << endl;
+    return false;
+  }
+  strncpy(addr.sun_path, m_path.c_str(), sizeof(addr.sun_path) - 1);
+
+  m_sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_sock < 0)
+  {
+    cerr << "*** ERROR: Could not create UNIX socket: "
+         << strerror(errno) << endl;
+    return false;
+  }
+
+  unlink(m_path.c_str());
+  if ((bind(m_sock, reinterpret_cast<struct sockaddr*>(&addr),
+            sizeof(addr)) == -1) ||
+      (listen(m_sock, 8) == -1) ||
+      !setNonBlocking(m_sock))
+  {
+    cerr << "*** ERROR: Could not set up UNIX socket " << m_path << ": "
+         << strerror(errno) << endl;
+    close();
+    return false;
+  }
+
+  m_accept_watch = new FdWatch(m_sock, FdWatch::FD_WATCH_RD);
+  m_accept_watch->activity.connect(
+      sigc::mem_fun(*this, &UnixEventServer::acceptConnection));
+
+  return true;
+} /* UnixEventServer::open */
+
+
+void UnixEventServer::close(void)
+{
+  while (!m_clients.empty())
+  {
+    deleteClient(m_clients.front().get());
+    m_clients.pop_front();
+  }
+  delete m_accept_watch;
+  m_accept_watch = nullptr;
+  if (m_sock >= 0)
+  {
+    ::close(m_sock);
+    m_sock = -1;
+    unlink(m_path.c_str());
+  }
+} /* UnixEventServer::close */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void UnixEventServer::acceptConnection(FdWatch*)
+{
+  int fd = accept(m_sock, NULL, NULL);
+  if (fd < 0)
+  {
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+    {
+      cerr << "*** WARNING: Failed to accept connection on UNIX socket "
+           << m_path << ": " << strerror(errno) << endl;
+    }
+    return;
+  }
+  if (!setNonBlocking(fd))
+  {
+    ::close(fd);
+    return;
+  }
+
+  std::unique_ptr<Client> client(new Client);
+  client->fd = fd;
+  client->framing = m_default_framing;
+  client->filter = m_default_filter;
+  client->rd_watch = new FdWatch(fd, FdWatch::FD_WATCH_RD);
+  client->rd_watch->activity.connect(sigc::bind(
+      sigc::mem_fun(*this, &UnixEventServer::clientDataReceived),
+      client.get()));
+  client->wr_watch = new FdWatch(fd, FdWatch::FD_WATCH_WR);
+  client->wr_watch->setEnabled(false);
+  client->wr_watch->activity.connect(sigc::bind(
+      sigc::mem_fun(*this, &UnixEventServer::clientWritable),
+      client.get()));
+  m_clients.push_back(std::move(client));
+} /* UnixEventServer::acceptConnection */
+
+
+void UnixEventServer::clientDataReceived(FdWatch*, Client* client)
+{
+  char buf[256];
+  ssize_t rd = read(client->fd, buf, sizeof(buf));
+  if (rd <= 0)
+  {
+    if ((rd < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+    {
+      return;
+    }
+    removeClient(client);
+    return;
+  }
+
+  client->rx_buf.append(buf, rd);
+  std::string::size_type eol;
+  while ((eol = client->rx_buf.find_first_of("\r\n")) != std::string::npos)
+  {
+    std::string cmd(client->rx_buf, 0, eol);
+    client->rx_buf.erase(0, eol + 1);
+    if (!cmd.empty())
+    {
+      handleCommand(client, cmd);
+    }
+  }
+  if (client->rx_buf.size() > 1024)
+  {
+    client->rx_buf.clear();
+  }
+} /* UnixEventServer::clientDataReceived */
+
+
+void UnixEventServer::clientWritable(FdWatch*, Client* client)
+{
+  ssize_t ret = send(client->fd, client->tx_buf.data(), client->tx_buf.size(),
+                     MSG_NOSIGNAL);
+  if (ret < 0)
+  {
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+    {
+      removeClient(client);
+    }
+    return;
+  }
+  client->tx_buf.erase(0, ret);
+  client->wr_watch->setEnabled(!client->tx_buf.empty());
+} /* UnixEventServer::clientWritable */
+
+
+void UnixEventServer::handleCommand(Client* client, const std::string& cmd)
+{
+  std::istringstream is(cmd);
+  std::string verb;
+  is >> verb;
+  std::string args;
+  std::getline(is, args);
+  if (verb == "SUBSCRIBE")
+  {
+    client->filter = FramedEventQueue::parseFilter(args);
+  }
+  else if (verb == "FRAMING")
+  {
+    std::string name;
+    std::istringstream(args) >> name;
+    FramedEventQueue::parseFraming(name, client->framing);
+  }
+} /* UnixEventServer::handleCommand */
+
+
+bool UnixEventServer::sendToClient(Client* client, const char* buf,
+                                   size_t len)
+{
+  if (client->tx_buf.empty())
+  {
+    ssize_t ret = send(client->fd, buf, len, MSG_NOSIGNAL);
+    if (ret < 0)
+    {
+      if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+      {
+        return false;
+      }
+      ret = 0;
+    }
+    buf += ret;
+    len -= ret;
+  }
+  if (len > 0)
+  {
+    if (client->tx_buf.size() + len > MAX_PENDING_BYTES)
+    {
+      cerr << "*** WARNING: Reader on UNIX socket " << m_path
+           << " is too slow. Disconnecting it." << endl;
+      return false;
+    }
+    client->tx_buf.append(buf, len);
+    client->wr_watch->setEnabled(true);
+  }
+  return true;
+} /* UnixEventServer::sendToClient */
+
+
+void UnixEventServer::writeEventBatch(void)
+{
+  std::vector<Client*> failed;
+  for (auto& client : m_clients)
+  {
+    m_event_buf.clear();
+    if ((m_event_queue.encodeBatch(m_event_buf, client->framing,
+                                   client->filter) > 0) &&
+        !sendToClient(client.get(), m_event_buf.data(), m_event_buf.size()))
+    {
+      failed.push_back(client.get());
+    }
+  }
+  for (auto client : failed)
+  {
+    removeClient(client);
+  }
+} /* UnixEventServer::writeEventBatch */
+
+
+void UnixEventServer::removeClient(Client* client)
+{
+  for (auto it=m_clients.begin(); it!=m_clients.end(); ++it)
+  {
+    if (it->get() == client)
+    {
+      deleteClient(client);
+      m_clients.erase(it);
+      return;
+    }
+  }
+} /* UnixEventServer::removeClient */
+
+
+void UnixEventServer::deleteClient(Client* client)
+{
+  delete client->rd_watch;
+  client->rd_watch = nullptr;
+  delete client->wr_watch;
+  client->wr_watch = nullptr;
+  ::close(client->fd);
+  client->fd = -1;
+} /* UnixEventServer::deleteClient */
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,263 @@
+/**
+@file   AsyncUnixEventServer.h
+@brief  Publish events to multiple readers through a UNIX domain socket
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_UNIX_EVENT_SERVER_INCLUDED
+#define ASYNC_UNIX_EVENT_SERVER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+#include <list>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFramedEventQueue.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class FdWatch;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Publish events to multiple readers through a UNIX domain socket
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class work like the event part of the Async::Pty class but instead of
+writing to a PTY, which only one reader can use at a time, events are
+published on a UNIX domain stream socket that any number of readers can
+connect to. Events written during one main loop iteration are written to each
+reader using a single system call.
+
+Each connected reader can control what it receives by sending commands, one
+per line, to the socket:
+
+- SUBSCRIBE [prefix ...]: Only receive events which type start with one of
+  the given prefixes. With no prefixes, all events are received.
+- FRAMING TEXT|BINARY|JSON: Select the framing format for this reader.
+
+Readers that are not able to keep up will have their data queued up to
+MAX_PENDING_BYTES. If that limit is exceeded the reader is disconnected.
+*/
+class UnixEventServer : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The maximum number of bytes queued for a slow reader
+     */
+    static const size_t MAX_PENDING_BYTES = 256 * 1024;
+
+    /**
+     * @brief   Constructor
+     * @param   path The filesystem path of the socket
+     */
+    explicit UnixEventServer(const std::string& path);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    UnixEventServer(const UnixEventServer&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    UnixEventServer& operator=(const UnixEventServer&) = delete;
+
+    /**
+     * @brief   Destructor
+     */
+    ~UnixEventServer(void);
+
+    /**
+     * @brief   Start listening on the socket
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * Any stale socket file at the given path will be removed first.
+     */
+    bool open(void);
+
+    /**
+     * @brief   Disconnect all readers and remove the socket
+     */
+    void close(void);
+
+    /**
+     * @brief   Check if the socket is open
+     * @return  Returns \em true if the server is listening for readers
+     */
+    bool isOpen(void) const { return m_sock >= 0; }
+
+    /**
+     * @brief   Set the framing format used for newly connected readers
+     * @param   framing The framing format to use
+     */
+    void setEventFraming(FramedEventQueue::Framing framing)
+    {
+      m_default_framing = framing;
+    }
+
+    /**
+     * @brief   Set the event filter used for newly connected readers
+     * @param   filter A list of event type prefixes, empty to write all
+     */
+    void setEventFilter(const FramedEventQueue::Filter& filter)
+    {
+      m_default_filter = filter;
+    }
+
+    /**
+     * @brief   Only write the latest event of each type per loop iteration
+     * @param   enable Set to \em true to enable coalescing
+     */
+    void setCoalesceEvents(bool enable) { m_event_queue.setCoalesce(enable); }
+
+    /**
+     * @brief   Publish an event to all interested readers
+     * @param   type The event type
+     * @param   msg The event message
+     */
+    void writeEvent(const std::string& type, const std::string& msg)
+    {
+      if (!m_clients.empty())
+      {
+        m_event_queue.queueEvent(type, msg);
+      }
+    }
+
+    /**
+     * @brief   Get the number of connected readers
+     * @return  Returns the number of connected readers
+     */
+    size_t readerCount(void) const { return m_clients.size(); }
+
+  private:
+    struct Client
+    {
+      int                         fd = -1;
+      FdWatch*                    rd_watch = nullptr;
+      FdWatch*                    wr_watch = nullptr;
+      std::string                 rx_buf;
+      std::string                 tx_buf;
+      FramedEventQueue::Framing   framing;
+      FramedEventQueue::Filter    filter;
+    };
+    typedef std::list<std::unique_ptr<Client>> ClientList;
+
+    std::string                 m_path;
+    int                         m_sock = -1;
+    FdWatch*                    m_accept_watch = nullptr;
+    ClientList                  m_clients;
+    FramedEventQueue            m_event_queue;
+    FramedEventQueue::Framing   m_default_framing =
+                                  FramedEventQueue::FRAMING_TEXT;
+    FramedEventQueue::Filter    m_default_filter;
+    std::string                 m_event_buf;
+
+    void acceptConnection(FdWatch*);
+    void clientDataReceived(FdWatch*, Client* client);
+    void clientWritable(FdWatch*, Client* client);
+    void handleCommand(Client* client, const std::string& cmd);
+    bool sendToClient(Client* client, const char* buf, size_t len);
+    void writeEventBatch(void);
+    void removeClient(Client* client);
+    void deleteClient(Client* client);
+
+};  /* class UnixEventServer */
+
+
+} /* namespace Async */
+
+#endif /* ASYNC_UNIX_EVENT_SERVER_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,241 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioAmp.h>
+#include <AsyncAudioClipper.h>
+#include <AsyncAudioFilter.h>
+#include <AsyncAudioChannelStrip.h>
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+  class BufferSource : public AudioSource
+  {
+    public:
+      void write(const float *samples, int count)
+      {
+        int pos = 0;
+        while (pos < count)
+        {
+          int ret = sinkWriteSamples(samples + pos, count - pos);
+          if (ret <= 0)
+          {
+            cerr << "*** ERROR: The audio pipe did not accept samples"
+                 << endl;
+            exit(1);
+          }
+          pos += ret;
+        }
+      }
+
+      virtual void resumeOutput(void) {}
+      virtual void allSamplesFlushed(void) {}
+  };
+
+  class BufferSink : public AudioSink
+  {
+    public:
+      vector<float> samples;
+
+      virtual int writeSamples(const float *buf, int count)
+      {
+        samples.insert(samples.end(), buf, buf + count);
+        return count;
+      }
+
+      virtual void flushSamples(void)
+      {
+        sourceAllSamplesFlushed();
+      }
+  };
+
+    // A description of one stage, used to set up both the chain of
+    // separate audio pipe elements and the channel strip
+  struct StageDesc
+  {
+    enum { GAIN, CLIP, FILTER } type;
+    float value;
+    string filter_spec;
+  };
+
+  class Chain
+  {
+    public:
+      Chain(const vector<StageDesc>& desc)
+      {
+        AudioSource *prev_src = &src;
+        for (const auto& stage : desc)
+        {
+          AudioProcessor *proc = nullptr;
+          switch (stage.type)
+          {
+            case StageDesc::GAIN:
+            {
+              AudioAmp *amp = new AudioAmp;
+              amp->setGain(stage.value);
+              proc = amp;
+              break;
+            }
+            case StageDesc::CLIP:
+            {
+              AudioClipper *clipper = new AudioClipper;
+              clipper->setClipLevel(stage.value);
+              proc = clipper;
+              break;
+            }
+            case StageDesc::FILTER:
+              proc = new AudioFilter(stage.filter_spec);
+              break;
+          }
+          prev_src->registerSink(proc, true);
+          prev_src = proc;
+        }
+        prev_src->registerSink(&sink);
+      }
+
+      BufferSource  src;
+      BufferSink    sink;
+  };
+
+  class Strip
+  {
+    public:
+      Strip(const vector<StageDesc>& desc)
+      {
+        for (const auto& stage : desc)
+        {
+          switch (stage.type)
+          {
+            case StageDesc::GAIN:
+              strip.addGain(stage.value);
+              break;
+            case StageDesc::CLIP:
+              strip.addClipper(stage.value);
+              break;
+            case StageDesc::FILTER:
+              strip.addFilter(new AudioFilter(stage.filter_spec));
+              break;
+          }
+        }
+        src.registerSink(&strip);
+        strip.registerSink(&sink);
+      }
+
+      BufferSource      src;
+      AudioChannelStrip strip;
+      BufferSink        sink;
+  };
+
+    // Run the same random input through a chain of separate pipe elements
+    // and a channel strip. The output must be bit identical unless a
+    // tolerance is given. Merging a gain stage into an adjacent gain or clip
+    // stage change the order of the multiplications so then the output may
+    // differ in the last bits.
+  void compare(const string& name, const vector<StageDesc>& desc,
+               float tolerance, mt19937& rng)
+  {
+    Chain chain(desc);
+    Strip strip(desc);
+    uniform_real_distribution<float> sample_dist(-2.0f, 2.0f);
+    uniform_int_distribution<int> block_dist(1, 512);
+    for (int block=0; block<200; ++block)
+    {
+      vector<float> buf(block_dist(rng));
+      for (auto& sample : buf)
+      {
+        sample = sample_dist(rng);
+      }
+      chain.src.write(buf.data(), buf.size());
+      strip.src.write(buf.data(), buf.size());
+    }
+
+    const vector<float>& expected = chain.sink.samples;
+    const vector<float>& out = strip.sink.samples;
+    bool ok = (expected.size() == out.size());
+    float max_diff = 0.0f;
+    for (size_t i=0; ok && (i<out.size()); ++i)
+    {
+      max_diff = max(max_diff, fabsf(expected[i] - out[i]));
+    }
+    if (ok && (tolerance == 0.0f))
+    {
+      ok = (memcmp(expected.data(), out.data(),
+                   out.size() * sizeof(float)) == 0);
+    }
+    else
+    {
+      ok = ok && (max_diff <= tolerance);
+    }
+
+    if (!ok)
+    {
+      cerr << "*** ERROR: " << name << ": " << out.size() << " of "
+           << expected.size() << " samples, max difference " << max_diff
+           << endl;
+      exit(1);
+    }
+  }
+};
+
+
+// Verify that an AudioChannelStrip give the same output as the chain of
+// separate AudioAmp, AudioClipper and AudioFilter objects it replace. The
+// stage setups used by LocalRxBase and LocalTx are tested as well as merged
+// gain and clipper stages.
+int main()
+{
+  mt19937 rng;
+
+#if (INTERNAL_SAMPLE_RATE == 16000)
+  const string splatter_spec = "LpCh9/-0.05/5000";
+  const string voiceband_spec = "LpCh9/-0.05/5500 x HpCh12/-0.05/300";
+#else
+  const string splatter_spec = "LpCh9/-0.05/3500";
+  const string voiceband_spec = "LpBu20/3500 x HpCh12/-0.05/300";
+#endif
+
+  compare("LocalRxBase clipper and splatter filter",
+          { {StageDesc::CLIP, 0.98f, ""},
+            {StageDesc::FILTER, 0.0f, splatter_spec} },
+          0.0f, rng);
+
+  compare("LocalTx preemphasis, clipper and voiceband filter",
+          { {StageDesc::FILTER, 0.0f, "BpBu4/300-4300 x HpBu1/3000"},
+            {StageDesc::CLIP, 1.0f, ""},
+            {StageDesc::FILTER, 0.0f, voiceband_spec} },
+          0.0f, rng);
+
+  compare("Clippers only",
+          { {StageDesc::CLIP, 1.0f, ""},
+            {StageDesc::CLIP, 0.5f, ""} },
+          0.0f, rng);
+
+  compare("Gain and clipper",
+          { {StageDesc::GAIN, 6.0f, ""},
+            {StageDesc::CLIP, 1.0f, ""} },
+          0.0f, rng);
+
+  compare("Clipper, gain, filter and gain",
+          { {StageDesc::CLIP, 0.9f, ""},
+            {StageDesc::GAIN, -3.0f, ""},
+            {StageDesc::FILTER, 0.0f, splatter_spec},
+            {StageDesc::GAIN, 3.0f, ""} },
+          1e-6f, rng);
+
+  compare("Gain, clipper and gain",
+          { {StageDesc::GAIN, 3.0f, ""},
+            {StageDesc::CLIP, 1.0f, ""},
+            {StageDesc::GAIN, -6.0f, ""} },
+          1e-6f, rng);
+
+  return 0;
+}
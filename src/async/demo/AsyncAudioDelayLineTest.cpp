@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioFade.h>
+#include <AsyncAudioDelayLine.h>
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+  class OnesSource : public AudioSource
+  {
+    public:
+      void write(int count)
+      {
+        vector<float> buf(count, 1.0f);
+        sinkWriteSamples(buf.data(), count);
+      }
+
+      virtual void resumeOutput(void) {}
+      virtual void allSamplesFlushed(void) {}
+  };
+
+  class BufferSink : public AudioSink
+  {
+    public:
+      vector<float> samples;
+
+      virtual int writeSamples(const float *buf, int count)
+      {
+        samples.insert(samples.end(), buf, buf + count);
+        return count;
+      }
+
+      virtual void flushSamples(void)
+      {
+        sourceAllSamplesFlushed();
+      }
+  };
+};
+
+
+// A delay line that is cleared before any samples have been written to it,
+// like when the squelch opens for the first time in a receiver, must fade
+// in the audio that follow. Run under a memory checker to also catch reads
+// outside of the fade curve.
+int main()
+{
+    // A fade that have been advanced before a length was set must start
+    // from unity gain when the length is set
+  AudioFade fade;
+  fade.fadeOut();
+  fade.advance(100);
+  fade.setLength(160);
+  if (fade.remaining() != 159)
+  {
+    cerr << "*** ERROR: Fade out started at the wrong position: "
+         << fade.remaining() << " samples remaining" << endl;
+    return 1;
+  }
+
+  OnesSource src;
+  AudioDelayLine delay(50);
+  BufferSink sink;
+  src.registerSink(&delay);
+  delay.registerSink(&sink);
+
+  delay.clear();
+  for (int i=0; i<20; ++i)
+  {
+    src.write(INTERNAL_SAMPLE_RATE / 100);
+  }
+
+  const vector<float>& out = sink.samples;
+  for (size_t i=0; i<out.size(); ++i)
+  {
+    if (!std::isfinite(out[i]) || (out[i] < 0.0f) || (out[i] > 1.0f))
+    {
+      cerr << "*** ERROR: Bad output sample " << i << ": " << out[i] << endl;
+      return 1;
+    }
+  }
+  if (out.back() != 1.0f)
+  {
+    cerr << "*** ERROR: The audio did not fade in after clear" << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
@@ -0,0 +1,449 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cassert>
+
+#include <AsyncAudioSource.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioFifo.h>
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+  const unsigned REF_MAX_WRITE_SIZE = 800;
+
+    // The AudioFifo implementation from before the storage was pooled and
+    // latency budgets were added. Used as the reference. Buffering is
+    // always enabled.
+  class ReferenceFifo : public AudioSink, public AudioSource
+  {
+    public:
+      explicit ReferenceFifo(unsigned fifo_size)
+        : fifo(fifo_size), fifo_size(fifo_size), head(0), tail(0),
+          do_overwrite(false), output_stopped(false), prebuf_samples(0),
+          prebuf(false), is_flushing(false), is_full(false),
+          input_stopped(false)
+      {
+      }
+
+      bool empty(void) const { return !is_full && (tail == head); }
+      bool full(void) const { return is_full; }
+      void setOverwrite(bool overwrite) { do_overwrite = overwrite; }
+
+      unsigned samplesInFifo(bool ignore_prebuf=false) const
+      {
+        unsigned samples_in_buffer =
+          is_full ? fifo_size : (head - tail + fifo_size) % fifo_size;
+        if (!ignore_prebuf && prebuf && !is_flushing &&
+            (samples_in_buffer < prebuf_samples))
+        {
+          return 0;
+        }
+        return samples_in_buffer;
+      }
+
+      void clear(void)
+      {
+        bool was_empty = empty();
+        is_full = false;
+        tail = head = 0;
+        prebuf = (prebuf_samples > 0);
+        output_stopped = false;
+        if (is_flushing && !was_empty)
+        {
+          sinkFlushSamples();
+        }
+      }
+
+      void setPrebufSamples(unsigned prebuf_samples)
+      {
+        this->prebuf_samples = min(prebuf_samples, fifo_size-1);
+        if (empty())
+        {
+          prebuf = (prebuf_samples > 0);
+        }
+      }
+
+      virtual int writeSamples(const float *samples, int count)
+      {
+        assert(count > 0);
+        is_flushing = false;
+        if (is_full)
+        {
+          input_stopped = true;
+          return 0;
+        }
+
+        int samples_written = 0;
+        if (empty() && !prebuf)
+        {
+          samples_written = sinkWriteSamples(samples, count);
+        }
+
+        while (!is_full && (samples_written < count))
+        {
+          while (!is_full && (samples_written < count))
+          {
+            fifo[head] = samples[samples_written++];
+            head = (head < fifo_size-1) ? head + 1 : 0;
+            if (head == tail)
+            {
+              if (do_overwrite)
+              {
+                tail = (tail < fifo_size-1) ? tail + 1 : 0;
+              }
+              else
+              {
+                is_full = true;
+              }
+            }
+          }
+          if (prebuf && (samplesInFifo() > 0))
+          {
+            prebuf = false;
+          }
+          writeSamplesFromFifo();
+        }
+
+        input_stopped = (samples_written == 0);
+        return samples_written;
+      }
+
+      virtual void flushSamples(void)
+      {
+        is_flushing = true;
+        prebuf = (prebuf_samples > 0);
+        if (empty())
+        {
+          sinkFlushSamples();
+        }
+        else
+        {
+          writeSamplesFromFifo();
+        }
+      }
+
+      virtual void resumeOutput(void)
+      {
+        if (output_stopped)
+        {
+          output_stopped = false;
+          writeSamplesFromFifo();
+        }
+      }
+
+      virtual void allSamplesFlushed(void)
+      {
+        if (empty() && is_flushing)
+        {
+          is_flushing = false;
+          sourceAllSamplesFlushed();
+        }
+      }
+
+    private:
+      vector<float> fifo;
+      unsigned      fifo_size;
+      unsigned      head, tail;
+      bool          do_overwrite;
+      bool          output_stopped;
+      unsigned      prebuf_samples;
+      bool          prebuf;
+      bool          is_flushing;
+      bool          is_full;
+      bool          input_stopped;
+
+      void writeSamplesFromFifo(void)
+      {
+        if (output_stopped || (samplesInFifo() == 0))
+        {
+          return;
+        }
+        bool was_full = full();
+        int samples_written;
+        do
+        {
+          unsigned samples_to_write = min(REF_MAX_WRITE_SIZE,
+                                          samplesInFifo(true));
+          samples_to_write = min(samples_to_write, fifo_size - tail);
+          samples_written = sinkWriteSamples(&fifo[tail], samples_to_write);
+          if (was_full && (samples_written > 0))
+          {
+            is_full = false;
+            was_full = false;
+          }
+          tail = (tail + samples_written) % fifo_size;
+        } while ((samples_written > 0) && !empty());
+
+        if (samples_written == 0)
+        {
+          output_stopped = true;
+        }
+        if (input_stopped && !full())
+        {
+          input_stopped = false;
+          sourceResumeOutput();
+        }
+        if (is_flushing && empty())
+        {
+          sinkFlushSamples();
+        }
+      }
+  };
+
+  class TestSource : public AudioSource
+  {
+    public:
+      unsigned resume_cnt = 0;
+      unsigned flushed_cnt = 0;
+
+      int write(const float *samples, int count)
+      {
+        return sinkWriteSamples(samples, count);
+      }
+      void flush(void) { sinkFlushSamples(); }
+      virtual void resumeOutput(void) { ++resume_cnt; }
+      virtual void allSamplesFlushed(void) { ++flushed_cnt; }
+  };
+
+    // A sink that only accept as many samples as it has been granted space
+    // for. The output then only depend on the order of the operations and
+    // not on how the FIFO split its writes.
+  class TestSink : public AudioSink
+  {
+    public:
+      vector<float> samples;
+      unsigned      space = 0;
+      unsigned      flush_cnt = 0;
+      bool          flush_pending = false;
+
+      virtual int writeSamples(const float *buf, int count)
+      {
+        int cnt = min(static_cast<unsigned>(count), space);
+        samples.insert(samples.end(), buf, buf + cnt);
+        space -= cnt;
+        flush_pending = false;
+        return cnt;
+      }
+
+      virtual void flushSamples(void)
+      {
+        ++flush_cnt;
+        flush_pending = true;
+      }
+
+      void grant(unsigned cnt)
+      {
+        space += cnt;
+        sourceResumeOutput();
+      }
+
+      void ackFlush(void)
+      {
+        if (flush_pending)
+        {
+          flush_pending = false;
+          sourceAllSamplesFlushed();
+        }
+      }
+  };
+
+  template <class Fifo>
+  struct Pipe
+  {
+    TestSource  src;
+    Fifo        fifo;
+    TestSink    sink;
+
+    Pipe(unsigned size, bool overwrite, unsigned prebuf) : fifo(size)
+    {
+      fifo.setOverwrite(overwrite);
+      fifo.setPrebufSamples(prebuf);
+      src.registerSink(&fifo);
+      fifo.registerSink(&sink);
+    }
+
+    ~Pipe(void)
+    {
+      fifo.unregisterSink();
+      src.unregisterSink();
+    }
+
+    string state(void) const
+    {
+      ostringstream ss;
+      ss << "out=" << sink.samples.size() << " fifo=" << fifo.samplesInFifo()
+         << "/" << fifo.samplesInFifo(true) << " full=" << fifo.full()
+         << " resume=" << src.resume_cnt << " flush=" << sink.flush_cnt
+         << " flushed=" << src.flushed_cnt;
+      return ss.str();
+    }
+  };
+
+    // Apply the same random sequence of writes, sink stalls, flushes and
+    // clears to the reference implementation and to AudioFifo. The accepted
+    // sample counts, the output and the flow control must be identical.
+  void compare(unsigned size, bool overwrite, unsigned prebuf, unsigned seed)
+  {
+    Pipe<ReferenceFifo> ref(size, overwrite, prebuf);
+    Pipe<AudioFifo> fifo(size, overwrite, prebuf);
+    mt19937 rng(seed);
+    uniform_int_distribution<int> op_dist(0, 99);
+    uniform_int_distribution<int> len_dist(1, 3 * size / 2 + 1);
+    float next_sample = 0.0f;
+    size_t checked = 0;
+    string failure;
+    for (int op_cnt=0; (op_cnt<2000) && failure.empty(); ++op_cnt)
+    {
+      int op = op_dist(rng);
+      string op_name;
+      if (op < 45)
+      {
+        int count = len_dist(rng);
+        vector<float> buf(count);
+        for (auto& sample : buf)
+        {
+          sample = next_sample++;
+        }
+        int ref_ret = ref.src.write(buf.data(), count);
+        int ret = fifo.src.write(buf.data(), count);
+        if (ret != ref_ret)
+        {
+          ostringstream ss;
+          ss << "write(" << count << ") returned " << ret << ", expected "
+             << ref_ret;
+          failure = ss.str();
+        }
+        op_name = "write";
+      }
+      else if (op < 85)
+      {
+        unsigned cnt = len_dist(rng);
+        ref.sink.grant(cnt);
+        fifo.sink.grant(cnt);
+        op_name = "grant";
+      }
+      else if (op < 92)
+      {
+        ref.src.flush();
+        fifo.src.flush();
+        op_name = "flush";
+      }
+      else if (op < 98)
+      {
+        ref.sink.ackFlush();
+        fifo.sink.ackFlush();
+        op_name = "ack flush";
+      }
+      else
+      {
+        ref.fifo.clear();
+        fifo.fifo.clear();
+        op_name = "clear";
+      }
+
+      if (failure.empty() && (fifo.state() != ref.state()))
+      {
+        failure = "after " + op_name + ": " + fifo.state() + ", expected " +
+                  ref.state();
+      }
+      else if (failure.empty())
+      {
+        const vector<float>& out = fifo.sink.samples;
+        if (!equal(out.begin() + checked, out.end(),
+                   ref.sink.samples.begin() + checked))
+        {
+          failure = "after " + op_name + ": The output differ";
+        }
+        checked = out.size();
+      }
+      if (!failure.empty())
+      {
+        ostringstream ss;
+        ss << " (operation " << op_cnt << ")";
+        failure += ss.str();
+      }
+    }
+
+    if (!failure.empty())
+    {
+      cerr << "*** ERROR: size=" << size << (overwrite ? " overwrite" : "")
+           << " prebuf=" << prebuf << " seed=" << seed << ": " << failure
+           << endl;
+      exit(1);
+    }
+  }
+
+    // A compressing latency budget splice out samples with a crossfade. When
+    // fewer samples than the crossfade length are removed, the crossfade
+    // must be shortened so that each output sample is a blend of two input
+    // samples.
+  void checkShortSplice(void)
+  {
+    Pipe<AudioFifo> pipe(1000, false, 0);
+    pipe.fifo.setLatencyBudget(64, AudioFifo::BUDGET_COMPRESS);
+    vector<float> ramp(72);
+    for (size_t i=0; i<ramp.size(); ++i)
+    {
+      ramp[i] = i;
+    }
+    pipe.src.write(ramp.data(), 64);
+    pipe.src.write(ramp.data() + 64, 8);
+    pipe.sink.grant(1000);
+
+      // A quarter of the second write, two samples, should be spliced out
+      // after the oldest ones using a two sample crossfade
+    vector<float> expected;
+    expected.push_back(2.0f / 3.0f);
+    expected.push_back(7.0f / 3.0f);
+    for (int i=4; i<72; ++i)
+    {
+      expected.push_back(i);
+    }
+    const vector<float>& out = pipe.sink.samples;
+    bool ok = (out.size() == expected.size());
+    for (size_t i=0; ok && (i<out.size()); ++i)
+    {
+      ok = (fabsf(out[i] - expected[i]) < 1e-5f);
+    }
+    if (!ok)
+    {
+      cerr << "*** ERROR: Wrong output from a short compressing splice"
+           << endl;
+      exit(1);
+    }
+  }
+};
+
+
+// Verify that AudioFifo behave exactly like the original implementation when
+// no latency budget is set, for FIFOs using a private buffer as well as
+// pooled chunks, and that short splices are crossfaded correctly.
+int main()
+{
+  const unsigned sizes[] = { 100, AudioFifo::CHUNK_SIZE, 5000 };
+  for (unsigned size : sizes)
+  {
+    for (int overwrite=0; overwrite<2; ++overwrite)
+    {
+      for (unsigned prebuf : { 0U, size / 3 })
+      {
+        for (unsigned seed=1; seed<=10; ++seed)
+        {
+          compare(size, overwrite != 0, prebuf, seed);
+        }
+      }
+    }
+  }
+
+  checkShortSplice();
+
+  return 0;
+}
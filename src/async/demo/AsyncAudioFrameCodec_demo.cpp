@@ -0,0 +1,86 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <memory>
+
+#include <AsyncAudioFrameCodec.h>
+
+// Measure the time it takes to encode and decode a test signal using each of
+// the available frame codecs. The optional argument is the length of the test
+// signal in seconds.
+int main(int argc, const char **argv)
+{
+  const int sample_rate = 8000;
+  const int frames_per_packet = 4;
+  int seconds = (argc > 1) ? atoi(argv[1]) : 60;
+  if (seconds <= 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [seconds]" << std::endl;
+    exit(1);
+  }
+
+  const char *codec_names[] = { "GSM", "GSM-WAV49", "SPEEX" };
+  for (const char *codec_name : codec_names)
+  {
+    std::unique_ptr<Async::AudioFrameCodec> codec(
+        Async::AudioFrameCodec::create(codec_name));
+    if (codec == nullptr)
+    {
+      std::cout << std::setw(10) << std::left << codec_name
+                << "not available" << std::endl;
+      continue;
+    }
+
+      // A test signal with a couple of tones and some noise
+    const int packet_samples = frames_per_packet * codec->frameSampleCount();
+    const int packet_cnt = seconds * sample_rate / packet_samples;
+    std::vector<float> input(packet_cnt * packet_samples);
+    for (size_t i=0; i<input.size(); ++i)
+    {
+      float t = static_cast<float>(i) / sample_rate;
+      input[i] = 0.3f * sinf(2.0f * M_PI * 440.0f * t) +
+                 0.2f * sinf(2.0f * M_PI * 1750.0f * t) +
+                 0.05f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+    }
+
+    std::vector<uint8_t> encoded(packet_cnt * 1024);
+    std::vector<int> encoded_len(packet_cnt);
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<packet_cnt; ++i)
+    {
+      encoded_len[i] = codec->encode(&input[i * packet_samples],
+                                     frames_per_packet, &encoded[i * 1024],
+                                     1024);
+    }
+    auto encoded_time = std::chrono::steady_clock::now();
+
+    std::vector<float> output(packet_samples);
+    int decoded_frames = 0;
+    for (int i=0; i<packet_cnt; ++i)
+    {
+      decoded_frames += codec->decode(&encoded[i * 1024], encoded_len[i],
+                                      frames_per_packet, &output[0]);
+    }
+    auto decoded_time = std::chrono::steady_clock::now();
+
+    double enc_s = std::chrono::duration<double>(encoded_time - start).count();
+    double dec_s = std::chrono::duration<double>(
+        decoded_time - encoded_time).count();
+    int frame_cnt = packet_cnt * frames_per_packet;
+    std::cout << std::setw(10) << std::left << codec_name << std::right
+              << std::fixed << std::setprecision(2)
+              << " encode: " << std::setw(7) << (1e6 * enc_s / frame_cnt)
+              << " us/frame (" << std::setw(7) << (seconds / enc_s)
+              << "x realtime)"
+              << "  decode: " << std::setw(7) << (1e6 * dec_s / frame_cnt)
+              << " us/frame (" << std::setw(7) << (seconds / dec_s)
+              << "x realtime)"
+              << "  decoded " << decoded_frames << "/" << frame_cnt
+              << std::endl;
+  }
+
+  return 0;
+}
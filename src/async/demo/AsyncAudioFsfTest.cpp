@@ -0,0 +1,194 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+#include <AsyncAudioFsf.h>
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+    // The original AudioFsf implementation where each resonator is run one
+    // at a time for each sample. Used as the reference.
+  class ScalarFsf
+  {
+    public:
+      ScalarFsf(size_t N, const float *coeff, float r=0.99999)
+        : combN(N, r), comb2(2, r)
+      {
+        for (size_t k=0; k<=N/2; ++k)
+        {
+          float H = coeff[k];
+          if (H > 0.0f)
+          {
+            resonators.push_back(Resonator(N, k, r, H));
+          }
+        }
+      }
+
+      void processSamples(float *dest, const float *src, int count)
+      {
+        for (int i=0; i<count; ++i)
+        {
+          float destN = combN.processSample(src[i]);
+          float dest2 = comb2.processSample(destN);
+          dest[i] = 0.0f;
+          for (auto& res : resonators)
+          {
+            dest[i] += res.processSample(dest2);
+          }
+        }
+      }
+
+    private:
+      class CombFilter
+      {
+        public:
+          CombFilter(size_t N, float r)
+            : N(N), r_fact(-std::pow(r, N)), delay(N, 0.0f), pos(0) {}
+
+          float processSample(const float& src)
+          {
+            float dest = src + delay[pos] * r_fact;
+            delay[pos] = src;
+            pos = (pos == N-1) ? 0 : pos + 1;
+            return dest;
+          }
+
+        private:
+          const size_t  N;
+          const float   r_fact;
+          vector<float> delay;
+          size_t        pos;
+      };
+
+      class Resonator
+      {
+        public:
+          Resonator(size_t N, size_t k, float r, float H)
+            : gain(H), coeff1(2.0*r*cos(2.0*M_PI*k/N)), coeff2(-r*r),
+              z1(0.0), z2(0.0)
+          {
+            gain /= N;
+            if ((k == 0) || (k == N/2))
+            {
+              gain /= 2.0;
+            }
+            if (k % 2 == 1)
+            {
+              gain = -gain;
+            }
+          }
+
+          float processSample(const float& src)
+          {
+            float dest = src + z1*coeff1 + z2*coeff2;
+            z2 = z1;
+            z1 = dest;
+            return dest * gain;
+          }
+
+        private:
+          float gain;
+          float coeff1;
+          float coeff2;
+          float z1;
+          float z2;
+      };
+
+      CombFilter          combN;
+      CombFilter          comb2;
+      vector<Resonator>   resonators;
+  };
+
+  class FsfUnderTest : public AudioFsf
+  {
+    public:
+      FsfUnderTest(size_t N, const float *coeff) : AudioFsf(N, coeff) {}
+      using AudioFsf::processSamples;
+  };
+
+  void compare(size_t N, const vector<float>& coeff, bool in_place,
+               mt19937& rng)
+  {
+    size_t res_cnt = 0;
+    for (auto H : coeff)
+    {
+      res_cnt += (H > 0.0f) ? 1 : 0;
+    }
+
+    ScalarFsf ref(N, coeff.data());
+    FsfUnderTest fsf(N, coeff.data());
+    uniform_real_distribution<float> sample_dist(-1.0f, 1.0f);
+    uniform_int_distribution<int> block_dist(1, 512);
+    size_t diff_cnt = 0;
+    for (int block=0; block<200; ++block)
+    {
+      int count = block_dist(rng);
+      vector<float> src(count);
+      for (auto& sample : src)
+      {
+        sample = sample_dist(rng);
+      }
+      vector<float> ref_out(count);
+      ref.processSamples(ref_out.data(), src.data(), count);
+      vector<float> out(count);
+      if (in_place)
+      {
+        out = src;
+        fsf.processSamples(out.data(), out.data(), count);
+      }
+      else
+      {
+        fsf.processSamples(out.data(), src.data(), count);
+      }
+      if (memcmp(ref_out.data(), out.data(), count * sizeof(float)) != 0)
+      {
+        ++diff_cnt;
+      }
+    }
+
+    if (diff_cnt > 0)
+    {
+      cerr << "*** ERROR: N=" << N << " with " << res_cnt
+           << " resonator(s)" << (in_place ? ", in place" : "") << ": "
+           << diff_cnt << " block(s) differ" << endl;
+      exit(1);
+    }
+  }
+};
+
+
+// Verify that the grouped resonator implementation in AudioFsf give the
+// exact same output as running the resonators one at a time. Filters with
+// one up to more than two whole resonator groups are tested, including the
+// special cases for k=0 and k=N/2, with random input and block sizes.
+int main()
+{
+  mt19937 rng;
+  const size_t N = 128;
+  for (size_t res_cnt=1; res_cnt<=12; ++res_cnt)
+  {
+    vector<float> coeff(N/2+1, 0.0f);
+    for (size_t k=5; k<5+res_cnt; ++k)
+    {
+      coeff[k] = (k % 3 == 0) ? 0.39811024f : 1.0f;
+    }
+    compare(N, coeff, false, rng);
+  }
+
+  vector<float> coeff(N/2+1, 0.0f);
+  coeff[0] = 1.0f;
+  coeff[1] = 0.5f;
+  coeff[N/4] = 1.0f;
+  coeff[N/2-1] = 0.5f;
+  coeff[N/2] = 1.0f;
+  compare(N, coeff, false, rng);
+  compare(N, coeff, true, rng);
+
+  return 0;
+}
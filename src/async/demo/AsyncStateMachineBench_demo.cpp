@@ -0,0 +1,93 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+
+#include <AsyncStateMachine.h>
+
+struct Context
+{
+  unsigned long handled = 0;
+  unsigned long transitions = 0;
+};
+
+struct StateTop;
+struct StateIdle;
+struct StateActive;
+struct StateActiveA;
+struct StateActiveB;
+
+struct StateTop : Async::StateTopBase<Context, StateTop>::Type
+{
+  static constexpr auto NAME = "Top";
+  void init(void) { setState<StateIdle>(); }
+  virtual void tickEvent(void) { ctx().handled += 1; }
+  virtual void toggleEvent(void) {}
+};
+
+struct StateIdle : Async::StateBase<StateTop, StateIdle>
+{
+  static constexpr auto NAME = "Idle";
+  virtual void toggleEvent(void) override { setState<StateActive>(); }
+};
+
+struct StateActive : Async::StateBase<StateTop, StateActive>
+{
+  static constexpr auto NAME = "Active";
+  void init(void) { setState<StateActiveA>(); }
+  void entry(void) { ctx().transitions += 1; }
+};
+
+struct StateActiveA : Async::StateBase<StateActive, StateActiveA>
+{
+  static constexpr auto NAME = "ActiveA";
+  virtual void toggleEvent(void) override { setState<StateActiveB>(); }
+};
+
+struct StateActiveB : Async::StateBase<StateActive, StateActiveB>
+{
+  static constexpr auto NAME = "ActiveB";
+  virtual void toggleEvent(void) override { setState<StateIdle>(); }
+};
+
+// Measure how many events per second the state machine can handle. Both
+// events that are handled within the active state and events that cause a
+// state transition are measured. The optional argument is the number of
+// events to dispatch.
+int main(int argc, const char **argv)
+{
+  long event_cnt = (argc > 1) ? atol(argv[1]) : 10000000;
+  if (event_cnt <= 0)
+  {
+    std::cerr << "Usage: " << argv[0] << " [event count]" << std::endl;
+    exit(1);
+  }
+
+  Context ctx;
+  Async::StateMachine<Context, StateTop> sm(&ctx);
+  sm.start();
+
+  auto start = std::chrono::steady_clock::now();
+  for (long i=0; i<event_cnt; ++i)
+  {
+    sm.state().tickEvent();
+  }
+  auto ticked = std::chrono::steady_clock::now();
+  for (long i=0; i<event_cnt; ++i)
+  {
+    sm.state().toggleEvent();
+  }
+  auto toggled = std::chrono::steady_clock::now();
+
+  double tick_s = std::chrono::duration<double>(ticked - start).count();
+  double toggle_s = std::chrono::duration<double>(toggled - ticked).count();
+  std::cout << std::fixed << std::setprecision(0)
+            << "Handled events:    " << std::setw(12) << (event_cnt / tick_s)
+            << " events/s" << std::endl
+            << "Transition events: " << std::setw(12)
+            << (event_cnt / toggle_s) << " events/s" << std::endl
+            << "(" << ctx.handled << " events handled, " << ctx.transitions
+            << " entries to the Active state)" << std::endl;
+
+  return 0;
+}
@@ -40,9 +40,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cassert>
 #include <cstring>
 
-#ifdef SPEEX_MAJOR
-#include <speex/speex.h>
-#endif
 
 
 /****************************************************************************
@@ -51,6 +48,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncAudioSampleConv.h>
+#include <AsyncAudioFrameCodecGsm.h>
+#ifdef SPEEX_MAJOR
+#include <AsyncAudioFrameCodecSpeex.h>
+#endif
 
 
 /****************************************************************************
@@ -102,20 +104,13 @@ struct Qso::Private
 #endif
   } Codec;
 
-  Codec     remote_codec;
+  Codec                 remote_codec;
+  AudioFrameCodecGsm    gsm_codec;
 #ifdef SPEEX_MAJOR
-  SpeexBits enc_bits;
-  SpeexBits dec_bits;
-  void *    enc_state;
-  void *    dec_state;
+  AudioFrameCodecSpeex  speex_codec;
 #endif
 
-  Private(void)
-    : remote_codec(CODEC_GSM)
-#if SPEEX_MAJOR
-      , enc_bits(), dec_bits(), enc_state(0), dec_state(0)
-#endif
-  {}
+  Private(void) : remote_codec(CODEC_GSM) {}
 };
 
 
@@ -153,7 +148,7 @@ struct Qso::Private
 
 Qso::Qso(const IpAddress& addr, const string& callsign, const string& name,
       	 const string& info)
-  : init_ok(false), sdes_length(0), state(STATE_DISCONNECTED), gsmh(0),
+  : init_ok(false), sdes_length(0), state(STATE_DISCONNECTED),
     next_audio_seq(0), keep_alive_timer(0), connect_retry_cnt(0),
     con_timeout_timer(0), callsign(callsign), name(name), local_stn_info(info),
     send_buffer_cnt(0), remote_ip(addr), rx_indicator_timer(0),
@@ -169,21 +164,10 @@ Qso::Qso(const IpAddress& addr, const string& callsign, const string& name,
   
   setLocalCallsign(callsign);
       
-  gsmh = gsm_create();
-
 #ifdef SPEEX_MAJOR
-  speex_bits_init(&p->enc_bits);
-  speex_bits_init(&p->dec_bits);
-    
-  p->enc_state = speex_encoder_init(&speex_nb_mode);
-  p->dec_state = speex_decoder_init(&speex_nb_mode);
-
-  int val = 25000;
-  speex_encoder_ctl(p->enc_state, SPEEX_SET_BITRATE, &val);
-  val = 8;
-  speex_encoder_ctl(p->enc_state, SPEEX_SET_QUALITY, &val);
-  val = 4;
-  speex_encoder_ctl(p->enc_state, SPEEX_SET_COMPLEXITY, &val);
+  p->speex_codec.setBitrate(25000);
+  p->speex_codec.setQuality(8);
+  p->speex_codec.setComplexity(4);
 #endif
     
   if (!Dispatcher::instance()->registerConnection(this, &Qso::handleCtrlInput,
@@ -204,17 +188,6 @@ Qso::~Qso(void)
 {
   disconnect();
   
-  gsm_destroy(gsmh);
-  gsmh = 0;
-
-#ifdef SPEEX_MAJOR
-  speex_bits_destroy(&p->enc_bits);
-  speex_bits_destroy(&p->dec_bits);
-
-  speex_encoder_destroy(p->enc_state);
-  speex_decoder_destroy(p->dec_state);
-#endif
-  
   if (init_ok)
   {
     Dispatcher::instance()->unregisterConnection(this);
@@ -404,13 +377,10 @@ bool Qso::sendAudioRaw(RawPacket *raw_packet)
   {
     // transcode SPEEX -> GSM
     VoicePacket voice_packet;
-    size_t nbytes = 0;
-    
-    for(int i=0; i<FRAME_COUNT; i++)
-    {
-      gsm_encode(gsmh, raw_packet->samples + i*160, voice_packet.data + i*33);
-      nbytes += 33;
-    }
+    int nbytes = p->gsm_codec.encodeS16(raw_packet->samples, FRAME_COUNT,
+                                        voice_packet.data,
+                                        sizeof(voice_packet.data));
+    assert(nbytes > 0);
     voice_packet.header.version = 0xc0;
     voice_packet.header.pt = 0x03;
     voice_packet.header.time = htonl(0);
@@ -470,22 +440,10 @@ int Qso::writeSamples(const float *samples, int count)
   while (samples_read < count)
   {
     int read_cnt = min(BUFFER_SIZE - send_buffer_cnt, count-samples_read);
-    for (int i=0; i<read_cnt; ++i)
-    {
-      float sample = samples[samples_read++];
-      if (sample > 1)
-      {
-      	send_buffer[send_buffer_cnt++] = 32767;
-      }
-      else if (sample < -1)
-      {
-      	send_buffer[send_buffer_cnt++] = -32767;
-      }
-      else
-      {
-      	send_buffer[send_buffer_cnt++] = static_cast<int16_t>(32767.0 * sample);
-      }
-    }
+    AudioSampleConv::floatToS16(send_buffer + send_buffer_cnt,
+                                samples + samples_read, read_cnt);
+    samples_read += read_cnt;
+    send_buffer_cnt += read_cnt;
     
     if (send_buffer_cnt == BUFFER_SIZE)
     {
@@ -770,7 +728,6 @@ inline void Qso::handleAudioPacket(unsigned char *buf, int len)
   VoicePacket *voice_packet = reinterpret_cast<VoicePacket*>(buf);
 
   RawPacket raw_packet = { voice_packet, len, receive_buffer };
-  short *sbuff = receive_buffer;
 
   /* Check that we have received a valid header. */
   if ((unsigned)len < sizeof(voice_packet->header))
@@ -778,81 +735,56 @@ inline void Qso::handleAudioPacket(unsigned char *buf, int len)
     cerr << "*** WARNING: Invalid audio packet size." << endl;
     return;
   }
+  size_t data_len = len - sizeof(voice_packet->header);
 
+    // All frames in the packet are decoded in one go
+  int frame_cnt = 0;
 #ifdef SPEEX_MAJOR
   if (voice_packet->header.pt == 0x96)
   {
-    speex_bits_read_from(&p->dec_bits, (char*)voice_packet->data,
-                         len - sizeof(voice_packet->header));
-          
-    for (int frameno=0; frameno<FRAME_COUNT; ++frameno)
+    frame_cnt = p->speex_codec.decodeS16(voice_packet->data, data_len,
+                                         FRAME_COUNT, receive_buffer);
+    if (frame_cnt < FRAME_COUNT)
     {
-      int err = speex_decode_int(p->dec_state, &p->dec_bits, sbuff);
-      if (err == -1)
-      {
-        cerr << "*** WARNING: Short frame count. There should be "
-             << FRAME_COUNT << " frames in each audio packet, but only "
-             << frameno << " frames have been received."
-             << endl;
-        return;
-      }
-      if (err == -2)
-      {
-        cerr << "*** WARNING: Corrupt Speex stream in received audio packet."
-             << endl;
-        return;
-      }
-
-      if (rx_indicator_timer == 0)
-      {
-        receiving_audio = true;
-        isReceiving(true);
-        rx_indicator_timer = new Timer(RX_INDICATOR_POLL_TIME,
-                                       Timer::TYPE_PERIODIC);
-        rx_indicator_timer->expired.connect(
-            mem_fun(*this, &Qso::checkRxActivity));
-        rx_timeout_left = RX_INDICATOR_SLACK;
-      }
-      
-      float samples[160];
-      for (int i = 0; i < 160; i++)
-      {
-        samples[i] = static_cast<float>(sbuff[i]) / 32768.0;
-      }
-      sinkWriteSamples(samples, 160);
-      sbuff += 160;
+      cerr << "*** WARNING: Short frame count or corrupt Speex stream. "
+           << "There should be " << FRAME_COUNT << " frames in each audio "
+           << "packet, but only " << frame_cnt << " frames could be decoded."
+           << endl;
     }
   }
   else
 #endif
   {
-    if ((unsigned)len < sizeof(voice_packet->header)+FRAME_COUNT*33)
+    if (data_len < FRAME_COUNT*33)
     {
       cerr << "*** WARNING: Invalid GSM audio packet size." << endl;
       return;
     }
-    for (int frameno=0; frameno<FRAME_COUNT; ++frameno)
+    p->gsm_codec.decodeS16(voice_packet->data, data_len, FRAME_COUNT,
+                           receive_buffer);
+    frame_cnt = FRAME_COUNT;
+  }
+
+  if (frame_cnt > 0)
+  {
+    if (rx_indicator_timer == 0)
     {
-      gsm_decode(gsmh, voice_packet->data + frameno*33, sbuff);
-      if (rx_indicator_timer == 0)
-      {
-        receiving_audio = true;
-        isReceiving(true); 
-        rx_indicator_timer = new Timer(RX_INDICATOR_POLL_TIME,
-                                       Timer::TYPE_PERIODIC);
-        rx_indicator_timer->expired.connect(
-            mem_fun(*this, &Qso::checkRxActivity));
-        rx_timeout_left = RX_INDICATOR_SLACK;
-      }
-      
-      float samples[160];
-      for (int i=0; i<160; ++i)
-      {
-        samples[i] = static_cast<float>(sbuff[i]) / 32768.0;
-      }
-      sinkWriteSamples(samples, 160);
-      sbuff += 160;
+      receiving_audio = true;
+      isReceiving(true);
+      rx_indicator_timer = new Timer(RX_INDICATOR_POLL_TIME,
+                                     Timer::TYPE_PERIODIC);
+      rx_indicator_timer->expired.connect(
+          mem_fun(*this, &Qso::checkRxActivity));
+      rx_timeout_left = RX_INDICATOR_SLACK;
     }
+
+    float samples[BUFFER_SIZE];
+    AudioSampleConv::s16ToFloat(samples, receive_buffer, frame_cnt * 160);
+    sinkWriteSamples(samples, frame_cnt * 160);
+  }
+  if (frame_cnt < FRAME_COUNT)
+  {
+    return;
   }
 
   rx_timeout_left += BLOCK_TIME;
@@ -969,27 +901,19 @@ bool Qso::sendVoicePacket(void)
 #ifdef SPEEX_MAJOR
   if (p->remote_codec == Private::CODEC_SPEEX)
   {
-    for(int i = 0; i < BUFFER_SIZE; i += 160)
-    {
-      speex_encode_int(p->enc_state, send_buffer + i, &p->enc_bits);
-    }
-    speex_bits_insert_terminator(&p->enc_bits);
-    size_t nsize = speex_bits_nbytes(&p->enc_bits);
-    if (nsize < sizeof(voice_packet.data))
-    {
-      nbytes = speex_bits_write(&p->enc_bits, (char*)voice_packet.data, nsize);
-    }
-    speex_bits_reset(&p->enc_bits);
+    int ret = p->speex_codec.encodeS16(send_buffer, FRAME_COUNT,
+                                       voice_packet.data,
+                                       sizeof(voice_packet.data));
+    nbytes = (ret > 0) ? ret : 0;
     voice_packet.header.pt = 0x96;
   }
   else
 #endif
   {
-    for(int i=0; i<FRAME_COUNT; i++)
-    {
-      gsm_encode(gsmh, send_buffer + i*160, voice_packet.data + i*33);
-      nbytes += 33;
-    }
+    int ret = p->gsm_codec.encodeS16(send_buffer, FRAME_COUNT,
+                                     voice_packet.data,
+                                     sizeof(voice_packet.data));
+    nbytes = (ret > 0) ? ret : 0;
     voice_packet.header.pt = 0x03;
   }
   if (!nbytes)
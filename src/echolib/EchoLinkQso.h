@@ -59,9 +59,6 @@ disconnected the application exits.
  *
  ****************************************************************************/
 
-extern "C" {
-#include <gsm.h>
-}
 #include <AsyncTimer.h>
 #include <AsyncIpAddress.h>
 #include <AsyncAudioSink.h>
@@ -482,7 +479,6 @@ class Qso
     unsigned char      	sdes_packet[1500];
     int       	      	sdes_length;
     State     	      	state;
-    gsm       	      	gsmh;
     uint16_t    	next_audio_seq;
     Async::Timer *	keep_alive_timer;
     int       	      	connect_retry_cnt;
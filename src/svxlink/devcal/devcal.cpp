@@ -42,6 +42,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <sstream>
+
+#include <json/json.h>
 
 
 /****************************************************************************
@@ -55,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioSplitter.h>
 #include <AsyncConfig.h>
 #include <AsyncFdWatch.h>
+#include <AsyncTimer.h>
 #include <Tx.h>
 #include <Rx.h>
 #include <common.h>
@@ -71,6 +76,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../trx/Ptt.h"
 #endif
 #include "../trx/Goertzel.h"
+#include "../trx/WelchPsd.h"
 #include "../trx/Emphasis.h"
 #include "../trx/RtlSdr.h"
 #include "../trx/Ddr.h"
@@ -276,17 +282,29 @@ class DevPrinter : public AudioSink
 {
   public:
     DevPrinter(unsigned samp_rate, const vector<float> &mod_fqs,
-               float max_dev=1.0f, float headroom_db=0.0f)
+               float max_dev=1.0f, float headroom_db=0.0f,
+               bool use_fft=false)
       : block_size(samp_rate / 20), w(block_size),
-        g(mod_fqs.size()), samp_cnt(0), max_dev(max_dev),
-        headroom(pow(10.0, headroom_db/20.0)), adj_level(1.0f), dev_est(0.0),
-        block_cnt(0), pwr_sum(0.0), tot_dev_est(0.0f), amp_sum(0.0),
-        fqerr_est(0.0), carrier_fq(0.0)
+        g(use_fft ? 0 : mod_fqs.size()), mod_fqs(mod_fqs), samp_cnt(0),
+        max_dev(max_dev), headroom(pow(10.0, headroom_db/20.0)),
+        adj_level(1.0f), dev_est(0.0), block_cnt(0), pwr_sum(0.0),
+        tot_dev_est(0.0f), amp_sum(0.0), fqerr_est(0.0), carrier_fq(0.0),
+        print_enabled(true)
     {
-      for (size_t i=0; i<mod_fqs.size(); ++i)
+      for (size_t i=0; i<g.size(); ++i)
       {
         g[i].initialize(mod_fqs[i], samp_rate);
       }
+      if (use_fft)
+      {
+          // Use the largest FFT size that fit in one measurement block
+        size_t N = 2;
+        while (2 * N <= static_cast<size_t>(block_size))
+        {
+          N *= 2;
+        }
+        psd.reset(new WelchPsd(samp_rate, N, WelchPsd::WINDOW_FLATTOP));
+      }
     }
 
     void adjustLevel(double adj_db)
@@ -309,20 +327,44 @@ class DevPrinter : public AudioSink
     }
 
     double carrierFq(void) const { return carrier_fq; }
+
+    void setPrintEnabled(bool enable) { print_enabled = enable; }
+
+    double toneDev(void) const { return dev_est; }
+
+    double fullBwDev(void) const { return tot_dev_est; }
+
+    double carrierFqErr(void) const { return fqerr_est; }
     
     virtual int writeSamples(const float *samples, int count)
     {
-      for (int i=0; i<count; ++i)
+      int pos = 0;
+      while (pos < count)
       {
-        pwr_sum += static_cast<double>(samples[i]) * samples[i];
-        amp_sum += samples[i];
-
-        float windowed = w[samp_cnt] * samples[i];
-        for (size_t i=0; i<g.size(); ++i)
+          // Feed the PSD one measurement block at a time so that the FFT
+          // segments line up with the blocks
+        int len = min(count - pos, block_size - samp_cnt);
+        if (psd)
         {
-          g[i].calc(windowed);
+          psd->writeSamples(samples + pos, len);
         }
-        if (++samp_cnt >= block_size)
+        for (int i=pos; i<pos+len; ++i)
+        {
+          pwr_sum += static_cast<double>(samples[i]) * samples[i];
+          amp_sum += samples[i];
+
+          if (!g.empty())
+          {
+            float windowed = w[samp_cnt] * samples[i];
+            for (size_t j=0; j<g.size(); ++j)
+            {
+              g[j].calc(windowed);
+            }
+          }
+          ++samp_cnt;
+        }
+        pos += len;
+        if (samp_cnt >= block_size)
         {
           double avg_power = pwr_sum / block_size;
           double tot_dev = sqrt(avg_power) * sqrt(2);
@@ -332,11 +374,26 @@ class DevPrinter : public AudioSink
           pwr_sum = 0.0;
 
           double dev = 0.0;
-          for (size_t i=0; i<g.size(); ++i)
+          if (psd)
+          {
+              // The PSD is updated for each overlapping FFT segment. All
+              // tone amplitudes are read from the same averaged spectrum.
+            for (size_t i=0; i<mod_fqs.size(); ++i)
+            {
+              double amp = psd->toneAmplitude(mod_fqs[i]);
+              dev += amp * amp;
+            }
+            dev = sqrt(dev);
+            psd->reset();
+          }
+          else
           {
-            dev += g[i].magnitudeSquared();
+            for (size_t i=0; i<g.size(); ++i)
+            {
+              dev += g[i].magnitudeSquared();
+            }
+            dev = 2 * sqrt(dev) / block_size;
           }
-          dev = 2 * sqrt(dev) / block_size;
           dev *= adj_level;
           dev *= headroom * max_dev;
           dev_est = (1.0-ALPHA) * dev + ALPHA * dev_est;
@@ -347,7 +404,7 @@ class DevPrinter : public AudioSink
           amp_sum = 0.0;
           fqerr_est = (1.0-ALPHA) * fqerr + ALPHA * fqerr_est;
 
-          if (++block_cnt >= PRINT_INTERVAL)
+          if (print_enabled && (++block_cnt >= PRINT_INTERVAL))
           {
             cout << "\r\033[K" "Tone dev=" << dev_est
                  << "  Full bw dev=" << tot_dev_est 
@@ -383,6 +440,8 @@ class DevPrinter : public AudioSink
     int           block_size;
     FlatTopWindow w;
     vector<Goertzel> g;
+    vector<float> mod_fqs;
+    unique_ptr<WelchPsd> psd;
     int           samp_cnt;
     float         max_dev;
     double        headroom;
@@ -394,6 +453,7 @@ class DevPrinter : public AudioSink
     double        amp_sum;
     double        fqerr_est;
     double        carrier_fq;
+    bool          print_enabled;
 };
 
 
@@ -401,13 +461,16 @@ class DevMeasure : public sigc::trackable
 {
   public:
     DevMeasure(unsigned samp_rate, const vector<float> &mod_fqs,
-               double carrier_fq=0.0)
-      : iold(0.0f), qold(0.0f), dev_print(samp_rate, mod_fqs),
+               double carrier_fq=0.0, bool use_fft=false)
+      : iold(0.0f), qold(0.0f),
+        dev_print(samp_rate, mod_fqs, 1.0f, 0.0f, use_fft),
         samp_rate(samp_rate)
     {
       dev_print.setCarrierFq(carrier_fq);
     }
 
+    DevPrinter& printer(void) { return dev_print; }
+
     void processPreDemod(const vector<RtlSdr::Sample> &preDemod)
     {
       vector<float> audio;
@@ -435,6 +498,15 @@ class DevMeasure : public sigc::trackable
 };
 
 
+struct Channel
+{
+  string      section;
+  Rx          *rx;
+  DevPrinter  *dp;
+  float       level_adjust_offset;
+};
+
+
 
 /****************************************************************************
  *
@@ -445,6 +517,8 @@ class DevMeasure : public sigc::trackable
 static void parse_arguments(int argc, const char **argv);
 static void stdin_handler(FdWatch *w);
 static void sigterm_handler(int signal);
+static void print_results(void);
+static double channel_preamp(const Channel& ch);
 
 
 /****************************************************************************
@@ -462,8 +536,13 @@ static int cal_tx = false;
 static int measure = false;
 static bool wb_mode = false;
 static int flat_fq_response = false;
+static int use_fft = false;
+static int batch_time = 0;
+static int json_output = false;
 static string cfgfile;
 static string cfgsect;
+static vector<string> cfgsects;
+static vector<Channel> channels;
 static FdWatch *stdin_watch = 0;
 static SineGenerator *gen = 0;
 static DevPrinter *dp = 0;
@@ -561,108 +640,150 @@ int main(int argc, const char *argv[])
   }
   else if (cal_rx)
   {
-    cfg.getValue(cfgsect, "PREAMP", level_adjust_offset);
-    cout << "--- Initial PREAMP=" << level_adjust_offset << endl;
-
-    cout << "--- Setting SQL_DET=OPEN\n";
-    cfg.setValue(cfgsect, "SQL_DET", "OPEN");
-    cout << "--- Setting DTMF_MUTING=0\n";
-    cfg.setValue(cfgsect, "DTMF_MUTING", "0");
-
-    cout << "--- Use +, - and 0 to adjust PREAMP\n";
-
-    rx = RxFactory::createNamedRx(cfg, cfgsect);
-    if ((rx == 0) || !rx->initialize())
+    for (vector<string>::const_iterator it = cfgsects.begin();
+         it != cfgsects.end();
+         ++it)
     {
-      cerr << "*** ERROR: Could not initialize receiver object\n";
-      exit(1);
-    }
-    rx->setVerbose(false);
-    AudioSource *prev_src = rx;
+      Channel ch;
+      ch.section = *it;
+      ch.level_adjust_offset = 0.0f;
+      const string prefix = (cfgsects.size() > 1) ? "--- " + *it + ": " : "--- ";
+      cfg.getValue(ch.section, "PREAMP", ch.level_adjust_offset);
+      cout << prefix << "Initial PREAMP=" << ch.level_adjust_offset << endl;
+
+      cout << prefix << "Setting SQL_DET=OPEN\n";
+      cfg.setValue(ch.section, "SQL_DET", "OPEN");
+      cout << prefix << "Setting DTMF_MUTING=0\n";
+      cfg.setValue(ch.section, "DTMF_MUTING", "0");
+
+      ch.rx = RxFactory::createNamedRx(cfg, ch.section);
+      if ((ch.rx == 0) || !ch.rx->initialize())
+      {
+        cerr << "*** ERROR: Could not initialize receiver object\n";
+        exit(1);
+      }
+      ch.rx->setVerbose(false);
+      AudioSource *prev_src = ch.rx;
 
-    AudioSplitter *splitter = new AudioSplitter;
-    prev_src->registerSink(splitter);
-    prev_src = splitter;
+      AudioSplitter *splitter = new AudioSplitter;
+      prev_src->registerSink(splitter);
+      prev_src = splitter;
 
-    if (!flat_fq_response)
-    {
-      PreemphasisFilter *preemph = new PreemphasisFilter;
-      prev_src->registerSink(preemph, true);
-      prev_src = preemph;
-    }
-    
-    dp = new DevPrinter(INTERNAL_SAMPLE_RATE, mod_fqs, maxdev, headroom_db);
-    prev_src->registerSink(dp, true);
-    prev_src = 0;
-
-    if (audio_dev[0] != '\0')
-    {
-      audio_io = new AudioIO(audio_dev, audio_ch);
-      if (!audio_io->open(AudioIO::MODE_WR))
+      if (!flat_fq_response)
       {
-        cerr << "*** WARNING: Could not open audio output device \""
-             << audio_dev << "\"\n";
+        PreemphasisFilter *preemph = new PreemphasisFilter;
+        prev_src->registerSink(preemph, true);
+        prev_src = preemph;
       }
-      else
+
+      ch.dp = new DevPrinter(INTERNAL_SAMPLE_RATE, mod_fqs, maxdev,
+                             headroom_db, use_fft);
+      ch.dp->setPrintEnabled(batch_time == 0);
+      prev_src->registerSink(ch.dp, true);
+      prev_src = 0;
+
+      if ((batch_time == 0) && (audio_dev[0] != '\0'))
       {
-        splitter->addSink(audio_io, true);
+        audio_io = new AudioIO(audio_dev, audio_ch);
+        if (!audio_io->open(AudioIO::MODE_WR))
+        {
+          cerr << "*** WARNING: Could not open audio output device \""
+               << audio_dev << "\"\n";
+        }
+        else
+        {
+          splitter->addSink(audio_io, true);
+        }
       }
+
+      ch.rx->setMuteState(Rx::MUTE_NONE);
+      channels.push_back(ch);
     }
 
-    rx->setMuteState(Rx::MUTE_NONE);
+    if (batch_time == 0)
+    {
+      cout << "--- Use +, - and 0 to adjust PREAMP\n";
+      rx = channels[0].rx;
+      dp = channels[0].dp;
+      level_adjust_offset = channels[0].level_adjust_offset;
+    }
   }
   else if (measure)
   {
-    cout << "--- Setting SQL_DET=OPEN\n";
-    cfg.setValue(cfgsect, "SQL_DET", "OPEN");
-    cout << "--- Setting DTMF_MUTING=0\n";
-    cfg.setValue(cfgsect, "DTMF_MUTING", "0");
-    string wbrx_sect;
-    if (cfg.getValue(cfgsect, "WBRX", wbrx_sect))
+    for (vector<string>::const_iterator it = cfgsects.begin();
+         it != cfgsects.end();
+         ++it)
     {
-      cout << "--- Setting " << wbrx_sect << "/SAMPLE_RATE to default value\n";
-      cfg.setValue(wbrx_sect, "SAMPLE_RATE", "");
-    }
-
-    rx = RxFactory::createNamedRx(cfg, cfgsect);
-    if ((rx == 0) || !rx->initialize())
-    {
-      cerr << "*** ERROR: Could not initialize receiver object\n";
-      exit(1);
-    }
-    rx->setVerbose(false);
-    AudioSource *prev_src = rx;
+      Channel ch;
+      ch.section = *it;
+      ch.level_adjust_offset = 0.0f;
+      const string prefix = (cfgsects.size() > 1) ? "--- " + *it + ": " : "--- ";
+      cout << prefix << "Setting SQL_DET=OPEN\n";
+      cfg.setValue(ch.section, "SQL_DET", "OPEN");
+      cout << prefix << "Setting DTMF_MUTING=0\n";
+      cfg.setValue(ch.section, "DTMF_MUTING", "0");
+      string wbrx_sect;
+      if (cfg.getValue(ch.section, "WBRX", wbrx_sect))
+      {
+        cout << prefix << "Setting " << wbrx_sect
+             << "/SAMPLE_RATE to default value\n";
+        cfg.setValue(wbrx_sect, "SAMPLE_RATE", "");
+      }
 
-    Ddr *ddr = dynamic_cast<Ddr*>(rx);
-    if (ddr == 0)
-    {
-      cerr << "*** ERROR: An rtl-sdr receiver is needed to measure deviation\n";
-      exit(1);
-    }
-    if (wb_mode)
-    {
-      ddr->setModulation(Modulation::MOD_WBFM);
-    }
-    DevMeasure *dev_measure = new DevMeasure(ddr->preDemodSampleRate(), 
-                                             mod_fqs, ddr->nbFq());
-    ddr->preDemod.connect(mem_fun(dev_measure, &DevMeasure::processPreDemod));
+      ch.rx = RxFactory::createNamedRx(cfg, ch.section);
+      if ((ch.rx == 0) || !ch.rx->initialize())
+      {
+        cerr << "*** ERROR: Could not initialize receiver object\n";
+        exit(1);
+      }
+      ch.rx->setVerbose(false);
+      AudioSource *prev_src = ch.rx;
 
-    if (audio_dev[0] != '\0')
-    {
-      audio_io = new AudioIO(audio_dev, audio_ch);
-      if (!audio_io->open(AudioIO::MODE_WR))
+      Ddr *ddr = dynamic_cast<Ddr*>(ch.rx);
+      if (ddr == 0)
       {
-        cerr << "*** WARNING: Could not open audio output device \""
-          << audio_dev << "\"\n";
+        cerr << "*** ERROR: An rtl-sdr receiver is needed to measure "
+                "deviation\n";
+        exit(1);
       }
-      else
+      if (wb_mode)
+      {
+        ddr->setModulation(Modulation::MOD_WBFM);
+      }
+      DevMeasure *dev_measure = new DevMeasure(ddr->preDemodSampleRate(),
+                                               mod_fqs, ddr->nbFq(), use_fft);
+      ddr->preDemod.connect(
+          mem_fun(dev_measure, &DevMeasure::processPreDemod));
+      ch.dp = &dev_measure->printer();
+      ch.dp->setPrintEnabled(batch_time == 0);
+
+      if ((batch_time == 0) && (audio_dev[0] != '\0'))
       {
-        prev_src->registerSink(audio_io);
-        rx->setMuteState(Rx::MUTE_NONE);
+        audio_io = new AudioIO(audio_dev, audio_ch);
+        if (!audio_io->open(AudioIO::MODE_WR))
+        {
+          cerr << "*** WARNING: Could not open audio output device \""
+            << audio_dev << "\"\n";
+        }
+        else
+        {
+          prev_src->registerSink(audio_io);
+          ch.rx->setMuteState(Rx::MUTE_NONE);
+        }
       }
+      channels.push_back(ch);
     }
   }
 
+  Timer *batch_timer = 0;
+  if (batch_time > 0)
+  {
+    cout << "--- Measuring for " << batch_time << " seconds\n";
+    batch_timer = new Timer(1000 * batch_time);
+    batch_timer->expired.connect(
+        sigc::hide(mem_fun(Application::app(), &Application::quit)));
+  }
+
   cout << "--- Use Q or Ctrl+C to quit\n\n";
 
   struct termios org_termios;
@@ -676,6 +797,9 @@ int main(int argc, const char *argv[])
 
   app.exec();
 
+  delete batch_timer;
+  print_results();
+
   if (audio_io != 0)
   {
     audio_io->close();
@@ -683,7 +807,12 @@ int main(int argc, const char *argv[])
   }
   delete gen;
   delete tx;
-  delete rx;
+  for (vector<Channel>::iterator it = channels.begin();
+       it != channels.end();
+       ++it)
+  {
+    delete it->rx;
+  }
 
   delete stdin_watch;
   tcsetattr(STDIN_FILENO, TCSANOW, &org_termios);
@@ -741,6 +870,13 @@ static void parse_arguments(int argc, const char **argv)
             "Flat TX/RX frequency response (no emphasis)", NULL},
     {"measure", 'M', POPT_ARG_NONE, &measure, 0, "Measure deviation", NULL},
     {"wide", 'w', POPT_ARG_NONE, &wb_mode, 0, "Wideband mode", NULL},
+    {"spectrum", 'S', POPT_ARG_NONE, &use_fft, 0,
+            "Use FFT (Welch PSD) based tone measurement", NULL},
+    {"batch", 'b', POPT_ARG_INT, &batch_time, 0,
+            "Measure non-interactively for the given time, then print the "
+            "results and exit", "<seconds>"},
+    {"json", 'j', POPT_ARG_NONE, &json_output, 0,
+            "Print the results in JSON format on exit", NULL},
     {"audiodev", 'a', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
             &audio_dev, 0,
 	    "The audio device to use for audio output",
@@ -826,6 +962,26 @@ static void parse_arguments(int argc, const char **argv)
     exit(1);
   }
 
+  if (batch_time < 0)
+  {
+    cerr << "*** ERROR: The batch time must be a positive number\n";
+    exit(1);
+  }
+  if ((batch_time > 0) && cal_tx)
+  {
+    cerr << "*** ERROR: Batch mode cannot be used for transmitter "
+            "calibration\n";
+    exit(1);
+  }
+
+  SvxLink::splitStr(cfgsects, cfgsect, ",");
+  if ((cfgsects.size() > 1) && (batch_time == 0))
+  {
+    cerr << "*** ERROR: Multiple config sections can only be given in "
+            "batch mode\n";
+    exit(1);
+  }
+
   poptFreeContext(optCon);
 
 } /* parse_arguments */
@@ -953,6 +1109,100 @@ static void sigterm_handler(int signal)
 } /* sigterm_handler */
 
 
+static void print_results(void)
+{
+  if (json_output)
+  {
+    Json::Value results(Json::objectValue);
+    results["mode"] = cal_tx ? "txcal" : (cal_rx ? "rxcal" : "measure");
+    results["method"] = use_fft ? "fft" : "goertzel";
+    Json::Value fqs(Json::arrayValue);
+    for (size_t i=0; i<mod_fqs.size(); ++i)
+    {
+      fqs.append(mod_fqs[i]);
+    }
+    results["modfqs"] = fqs;
+    results["caldev"] = caldev;
+    results["maxdev"] = maxdev;
+    results["headroom"] = headroom_db;
+    if (cal_tx)
+    {
+      results["section"] = cfgsect;
+      results["master_gain"] = gen->levelAdjust() + level_adjust_offset;
+    }
+    Json::Value chs(Json::arrayValue);
+    for (vector<Channel>::const_iterator it = channels.begin();
+         it != channels.end();
+         ++it)
+    {
+      Json::Value ch(Json::objectValue);
+      ch["section"] = it->section;
+      ch["tone_dev"] = it->dp->toneDev();
+      ch["full_bw_dev"] = it->dp->fullBwDev();
+      ch["carrier_fq_err"] = it->dp->carrierFqErr();
+      if (cal_rx)
+      {
+        double preamp = channel_preamp(*it);
+        ch["preamp"] = preamp;
+        if (it->dp->toneDev() > 0.0)
+        {
+          ch["suggested_preamp"] =
+            preamp + 20.0 * log10(caldev / it->dp->toneDev());
+        }
+      }
+      else if (it->dp->carrierFq() > 0.0)
+      {
+        ch["carrier_fq"] = it->dp->carrierFq();
+        ch["carrier_fq_err_ppm"] =
+          1000000.0 * it->dp->carrierFqErr() / it->dp->carrierFq();
+      }
+      chs.append(ch);
+    }
+    results["channels"] = chs;
+
+    Json::StreamWriterBuilder builder;
+    builder["commentStyle"] = "None";
+    builder["indentation"] = "  ";
+    Json::StreamWriter* writer = builder.newStreamWriter();
+    cout << endl;
+    writer->write(results, &cout);
+    cout << endl;
+    delete writer;
+  }
+  else if (batch_time > 0)
+  {
+    cout << "\n--- Results\n";
+    for (vector<Channel>::const_iterator it = channels.begin();
+         it != channels.end();
+         ++it)
+    {
+      cout << it->section << ": Tone dev=" << it->dp->toneDev()
+           << "  Full bw dev=" << it->dp->fullBwDev()
+           << "  Carrier freq err=" << it->dp->carrierFqErr();
+      if (cal_rx && (it->dp->toneDev() > 0.0))
+      {
+        double preamp = channel_preamp(*it);
+        cout << "  Suggested PREAMP="
+             << (preamp + 20.0 * log10(caldev / it->dp->toneDev()));
+      }
+      cout << endl;
+    }
+  }
+} /* print_results */
+
+
+static double channel_preamp(const Channel& ch)
+{
+    // The channel calibrated interactively is adjusted through the global
+    // DevPrinter and level offset by the stdin handler
+  if (ch.dp == dp)
+  {
+    return dp->levelAdjust() + level_adjust_offset;
+  }
+  return ch.dp->levelAdjust() + ch.level_adjust_offset;
+} /* channel_preamp */
+
+
 /*
  * This file has not been truncated
  */
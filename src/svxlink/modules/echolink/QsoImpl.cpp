@@ -192,7 +192,7 @@ QsoImpl::QsoImpl(const StationData &station, ModuleEchoLink *module)
     idle_timer->expired.connect(mem_fun(*this, &QsoImpl::idleTimeoutCheck));
   }
   
-  sink_handler = new AudioPassthrough;
+  sink_handler = new AudioPassthrough(true);
   AudioSink::setHandler(sink_handler);
 
   msg_handler = new MsgHandler(INTERNAL_SAMPLE_RATE);
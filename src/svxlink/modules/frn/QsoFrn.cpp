@@ -137,7 +137,7 @@ QsoFrn::QsoFrn(ModuleFrn *module)
   , state(STATE_DISCONNECTED)
   , connect_retry_cnt(0)
   , send_buffer_cnt(0)
-  , gsmh(gsm_create())
+  , codec(true)
   , lines_to_read(-1)
   , is_receiving_voice(false)
   , is_rf_disabled(false)
@@ -240,9 +240,6 @@ QsoFrn::QsoFrn(ModuleFrn *module)
     return;
   }
 
-  int gsm_one = 1;
-  assert(gsm_option(gsmh, GSM_OPT_WAV49, &gsm_one) != -1);
-
   tcp_client->connected.connect(
       mem_fun(*this, &QsoFrn::onConnected));
   tcp_client->disconnected.connect(
@@ -295,9 +292,6 @@ QsoFrn::~QsoFrn(void)
 
   delete keepalive_timer;
   keepalive_timer = 0;
-
-  gsm_destroy(gsmh);
-  gsmh = 0;
 }
 
 
@@ -386,16 +380,10 @@ int QsoFrn::writeSamples(const float *samples, int count)
   while (samples_read < count)
   {
     int read_cnt = min(BUFFER_SIZE - send_buffer_cnt, count-samples_read);
-    for (int i = 0; i < read_cnt; i++)
-    {
-      float sample = samples[samples_read++];
-      if (sample > 1)
-        send_buffer[send_buffer_cnt++] = 32767;
-      else if (sample < -1)
-        send_buffer[send_buffer_cnt++] = -32767;
-      else
-        send_buffer[send_buffer_cnt++] = static_cast<int16_t>(32767.0 * sample);
-    }
+    memcpy(send_buffer + send_buffer_cnt, samples + samples_read,
+           read_cnt * sizeof(*samples));
+    samples_read += read_cnt;
+    send_buffer_cnt += read_cnt;
     if (send_buffer_cnt == BUFFER_SIZE)
     {
       if (state == STATE_TX_AUDIO)
@@ -505,24 +493,15 @@ void QsoFrn::login(void)
   tcp_client->write(req.c_str(), req.length());
 }
 
-void QsoFrn::sendVoiceData(short *data, int len)
+void QsoFrn::sendVoiceData(const float *data, int len)
 {
   assert(len == BUFFER_SIZE);
 
-  size_t nbytes = 0;
-  unsigned char gsm_data[FRN_AUDIO_PACKET_SIZE];
-
-  for (int nframe = 0; nframe < FRAME_COUNT; nframe++)
-  {
-    short * src = data + nframe * PCM_FRAME_SIZE;
-    unsigned char * dst = gsm_data + nframe * GSM_FRAME_SIZE;
-
     // GSM_OPT_WAV49, produce alternating frames 32, 33, 32, 33, ..
-    gsm_encode(gsmh, src, dst);
-    gsm_encode(gsmh, src + PCM_FRAME_SIZE / 2, dst + 32);
-
-    nbytes += GSM_FRAME_SIZE;
-  }
+  unsigned char gsm_data[FRN_AUDIO_PACKET_SIZE];
+  int ret = codec.encode(data, CODEC_FRAME_COUNT, gsm_data, sizeof(gsm_data));
+  assert(ret == FRN_AUDIO_PACKET_SIZE);
+  size_t nbytes = ret;
   sendRequest(RQ_TX1);
   size_t written = tcp_client->write(gsm_data, nbytes);
   if (written != nbytes)
@@ -602,8 +581,6 @@ void QsoFrn::sendRequest(Request rq)
 int QsoFrn::handleAudioData(unsigned char *data, int len)
 {
   unsigned char *gsm_data = data + CLIENT_INDEX_SIZE;
-  short *pcm_buffer = receive_buffer;
-  float pcm_samples[PCM_FRAME_SIZE];
 
   if (len < FRN_AUDIO_PACKET_SIZE + CLIENT_INDEX_SIZE)
     return 0;
@@ -618,25 +595,19 @@ int QsoFrn::handleAudioData(unsigned char *data, int len)
 
   if (!is_rf_disabled)
   {
-    for (int frameno = 0; frameno < FRAME_COUNT; frameno++)
+    // GSM_OPT_WAV49, consume alternating frames of size 33, 32, 33, 32, ..
+    int decoded_cnt = codec.decode(gsm_data, FRN_AUDIO_PACKET_SIZE,
+                                   CODEC_FRAME_COUNT, receive_buffer);
+    if (decoded_cnt != CODEC_FRAME_COUNT)
     {
-      unsigned char *src = gsm_data + frameno * GSM_FRAME_SIZE;
-      short *dst = pcm_buffer;
-      bool is_gsm_decode_success = true;
-
-      // GSM_OPT_WAV49, consume alternating frames of size 33, 32, 33, 32, ..
-      if (gsm_decode(gsmh, src, dst) == -1)
-        is_gsm_decode_success = false;
-
-      if (gsm_decode(gsmh, src + 33, dst + PCM_FRAME_SIZE / 2) == -1)
-        is_gsm_decode_success = false;
-
-      if (!is_gsm_decode_success)
-        cerr << "gsm decoder failed to decode frame " << frameno << endl;
-
-      for (int i = 0; i < PCM_FRAME_SIZE; i++)
-         pcm_samples[i] = static_cast<float>(pcm_buffer[i]) / 32768.0;
+      cerr << "gsm decoder failed to decode "
+           << (CODEC_FRAME_COUNT - decoded_cnt) << " of "
+           << CODEC_FRAME_COUNT << " frames" << endl;
+    }
 
+    for (int frameno = 0; frameno < FRAME_COUNT; frameno++)
+    {
+      float *pcm_samples = receive_buffer + frameno * PCM_FRAME_SIZE;
       int all_written = 0;
       while (all_written < PCM_FRAME_SIZE)
       {
@@ -650,7 +621,6 @@ int QsoFrn::handleAudioData(unsigned char *data, int len)
         }
         all_written += written;
       }
-      pcm_buffer += PCM_FRAME_SIZE;
     }
   }
   setState(STATE_IDLE);
@@ -46,13 +46,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  * Project Includes
  *
  ****************************************************************************/
-extern "C" {
-#include <gsm.h>
-}
-
 #include <AsyncAudioSink.h>
 #include <AsyncAudioSource.h>
 #include <AsyncTcpClient.h>
+#include <AsyncAudioFrameCodecGsm.h>
 #include <CppStdCompat.h>
 
 
@@ -380,7 +377,7 @@ class QsoFrn
      * @param Pcm buffer with samples
      * @param Size of buffer
      */
-    void sendVoiceData(short *data, int len);
+    void sendVoiceData(const float *data, int len);
 
     /**
      * @brief Sends FRN client request to the server
@@ -528,6 +525,7 @@ class QsoFrn
     static const int        GSM_FRAME_SIZE          = 65;     // WAV49 has 65
     static const int        BUFFER_SIZE             = FRAME_COUNT*PCM_FRAME_SIZE;
     static const int        FRN_AUDIO_PACKET_SIZE   = FRAME_COUNT*GSM_FRAME_SIZE;
+    static const int        CODEC_FRAME_COUNT       = 2*FRAME_COUNT;
 
     static const int        CON_TIMEOUT_TIME        = 30000;
     static const int        RX_TIMEOUT_TIME         = 1000;
@@ -547,10 +545,10 @@ class QsoFrn
     Async::Timer *      reconnect_timer;
     State               state;
     int                 connect_retry_cnt;
-    short               receive_buffer[BUFFER_SIZE];
-    short               send_buffer[BUFFER_SIZE];
+    float               receive_buffer[BUFFER_SIZE];
+    float               send_buffer[BUFFER_SIZE];
     int                 send_buffer_cnt;
-    gsm                 gsmh;
+    Async::AudioFrameCodecGsm codec;
     int                 lines_to_read;
     FrnList             cur_item_list;
     FrnList             client_list;
@@ -204,6 +204,7 @@ bool ModuleParrot::initialize(void)
   AudioSink::setHandler(adapter);
   
   fifo = new AudioFifo(atoi(fifo_len.c_str())*INTERNAL_SAMPLE_RATE);
+  fifo->setName(name() + "/Fifo");
   fifo->setOverwrite(true);
   adapter->registerSink(fifo, true);
   
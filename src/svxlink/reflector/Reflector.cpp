@@ -30,7 +30,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <sys/socket.h>
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <random>
 #include <json/json.h>
 
 
@@ -56,6 +65,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Reflector.h"
 #include "ReflectorClient.h"
 #include "TGHandler.h"
+#include "TGMixer.h"
 
 
 /****************************************************************************
@@ -122,13 +132,31 @@ namespace {
  ****************************************************************************/
 
 Reflector::Reflector(void)
-  : m_srv(0), m_udp_sock(0), m_tg_for_v1_clients(1), m_random_qsy_lo(0),
-    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0)
+  : m_srv(0), m_tg_for_v1_clients(1), m_random_qsy_lo(0),
+    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0),
+    m_accept_rate(DEFAULT_ACCEPT_RATE),
+    m_accept_queue_size(DEFAULT_ACCEPT_QUEUE_SIZE),
+    m_accept_tokens(DEFAULT_ACCEPT_RATE),
+    m_accept_timer(ACCEPT_TICK_TIME, Timer::TYPE_PERIODIC, false),
+    m_node_joined_timer(NODE_JOINED_BATCH_TIME, Timer::TYPE_ONESHOT, false),
+    m_node_list_epoch(0), m_node_list_version(0)
 {
+    // A new epoch on each start make clients holding a node list from an
+    // earlier reflector instance ask for the full list
+  std::random_device rd;
+  while (m_node_list_epoch == 0)
+  {
+    m_node_list_epoch = rd();
+  }
+
   TGHandler::instance()->talkerUpdated.connect(
       mem_fun(*this, &Reflector::onTalkerUpdated));
   TGHandler::instance()->requestAutoQsy.connect(
       mem_fun(*this, &Reflector::onRequestAutoQsy));
+  m_accept_timer.expired.connect(
+      mem_fun(*this, &Reflector::onAcceptTick));
+  m_node_joined_timer.expired.connect(
+      mem_fun(*this, &Reflector::flushNodeJoined));
 } /* Reflector::Reflector */
 
 
@@ -136,11 +164,20 @@ Reflector::~Reflector(void)
 {
   delete m_http_server;
   m_http_server = 0;
-  delete m_udp_sock;
-  m_udp_sock = 0;
+  for (auto& sock : m_udp_socks)
+  {
+    delete sock;
+  }
+  m_udp_socks.clear();
+  m_accept_queue.clear();
   delete m_srv;
   m_srv = 0;
   m_client_con_map.clear();
+  for (MixerMap::iterator it=m_mixers.begin(); it!=m_mixers.end(); ++it)
+  {
+    delete it->second;
+  }
+  m_mixers.clear();
   ReflectorClient::cleanup();
   delete TGHandler::instance();
 } /* Reflector::~Reflector */
@@ -173,6 +210,10 @@ bool Reflector::initialize(Async::Config &cfg)
     }
   }
 
+  cfg.getValue("GLOBAL", "ACCEPT_RATE", m_accept_rate);
+  m_accept_tokens = m_accept_rate;
+  cfg.getValue("GLOBAL", "ACCEPT_QUEUE_SIZE", m_accept_queue_size);
+
   std::string listen_port("5300");
   cfg.getValue("GLOBAL", "LISTEN_PORT", listen_port);
   m_srv = new TcpServer<FramedTcpConnection>(listen_port);
@@ -183,14 +224,10 @@ bool Reflector::initialize(Async::Config &cfg)
 
   uint16_t udp_listen_port = 5300;
   cfg.getValue("GLOBAL", "LISTEN_PORT", udp_listen_port);
-  m_udp_sock = new UdpSocket(udp_listen_port);
-  if ((m_udp_sock == 0) || !m_udp_sock->initOk())
+  if (!initUdpSockets(udp_listen_port))
   {
-    cerr << "*** ERROR: Could not initialize UDP socket" << endl;
     return false;
   }
-  m_udp_sock->dataReceived.connect(
-      mem_fun(*this, &Reflector::udpDatagramReceived));
 
   unsigned sql_timeout = 0;
   cfg.getValue("GLOBAL", "SQL_TIMEOUT", sql_timeout);
@@ -232,28 +269,76 @@ bool Reflector::initialize(Async::Config &cfg)
 
 void Reflector::nodeList(std::vector<std::string>& nodes) const
 {
-  nodes.clear();
-  for (const auto& item : m_client_con_map)
+  nodes.assign(m_announced_nodes.begin(), m_announced_nodes.end());
+  nodes.insert(nodes.end(), m_joined_nodes.begin(), m_joined_nodes.end());
+} /* Reflector::nodeList */
+
+
+bool Reflector::nodeIsLoggedIn(const std::string& callsign) const
+{
+  return (m_announced_nodes.count(callsign) > 0) ||
+         (std::find(m_joined_nodes.begin(), m_joined_nodes.end(), callsign) !=
+          m_joined_nodes.end());
+} /* Reflector::nodeIsLoggedIn */
+
+
+void Reflector::nodeLoggedIn(ReflectorClient *client)
+{
+  m_joined_nodes.push_back(client->callsign());
+  if (!m_node_joined_timer.isEnabled())
   {
-    const std::string& callsign = item.second->callsign();
-    if (!callsign.empty())
+    m_node_joined_timer.setEnable(true);
+  }
+} /* Reflector::nodeLoggedIn */
+
+
+void Reflector::nodeListUpdate(uint32_t epoch, uint32_t version,
+                               MsgNodeListUpdate& msg) const
+{
+  uint32_t change_cnt = m_node_list_version - version;
+  if ((epoch == m_node_list_epoch) && (version <= m_node_list_version) &&
+      (change_cnt <= m_node_list_changes.size()) &&
+      (change_cnt < m_announced_nodes.size()))
+  {
+    msg = MsgNodeListUpdate(m_node_list_epoch, version, m_node_list_version);
+    msg.records().reserve(change_cnt);
+    for (auto it=m_node_list_changes.end()-change_cnt;
+         it!=m_node_list_changes.end(); ++it)
     {
-      nodes.push_back(callsign);
+      msg.pushBack(MsgNodeListUpdate::Record(
+            it->joined ? MsgNodeListUpdate::Record::OP_JOINED
+                       : MsgNodeListUpdate::Record::OP_LEFT,
+            it->callsign));
     }
+    return;
   }
-} /* Reflector::nodeList */
+
+  msg = MsgNodeListUpdate(m_node_list_epoch, 0, m_node_list_version, true);
+  msg.records().reserve(m_announced_nodes.size());
+  for (const auto& callsign : m_announced_nodes)
+  {
+    msg.pushBack(MsgNodeListUpdate::Record(
+          MsgNodeListUpdate::Record::OP_JOINED, callsign));
+  }
+} /* Reflector::nodeListUpdate */
 
 
 void Reflector::broadcastMsg(const ReflectorMsg& msg,
                              const ReflectorClient::Filter& filter)
 {
+  std::string packed;
+  if (!ReflectorClient::packMsg(msg, packed))
+  {
+    cerr << "*** ERROR: Failed to pack TCP message\n";
+    return;
+  }
   for (const auto& item : m_client_con_map)
   {
     ReflectorClient *client = item.second;
     if (filter(client) &&
         (client->conState() == ReflectorClient::STATE_CONNECTED))
     {
-      client->sendMsg(msg);
+      client->sendPackedMsg(msg.type(), packed);
     }
   }
 } /* Reflector::broadcastMsg */
@@ -262,8 +347,13 @@ void Reflector::broadcastMsg(const ReflectorMsg& msg,
 bool Reflector::sendUdpDatagram(ReflectorClient *client, const void *buf,
                                 size_t count)
 {
-  return m_udp_sock->write(client->remoteHost(), client->remoteUdpPort(), buf,
-                           count);
+  UdpSocket *sock = client->udpSocket();
+  if (sock == 0)
+  {
+    return false;
+  }
+  return sock->write(client->remoteHost(), client->remoteUdpPort(), buf,
+                     count);
 } /* Reflector::sendUdpDatagram */
 
 
@@ -282,6 +372,21 @@ void Reflector::broadcastUdpMsg(const ReflectorUdpMsg& msg,
 } /* Reflector::broadcastUdpMsg */
 
 
+void Reflector::broadcastUdpAudio(const void *buf, int count,
+                                  const ReflectorClient::Filter& filter)
+{
+  for (const auto& item : m_client_con_map)
+  {
+    ReflectorClient *client = item.second;
+    if (filter(client) &&
+        (client->conState() == ReflectorClient::STATE_CONNECTED))
+    {
+      client->sendUdpAudio(buf, count);
+    }
+  }
+} /* Reflector::broadcastUdpAudio */
+
+
 void Reflector::requestQsy(ReflectorClient *client, uint32_t tg)
 {
   uint32_t current_tg = TGHandler::instance()->TGForClient(client);
@@ -326,18 +431,200 @@ void Reflector::clientConnected(Async::FramedTcpConnection *con)
 {
   cout << "Client " << con->remoteHost() << ":" << con->remotePort()
        << " connected" << endl;
-  m_client_con_map[con] = new ReflectorClient(this, con, m_cfg);
+
+  if (m_accept_rate == 0)
+  {
+    admitClient(con);
+    return;
+  }
+
+  if (m_accept_queue.empty() && (m_accept_tokens >= 1.0f))
+  {
+    m_accept_tokens -= 1.0f;
+    m_accept_timer.setEnable(true);
+    admitClient(con);
+    return;
+  }
+
+  if (m_accept_queue.size() >= m_accept_queue_size)
+  {
+    cout << "*** WARNING: The accept queue is full. Rejecting client "
+         << con->remoteHost() << ":" << con->remotePort() << endl;
+    con->disconnect();
+    Application::app().runTask([=]{
+        con->disconnected(con, FramedTcpConnection::DR_ORDERED_DISCONNECT);
+      });
+    return;
+  }
+
+    // Buffer the frames received before the client is admitted, typically
+    // the protocol version message, so that they can be handled later
+  con->setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
+  PendingCon pending;
+  pending.con = con;
+  pending.heartbeat_tx_cnt = ACCEPT_HEARTBEAT_TICKS;
+  pending.frame_received_con = con->frameReceived.connect(
+      mem_fun(*this, &Reflector::pendingFrameReceived));
+  m_accept_queue.push_back(pending);
+  m_accept_timer.setEnable(true);
 } /* Reflector::clientConnected */
 
 
+void Reflector::admitClient(Async::FramedTcpConnection *con)
+{
+  m_client_con_map[con] = new ReflectorClient(this, con, m_cfg);
+} /* Reflector::admitClient */
+
+
+void Reflector::pendingFrameReceived(Async::FramedTcpConnection *con,
+                                     std::vector<uint8_t>& data)
+{
+  for (auto& pending : m_accept_queue)
+  {
+    if (pending.con == con)
+    {
+      if (pending.frames.size() < MAX_PENDING_FRAMES)
+      {
+        pending.frames.push_back(data);
+      }
+      return;
+    }
+  }
+} /* Reflector::pendingFrameReceived */
+
+
+void Reflector::onAcceptTick(Async::Timer *t)
+{
+  m_accept_tokens = std::min(static_cast<float>(m_accept_rate),
+      m_accept_tokens + m_accept_rate * ACCEPT_TICK_TIME / 1000.0f);
+
+  while (!m_accept_queue.empty() && (m_accept_tokens >= 1.0f))
+  {
+    PendingCon pending = m_accept_queue.front();
+    m_accept_queue.pop_front();
+    m_accept_tokens -= 1.0f;
+    pending.frame_received_con.disconnect();
+    admitClient(pending.con);
+    for (auto& frame : pending.frames)
+    {
+      if (m_client_con_map.find(pending.con) == m_client_con_map.end())
+      {
+        break;
+      }
+      pending.con->frameReceived(pending.con, frame);
+    }
+  }
+
+    // Keep the connections waiting in the queue alive. The client will
+    // otherwise time out before it has been admitted.
+  for (auto& pending : m_accept_queue)
+  {
+    if (--pending.heartbeat_tx_cnt == 0)
+    {
+      pending.heartbeat_tx_cnt = ACCEPT_HEARTBEAT_TICKS;
+      std::string packed;
+      if (ReflectorClient::packMsg(MsgHeartbeat(), packed))
+      {
+        pending.con->write(packed.data(), packed.size());
+      }
+    }
+  }
+
+  if (m_accept_queue.empty() && (m_accept_tokens >= m_accept_rate))
+  {
+    m_accept_timer.setEnable(false);
+  }
+} /* Reflector::onAcceptTick */
+
+
+void Reflector::flushNodeJoined(Async::Timer *t)
+{
+  m_node_joined_timer.setEnable(false);
+  if (m_joined_nodes.empty())
+  {
+    return;
+  }
+
+  std::vector<std::string> packed(m_joined_nodes.size());
+  for (size_t i=0; i<m_joined_nodes.size(); ++i)
+  {
+    ReflectorClient::packMsg(MsgNodeJoined(m_joined_nodes[i]), packed[i]);
+  }
+  for (const auto& item : m_client_con_map)
+  {
+    ReflectorClient *client = item.second;
+    if ((client->conState() != ReflectorClient::STATE_CONNECTED) ||
+        client->nodeListSync())
+    {
+      continue;
+    }
+      // A node that joined in this batch already got the nodes that
+      // joined before it, and itself, in the node list sent at login
+    auto jit = std::find(m_joined_nodes.begin(), m_joined_nodes.end(),
+                         client->callsign());
+    size_t first = (jit != m_joined_nodes.end())
+      ? (jit - m_joined_nodes.begin()) + 1 : 0;
+    for (size_t i=first; i<m_joined_nodes.size(); ++i)
+    {
+      client->sendPackedMsg(MsgNodeJoined::TYPE, packed[i]);
+    }
+  }
+  publishNodeListChanges(m_joined_nodes, true);
+  m_announced_nodes.insert(m_joined_nodes.begin(), m_joined_nodes.end());
+  m_joined_nodes.clear();
+} /* Reflector::flushNodeJoined */
+
+
+void Reflector::publishNodeListChanges(
+    const std::vector<std::string>& callsigns, bool joined)
+{
+  for (const auto& callsign : callsigns)
+  {
+    m_node_list_changes.push_back(NodeListChange{joined, callsign});
+  }
+  m_node_list_version += callsigns.size();
+  while (m_node_list_changes.size() > NODE_LIST_HISTORY_SIZE)
+  {
+    m_node_list_changes.pop_front();
+  }
+
+    // Each client build its own update, merging all changes not yet sent
+  for (const auto& item : m_client_con_map)
+  {
+    item.second->nodeListChanged();
+  }
+} /* Reflector::publishNodeListChanges */
+
+
 void Reflector::clientDisconnected(Async::FramedTcpConnection *con,
                            Async::FramedTcpConnection::DisconnectReason reason)
 {
+  for (auto pit=m_accept_queue.begin(); pit!=m_accept_queue.end(); ++pit)
+  {
+    if (pit->con == con)
+    {
+      cout << "Client " << con->remoteHost() << ":" << con->remotePort()
+           << " disconnected while waiting in the accept queue: "
+           << TcpConnection::disconnectReasonStr(reason) << endl;
+      pit->frame_received_con.disconnect();
+      m_accept_queue.erase(pit);
+      return;
+    }
+  }
+
   ReflectorClientConMap::iterator it = m_client_con_map.find(con);
-  assert(it != m_client_con_map.end());
+  if (it == m_client_con_map.end())
+  {
+      // A client rejected because of a full accept queue
+    return;
+  }
   ReflectorClient *client = (*it).second;
 
   TGHandler::instance()->removeClient(client);
+  for (MixerMap::iterator it=m_mixers.begin(); it!=m_mixers.end(); ++it)
+  {
+    it->second->removeClient(client);
+  }
 
   if (!client->callsign().empty())
   {
@@ -354,15 +641,130 @@ void Reflector::clientDisconnected(Async::FramedTcpConnection *con,
 
   if (!client->callsign().empty())
   {
-    broadcastMsg(MsgNodeLeft(client->callsign()),
-        ReflectorClient::ExceptFilter(client));
+      // A node not yet announced to the other nodes is only known by the
+      // legacy nodes that joined after it in the same batch. They got it
+      // in the node list sent at login.
+    auto jit = std::find(m_joined_nodes.begin(), m_joined_nodes.end(),
+                         client->callsign());
+    if (jit != m_joined_nodes.end())
+    {
+      const std::set<std::string> later_nodes(jit + 1, m_joined_nodes.end());
+      m_joined_nodes.erase(jit);
+      if (!later_nodes.empty())
+      {
+        std::string packed;
+        ReflectorClient::packMsg(MsgNodeLeft(client->callsign()), packed);
+        for (const auto& item : m_client_con_map)
+        {
+          ReflectorClient *other = item.second;
+          if ((other->conState() == ReflectorClient::STATE_CONNECTED) &&
+              !other->nodeListSync() &&
+              (later_nodes.count(other->callsign()) > 0))
+          {
+            other->sendPackedMsg(MsgNodeLeft::TYPE, packed);
+          }
+        }
+      }
+    }
+    else if (m_announced_nodes.erase(client->callsign()) > 0)
+    {
+      broadcastMsg(MsgNodeLeft(client->callsign()),
+          ReflectorClient::mkAndFilter(
+            ReflectorClient::ExceptFilter(client),
+            ReflectorClient::NodeListSyncFilter(false)));
+      publishNodeListChanges(std::vector<std::string>(1, client->callsign()),
+                             false);
+    }
   }
   Application::app().runTask([=]{ delete client; });
 } /* Reflector::clientDisconnected */
 
 
+bool Reflector::initUdpSockets(uint16_t port)
+{
+  std::vector<std::string> bind_addrs;
+  m_cfg->getValue("GLOBAL", "UDP_LISTEN_ADDR", bind_addrs);
+  if (bind_addrs.empty())
+  {
+    bind_addrs.push_back("");
+  }
+
+  unsigned sock_cnt = 1;
+  if (!m_cfg->getValue("GLOBAL", "UDP_SOCKETS", 1U, 64U, sock_cnt, true))
+  {
+    cerr << "*** ERROR: Illegal value for configuration variable "
+            "GLOBAL/UDP_SOCKETS. Valid range is 1 to 64." << endl;
+    return false;
+  }
+
+  for (const auto& bind_addr_str : bind_addrs)
+  {
+    IpAddress bind_addr;
+    if (!bind_addr_str.empty())
+    {
+      bind_addr = IpAddress(bind_addr_str);
+      if (bind_addr.isEmpty())
+      {
+        cerr << "*** ERROR: Illegal IP address \"" << bind_addr_str
+             << "\" in configuration variable GLOBAL/UDP_LISTEN_ADDR"
+             << endl;
+        return false;
+      }
+    }
+
+      // More than one socket per address share the port using SO_REUSEPORT
+      // so that the kernel can spread the receive processing over more
+      // receive queues and CPU cores
+    for (unsigned i=0; i<sock_cnt; ++i)
+    {
+      UdpSocket *sock = new UdpSocket(port, bind_addr, sock_cnt > 1);
+      if (!sock->initOk())
+      {
+        cerr << "*** ERROR: Could not initialize UDP socket";
+        if (!bind_addr.isEmpty())
+        {
+          cerr << " for address " << bind_addr;
+        }
+        cerr << endl;
+        delete sock;
+        return false;
+      }
+      sock->dataReceived.connect(
+          sigc::bind(mem_fun(*this, &Reflector::udpDatagramReceived), sock));
+      m_udp_socks.push_back(sock);
+    }
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+      // Steer incoming datagrams to a socket based on the client id in the
+      // message header so that the load is evenly spread and all packets
+      // from one client is received on the same socket. A datagram too short
+      // to contain a header end up on the first socket.
+    if (sock_cnt > 1)
+    {
+      struct sock_filter code[] = {
+        { BPF_LD  | BPF_H   | BPF_ABS, 0, 0, 2 },         // A = client id
+        { BPF_ALU | BPF_MOD | BPF_K,   0, 0, sock_cnt },  // A = A % sock_cnt
+        { BPF_RET | BPF_A,             0, 0, 0 }          // return A
+      };
+      struct sock_fprog prog = { sizeof(code) / sizeof(code[0]), code };
+      int fd = m_udp_socks[m_udp_socks.size() - sock_cnt]->fd();
+      if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                     sizeof(prog)) == -1)
+      {
+        cerr << "*** WARNING: Could not attach the UDP socket steering "
+                "program: " << strerror(errno) << ". Datagrams will be "
+                "distributed by the kernel default hash instead." << endl;
+      }
+    }
+#endif
+  }
+
+  return true;
+} /* Reflector::initUdpSockets */
+
+
 void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
-                                    void *buf, int count)
+                                    void *buf, int count, UdpSocket *sock)
 {
   stringstream ss;
   ss.write(reinterpret_cast<const char *>(buf), count);
@@ -389,12 +791,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
          << addr << " instead of " << client->remoteHost() << endl;
     return;
   }
-  if (client->remoteUdpPort() == 0)
-  {
-    client->setRemoteUdpPort(port);
-    client->sendUdpMsg(MsgUdpHeartbeat());
-  }
-  else if (port != client->remoteUdpPort())
+  if ((client->remoteUdpPort() != 0) && (port != client->remoteUdpPort()))
   {
     cerr << "*** WARNING[" << client->callsign()
          << "]: Incoming UDP packet has the wrong source UDP "
@@ -402,6 +799,14 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
          << client->remoteUdpPort() << endl;
     return;
   }
+    // Replies are sent through the socket the client is sending to so that
+    // they originate from the address and port that the client expect
+  client->setUdpSocket(sock);
+  if (client->remoteUdpPort() == 0)
+  {
+    client->setRemoteUdpPort(port);
+    client->sendUdpMsg(MsgUdpHeartbeat());
+  }
 
     // Check sequence number
   uint16_t udp_rx_seq_diff = header.sequenceNum() - client->nextUdpRxSeq();
@@ -438,29 +843,42 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
                << "]: Could not unpack incoming MsgUdpAudioV1 message" << endl;
           return;
         }
-        uint32_t tg = TGHandler::instance()->TGForClient(client);
-        if (!msg.audioData().empty() && (tg > 0))
+        handleUdpAudio(client, msg.audioData());
+      }
+      break;
+    }
+
+    case MsgUdpAudioFrames::TYPE:
+    {
+      if (!client->isBlocked())
+      {
+        MsgUdpAudioFrames msg;
+        if (!msg.unpack(ss))
         {
-          ReflectorClient* talker = TGHandler::instance()->talkerForTG(tg);
-          if (talker == 0)
-          {
-            TGHandler::instance()->setTalkerForTG(tg, client);
-            talker = TGHandler::instance()->talkerForTG(tg);
-          }
-          if (talker == client)
-          {
-            TGHandler::instance()->setTalkerForTG(tg, client);
-            broadcastUdpMsg(msg,
-                ReflectorClient::mkAndFilter(
-                  ReflectorClient::ExceptFilter(client),
-                  ReflectorClient::TgFilter(tg)));
-            //broadcastUdpMsgExcept(tg, client, msg,
-            //    ProtoVerRange(ProtoVer(0, 6),
-            //                  ProtoVer(1, ProtoVer::max().minor())));
-            //MsgUdpAudio msg_v2(msg);
-            //broadcastUdpMsgExcept(tg, client, msg_v2,
-            //    ProtoVerRange(ProtoVer(2, 0), ProtoVer::max()));
-          }
+          cerr << "*** WARNING[" << client->callsign()
+               << "]: Could not unpack incoming MsgUdpAudioFrames message"
+               << endl;
+          return;
+        }
+        if (!client->audioFramingNegotiated())
+        {
+          cerr << "*** WARNING[" << client->callsign()
+               << "]: Dropping MsgUdpAudioFrames message since audio "
+                  "framing has not been negotiated" << endl;
+          return;
+        }
+        if (msg.frameCount() > client->udpFramesPerPacket())
+        {
+          cerr << "*** WARNING[" << client->callsign()
+               << "]: Dropping MsgUdpAudioFrames message with "
+               << msg.frameCount() << " frames. The negotiated maximum is "
+               << client->udpFramesPerPacket() << " frame(s) per packet."
+               << endl;
+          return;
+        }
+        for (const auto& frame : msg.frames())
+        {
+          handleUdpAudio(client, frame);
         }
       }
       break;
@@ -504,6 +922,11 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
     {
       uint32_t tg = TGHandler::instance()->TGForClient(client);
       ReflectorClient* talker = TGHandler::instance()->talkerForTG(tg);
+      MixerMap::iterator mixer_it = m_mixers.find(tg);
+      if (mixer_it != m_mixers.end())
+      {
+        mixer_it->second->flushTalker(client);
+      }
       if ((tg > 0) && (client == talker))
       {
         TGHandler::instance()->setTalkerForTG(tg, 0);
@@ -565,6 +988,44 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
 } /* Reflector::udpDatagramReceived */
 
 
+void Reflector::handleUdpAudio(ReflectorClient *client,
+                               const std::vector<uint8_t>& frame)
+{
+  uint32_t tg = TGHandler::instance()->TGForClient(client);
+  if (frame.empty() || (tg == 0))
+  {
+    return;
+  }
+
+  ReflectorClient* talker = TGHandler::instance()->talkerForTG(tg);
+  TGMixer* mixer = mixerForTG(tg, client);
+  if (mixer != 0)
+  {
+      // In mixing mode the first talker is reported as the talker
+      // for the TG while the rest are only heard in the mix
+    if (mixer->writeAudio(client, frame) &&
+        ((talker == 0) || (talker == client)))
+    {
+      TGHandler::instance()->setTalkerForTG(tg, client);
+    }
+    return;
+  }
+  if (talker == 0)
+  {
+    TGHandler::instance()->setTalkerForTG(tg, client);
+    talker = TGHandler::instance()->talkerForTG(tg);
+  }
+  if (talker == client)
+  {
+    TGHandler::instance()->setTalkerForTG(tg, client);
+    broadcastUdpAudio(&frame.front(), frame.size(),
+        ReflectorClient::mkAndFilter(
+          ReflectorClient::ExceptFilter(client),
+          ReflectorClient::TgFilter(tg)));
+  }
+} /* Reflector::handleUdpAudio */
+
+
 void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
                                 ReflectorClient *new_talker)
 {
@@ -581,10 +1042,15 @@ void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
     {
       broadcastMsg(MsgTalkerStopV1(old_talker->callsign()), v1_client_filter);
     }
-    broadcastUdpMsg(MsgUdpFlushSamples(),
-          ReflectorClient::mkAndFilter(
-            ReflectorClient::TgFilter(tg),
-            ReflectorClient::ExceptFilter(old_talker)));
+      // When mixing, the mixer flush the audio stream when all talkers are
+      // done
+    if (TGHandler::instance()->mixTalkers(tg) == 0)
+    {
+      broadcastUdpMsg(MsgUdpFlushSamples(),
+            ReflectorClient::mkAndFilter(
+              ReflectorClient::TgFilter(tg),
+              ReflectorClient::ExceptFilter(old_talker)));
+    }
   }
   if (new_talker != 0)
   {
@@ -627,92 +1093,64 @@ void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
     return;
   }
 
-  Json::Value status;
-  status["nodes"] = Json::Value(Json::objectValue);
+    // The status document is assembled directly as text. The node
+    // information is stored pre-serialized in each client so no JSON trees
+    // need to be built per request.
+  std::vector<ReflectorClient*> clients;
+  clients.reserve(m_client_con_map.size());
   for (const auto& item : m_client_con_map)
   {
-    ReflectorClient* client = item.second;
-    Json::Value node(client->nodeInfo());
-    //node["addr"] = client->remoteHost().toString();
-    node["protoVer"]["majorVer"] = client->protoVer().majorVer();
-    node["protoVer"]["minorVer"] = client->protoVer().minorVer();
+    if (!item.second->callsign().empty())
+    {
+      clients.push_back(item.second);
+    }
+  }
+  std::sort(clients.begin(), clients.end(),
+      [](const ReflectorClient* a, const ReflectorClient* b)
+      {
+        return a->callsign() < b->callsign();
+      });
+
+  std::ostringstream os;
+  os << "{\"nodes\":{";
+  const char* node_sep = "";
+  for (ReflectorClient* client : clients)
+  {
     auto tg = client->currentTG();
     if (!TGHandler::instance()->showActivity(tg))
     {
       tg = 0;
     }
-    node["tg"] = tg;
-    node["restrictedTG"] = TGHandler::instance()->isRestricted(tg);
-    Json::Value tgs = Json::Value(Json::arrayValue);
-    const std::set<uint32_t>& monitored_tgs = client->monitoredTGs();
-    for (std::set<uint32_t>::const_iterator mtg_it=monitored_tgs.begin();
-         mtg_it!=monitored_tgs.end(); ++mtg_it)
+    bool is_talker = TGHandler::instance()->talkerForTG(tg) == client;
+    MixerMap::const_iterator mixer_it = m_mixers.find(tg);
+    if (mixer_it != m_mixers.end())
     {
-      tgs.append(*mtg_it);
+      is_talker = is_talker || mixer_it->second->isTalker(client);
     }
-    node["monitoredTGs"] = tgs;
-    bool is_talker = TGHandler::instance()->talkerForTG(tg) == client;
-    node["isTalker"] = is_talker;
 
-    if (node.isMember("qth") && node["qth"].isArray())
+    os << node_sep << Json::valueToQuotedString(client->callsign().c_str())
+       << ":{";
+    node_sep = ",";
+    if (client->writeNodeInfo(os))
     {
-      //std::cout << "### Found qth" << std::endl;
-      Json::Value& qths(node["qth"]);
-      for (Json::Value::ArrayIndex i=0; i<qths.size(); ++i)
-      {
-        Json::Value& qth(qths[i]);
-        if (qth.isMember("rx") && qth["rx"].isObject())
-        {
-          //std::cout << "### Found rx" << std::endl;
-          Json::Value::Members rxs(qth["rx"].getMemberNames());
-          for (Json::Value::Members::const_iterator it=rxs.begin(); it!=rxs.end(); ++it)
-          {
-            //std::cout << "### member=" << *it << std::endl;
-            const std::string& rx_id_str(*it);
-            if (rx_id_str.size() == 1)
-            {
-              char rx_id(rx_id_str[0]);
-              Json::Value& rx(qth["rx"][rx_id_str]);
-              if (client->rxExist(rx_id))
-              {
-                rx["siglev"] = client->rxSiglev(rx_id);
-                rx["enabled"] = client->rxEnabled(rx_id);
-                rx["sql_open"] = client->rxSqlOpen(rx_id);
-                rx["active"] = client->rxActive(rx_id);
-              }
-            }
-          }
-        }
-        if (qth.isMember("tx") && qth["tx"].isObject())
-        {
-          //std::cout << "### Found tx" << std::endl;
-          Json::Value::Members txs(qth["tx"].getMemberNames());
-          for (Json::Value::Members::const_iterator it=txs.begin(); it!=txs.end(); ++it)
-          {
-            //std::cout << "### member=" << *it << std::endl;
-            const std::string& tx_id_str(*it);
-            if (tx_id_str.size() == 1)
-            {
-              char tx_id(tx_id_str[0]);
-              Json::Value& tx(qth["tx"][tx_id_str]);
-              if (client->txExist(tx_id))
-              {
-                tx["transmit"] = client->txTransmit(tx_id);
-              }
-            }
-          }
-        }
-      }
+      os << ",";
+    }
+    //os << "\"addr\":\"" << client->remoteHost() << "\",";
+    os << "\"protoVer\":{\"majorVer\":" << client->protoVer().majorVer()
+       << ",\"minorVer\":" << client->protoVer().minorVer() << "}"
+       << ",\"tg\":" << tg
+       << ",\"restrictedTG\":"
+       << (TGHandler::instance()->isRestricted(tg) ? "true" : "false")
+       << ",\"monitoredTGs\":[";
+    const char* tg_sep = "";
+    for (uint32_t mtg : client->monitoredTGs())
+    {
+      os << tg_sep << mtg;
+      tg_sep = ",";
     }
-    status["nodes"][client->callsign()] = node;
+    os << "],\"isTalker\":" << (is_talker ? "true" : "false") << "}";
   }
-  std::ostringstream os;
-  Json::StreamWriterBuilder builder;
-  builder["commentStyle"] = "None";
-  builder["indentation"] = ""; //The JSON document is written on a single line
-  Json::StreamWriter* writer = builder.newStreamWriter();
-  writer->write(status, &os);
-  delete writer;
+  os << "}}";
   res.setContent("application/json", os.str());
   if (req.method == "HEAD")
   {
@@ -783,6 +1221,43 @@ uint32_t Reflector::nextRandomQsyTg(void)
 } /* Reflector::nextRandomQsyTg */
 
 
+TGMixer* Reflector::mixerForTG(uint32_t tg, ReflectorClient *client)
+{
+  MixerMap::iterator it = m_mixers.find(tg);
+  if (it != m_mixers.end())
+  {
+    return it->second;
+  }
+
+  unsigned mix_talkers = TGHandler::instance()->mixTalkers(tg);
+  if ((mix_talkers == 0) || client->supportedCodecs().empty())
+  {
+    return 0;
+  }
+  TGMixer *mixer = new TGMixer(this, *m_cfg, tg,
+                               client->supportedCodecs().front(),
+                               mix_talkers);
+  mixer->idle.connect(mem_fun(*this, &Reflector::onMixerIdle));
+  m_mixers[tg] = mixer;
+  return mixer;
+} /* Reflector::mixerForTG */
+
+
+void Reflector::onMixerIdle(TGMixer *mixer)
+{
+  uint32_t tg = mixer->tg();
+  Application::app().runTask([=]
+    {
+      MixerMap::iterator it = m_mixers.find(tg);
+      if ((it != m_mixers.end()) && (it->second->talkerCount() == 0))
+      {
+        delete it->second;
+        m_mixers.erase(it);
+      }
+    });
+} /* Reflector::onMixerIdle */
+
+
 /*
  * This file has not been truncated
  */
@@ -38,6 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 #include <vector>
 #include <string>
+#include <deque>
+#include <set>
 
 
 /****************************************************************************
@@ -76,6 +78,8 @@ namespace Async
 
 class ReflectorMsg;
 class ReflectorUdpMsg;
+class MsgNodeListUpdate;
+class TGMixer;
 
 
 /****************************************************************************
@@ -141,10 +145,42 @@ class Reflector : public sigc::trackable
      * @param   nodes The vector to return the result in
      *
      * This function is used to get a list of the callsigns of all connected
-     * nodes.
+     * nodes, including the ones that have logged in but not yet been
+     * announced to the other nodes.
      */
     void nodeList(std::vector<std::string>& nodes) const;
 
+    /**
+     * @brief   Check if a node with the given callsign is logged in
+     * @param   callsign The callsign to look for
+     * @return  Returns \em true if the node is logged in
+     */
+    bool nodeIsLoggedIn(const std::string& callsign) const;
+
+    /**
+     * @brief   Tell the reflector that a client has logged in
+     * @param   client The client that has logged in
+     *
+     * The other nodes are not notified immediately. Nodes logging in within
+     * NODE_JOINED_BATCH_TIME milliseconds are announced together, which keep
+     * the number of messages down when many nodes reconnect at the same time.
+     */
+    void nodeLoggedIn(ReflectorClient *client);
+
+    /**
+     * @brief   Get the node list changes since a given node list version
+     * @param   epoch The node list epoch known by the client
+     * @param   version The node list version known by the client
+     * @param   msg The message to fill in
+     *
+     * If the epoch match and the changes since the given version are still
+     * remembered, and they are fewer than the number of nodes, only the
+     * changes are filled in. Otherwise the message will contain the full node
+     * list.
+     */
+    void nodeListUpdate(uint32_t epoch, uint32_t version,
+                        MsgNodeListUpdate& msg) const;
+
     /**
      * @brief   Broadcast a TCP message to connected clients
      * @param   msg The message to broadcast
@@ -169,6 +205,19 @@ class Reflector : public sigc::trackable
     void broadcastUdpMsg(const ReflectorUdpMsg& msg,
         const ReflectorClient::Filter& filter=ReflectorClient::NoFilter());
 
+    /**
+     * @brief   Broadcast an encoded audio frame to connected clients
+     * @param   buf The encoded audio frame
+     * @param   count The size of the audio frame
+     * @param   filter The client filter to apply
+     *
+     * The frame is sent to each client using the audio framing negotiated
+     * by that client, so clients that have requested multiple frames per
+     * UDP packet will get the frames repacketized.
+     */
+    void broadcastUdpAudio(const void *buf, int count,
+        const ReflectorClient::Filter& filter=ReflectorClient::NoFilter());
+
     /**
      * @brief   Get the TG for protocol V1 clients
      * @return  Returns the TG used for protocol V1 clients
@@ -182,12 +231,35 @@ class Reflector : public sigc::trackable
     void requestQsy(ReflectorClient *client, uint32_t tg);
 
   private:
+    static const unsigned DEFAULT_ACCEPT_RATE       = 20;
+    static const unsigned DEFAULT_ACCEPT_QUEUE_SIZE = 1000;
+    static const unsigned ACCEPT_TICK_TIME          = 100;
+    static const unsigned MAX_PENDING_FRAMES        = 4;
+    static const unsigned ACCEPT_HEARTBEAT_TICKS    = 50;
+    static const unsigned NODE_JOINED_BATCH_TIME    = 250;
+    static const unsigned NODE_LIST_HISTORY_SIZE    = 1000;
+
+    struct PendingCon
+    {
+      Async::FramedTcpConnection*       con;
+      std::vector<std::vector<uint8_t>> frames;
+      sigc::connection                  frame_received_con;
+      unsigned                          heartbeat_tx_cnt;
+    };
+
+    struct NodeListChange
+    {
+      bool        joined;
+      std::string callsign;
+    };
+
     typedef std::map<Async::FramedTcpConnection*,
                      ReflectorClient*> ReflectorClientConMap;
     typedef Async::TcpServer<Async::FramedTcpConnection> FramedTcpServer;
+    typedef std::map<uint32_t, TGMixer*> MixerMap;
 
     FramedTcpServer*                                m_srv;
-    Async::UdpSocket*                               m_udp_sock;
+    std::vector<Async::UdpSocket*>                  m_udp_socks;
     ReflectorClientConMap                           m_client_con_map;
     Async::Config*                                  m_cfg;
     uint32_t                                        m_tg_for_v1_clients;
@@ -195,14 +267,36 @@ class Reflector : public sigc::trackable
     uint32_t                                        m_random_qsy_hi;
     uint32_t                                        m_random_qsy_tg;
     Async::TcpServer<Async::HttpServerConnection>*  m_http_server;
+    MixerMap                                        m_mixers;
+    unsigned                                        m_accept_rate;
+    unsigned                                        m_accept_queue_size;
+    float                                           m_accept_tokens;
+    std::deque<PendingCon>                          m_accept_queue;
+    Async::Timer                                    m_accept_timer;
+    std::set<std::string>                           m_announced_nodes;
+    std::vector<std::string>                        m_joined_nodes;
+    Async::Timer                                    m_node_joined_timer;
+    uint32_t                                        m_node_list_epoch;
+    uint32_t                                        m_node_list_version;
+    std::deque<NodeListChange>                      m_node_list_changes;
 
     Reflector(const Reflector&);
     Reflector& operator=(const Reflector&);
     void clientConnected(Async::FramedTcpConnection *con);
+    void admitClient(Async::FramedTcpConnection *con);
+    void pendingFrameReceived(Async::FramedTcpConnection *con,
+                              std::vector<uint8_t>& data);
+    void onAcceptTick(Async::Timer *t);
+    void flushNodeJoined(Async::Timer *t=0);
+    void publishNodeListChanges(const std::vector<std::string>& callsigns,
+                                bool joined);
     void clientDisconnected(Async::FramedTcpConnection *con,
                             Async::FramedTcpConnection::DisconnectReason reason);
+    bool initUdpSockets(uint16_t port);
     void udpDatagramReceived(const Async::IpAddress& addr, uint16_t port,
-                             void *buf, int count);
+                             void *buf, int count, Async::UdpSocket *sock);
+    void handleUdpAudio(ReflectorClient *client,
+                        const std::vector<uint8_t>& frame);
     void onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
                          ReflectorClient *new_talker);
     void httpRequestReceived(Async::HttpServerConnection *con,
@@ -212,6 +306,8 @@ class Reflector : public sigc::trackable
         Async::HttpServerConnection::DisconnectReason reason);
     void onRequestAutoQsy(uint32_t from_tg);
     uint32_t nextRandomQsyTg(void);
+    TGMixer* mixerForTG(uint32_t tg, ReflectorClient *client);
+    void onMixerIdle(TGMixer *mixer);
 
 };  /* class Reflector */
 
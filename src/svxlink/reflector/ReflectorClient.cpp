@@ -35,7 +35,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iomanip>
 #include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <iterator>
+#include <json/json.h>
 
 
 /****************************************************************************
@@ -94,6 +96,7 @@ using namespace Async;
  *
  ****************************************************************************/
 
+static std::string jsonObjectMembers(const Json::Value& obj);
 
 
 /****************************************************************************
@@ -156,7 +159,8 @@ ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con
                                  Async::Config *cfg)
   : m_con(con), m_con_state(STATE_EXPECT_PROTO_VER),
     m_disc_timer(10000, Timer::TYPE_ONESHOT, false),
-    m_client_id(newClient(this)), m_remote_udp_port(0), m_cfg(cfg),
+    m_client_id(newClient(this)), m_remote_udp_port(0), m_udp_sock(0),
+    m_cfg(cfg),
     m_next_udp_tx_seq(0), m_next_udp_rx_seq(0),
     m_heartbeat_timer(1000, Timer::TYPE_PERIODIC),
     m_heartbeat_tx_cnt(HEARTBEAT_TX_CNT_RESET),
@@ -164,15 +168,32 @@ ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con
     m_udp_heartbeat_tx_cnt(UDP_HEARTBEAT_TX_CNT_RESET),
     m_udp_heartbeat_rx_cnt(UDP_HEARTBEAT_RX_CNT_RESET),
     m_reflector(ref), m_blocktime(0), m_remaining_blocktime(0),
-    m_current_tg(0)
+    m_current_tg(0), m_node_info_parts(1), m_udp_frames_per_packet(1),
+    m_audio_framing_negotiated(false),
+    m_udp_tx_flush_timer(UDP_AUDIO_FLUSH_TIME, Timer::TYPE_ONESHOT, false),
+    m_node_list_sync(false), m_node_list_epoch(0), m_node_list_version(0),
+    m_node_list_update_pending(false), m_tx_queue_size(0),
+    m_tx_flush_timer(0, Timer::TYPE_ONESHOT, false)
 {
   m_con->setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
+  if (!m_con->setNoDelay(true))
+  {
+    cerr << "*** WARNING: Could not set TCP_NODELAY for client "
+         << m_con->remoteHost() << ":" << m_con->remotePort() << ": "
+         << strerror(errno) << endl;
+  }
   m_con->frameReceived.connect(
       mem_fun(*this, &ReflectorClient::onFrameReceived));
+  m_con->sendQueueEmpty.connect(
+      mem_fun(*this, &ReflectorClient::onSendQueueEmpty));
+  m_tx_flush_timer.expired.connect(
+      mem_fun(*this, &ReflectorClient::flushTxQueue));
   m_disc_timer.expired.connect(
       mem_fun(*this, &ReflectorClient::onDiscTimeout));
   m_heartbeat_timer.expired.connect(
       mem_fun(*this, &ReflectorClient::handleHeartbeat));
+  m_udp_tx_flush_timer.expired.connect(
+      sigc::hide(sigc::mem_fun(*this, &ReflectorClient::sendPendingUdpAudio)));
 
   string codecs;
   if (m_cfg->getValue("GLOBAL", "CODECS", codecs))
@@ -216,25 +237,61 @@ ReflectorClient::~ReflectorClient(void)
 
 int ReflectorClient::sendMsg(const ReflectorMsg& msg)
 {
-  if (((m_con_state != STATE_CONNECTED) && (msg.type() >= 100)) ||
+  std::string packed;
+  if (!packMsg(msg, packed))
+  {
+    cerr << "*** ERROR: Failed to pack TCP message\n";
+    errno = EBADMSG;
+    return -1;
+  }
+  return sendPackedMsg(msg.type(), packed);
+} /* ReflectorClient::sendMsg */
+
+
+int ReflectorClient::sendPackedMsg(unsigned type, const std::string& packed)
+{
+  if (((m_con_state != STATE_CONNECTED) && (type >= 100)) ||
       !m_con->isConnected())
   {
     errno = ENOTCONN;
     return -1;
   }
 
+  if (m_tx_queue_size + packed.size() > TX_QUEUE_MAX_SIZE)
+  {
+    cerr << "*** WARNING: The TCP send queue overflowed for client ";
+    if (!m_callsign.empty())
+    {
+      cerr << m_callsign << " ";
+    }
+    cerr << m_con->remoteHost() << ":" << m_con->remotePort() << endl;
+    clearTxQueue();
+    sendError("TCP send queue overflow");
+    errno = ENOBUFS;
+    return -1;
+  }
+
   m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
 
+  m_tx_queue[txPrio(type)].push_back(packed);
+  m_tx_queue_size += packed.size();
+  m_tx_flush_timer.setEnable(true);
+
+  return 0;
+} /* ReflectorClient::sendPackedMsg */
+
+
+bool ReflectorClient::packMsg(const ReflectorMsg& msg, std::string& packed)
+{
   ReflectorMsg header(msg.type());
   ostringstream ss;
   if (!header.pack(ss) || !msg.pack(ss))
   {
-    cerr << "*** ERROR: Failed to pack TCP message\n";
-    errno = EBADMSG;
-    return -1;
+    return false;
   }
-  return m_con->write(ss.str().data(), ss.str().size());
-} /* ReflectorClient::sendMsg */
+  packed = ss.str();
+  return true;
+} /* ReflectorClient::packMsg */
 
 
 void ReflectorClient::udpMsgReceived(const ReflectorUdpMsg &header)
@@ -243,7 +300,8 @@ void ReflectorClient::udpMsgReceived(const ReflectorUdpMsg &header)
 
   m_udp_heartbeat_rx_cnt = UDP_HEARTBEAT_RX_CNT_RESET;
 
-  if ((m_blocktime > 0) && (header.type() == MsgUdpAudio::TYPE))
+  if ((m_blocktime > 0) && ((header.type() == MsgUdpAudio::TYPE) ||
+                            (header.type() == MsgUdpAudioFrames::TYPE)))
   {
     m_remaining_blocktime = m_blocktime;
   }
@@ -252,18 +310,28 @@ void ReflectorClient::udpMsgReceived(const ReflectorUdpMsg &header)
 
 void ReflectorClient::sendUdpMsg(const ReflectorUdpMsg &msg)
 {
-  if (remoteUdpPort() == 0)
+  sendPendingUdpAudio();
+  sendUdpMsgP(msg);
+} /* ReflectorClient::sendUdpMsg */
+
+
+void ReflectorClient::sendUdpAudio(const void *buf, int count)
+{
+  if (m_udp_frames_per_packet <= 1)
   {
+    sendUdpMsgP(MsgUdpAudio(buf, count));
     return;
   }
-
-  m_udp_heartbeat_tx_cnt = UDP_HEARTBEAT_TX_CNT_RESET;
-
-  ReflectorUdpMsg header(msg.type(), clientId(), nextUdpTxSeq());
-  ostringstream ss;
-  assert(header.pack(ss) && msg.pack(ss));
-  (void)m_reflector->sendUdpDatagram(this, ss.str().data(), ss.str().size());
-} /* ReflectorClient::sendUdpMsg */
+  m_udp_tx_frames.addFrame(buf, count);
+  if (m_udp_tx_frames.frameCount() >= m_udp_frames_per_packet)
+  {
+    sendPendingUdpAudio();
+    return;
+  }
+    // Do not hold back a partial packet if no more frames arrive
+  m_udp_tx_flush_timer.setEnable(true);
+  m_udp_tx_flush_timer.reset();
+} /* ReflectorClient::sendUdpAudio */
 
 
 void ReflectorClient::setBlock(unsigned blocktime)
@@ -273,6 +341,51 @@ void ReflectorClient::setBlock(unsigned blocktime)
 } /* ReflectorClient::setBlock */
 
 
+void ReflectorClient::nodeListChanged(void)
+{
+  if (m_node_list_sync && (m_con_state == STATE_CONNECTED))
+  {
+    m_node_list_update_pending = true;
+    m_tx_flush_timer.setEnable(true);
+  }
+} /* ReflectorClient::nodeListChanged */
+
+
+bool ReflectorClient::writeNodeInfo(std::ostream& os) const
+{
+  for (size_t i=0; i<m_node_info_slots.size(); ++i)
+  {
+    const NodeInfoSlot& slot = m_node_info_slots[i];
+    os << m_node_info_parts[i] << '{' << slot.members;
+    const char* sep = slot.members.empty() ? "" : ",";
+    if (slot.is_rx)
+    {
+      RxMap::const_iterator it = m_rx_map.find(slot.id);
+      if (it != m_rx_map.end())
+      {
+        const Rx& rx = it->second;
+        os << sep << "\"siglev\":" << static_cast<unsigned>(rx.siglev)
+           << ",\"enabled\":" << (rx.enabled ? "true" : "false")
+           << ",\"sql_open\":" << (rx.sql_open ? "true" : "false")
+           << ",\"active\":" << (rx.active ? "true" : "false");
+      }
+    }
+    else
+    {
+      TxMap::const_iterator it = m_tx_map.find(slot.id);
+      if (it != m_tx_map.end())
+      {
+        os << sep << "\"transmit\":"
+           << (it->second.transmit ? "true" : "false");
+      }
+    }
+    os << '}';
+  }
+  os << m_node_info_parts.back();
+  return !m_node_info_slots.empty() || !m_node_info_parts.back().empty();
+} /* ReflectorClient::writeNodeInfo */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -375,6 +488,12 @@ void ReflectorClient::onFrameReceived(FramedTcpConnection *con,
     case MsgError::TYPE:
       handleMsgError(ss);
       break;
+    case MsgAudioFraming::TYPE:
+      handleMsgAudioFraming(ss);
+      break;
+    case MsgNodeListSync::TYPE:
+      handleMsgNodeListSync(ss);
+      break;
     default:
       // Better just ignoring unknown protocol messages for making it easier to
       // add messages to the protocol and still be backwards compatible.
@@ -460,10 +579,7 @@ void ReflectorClient::handleMsgAuthResponse(std::istream& is)
   string auth_key = lookupUserKey(msg.callsign());
   if (!auth_key.empty() && msg.verify(auth_key, m_auth_challenge))
   {
-    vector<string> connected_nodes;
-    m_reflector->nodeList(connected_nodes);
-    if (find(connected_nodes.begin(), connected_nodes.end(),
-             msg.callsign()) == connected_nodes.end())
+    if (!m_reflector->nodeIsLoggedIn(msg.callsign()))
     {
       m_con->setMaxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
       m_callsign = msg.callsign();
@@ -474,9 +590,14 @@ void ReflectorClient::handleMsgAuthResponse(std::istream& is)
            << "." << m_client_proto_ver.minorVer()
            << endl;
       m_con_state = STATE_CONNECTED;
+      m_reflector->nodeLoggedIn(this);
       MsgServerInfo msg_srv_info(m_client_id, m_supported_codecs);
-      m_reflector->nodeList(msg_srv_info.nodes());
+      if (!m_node_list_sync)
+      {
+        m_reflector->nodeList(msg_srv_info.nodes());
+      }
       sendMsg(msg_srv_info);
+      nodeListChanged();
       if (m_client_proto_ver < ProtoVer(0, 7))
       {
         MsgNodeList msg_node_list(msg_srv_info.nodes());
@@ -497,7 +618,6 @@ void ReflectorClient::handleMsgAuthResponse(std::istream& is)
                     << m_reflector->tgForV1Clients() << std::endl;
         }
       }
-      m_reflector->broadcastMsg(MsgNodeJoined(m_callsign), ExceptFilter(this));
     }
     else
     {
@@ -598,20 +718,124 @@ void ReflectorClient::handleNodeInfo(std::istream& is)
     return;
   }
   //std::cout << "### handleNodeInfo: " << msg.json() << std::endl;
+  Json::Value node_info;
   try
   {
     std::istringstream is(msg.json());
-    is >> m_node_info;
+    is >> node_info;
   }
   catch (const Json::Exception& e)
   {
     std::cerr << "*** WARNING[" << m_callsign
               << "]: Failed to parse MsgNodeInfo JSON object: "
               << e.what() << std::endl;
+    return;
+  }
+  if (!node_info.isObject())
+  {
+    std::cerr << "*** WARNING[" << m_callsign
+              << "]: The MsgNodeInfo JSON data is not an object" << std::endl;
+    return;
   }
+  setNodeInfo(node_info);
 } /* ReflectorClient::handleNodeInfo */
 
 
+void ReflectorClient::setNodeInfo(Json::Value& info)
+{
+    // Members filled in by the reflector when writing the status
+  static const char* node_members[] = {
+    "protoVer", "tg", "restrictedTG", "monitoredTGs", "isTalker"
+  };
+  static const char* rx_members[] = {
+    "siglev", "enabled", "sql_open", "active"
+  };
+
+  for (const char* member : node_members)
+  {
+    info.removeMember(member);
+  }
+
+    // Replace each receiver and transmitter object with a placeholder string
+    // where the current status is to be inserted. The placeholders get a
+    // random prefix so that they cannot be mistaken for strings in the node
+    // information. Since jsoncpp write object members in sorted order, the
+    // placeholders will appear in the order they were inserted.
+  const std::string placeholder_prefix =
+    std::string("\x01") + std::to_string(id_gen()) + ":";
+  std::vector<NodeInfoSlot> slots;
+  if (info.isMember("qth") && info["qth"].isArray())
+  {
+    Json::Value& qths(info["qth"]);
+    for (Json::Value::ArrayIndex i=0; i<qths.size(); ++i)
+    {
+      Json::Value& qth(qths[i]);
+      if (!qth.isObject())
+      {
+        continue;
+      }
+      for (const char* dir : {"rx", "tx"})
+      {
+        bool is_rx = (dir[0] == 'r');
+        if (!qth.isMember(dir) || !qth[dir].isObject())
+        {
+          continue;
+        }
+        Json::Value& sites(qth[dir]);
+        for (const std::string& id_str : sites.getMemberNames())
+        {
+          Json::Value& site(sites[id_str]);
+          if ((id_str.size() != 1) || !(site.isObject() || site.isNull()))
+          {
+            continue;
+          }
+          if (is_rx)
+          {
+            for (const char* member : rx_members)
+            {
+              site.removeMember(member);
+            }
+          }
+          else
+          {
+            site.removeMember("transmit");
+          }
+          slots.push_back(NodeInfoSlot{is_rx, id_str[0],
+                                       jsonObjectMembers(site)});
+          site = placeholder_prefix + std::to_string(slots.size() - 1);
+        }
+      }
+    }
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["commentStyle"] = "None";
+  builder["indentation"] = "";
+  std::string json(jsonObjectMembers(info));
+  std::vector<std::string> parts;
+  std::string::size_type pos = 0;
+  for (size_t i=0; i<slots.size(); ++i)
+  {
+    const std::string token(Json::writeString(builder,
+          Json::Value(placeholder_prefix + std::to_string(i))));
+    std::string::size_type token_pos = json.find(token, pos);
+    if (token_pos == std::string::npos)
+    {
+      std::cerr << "*** WARNING[" << m_callsign
+                << "]: Failed to prepare node information JSON object"
+                << std::endl;
+      return;
+    }
+    parts.push_back(json.substr(pos, token_pos - pos));
+    pos = token_pos + token.size();
+  }
+  parts.push_back(json.substr(pos));
+
+  m_node_info_parts.swap(parts);
+  m_node_info_slots.swap(slots);
+} /* ReflectorClient::setNodeInfo */
+
+
 void ReflectorClient::handleMsgSignalStrengthValues(std::istream& is)
 {
   MsgSignalStrengthValues msg;
@@ -798,6 +1022,205 @@ void ReflectorClient::handleMsgError(std::istream& is)
 } /* ReflectorClient::handleMsgError */
 
 
+void ReflectorClient::handleMsgAudioFraming(std::istream& is)
+{
+  MsgAudioFraming msg;
+  if (!msg.unpack(is))
+  {
+    cout << m_callsign << ": ERROR: Could not unpack MsgAudioFraming" << endl;
+    sendError("Illegal MsgAudioFraming protocol message received");
+    return;
+  }
+  sendPendingUdpAudio();
+  m_udp_frames_per_packet = std::max(1U, std::min(
+        static_cast<unsigned>(msg.framesPerPacket()),
+        static_cast<unsigned>(MsgAudioFraming::MAX_FRAMES_PER_PACKET)));
+  m_audio_framing_negotiated = true;
+  cout << m_callsign << ": Using " << m_udp_frames_per_packet
+       << " audio frame(s) per UDP packet" << endl;
+  sendMsg(MsgAudioFraming(m_udp_frames_per_packet));
+} /* ReflectorClient::handleMsgAudioFraming */
+
+
+void ReflectorClient::handleMsgNodeListSync(std::istream& is)
+{
+  MsgNodeListSync msg;
+  if (!msg.unpack(is))
+  {
+    cout << "Client " << m_con->remoteHost() << ":" << m_con->remotePort()
+         << " ERROR: Could not unpack MsgNodeListSync" << endl;
+    sendError("Illegal MsgNodeListSync protocol message received");
+    return;
+  }
+  m_node_list_sync = true;
+  m_node_list_epoch = msg.epoch();
+  m_node_list_version = msg.version();
+  nodeListChanged();
+} /* ReflectorClient::handleMsgNodeListSync */
+
+
+bool ReflectorClient::packNodeListUpdate(std::string& packed)
+{
+  MsgNodeListUpdate msg;
+  m_reflector->nodeListUpdate(m_node_list_epoch, m_node_list_version, msg);
+  if (!packMsg(msg, packed))
+  {
+    cerr << "*** ERROR: Failed to pack TCP message\n";
+    return false;
+  }
+    // From now on the client is expected to be at the version just sent
+  m_node_list_epoch = msg.epoch();
+  m_node_list_version = msg.version();
+  return true;
+} /* ReflectorClient::packNodeListUpdate */
+
+
+ReflectorClient::TxPrio ReflectorClient::txPrio(unsigned type)
+{
+  switch (type)
+  {
+    case MsgNodeList::TYPE:
+    case MsgNodeJoined::TYPE:
+    case MsgNodeLeft::TYPE:
+    case MsgNodeListUpdate::TYPE:
+      return TX_PRIO_LOW;
+    default:
+      return TX_PRIO_HIGH;
+  }
+} /* ReflectorClient::txPrio */
+
+
+bool ReflectorClient::txPending(void) const
+{
+  return m_node_list_update_pending || (m_tx_queue_size > 0);
+} /* ReflectorClient::txPending */
+
+
+void ReflectorClient::clearTxQueue(void)
+{
+  for (auto& queue : m_tx_queue)
+  {
+    queue.clear();
+  }
+  m_tx_queue_size = 0;
+  m_node_list_update_pending = false;
+} /* ReflectorClient::clearTxQueue */
+
+
+void ReflectorClient::flushTxQueue(Async::Timer *t)
+{
+  m_tx_flush_timer.setEnable(false);
+  if (!m_con->isConnected())
+  {
+    clearTxQueue();
+    return;
+  }
+
+    // Write as many messages as the send budget allow in one go. If the
+    // budget is exhausted, the rest is sent when the connection has caught
+    // up. A pending node list update is sent after the control messages so
+    // that it reflect the latest node list.
+  m_con->cork();
+  while (m_con->txQueueSize() < TX_BUDGET)
+  {
+    std::string packed;
+    if (!m_tx_queue[TX_PRIO_HIGH].empty())
+    {
+      packed.swap(m_tx_queue[TX_PRIO_HIGH].front());
+      m_tx_queue[TX_PRIO_HIGH].pop_front();
+      m_tx_queue_size -= packed.size();
+    }
+    else if (m_node_list_update_pending)
+    {
+      m_node_list_update_pending = false;
+      if (!packNodeListUpdate(packed))
+      {
+        continue;
+      }
+    }
+    else if (!m_tx_queue[TX_PRIO_LOW].empty())
+    {
+      packed.swap(m_tx_queue[TX_PRIO_LOW].front());
+      m_tx_queue[TX_PRIO_LOW].pop_front();
+      m_tx_queue_size -= packed.size();
+    }
+    else
+    {
+      break;
+    }
+    if (m_con->write(packed.data(), packed.size()) < 0)
+    {
+      cerr << "*** ERROR[" << callsign() << "]: Failed to write a "
+           << packed.size() << " byte message to "
+           << m_con->remoteHost() << ":" << m_con->remotePort() << ": "
+           << strerror(errno) << endl;
+      disconnect();
+      return;
+    }
+  }
+  if (m_con->uncork() < 0)
+  {
+    cerr << "*** ERROR[" << callsign() << "]: Failed to send to "
+         << m_con->remoteHost() << ":" << m_con->remotePort() << ": "
+         << strerror(errno) << endl;
+    disconnect();
+    return;
+  }
+
+    // If everything written was accepted by the OS there will be no send
+    // queue empty event so the next chunk is sent in the next iteration
+  if (txPending() && (m_con->txQueueSize() == 0))
+  {
+    m_tx_flush_timer.setEnable(true);
+  }
+} /* ReflectorClient::flushTxQueue */
+
+
+void ReflectorClient::onSendQueueEmpty(Async::FramedTcpConnection *con)
+{
+  if (txPending())
+  {
+    m_tx_flush_timer.setEnable(true);
+  }
+} /* ReflectorClient::onSendQueueEmpty */
+
+
+void ReflectorClient::sendUdpMsgP(const ReflectorUdpMsg &msg)
+{
+  if (remoteUdpPort() == 0)
+  {
+    return;
+  }
+
+  m_udp_heartbeat_tx_cnt = UDP_HEARTBEAT_TX_CNT_RESET;
+
+  ReflectorUdpMsg header(msg.type(), clientId(), nextUdpTxSeq());
+  ostringstream ss;
+  assert(header.pack(ss) && msg.pack(ss));
+  (void)m_reflector->sendUdpDatagram(this, ss.str().data(), ss.str().size());
+} /* ReflectorClient::sendUdpMsgP */
+
+
+void ReflectorClient::sendPendingUdpAudio(void)
+{
+  m_udp_tx_flush_timer.setEnable(false);
+  if (m_udp_tx_frames.isEmpty())
+  {
+    return;
+  }
+  if (m_udp_tx_frames.frameCount() == 1)
+  {
+    const std::vector<uint8_t>& frame = m_udp_tx_frames.frames().front();
+    sendUdpMsgP(MsgUdpAudio(frame));
+  }
+  else
+  {
+    sendUdpMsgP(m_udp_tx_frames);
+  }
+  m_udp_tx_frames.clear();
+} /* ReflectorClient::sendPendingUdpAudio */
+
+
 void ReflectorClient::sendError(const std::string& msg)
 {
   sendMsg(MsgError(msg));
@@ -818,6 +1241,8 @@ void ReflectorClient::onDiscTimeout(Timer *t)
 void ReflectorClient::disconnect(void)
 {
   m_heartbeat_timer.setEnable(false);
+  m_tx_flush_timer.setEnable(false);
+  clearTxQueue();
   m_remote_udp_port = 0;
   m_con->disconnect();
   m_con_state = STATE_DISCONNECTED;
@@ -902,6 +1327,32 @@ std::string ReflectorClient::lookupUserKey(const std::string& callsign)
 } /* ReflectorClient::lookupUserKey */
 
 
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief   Serialize a JSON object without the enclosing braces
+ * @param   obj The object to serialize
+ * @return  Returns the compact JSON representation of the object members
+ */
+static std::string jsonObjectMembers(const Json::Value& obj)
+{
+  if (!obj.isObject() || obj.empty())
+  {
+    return "";
+  }
+  Json::StreamWriterBuilder builder;
+  builder["commentStyle"] = "None";
+  builder["indentation"] = "";
+  std::string json(Json::writeString(builder, obj));
+  return json.substr(1, json.size() - 2);
+} /* jsonObjectMembers */
+
+
 /*
  * This file has not been truncated
  */
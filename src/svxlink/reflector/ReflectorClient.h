@@ -35,8 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <string>
-#include <json/json.h>
 #include <random>
+#include <deque>
 
 
 /****************************************************************************
@@ -66,6 +66,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+namespace Json
+{
+  class Value;
+};
+
+namespace Async
+{
+  class UdpSocket;
+};
 
 
 /****************************************************************************
@@ -198,6 +207,18 @@ class ReflectorClient
         uint32_t m_tg;
     };
 
+    class NodeListSyncFilter : public Filter
+    {
+      public:
+        NodeListSyncFilter(bool sync) : m_sync(sync) {}
+        virtual bool operator ()(ReflectorClient *client) const
+        {
+          return client->m_node_list_sync == m_sync;
+        }
+      private:
+        bool m_sync;
+    };
+
     template <class F1, class F2>
     class AndFilter : public Filter
     {
@@ -299,6 +320,22 @@ class ReflectorClient
      */
     void setRemoteUdpPort(uint16_t port) { m_remote_udp_port = port; }
 
+    /**
+     * @brief   Return the UDP socket that the client is sending to
+     * @return  Returns the socket, or 0 if no UDP packet has been received
+     */
+    Async::UdpSocket* udpSocket(void) const { return m_udp_sock; }
+
+    /**
+     * @brief   Set the UDP socket that the client is sending to
+     * @param   sock The socket that the last UDP packet was received on
+     *
+     * The Reflector use this function to record which socket that the client
+     * is sending to so that UDP packets to the client can be sent through
+     * the same socket.
+     */
+    void setUdpSocket(Async::UdpSocket* sock) { m_udp_sock = sock; }
+
     /**
      * @brief   Get the callsign for this connection
      * @return  Returns the callsign associated with this coinnection
@@ -333,6 +370,29 @@ class ReflectorClient
      */
     int sendMsg(const ReflectorMsg& msg);
 
+    /**
+     * @brief   Send an already packed TCP message to the remote end
+     * @param   type The type of the message
+     * @param   packed The packed header and message, as created by packMsg
+     * @return  On success 0 is returned or else -1
+     *
+     * This function is used when the same message is to be sent to many
+     * clients so that it only have to be packed once.
+     * Messages are queued and written in one go at the end of the current
+     * main loop iteration. Control messages, like talker start/stop and QSY
+     * requests, are sent before node list messages and a client that does
+     * not keep up with the sent data is disconnected.
+     */
+    int sendPackedMsg(unsigned type, const std::string& packed);
+
+    /**
+     * @brief   Pack a TCP message, including the header, for transmission
+     * @param   msg The message to pack
+     * @param   packed The string to store the packed message in
+     * @return  Returns \em true on success or else \em false
+     */
+    static bool packMsg(const ReflectorMsg& msg, std::string& packed);
+
     /**
      * @brief   Handle a received UDP message
      * @param   The received UDP message
@@ -348,6 +408,36 @@ class ReflectorClient
      */
     void sendUdpMsg(const ReflectorUdpMsg &msg);
 
+    /**
+     * @brief   Send one encoded audio frame to the client
+     * @param   buf The encoded audio frame
+     * @param   count The size of the audio frame
+     *
+     * If the client has negotiated audio framing using the MsgAudioFraming
+     * message, frames are collected until there are enough of them to fill
+     * a MsgUdpAudioFrames message. Any collected frames are also sent before
+     * any other UDP message, so a flush will always send what is left.
+     * A partial packet is sent if no new frame has arrived within
+     * UDP_AUDIO_FLUSH_TIME milliseconds.
+     * Otherwise each frame is sent immediately in a MsgUdpAudio message.
+     */
+    void sendUdpAudio(const void *buf, int count);
+
+    /**
+     * @brief   Get the number of audio frames sent in each UDP packet
+     * @return  Returns the negotiated number of frames per UDP packet
+     */
+    unsigned udpFramesPerPacket(void) const { return m_udp_frames_per_packet; }
+
+    /**
+     * @brief   Check if multi-frame UDP audio packets have been negotiated
+     * @return  Returns \em true if a MsgAudioFraming exchange has been done
+     */
+    bool audioFramingNegotiated(void) const
+    {
+      return m_audio_framing_negotiated;
+    }
+
     /**
      * @brief   Block client audio for the specified time
      * @param   The number of seconds to block
@@ -376,6 +466,31 @@ class ReflectorClient
      */
     const ProtoVer& protoVer(void) const { return m_client_proto_ver; }
 
+    /**
+     * @brief   Check if the client use incremental node list updates
+     * @return  Returns \em true if the client has sent a MsgNodeListSync
+     */
+    bool nodeListSync(void) const { return m_node_list_sync; }
+
+    /**
+     * @brief   Tell the client that the node list has changed
+     *
+     * Clients using incremental node list updates are sent one update
+     * covering all changes made since the last update was sent. Updates that
+     * have not been sent yet are merged so that a slow client is not sent a
+     * backlog of superseded updates.
+     */
+    void nodeListChanged(void);
+
+    /**
+     * @brief   Get the audio codecs supported by the reflector
+     * @return  Returns the list of codecs announced to the client
+     */
+    const std::vector<std::string>& supportedCodecs(void) const
+    {
+      return m_supported_codecs;
+    }
+
     /**
      * @brief   Get the current talk group
      * @return  Returns the currently selected talk group
@@ -424,12 +539,35 @@ class ReflectorClient
     void setTxTransmit(char id, bool transmit) { m_tx_map[id].transmit = transmit; }
     bool txTransmit(char id) { return m_tx_map[id].transmit; }
 
-    const Json::Value& nodeInfo(void) const { return m_node_info; }
+    /**
+     * @brief   Write the node information as JSON object members
+     * @param   os The stream to write to
+     * @return  Returns \em true if anything was written
+     *
+     * The node information JSON object received from the client is stored
+     * pre-serialized so writing it is mostly a matter of copying strings.
+     * The current receiver and transmitter status is filled in for each
+     * receiver and transmitter found in the node information. The enclosing
+     * braces are not written so that the caller can add more members.
+     */
+    bool writeNodeInfo(std::ostream& os) const;
 
   private:
     using ClientIdRandomDist  = std::uniform_int_distribution<ClientId>;
     using ClientMap           = std::map<ClientId, ReflectorClient*>;
 
+    typedef enum
+    {
+      TX_PRIO_HIGH, TX_PRIO_LOW, TX_PRIO_CNT
+    } TxPrio;
+
+    struct NodeInfoSlot
+    {
+      bool        is_rx;
+      char        id;
+      std::string members;
+    };
+
     static const uint16_t MIN_MAJOR_VER = 0;
     static const uint16_t MIN_MINOR_VER = 6;
 
@@ -437,6 +575,10 @@ class ReflectorClient
     static const unsigned HEARTBEAT_RX_CNT_RESET      = 15;
     static const unsigned UDP_HEARTBEAT_TX_CNT_RESET  = 15;
     static const unsigned UDP_HEARTBEAT_RX_CNT_RESET  = 120;
+    static const unsigned UDP_AUDIO_FLUSH_TIME        = 100;
+
+    static const size_t   TX_BUDGET                   = 16384;
+    static const size_t   TX_QUEUE_MAX_SIZE           = 1024 * 1024;
 
     static const ClientId CLIENT_ID_MAX = std::numeric_limits<ClientId>::max();
 
@@ -451,6 +593,7 @@ class ReflectorClient
     std::string                 m_callsign;
     ClientId                    m_client_id;
     uint16_t                    m_remote_udp_port;
+    Async::UdpSocket*           m_udp_sock;
     Async::Config*              m_cfg;
     uint16_t                    m_next_udp_tx_seq;
     uint16_t                    m_next_udp_rx_seq;
@@ -468,7 +611,19 @@ class ReflectorClient
     std::set<uint32_t>          m_monitored_tgs;
     RxMap                       m_rx_map;
     TxMap                       m_tx_map;
-    Json::Value                 m_node_info;
+    std::vector<std::string>    m_node_info_parts;
+    std::vector<NodeInfoSlot>   m_node_info_slots;
+    unsigned                    m_udp_frames_per_packet;
+    bool                        m_audio_framing_negotiated;
+    MsgUdpAudioFrames           m_udp_tx_frames;
+    Async::Timer                m_udp_tx_flush_timer;
+    bool                        m_node_list_sync;
+    uint32_t                    m_node_list_epoch;
+    uint32_t                    m_node_list_version;
+    bool                        m_node_list_update_pending;
+    std::deque<std::string>     m_tx_queue[TX_PRIO_CNT];
+    size_t                      m_tx_queue_size;
+    Async::Timer                m_tx_flush_timer;
 
     static ClientId newClient(ReflectorClient* client);
 
@@ -481,11 +636,22 @@ class ReflectorClient
     void handleSelectTG(std::istream& is);
     void handleTgMonitor(std::istream& is);
     void handleNodeInfo(std::istream& is);
+    void setNodeInfo(Json::Value& info);
     void handleMsgSignalStrengthValues(std::istream& is);
     void handleMsgTxStatus(std::istream& is);
     void handleRequestQsy(std::istream& is);
     void handleStateEvent(std::istream& is);
     void handleMsgError(std::istream& is);
+    void handleMsgAudioFraming(std::istream& is);
+    void handleMsgNodeListSync(std::istream& is);
+    bool packNodeListUpdate(std::string& packed);
+    static TxPrio txPrio(unsigned type);
+    bool txPending(void) const;
+    void clearTxQueue(void);
+    void flushTxQueue(Async::Timer *t);
+    void onSendQueueEmpty(Async::FramedTcpConnection *con);
+    void sendUdpMsgP(const ReflectorUdpMsg &msg);
+    void sendPendingUdpAudio(void);
     void sendError(const std::string& msg);
     void onDiscTimeout(Async::Timer *t);
     void disconnect(void);
@@ -1111,6 +1111,124 @@ class MsgTxStatus : public ReflectorMsgBase<113>
 }; /* class MsgTxStatus */
 
 
+/**
+@brief   Audio framing negotiation
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent by a client to request that multiple encoded audio frames
+are aggregated into each UDP packet sent to it, using the MsgUdpAudioFrames
+message. The reflector answer with the same message type, containing the
+number of frames per packet that it will use for the client. The client may
+send MsgUdpAudioFrames messages to the reflector only after having received
+the answer. A reflector not supporting this message will not answer so the
+client will then keep sending one frame per packet.
+*/
+class MsgAudioFraming : public ReflectorMsgBase<114>
+{
+  public:
+    static const uint8_t MAX_FRAMES_PER_PACKET = 10;
+
+    MsgAudioFraming(uint8_t frames_per_packet=1)
+      : m_frames_per_packet(frames_per_packet) {}
+    uint8_t framesPerPacket(void) const { return m_frames_per_packet; }
+
+    ASYNC_MSG_MEMBERS(m_frames_per_packet)
+
+  private:
+    uint8_t m_frames_per_packet;
+}; /* MsgAudioFraming */
+
+
+/**
+@brief   Request incremental node list synchronization
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent by a client, right after MsgProtoVer, to request that the
+node list is kept in sync using MsgNodeListUpdate messages instead of the node
+list in MsgServerInfo and the MsgNodeJoined/MsgNodeLeft messages. The epoch and
+version tell what node list the client got during a previous connection so that
+the reflector only need to send the changes since then. Both should be zero if
+the client have no node list. The message may also be sent when connected to
+request a resynchronization. A reflector not supporting this message will
+ignore it.
+*/
+class MsgNodeListSync : public ReflectorMsgBase<115>
+{
+  public:
+    MsgNodeListSync(uint32_t epoch=0, uint32_t version=0)
+      : m_epoch(epoch), m_version(version) {}
+    uint32_t epoch(void) const { return m_epoch; }
+    uint32_t version(void) const { return m_version; }
+
+    ASYNC_MSG_MEMBERS(m_epoch, m_version)
+
+  private:
+    uint32_t m_epoch;
+    uint32_t m_version;
+}; /* MsgNodeListSync */
+
+
+/**
+@brief   Incremental node list update
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent by the reflector to clients that have requested node list
+synchronization using MsgNodeListSync. The node list is identified by an epoch,
+which is changed when the reflector is restarted, and a version number that is
+incremented for each change. If the full flag is set, the records contain the
+complete node list. If not, the records contain the changes needed to go from
+version fromVersion() to version(). A client that is not able to apply the
+changes should send a MsgNodeListSync with zero epoch and version to get the
+full node list.
+*/
+class MsgNodeListUpdate : public ReflectorMsgBase<116>
+{
+  public:
+    class Record : public Async::Msg
+    {
+      public:
+        typedef enum {OP_JOINED=0, OP_LEFT=1} Op;
+
+        Record(void) : m_op(OP_JOINED) {}
+        Record(Op op, const std::string& callsign)
+          : m_op(op), m_callsign(callsign) {}
+        bool joined(void) const { return m_op == OP_JOINED; }
+        const std::string& callsign(void) const { return m_callsign; }
+
+        ASYNC_MSG_MEMBERS(m_op, m_callsign)
+
+      private:
+        uint8_t     m_op;
+        std::string m_callsign;
+    };
+    typedef std::vector<Record> Records;
+
+    MsgNodeListUpdate(uint32_t epoch=0, uint32_t from_version=0,
+                      uint32_t version=0, bool full=false)
+      : m_epoch(epoch), m_from_version(from_version), m_version(version),
+        m_full(full ? 1 : 0) {}
+    uint32_t epoch(void) const { return m_epoch; }
+    uint32_t fromVersion(void) const { return m_from_version; }
+    uint32_t version(void) const { return m_version; }
+    bool isFull(void) const { return m_full != 0; }
+    Records& records(void) { return m_records; }
+    const Records& records(void) const { return m_records; }
+    void pushBack(const Record& record) { m_records.push_back(record); }
+
+    ASYNC_MSG_MEMBERS(m_epoch, m_from_version, m_version, m_full, m_records)
+
+  private:
+    uint32_t  m_epoch;
+    uint32_t  m_from_version;
+    uint32_t  m_version;
+    uint8_t   m_full;
+    Records   m_records;
+}; /* MsgNodeListUpdate */
+
+
 /***************************** UDP Messages *****************************/
 
 /**
@@ -1204,6 +1322,39 @@ struct MsgUdpSignalStrengthValues
 }; /* MsgUdpSignalStrengthValues */
 
 
+/**
+@brief   Multi frame audio UDP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message carry multiple encoded audio frames in one UDP packet. Each frame
+is handled exactly as if it had been received in a MsgUdpAudio message. It is
+only used after having been negotiated using the MsgAudioFraming message.
+*/
+class MsgUdpAudioFrames : public ReflectorUdpMsgBase<105>
+{
+  public:
+    typedef std::vector<std::vector<uint8_t> > Frames;
+
+    MsgUdpAudioFrames(void) {}
+    Frames& frames(void) { return m_frames; }
+    const Frames& frames(void) const { return m_frames; }
+    size_t frameCount(void) const { return m_frames.size(); }
+    bool isEmpty(void) const { return m_frames.empty(); }
+    void addFrame(const void *buf, int count)
+    {
+      const uint8_t *bbuf = reinterpret_cast<const uint8_t*>(buf);
+      m_frames.push_back(std::vector<uint8_t>(bbuf, bbuf + count));
+    }
+    void clear(void) { m_frames.clear(); }
+
+    ASYNC_MSG_MEMBERS(m_frames)
+
+  private:
+    Frames m_frames;
+}; /* MsgUdpAudioFrames */
+
+
 #if 0
 /**
 @brief	 Audio UDP network message V2
@@ -170,6 +170,11 @@ bool TGHandler::switchTo(ReflectorClient *client, uint32_t tg)
       {
         tg_info->auto_qsy_time = time(NULL) + tg_info->auto_qsy_after_s;
       }
+      m_cfg->getValue(ss.str(), "MIX_TALKERS", tg_info->mix_talkers);
+      if (tg_info->mix_talkers < 2)
+      {
+        tg_info->mix_talkers = 0;
+      }
       m_id_map[tg] = tg_info;
     }
     tg_info->clients.insert(client);
@@ -306,6 +311,17 @@ bool TGHandler::isRestricted(uint32_t tg) const
 } /* TGHandler::isRestricted */
 
 
+unsigned TGHandler::mixTalkers(uint32_t tg) const
+{
+  IdMap::const_iterator id_map_it = m_id_map.find(tg);
+  if (id_map_it == m_id_map.end())
+  {
+    return 0;
+  }
+  return id_map_it->second->mix_talkers;
+} /* TGHandler::mixTalkers */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -340,7 +356,9 @@ void TGHandler::checkTimers(Async::Timer *t)
         setTalkerForTG(tg_info->id, 0);
       }
 
-      if ((tg_info->sql_timeout_cnt > 0) && (--tg_info->sql_timeout_cnt == 0))
+        // In mixing mode the TGMixer apply the timeout to every talker
+      if ((tg_info->mix_talkers == 0) && (tg_info->sql_timeout_cnt > 0) &&
+          (--tg_info->sql_timeout_cnt == 0))
       {
         cout << tg_info->talker->callsign() << ": Talker audio timeout on TG #"
              << tg_info->id << endl;
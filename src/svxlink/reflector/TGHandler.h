@@ -146,6 +146,21 @@ class TGHandler : public sigc::trackable
 
     void setSqlTimeoutBlocktime(unsigned sql_timeout_blocktime);
 
+    /**
+     * @brief   Get the squelch timeout
+     * @return  Returns the squelch timeout in seconds, 0 if disabled
+     */
+    unsigned sqlTimeout(void) const { return m_sql_timeout; }
+
+    /**
+     * @brief   Get the time a talker is blocked after a squelch timeout
+     * @return  Returns the block time in seconds
+     */
+    unsigned sqlTimeoutBlocktime(void) const
+    {
+      return m_sql_timeout_blocktime;
+    }
+
     bool switchTo(ReflectorClient *client, uint32_t tg);
 
     void removeClient(ReflectorClient* client);
@@ -164,6 +179,13 @@ class TGHandler : public sigc::trackable
 
     bool isRestricted(uint32_t tg) const;
 
+    /**
+     * @brief   Get the maximum number of talkers to mix for a talk group
+     * @param   tg The talk group
+     * @return  Returns the configured MIX_TALKERS value, 0 if not mixing
+     */
+    unsigned mixTalkers(uint32_t tg) const;
+
     sigc::signal<void, uint32_t,
       ReflectorClient*, ReflectorClient*> talkerUpdated;
 
@@ -181,10 +203,11 @@ class TGHandler : public sigc::trackable
       unsigned          sql_timeout_cnt;
       time_t            auto_qsy_after_s;
       time_t            auto_qsy_time;
+      unsigned          mix_talkers;
 
       TGInfo(uint32_t tg)
         : id(tg), talker(0), sql_timeout_cnt(0), auto_qsy_after_s(0),
-          auto_qsy_time(-1)
+          auto_qsy_time(-1), mix_talkers(0)
       {
         timerclear(&last_talker_timestamp);
       }
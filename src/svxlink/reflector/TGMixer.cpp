@@ -0,0 +1,587 @@
+/**
+@file   TGMixer.cpp
+@brief  Mix the audio from multiple concurrent talkers in a talk group
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioEncoder.h>
+#include <AsyncAudioDecoder.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "TGMixer.h"
+#include "TGHandler.h"
+#include "Reflector.h"
+#include "ReflectorClient.h"
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+#define MS_TO_SAMPLES(ms) ((ms) * INTERNAL_SAMPLE_RATE / 1000)
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+  class NotMixedFilter : public ReflectorClient::Filter
+  {
+    public:
+      NotMixedFilter(const TGMixer *mixer) : m_mixer(mixer) {}
+      virtual bool operator ()(ReflectorClient *client) const
+      {
+        return !m_mixer->isTalker(client);
+      }
+    private:
+      const TGMixer* m_mixer;
+  };
+
+  inline float clip(float sample)
+  {
+    return std::min(std::max(sample, -1.0f), 1.0f);
+  }
+};
+
+
+  /*
+   * One talker that is being mixed. The decoder for the talker write its
+   * output into the jitter buffer in this object.
+   */
+class TGMixer::Talker : public Async::AudioSink
+{
+  public:
+    ReflectorClient*      client;
+    Async::AudioDecoder*  dec;
+    Async::AudioEncoder*  enc;
+    std::vector<float>    block;
+    bool                  prebuffering;
+    bool                  flushing;
+    bool                  mix_minus_active;
+    struct timeval        last_audio;
+    struct timeval        talk_start;
+
+    Talker(ReflectorClient *client, size_t block_size)
+      : client(client), dec(0), enc(0), block(block_size, 0.0f),
+        prebuffering(true), flushing(false), mix_minus_active(false),
+        m_rd_pos(0)
+    {
+      gettimeofday(&last_audio, NULL);
+      talk_start = last_audio;
+    }
+
+    ~Talker(void)
+    {
+      if (dec != 0)
+      {
+        dec->unregisterSink();
+        delete dec;
+      }
+      delete enc;
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      if (samplesAvailable() + count > MS_TO_SAMPLES(MAX_BUF_TIME))
+      {
+          // Drop audio that arrive too fast rather than increasing the delay
+        return count;
+      }
+      if (m_rd_pos > m_buf.size() / 2)
+      {
+        m_buf.erase(m_buf.begin(), m_buf.begin() + m_rd_pos);
+        m_rd_pos = 0;
+      }
+      m_buf.insert(m_buf.end(), samples, samples + count);
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      sourceAllSamplesFlushed();
+    }
+
+    size_t samplesAvailable(void) const { return m_buf.size() - m_rd_pos; }
+
+      // Read the next block of audio into the block buffer, zero padding it
+      // if there is not enough audio available
+    void readBlock(void)
+    {
+      size_t cnt = std::min(block.size(), samplesAvailable());
+      std::copy(m_buf.begin() + m_rd_pos, m_buf.begin() + m_rd_pos + cnt,
+                block.begin());
+      std::fill(block.begin() + cnt, block.end(), 0.0f);
+      m_rd_pos += cnt;
+      if (m_rd_pos == m_buf.size())
+      {
+        m_buf.clear();
+        m_rd_pos = 0;
+      }
+    }
+
+  private:
+    std::vector<float>  m_buf;
+    size_t              m_rd_pos;
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+TGMixer::TGMixer(Reflector *reflector, Async::Config& cfg, uint32_t tg,
+                 const std::string& codec, unsigned max_talkers)
+  : m_reflector(reflector), m_cfg(cfg), m_tg(tg), m_codec(codec),
+    m_max_talkers(std::min(max_talkers, MAX_TALKERS)), m_listener_enc(0),
+    m_listener_stream_active(false),
+    m_mix_timer(BLOCK_TIME, Async::Timer::TYPE_PERIODIC, false),
+    m_mix_buf(MS_TO_SAMPLES(BLOCK_TIME), 0.0f),
+    m_out_buf(MS_TO_SAMPLES(BLOCK_TIME), 0.0f)
+{
+  timerclear(&m_next_block_time);
+  m_mix_timer.expired.connect(mem_fun(*this, &TGMixer::onMixTimer));
+
+  m_listener_enc = createEncoder();
+  if (m_listener_enc != 0)
+  {
+    m_listener_enc->writeEncodedSamples.connect(
+        mem_fun(*this, &TGMixer::sendListenerAudio));
+    m_listener_enc->flushEncodedSamples.connect(
+        mem_fun(*this, &TGMixer::flushListenerAudio));
+  }
+} /* TGMixer::TGMixer */
+
+
+TGMixer::~TGMixer(void)
+{
+  for (TalkerList::iterator it = m_talkers.begin(); it != m_talkers.end(); ++it)
+  {
+    delete *it;
+  }
+  m_talkers.clear();
+  delete m_listener_enc;
+} /* TGMixer::~TGMixer */
+
+
+bool TGMixer::writeAudio(ReflectorClient *client,
+                         const std::vector<uint8_t>& data)
+{
+  if (m_listener_enc == 0)
+  {
+    return false;
+  }
+
+  Talker *talker = findTalker(client);
+  if (talker == 0)
+  {
+    if (m_talkers.size() >= m_max_talkers)
+    {
+      return false;
+    }
+    talker = new Talker(client, m_mix_buf.size());
+    talker->dec = AudioDecoder::create(m_codec);
+    talker->enc = createEncoder();
+    if ((talker->dec == 0) || (talker->enc == 0))
+    {
+      cerr << "*** ERROR: Failed to create " << m_codec
+           << " codec for mixing TG #" << m_tg << endl;
+      delete talker;
+      return false;
+    }
+    talker->dec->registerSink(talker, false);
+    talker->enc->writeEncodedSamples.connect(
+        sigc::bind(mem_fun(*this, &TGMixer::sendTalkerAudio), client));
+    talker->enc->flushEncodedSamples.connect(
+        sigc::bind(mem_fun(*this, &TGMixer::flushTalkerAudio), client));
+    m_talkers.push_back(talker);
+    cout << client->callsign() << ": Mixing talker start on TG #" << m_tg
+         << " (" << m_talkers.size() << "/" << m_max_talkers << ")" << endl;
+
+    if (!m_mix_timer.isEnabled())
+    {
+      gettimeofday(&m_next_block_time, NULL);
+      m_mix_timer.setEnable(true);
+    }
+  }
+
+  talker->flushing = false;
+  gettimeofday(&talker->last_audio, NULL);
+  talker->dec->writeEncodedSamples(const_cast<uint8_t*>(&data.front()),
+                                   data.size());
+  return true;
+} /* TGMixer::writeAudio */
+
+
+void TGMixer::flushTalker(ReflectorClient *client)
+{
+  Talker *talker = findTalker(client);
+  if (talker != 0)
+  {
+    talker->flushing = true;
+    talker->dec->flushEncodedSamples();
+  }
+} /* TGMixer::flushTalker */
+
+
+void TGMixer::removeClient(ReflectorClient *client)
+{
+  for (TalkerList::iterator it = m_talkers.begin(); it != m_talkers.end(); ++it)
+  {
+    if ((*it)->client == client)
+    {
+        // Make sure that no flush message is sent to a disappearing client
+      (*it)->mix_minus_active = false;
+      deleteTalker(it);
+      return;
+    }
+  }
+} /* TGMixer::removeClient */
+
+
+bool TGMixer::isTalker(const ReflectorClient *client) const
+{
+  return findTalker(client) != 0;
+} /* TGMixer::isTalker */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+Async::AudioEncoder* TGMixer::createEncoder(void)
+{
+  AudioEncoder *enc = AudioEncoder::create(m_codec);
+  if (enc == 0)
+  {
+    cerr << "*** ERROR: Failed to create " << m_codec
+         << " audio encoder for mixing TG #" << m_tg << endl;
+    return 0;
+  }
+
+  string opt_prefix = string("MIX_") + enc->name() + "_ENC_";
+  list<string> names = m_cfg.listSection("GLOBAL");
+  for (list<string>::const_iterator nit=names.begin(); nit!=names.end(); ++nit)
+  {
+    if ((*nit).find(opt_prefix) == 0)
+    {
+      string opt_value;
+      m_cfg.getValue("GLOBAL", *nit, opt_value);
+      enc->setOption((*nit).substr(opt_prefix.size()), opt_value);
+    }
+  }
+  return enc;
+} /* TGMixer::createEncoder */
+
+
+TGMixer::Talker* TGMixer::findTalker(const ReflectorClient *client) const
+{
+  for (TalkerList::const_iterator it = m_talkers.begin();
+       it != m_talkers.end(); ++it)
+  {
+    if ((*it)->client == client)
+    {
+      return *it;
+    }
+  }
+  return 0;
+} /* TGMixer::findTalker */
+
+
+void TGMixer::deleteTalker(TalkerList::iterator it)
+{
+  Talker *talker = *it;
+  m_talkers.erase(it);
+  cout << talker->client->callsign() << ": Mixing talker stop on TG #"
+       << m_tg << endl;
+  if (talker->mix_minus_active)
+  {
+    talker->enc->flushSamples();
+  }
+  delete talker;
+} /* TGMixer::deleteTalker */
+
+
+void TGMixer::onMixTimer(Async::Timer *t)
+{
+  struct timeval now;
+  gettimeofday(&now, NULL);
+
+    // Start over if we have fallen too far behind, e.g. due to a long
+    // blocking operation somewhere else in the application
+  struct timeval diff;
+  timersub(&now, &m_next_block_time, &diff);
+  if ((diff.tv_sec > 0) || (diff.tv_usec > 5000L * BLOCK_TIME))
+  {
+    m_next_block_time = now;
+  }
+
+  const struct timeval block_time = {0, 1000L * BLOCK_TIME};
+  while (!timercmp(&m_next_block_time, &now, >))
+  {
+    mixBlock();
+    if (!m_mix_timer.isEnabled())
+    {
+      break;
+    }
+    timeradd(&m_next_block_time, &block_time, &m_next_block_time);
+  }
+} /* TGMixer::onMixTimer */
+
+
+void TGMixer::mixBlock(void)
+{
+  const size_t block_size = m_mix_buf.size();
+
+    // Read one block from each talker and sum them up
+  std::fill(m_mix_buf.begin(), m_mix_buf.end(), 0.0f);
+  size_t contributing = 0;
+  for (TalkerList::iterator it = m_talkers.begin(); it != m_talkers.end(); ++it)
+  {
+    Talker *talker = *it;
+    if (talker->prebuffering &&
+        (talker->flushing ||
+         (talker->samplesAvailable() >= MS_TO_SAMPLES(PREBUF_TIME))))
+    {
+      talker->prebuffering = false;
+    }
+    if (talker->prebuffering)
+    {
+      std::fill(talker->block.begin(), talker->block.end(), 0.0f);
+      continue;
+    }
+    talker->readBlock();
+    const float *src = &talker->block.front();
+    float *dest = &m_mix_buf.front();
+    for (size_t i=0; i<block_size; ++i)
+    {
+      dest[i] += src[i];
+    }
+    ++contributing;
+  }
+
+    // All pure listeners get the full mix from the shared encoder
+  if (contributing > 0)
+  {
+    m_listener_stream_active = true;
+  }
+  if (m_listener_stream_active)
+  {
+    for (size_t i=0; i<block_size; ++i)
+    {
+      m_out_buf[i] = clip(m_mix_buf[i]);
+    }
+    m_listener_enc->writeSamples(&m_out_buf.front(), block_size);
+  }
+
+    // Each talker get the mix minus its own audio. Nothing is sent to a
+    // talker if no one else is talking.
+  for (TalkerList::iterator it = m_talkers.begin(); it != m_talkers.end(); ++it)
+  {
+    Talker *talker = *it;
+    size_t others = contributing - (talker->prebuffering ? 0 : 1);
+    if (others > 0)
+    {
+      talker->mix_minus_active = true;
+    }
+    else if (talker->mix_minus_active)
+    {
+      talker->mix_minus_active = false;
+      talker->enc->flushSamples();
+      continue;
+    }
+    if (talker->mix_minus_active)
+    {
+      const float *own = &talker->block.front();
+      for (size_t i=0; i<block_size; ++i)
+      {
+        m_out_buf[i] = clip(m_mix_buf[i] - own[i]);
+      }
+      talker->enc->writeSamples(&m_out_buf.front(), block_size);
+    }
+  }
+
+    // Remove talkers that have stopped talking or left the talk group. The
+    // squelch timeout is applied to each mixed talker.
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  const unsigned sql_timeout = TGHandler::instance()->sqlTimeout();
+  TalkerList::iterator it = m_talkers.begin();
+  while (it != m_talkers.end())
+  {
+    Talker *talker = *it;
+    struct timeval diff;
+    timersub(&now, &talker->talk_start, &diff);
+    if ((sql_timeout > 0) &&
+        (diff.tv_sec >= static_cast<long>(sql_timeout)))
+    {
+      ReflectorClient *client = talker->client;
+      cout << client->callsign() << ": Talker audio timeout on TG #"
+           << m_tg << endl;
+      client->setBlock(TGHandler::instance()->sqlTimeoutBlocktime());
+      deleteTalker(it);
+      if (TGHandler::instance()->talkerForTG(m_tg) == client)
+      {
+        TGHandler::instance()->setTalkerForTG(m_tg, 0);
+      }
+      it = m_talkers.begin();
+      continue;
+    }
+    timersub(&now, &talker->last_audio, &diff);
+    bool is_idle = (diff.tv_sec * 1000 + diff.tv_usec / 1000) >
+                   static_cast<long>(TALKER_IDLE_TIME);
+    if ((TGHandler::instance()->TGForClient(talker->client) != m_tg) ||
+        ((talker->flushing || is_idle) && (talker->samplesAvailable() == 0)))
+    {
+      deleteTalker(it);
+      it = m_talkers.begin();
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  if (m_talkers.empty())
+  {
+    m_mix_timer.setEnable(false);
+    if (m_listener_stream_active)
+    {
+      m_listener_stream_active = false;
+      m_listener_enc->flushSamples();
+    }
+    idle(this);
+  }
+} /* TGMixer::mixBlock */
+
+
+void TGMixer::sendListenerAudio(const void *buf, int count)
+{
+  m_reflector->broadcastUdpAudio(buf, count,
+      ReflectorClient::mkAndFilter(
+        ReflectorClient::TgFilter(m_tg),
+        NotMixedFilter(this)));
+} /* TGMixer::sendListenerAudio */
+
+
+void TGMixer::flushListenerAudio(void)
+{
+  m_reflector->broadcastUdpMsg(MsgUdpFlushSamples(),
+      ReflectorClient::mkAndFilter(
+        ReflectorClient::TgFilter(m_tg),
+        NotMixedFilter(this)));
+} /* TGMixer::flushListenerAudio */
+
+
+void TGMixer::sendTalkerAudio(const void *buf, int count,
+                              ReflectorClient *client)
+{
+  client->sendUdpAudio(buf, count);
+} /* TGMixer::sendTalkerAudio */
+
+
+void TGMixer::flushTalkerAudio(ReflectorClient *client)
+{
+  client->sendUdpMsg(MsgUdpFlushSamples());
+} /* TGMixer::flushTalkerAudio */
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,273 @@
+/**
+@file   TGMixer.h
+@brief  Mix the audio from multiple concurrent talkers in a talk group
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef TG_MIXER_INCLUDED
+#define TG_MIXER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <sys/time.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class Config;
+  class AudioEncoder;
+  class AudioDecoder;
+};
+
+class Reflector;
+class ReflectorClient;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Mix the audio from multiple concurrent talkers in a talk group
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+Normally only one node at a time may talk in a talk group. For talk groups
+configured with MIX_TALKERS set to two or more, the reflector instead decode
+the audio from up to that many concurrent talkers, mix it and encode it again
+before sending it out.
+
+All nodes that are only listening receive the same mix, produced by one shared
+encoder. Each talker receive a "mix-minus", that is the mix without its own
+audio, produced by an encoder dedicated to that talker. The CPU load is
+therefore only dependent on the number of active talkers and not on the
+number of listening nodes.
+
+The audio is mixed in blocks of BLOCK_TIME milliseconds, paced by a timer.
+Each talker has a small jitter buffer that must be filled with PREBUF_TIME
+milliseconds of audio before the talker is included in the mix.
+*/
+class TGMixer : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The length of one mixed audio block in milliseconds
+     */
+    static const unsigned BLOCK_TIME        = 20;
+
+    /**
+     * @brief   The amount of audio to buffer before a talker is mixed in
+     */
+    static const unsigned PREBUF_TIME       = 60;
+
+    /**
+     * @brief   The maximum amount of audio to buffer for each talker
+     */
+    static const unsigned MAX_BUF_TIME      = 500;
+
+    /**
+     * @brief   Remove a talker after this long without audio (milliseconds)
+     */
+    static const unsigned TALKER_IDLE_TIME  = 1000;
+
+    /**
+     * @brief   The maximum number of concurrent talkers that can be mixed
+     */
+    static const unsigned MAX_TALKERS       = 8;
+
+    /**
+     * @brief   Constructor
+     * @param   reflector The reflector object used to send audio
+     * @param   cfg The reflector configuration
+     * @param   tg The talk group to mix audio for
+     * @param   codec The name of the audio codec to use
+     * @param   max_talkers The maximum number of concurrent talkers
+     */
+    TGMixer(Reflector *reflector, Async::Config& cfg, uint32_t tg,
+            const std::string& codec, unsigned max_talkers);
+
+    /**
+     * @brief   Destructor
+     */
+    ~TGMixer(void);
+
+    /**
+     * @brief   Get the talk group this mixer handle
+     * @return  Returns the talk group number
+     */
+    uint32_t tg(void) const { return m_tg; }
+
+    /**
+     * @brief   Write encoded audio received from a client
+     * @param   client The client that sent the audio
+     * @param   data The encoded audio
+     * @return  Returns \em false if all talker slots are occupied
+     */
+    bool writeAudio(ReflectorClient *client, const std::vector<uint8_t>& data);
+
+    /**
+     * @brief   Indicate that a talker has stopped talking
+     * @param   client The client that sent the flush request
+     *
+     * The talker is removed from the mix when its buffered audio has been
+     * played.
+     */
+    void flushTalker(ReflectorClient *client);
+
+    /**
+     * @brief   Immediately remove a client from the mixer
+     * @param   client The client to remove
+     */
+    void removeClient(ReflectorClient *client);
+
+    /**
+     * @brief   Check if a client is one of the mixed talkers
+     * @param   client The client to check
+     * @return  Returns \em true if the client is currently being mixed
+     */
+    bool isTalker(const ReflectorClient *client) const;
+
+    /**
+     * @brief   Get the number of talkers currently being mixed
+     * @return  Returns the number of active talkers
+     */
+    size_t talkerCount(void) const { return m_talkers.size(); }
+
+    /**
+     * @brief   A signal emitted when the mixer has become idle
+     * @param   mixer The mixer that has become idle
+     *
+     * This signal is emitted when all talkers have stopped and all audio has
+     * been sent. The mixer may be deleted at this point, but not from within
+     * the signal handler.
+     */
+    sigc::signal<void, TGMixer*> idle;
+
+  private:
+    class Talker;
+    typedef std::vector<Talker*> TalkerList;
+
+    Reflector*            m_reflector;
+    Async::Config&        m_cfg;
+    uint32_t              m_tg;
+    std::string           m_codec;
+    unsigned              m_max_talkers;
+    TalkerList            m_talkers;
+    Async::AudioEncoder*  m_listener_enc;
+    bool                  m_listener_stream_active;
+    Async::Timer          m_mix_timer;
+    struct timeval        m_next_block_time;
+    std::vector<float>    m_mix_buf;
+    std::vector<float>    m_out_buf;
+
+    TGMixer(const TGMixer&);
+    TGMixer& operator=(const TGMixer&);
+    Async::AudioEncoder* createEncoder(void);
+    Talker* findTalker(const ReflectorClient *client) const;
+    void deleteTalker(TalkerList::iterator it);
+    void onMixTimer(Async::Timer *t);
+    void mixBlock(void);
+    void sendListenerAudio(const void *buf, int count);
+    void flushListenerAudio(void);
+    void sendTalkerAudio(const void *buf, int count, ReflectorClient *client);
+    void flushTalkerAudio(ReflectorClient *client);
+
+};  /* class TGMixer */
+
+
+//} /* namespace */
+
+#endif /* TG_MIXER_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
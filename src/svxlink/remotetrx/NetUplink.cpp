@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iostream>
 #include <cstring>
 #include <cerrno>
+#include <cmath>
 
 
 /****************************************************************************
@@ -129,7 +130,9 @@ NetUplink::NetUplink(Config &cfg, const string &name, Rx *rx, Tx *tx,
     cfg(cfg), name(name), last_msg_timestamp(), heartbeat_timer(0),
     audio_enc(0), audio_dec(0), loopback_con(0), rx_splitter(0),
     tx_selector(0), state(STATE_DISC), mute_tx_timer(0), tx_muted(false),
-    fallback_enabled(false), tx_ctrl_mode(Tx::TX_OFF)
+    fallback_enabled(false), tx_ctrl_mode(Tx::TX_OFF),
+    telemetry_interval(DEFAULT_TELEMETRY_INTERVAL), telemetry_batching(false),
+    telemetry_timer(0)
 {
   heartbeat_timer = new Timer(10000);
   heartbeat_timer->setEnable(false);
@@ -155,6 +158,7 @@ NetUplink::~NetUplink(void)
   delete server;
   delete heartbeat_timer;
   delete mute_tx_timer;
+  delete telemetry_timer;
   //delete siglev_check_timer;
 } /* NetUplink::~NetUplink */
 
@@ -203,6 +207,15 @@ bool NetUplink::initialize(void)
     mute_tx_timer->expired.connect(mem_fun(*this, &NetUplink::unmuteTx));
   }
   
+  cfg.getValue(name, "TELEMETRY_INTERVAL", telemetry_interval, true);
+  if (telemetry_interval > 0)
+  {
+    telemetry_timer = new Timer(telemetry_interval);
+    telemetry_timer->setEnable(false);
+    telemetry_timer->expired.connect(
+        sigc::hide(mem_fun(*this, &NetUplink::flushTelemetry)));
+  }
+
   server = new TcpServer<>(listen_port);
   server->clientConnected.connect(mem_fun(*this, &NetUplink::clientConnected));
   server->clientDisconnected.connect(
@@ -223,7 +236,7 @@ bool NetUplink::initialize(void)
   rx_splitter = new AudioSplitter;
   rx->registerSink(rx_splitter);
 
-  loopback_con = new AudioPassthrough;
+  loopback_con = new AudioPassthrough(true);
   
   rx_splitter->addSink(loopback_con);
 
@@ -233,6 +246,7 @@ bool NetUplink::initialize(void)
   unsigned tx_jitter_buffer_delay = 0;
   cfg.getValue(name, "TX_JITTER_BUFFER_DELAY", tx_jitter_buffer_delay);
   fifo = new AudioFifo(INTERNAL_SAMPLE_RATE);
+  fifo->setName(name + "/Fifo");
   fifo->setPrebufSamples(tx_jitter_buffer_delay*INTERNAL_SAMPLE_RATE/1000);
   tx_selector->addSource(fifo);
   tx_selector->selectSource(fifo);
@@ -296,9 +310,14 @@ void NetUplink::handleIncomingConnection(TcpConnection *incoming_con)
   gettimeofday(&last_msg_timestamp, NULL);
   
   setState(STATE_CON_SETUP);
+  resetTelemetry();
 
   MsgProtoVer *ver_msg = new MsgProtoVer;
   sendMsg(ver_msg);
+    // Announce the supported protocol features in a second version message
+    // that older clients ignore while waiting for authentication
+  sendMsg(new MsgProtoVer(MsgProtoVer::MAJOR,
+                          MsgProtoVer::MINOR_TELEMETRY_BATCH));
   
   if (auth_key.empty())
   {
@@ -507,6 +526,21 @@ void NetUplink::handleMsg(Msg *msg)
     {
       break;
     }
+
+    case MsgProtoVer::TYPE:
+    {
+      MsgProtoVer *ver_msg = reinterpret_cast<MsgProtoVer*>(msg);
+      if ((msg->size() == sizeof(MsgProtoVer)) &&
+          (ver_msg->majorVer() == MsgProtoVer::MAJOR) &&
+          (ver_msg->minorVer() >= MsgProtoVer::MINOR_TELEMETRY_BATCH) &&
+          (telemetry_timer != 0))
+      {
+        cout << name << ": Using batched receiver telemetry every "
+             << telemetry_interval << "ms\n";
+        telemetry_batching = true;
+      }
+      break;
+    }
     
     case MsgReset::TYPE:
     {
@@ -741,6 +775,10 @@ void NetUplink::squelchOpen(bool is_open)
     }
   }
 
+    // Make sure that queued telemetry reach the other end before the
+    // squelch state change
+  flushTelemetry();
+
   MsgSquelch *msg = new MsgSquelch(is_open, rx->signalStrength(),
                                    rx->sqlRxId(), rx->squelchActivityInfo());
   sendMsg(msg);
@@ -751,6 +789,15 @@ void NetUplink::dtmfDigitDetected(char digit, int duration)
 {
   cout << name << ": DTMF digit detected: " << digit << " with duration " << duration
        << " milliseconds" << endl;
+  if (telemetry_batching)
+  {
+    MsgRxTelemetry::Entry entry;
+    entry.type = MsgRxTelemetry::ENTRY_DTMF;
+    entry.digit = digit;
+    entry.duration = duration;
+    queueTelemetryEvent(entry);
+    return;
+  }
   MsgDtmf *msg = new MsgDtmf(digit, duration);
   sendMsg(msg);
 } /* NetUplink::dtmfDigitDetected */
@@ -759,6 +806,14 @@ void NetUplink::dtmfDigitDetected(char digit, int duration)
 void NetUplink::toneDetected(float tone_fq)
 {
   cout << name << ": Tone detected: " << tone_fq << endl;
+  if (telemetry_batching)
+  {
+    MsgRxTelemetry::Entry entry;
+    entry.type = MsgRxTelemetry::ENTRY_TONE;
+    entry.tone_fq = tone_fq;
+    queueTelemetryEvent(entry);
+    return;
+  }
   MsgTone *msg = new MsgTone(tone_fq);
   sendMsg(msg);
 } /* NetUplink::toneDetected */
@@ -869,12 +924,108 @@ void NetUplink::setFallbackActive(bool activate)
 
 void NetUplink::signalLevelUpdated(float siglev)
 {
+  if (telemetry_batching)
+  {
+      // Only the latest signal level for each receiver is sent each tick
+    pending_siglev[rx->sqlRxId()] = rx->signalStrength();
+    telemetry_timer->setEnable(true);
+    return;
+  }
   MsgSiglevUpdate *msg = new MsgSiglevUpdate(rx->signalStrength(),
 					     rx->sqlRxId());
   sendMsg(msg);  
 } /* NetUplink::signalLevelUpdated */
 
 
+void NetUplink::queueTelemetryEvent(const MsgRxTelemetry::Entry& entry)
+{
+  pending_events.push_back(entry);
+  telemetry_timer->setEnable(true);
+} /* NetUplink::queueTelemetryEvent */
+
+
+void NetUplink::flushTelemetry(void)
+{
+  if (telemetry_timer != 0)
+  {
+    telemetry_timer->setEnable(false);
+  }
+  if (pending_siglev.empty() && pending_events.empty())
+  {
+    return;
+  }
+
+  MsgRxTelemetry *msg = new MsgRxTelemetry;
+  for (const auto& siglev : pending_siglev)
+  {
+    if (msg->isFull())
+    {
+      sendMsg(msg);
+      msg = new MsgRxTelemetry;
+    }
+    const char rx_id = siglev.first;
+    auto sent_it = sent_siglev.find(rx_id);
+    if (sent_it != sent_siglev.end())
+    {
+      float steps = roundf((siglev.second - sent_it->second) /
+                           MsgRxTelemetry::SIGLEV_DELTA_STEP);
+      if ((steps >= -128.0f) && (steps <= 127.0f))
+      {
+        if (steps != 0.0f)
+        {
+          msg->addSiglevDelta(rx_id, static_cast<int8_t>(steps));
+            // Track the value that the receiver will reconstruct so that
+            // rounding errors do not accumulate
+          sent_it->second += steps * MsgRxTelemetry::SIGLEV_DELTA_STEP;
+        }
+        continue;
+      }
+    }
+    msg->addSiglev(rx_id, siglev.second);
+    sent_siglev[rx_id] = siglev.second;
+  }
+  pending_siglev.clear();
+
+  for (const auto& entry : pending_events)
+  {
+    if (msg->isFull())
+    {
+      sendMsg(msg);
+      msg = new MsgRxTelemetry;
+    }
+    if (entry.type == MsgRxTelemetry::ENTRY_DTMF)
+    {
+      msg->addDtmf(entry.digit, entry.duration);
+    }
+    else if (entry.type == MsgRxTelemetry::ENTRY_TONE)
+    {
+      msg->addTone(entry.tone_fq);
+    }
+  }
+  pending_events.clear();
+
+  if (msg->isEmpty())
+  {
+    delete msg;
+    return;
+  }
+  sendMsg(msg);
+} /* NetUplink::flushTelemetry */
+
+
+void NetUplink::resetTelemetry(void)
+{
+  telemetry_batching = false;
+  if (telemetry_timer != 0)
+  {
+    telemetry_timer->setEnable(false);
+  }
+  pending_siglev.clear();
+  sent_siglev.clear();
+  pending_events.clear();
+} /* NetUplink::resetTelemetry */
+
+
 void NetUplink::forceDisconnect(void)
 {
   con->disconnect();
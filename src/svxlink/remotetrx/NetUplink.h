@@ -38,6 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 
 #include <string>
+#include <map>
+#include <vector>
 
 
 /****************************************************************************
@@ -160,6 +162,8 @@ class NetUplink : public Uplink
   protected:
     
   private:
+    static const int DEFAULT_TELEMETRY_INTERVAL = 100;
+
     typedef enum
     {
       STATE_DISC, STATE_CON_SETUP, STATE_READY, STATE_DISC_CLEANUP
@@ -190,6 +194,12 @@ class NetUplink : public Uplink
     bool		    tx_muted;
     bool                    fallback_enabled;
     Tx::TxCtrlMode	    tx_ctrl_mode;
+    int                     telemetry_interval;
+    bool                    telemetry_batching;
+    Async::Timer            *telemetry_timer;
+    std::map<char, float>   pending_siglev;
+    std::map<char, float>   sent_siglev;
+    std::vector<NetTrxMsg::MsgRxTelemetry::Entry> pending_events;
     
     NetUplink(const NetUplink&);
     NetUplink& operator=(const NetUplink&);
@@ -236,6 +246,9 @@ class NetUplink : public Uplink
     void unmuteTx(Async::Timer *t);
     void setFallbackActive(bool activate);
     void signalLevelUpdated(float siglev);
+    void queueTelemetryEvent(const NetTrxMsg::MsgRxTelemetry::Entry& entry);
+    void flushTelemetry(void);
+    void resetTelemetry(void);
     void forceDisconnect(void);
     void setState(State new_state) { state = new_state; }
 
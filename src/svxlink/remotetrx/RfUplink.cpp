@@ -282,7 +282,7 @@ bool RfUplink::initialize(void)
     tx_audio_sel = new AudioSelector;
     tx_audio_sel->addSource(prev_src);
     tx_audio_sel->enableAutoSelect(prev_src, 10);
-    AudioPassthrough *connector = new AudioPassthrough;
+    AudioPassthrough *connector = new AudioPassthrough(true);
     splitter->addSink(connector, true);
     tx_audio_sel->addSource(connector);
     tx_audio_sel->enableAutoSelect(connector, 0);
@@ -32,8 +32,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <map>
 
+#include <json/json.h>
+
 
 /****************************************************************************
  *
@@ -103,6 +106,7 @@ static float siglev_offset = 0.0;
 static std::map<float, CtcssMeasurement> ctcss_snr_sum;
 static std::map<float, float> ctcss_open_snr;
 static std::map<float, float> ctcss_close_snr;
+static bool json_output = false;
 
 
 /****************************************************************************
@@ -212,6 +216,32 @@ void sample_squelch_close(Timer *t)
       printf("\n");
     }
     cout << endl;
+
+    if (json_output)
+    {
+      Json::Value results(Json::objectValue);
+      results["section"] = rx->name();
+      results["siglev_slope"] = new_siglev_slope;
+      results["siglev_offset"] = new_siglev_offset;
+      Json::Value ctcss(Json::arrayValue);
+      for (const auto& entry : ctcss_close_snr)
+      {
+        Json::Value tone(Json::objectValue);
+        tone["fq"] = entry.first;
+        tone["snr"] = ctcss_open_snr[entry.first] - entry.second;
+        tone["snr_offset"] = entry.second;
+        ctcss.append(tone);
+      }
+      results["ctcss"] = ctcss;
+
+      Json::StreamWriterBuilder builder;
+      builder["commentStyle"] = "None";
+      builder["indentation"] = "  ";
+      Json::StreamWriter* writer = builder.newStreamWriter();
+      writer->write(results, &cout);
+      cout << endl;
+      delete writer;
+    }
     
     //rx->setVerbose(true);
     
@@ -321,13 +351,19 @@ int main(int argc, char **argv)
           "terms and conditions in\n";
   cout << "the GNU GPL (General Public License) version 2 or later.\n\n";
 
-  if (argc < 3)
+  int argi = 1;
+  if ((argc > argi) && (strcmp(argv[argi], "--json") == 0))
+  {
+    json_output = true;
+    ++argi;
+  }
+  if (argc - argi < 2)
   {
-    cerr << "Usage: siglevdetcal <config file> <receiver section>\n";
+    cerr << "Usage: siglevdetcal [--json] <config file> <receiver section>\n";
     exit(1);
   }
-  string cfg_file(argv[1]);
-  string rx_name(argv[2]);
+  string cfg_file(argv[argi]);
+  string rx_name(argv[argi+1]);
   
   if (!cfg.open(cfg_file))
   {
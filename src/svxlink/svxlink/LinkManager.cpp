@@ -292,7 +292,7 @@ void LinkManager::addLogic(LogicBase *logic)
     // Now create a connection from the new logic source to each sink.
   for (SinkMap::iterator it=sinks.begin(); it != sinks.end(); ++it)
   {
-    AudioPassthrough *connector = new AudioPassthrough;
+    AudioPassthrough *connector = new AudioPassthrough(true);
     splitter->addSink(connector, true);
     AudioSelector *other_selector = (*it).second.selector;
     other_selector->addSource(connector);
@@ -302,7 +302,7 @@ void LinkManager::addLogic(LogicBase *logic)
     // Now create a connection from each existing logic source to the new sink.
   for (SourceMap::iterator it=sources.begin(); it!=sources.end(); ++it)
   {
-    AudioPassthrough *connector = new AudioPassthrough;
+    AudioPassthrough *connector = new AudioPassthrough(true);
     (*it).second.splitter->addSink(connector, true);
     selector->addSource(connector);
     sinks[logic->name()].connectors[(*it).first] = connector;
@@ -73,6 +73,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioPacer.h>
 #include <AsyncAudioDebugger.h>
 #include <AsyncAudioRecorder.h>
+#include <AsyncPty.h>
+#include <AsyncUnixEventServer.h>
 #include <common.h>
 #include <config.h>
 
@@ -170,6 +172,7 @@ Logic::Logic(void)
     currently_set_tx_ctrl_mode(Tx::TX_OFF), is_online(true),
     dtmf_digit_handler(0),                  state_pty(0),
     dtmf_ctrl_pty(0),                       command_pty(0),
+    state_socket(0),
     m_ctcss_to_tg_timer(-1),                m_ctcss_to_tg_last_fq(0.0f)
 {
   rgr_sound_timer.expired.connect(sigc::hide(
@@ -268,6 +271,51 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
     }
   }
 
+  string state_socket_path;
+  cfg().getValue(name(), "STATE_SOCKET", state_socket_path);
+  if (!state_socket_path.empty())
+  {
+    state_socket = new UnixEventServer(state_socket_path);
+    if (!state_socket->open())
+    {
+      cerr << "*** ERROR: Could not open state socket "
+           << state_socket_path << " as specified in configuration variable "
+           << name() << "/" << "STATE_SOCKET" << endl;
+      cleanup();
+      return false;
+    }
+  }
+
+  FramedEventQueue::Framing state_framing = FramedEventQueue::FRAMING_TEXT;
+  string state_framing_str;
+  if (cfg().getValue(name(), "STATE_FRAMING", state_framing_str) &&
+      !FramedEventQueue::parseFraming(state_framing_str, state_framing))
+  {
+    cerr << "*** ERROR: Illegal value \"" << state_framing_str
+         << "\" for configuration variable " << name() << "/STATE_FRAMING. "
+         << "Valid values are TEXT, BINARY and JSON." << endl;
+    cleanup();
+    return false;
+  }
+  string state_filter_str;
+  cfg().getValue(name(), "STATE_FILTER", state_filter_str);
+  FramedEventQueue::Filter state_filter =
+    FramedEventQueue::parseFilter(state_filter_str);
+  bool state_coalesce = false;
+  cfg().getValue(name(), "STATE_COALESCE", state_coalesce);
+  if (state_pty != 0)
+  {
+    state_pty->setEventFraming(state_framing);
+    state_pty->setEventFilter(state_filter);
+    state_pty->setCoalesceEvents(state_coalesce);
+  }
+  if (state_socket != 0)
+  {
+    state_socket->setEventFraming(state_framing);
+    state_socket->setEventFilter(state_filter);
+    state_socket->setCoalesceEvents(state_coalesce);
+  }
+
   string dtmf_ctrl_pty_path;
   cfg().getValue(name(), "DTMF_CTRL_PTY", dtmf_ctrl_pty_path);
   if (!dtmf_ctrl_pty_path.empty())
@@ -436,13 +484,13 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   audio_to_module_selector = new AudioSelector;
 
     // Connect RX audio to the modules
-  AudioPassthrough *passthrough = new AudioPassthrough;
+  AudioPassthrough *passthrough = new AudioPassthrough(true);
   rx_splitter->addSink(passthrough, true);
   audio_to_module_selector->addSource(passthrough);
   audio_to_module_selector->enableAutoSelect(passthrough, 10);
 
     // Connect inter logic audio input to the modules
-  passthrough = new AudioPassthrough;
+  passthrough = new AudioPassthrough(true);
   logic_con_in->addSink(passthrough, true);
   audio_to_module_selector->addSource(passthrough);
   audio_to_module_selector->enableAutoSelect(passthrough, 0);
@@ -452,7 +500,7 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   audio_to_module_selector->registerSink(audio_to_module_splitter, true);
 
     // Connect RX audio to inter logic audio output
-  passthrough = new AudioPassthrough;
+  passthrough = new AudioPassthrough(true);
   rx_splitter->addSink(passthrough, true);
   logic_con_out->addSource(passthrough);
   logic_con_out->enableAutoSelect(passthrough, 10);
@@ -497,7 +545,7 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   tx_audio_selector->enableAutoSelect(audio_from_module_idle_det, 0);
 
     // Connect audio from modules to the inter logic audio output
-  passthrough = new AudioPassthrough;
+  passthrough = new AudioPassthrough(true);
   audio_from_module_splitter->addSink(passthrough, true);
   logic_con_out->addSource(passthrough);
   logic_con_out->enableAutoSelect(passthrough, 0);
@@ -535,12 +583,12 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
     }
 
       // Connect RX audio and link audio to the qso recorder
-    passthrough = new AudioPassthrough;
+    passthrough = new AudioPassthrough(true);
     audio_to_module_splitter->addSink(passthrough, true);
     qso_recorder->addSource(passthrough, 10);
 
       // Connect audio from modules to the qso recorder
-    passthrough = new AudioPassthrough;
+    passthrough = new AudioPassthrough(true);
     audio_from_module_splitter->addSink(passthrough, true);
     qso_recorder->addSource(passthrough, 0);
   }
@@ -554,6 +602,7 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
 
     // Add a pre-buffered FIFO to avoid underrun
   AudioFifo *tx_fifo = new AudioFifo(1024 * INTERNAL_SAMPLE_RATE / 8000);
+  tx_fifo->setName(name() + "/TxFifo");
   tx_fifo->setPrebufSamples(512 * INTERNAL_SAMPLE_RATE / 8000);
   prev_tx_src->registerSink(tx_fifo, true);
   prev_tx_src = tx_fifo;
@@ -1156,11 +1205,15 @@ void Logic::commandPtyCmdReceived(const void *buf, size_t count)
     }
     cfg().setValue(section, tag, value);
   }
+  else if (cmd == "FIFOS")
+  {
+    AudioFifo::printFifoInfo(std::cout);
+  }
   else
   {
     std::cerr << "*** ERROR: Unknown PTY command in logic "
               << name() << ": \"" << cmdline << "\". "
-              << "Valid commands are: CFG"
+              << "Valid commands are: CFG, FIFOS"
               << std::endl;
   }
 } /* Logic::commandPtyCmdReceived */
@@ -1734,6 +1787,7 @@ void Logic::cleanup(void)
   delete state_pty;                   state_pty = 0;
   delete dtmf_ctrl_pty;               dtmf_ctrl_pty = 0;
   delete command_pty;                 command_pty = 0;
+  delete state_socket;                state_socket = 0;
 } /* Logic::cleanup */
 
 
@@ -1769,18 +1823,14 @@ void Logic::onPublishStateEvent(const string &event_name, const string &msg)
 {
   publishStateEvent(event_name, msg);
 
-  if (state_pty == 0)
+  if (state_pty != 0)
   {
-    return;
+    state_pty->writeEvent(event_name, msg);
+  }
+  if (state_socket != 0)
+  {
+    state_socket->writeEvent(event_name, msg);
   }
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  stringstream os;
-  os << setfill('0');
-  os << tv.tv_sec << "." << setw(3) << tv.tv_usec / 1000 << " ";
-  os << event_name << " " << msg;
-  os << endl;
-  state_pty->write(os.str().c_str(), os.str().size());
 } /* Logic::onPublishStateEvent */
 
 
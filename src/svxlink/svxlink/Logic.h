@@ -90,6 +90,7 @@ namespace Async
   class AudioSource;
   class AudioSink;
   class Pty;
+  class UnixEventServer;
 };
 
 
@@ -295,6 +296,7 @@ class Logic : public LogicBase
     Async::Pty                      *dtmf_ctrl_pty;
     std::map<uint16_t, uint32_t>    m_ctcss_to_tg;
     Async::Pty                      *command_pty;
+    Async::UnixEventServer          *state_socket;
     Async::Timer                    m_ctcss_to_tg_timer;
     float                           m_ctcss_to_tg_last_fq;
 
@@ -150,7 +150,10 @@ ReflectorLogic::ReflectorLogic(void)
     m_mute_first_tx_loc(true), m_mute_first_tx_rem(false),
     m_tmp_monitor_timer(1000, Async::Timer::TYPE_PERIODIC),
     m_tmp_monitor_timeout(DEFAULT_TMP_MONITOR_TIMEOUT), m_use_prio(true),
-    m_qsy_pending_timer(-1), m_verbose(true)
+    m_qsy_pending_timer(-1), m_verbose(true), m_udp_frames_per_packet(1),
+    m_tx_frames_per_packet(1),
+    m_udp_tx_flush_timer(UDP_AUDIO_FLUSH_TIME, Timer::TYPE_ONESHOT, false),
+    m_node_list_epoch(0), m_node_list_version(0)
 {
   m_reconnect_timer.expired.connect(
       sigc::hide(mem_fun(*this, &ReflectorLogic::reconnect)));
@@ -158,6 +161,8 @@ ReflectorLogic::ReflectorLogic(void)
       mem_fun(*this, &ReflectorLogic::handleTimerTick));
   m_flush_timeout_timer.expired.connect(
       mem_fun(*this, &ReflectorLogic::flushTimeout));
+  m_udp_tx_flush_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &ReflectorLogic::sendPendingUdpAudio)));
   timerclear(&m_last_talker_timestamp);
 
   m_tg_select_timer.expired.connect(sigc::hide(
@@ -337,6 +342,7 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
 
     // Create jitter buffer
   AudioFifo *fifo = new Async::AudioFifo(2*INTERNAL_SAMPLE_RATE);
+  fifo->setName(name() + "/JitterBuffer");
   prev_src->registerSink(fifo, true);
   prev_src = fifo;
   unsigned jitter_buffer_delay = 0;
@@ -345,6 +351,14 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
   {
     fifo->setPrebufSamples(jitter_buffer_delay * INTERNAL_SAMPLE_RATE / 1000);
   }
+  unsigned jitter_buffer_max_delay = 0;
+  cfg().getValue(name(), "JITTER_BUFFER_MAX_DELAY", jitter_buffer_max_delay);
+  if (jitter_buffer_max_delay > 0)
+  {
+    fifo->setLatencyBudget(
+        jitter_buffer_max_delay * INTERNAL_SAMPLE_RATE / 1000,
+        AudioFifo::BUDGET_COMPRESS);
+  }
 
   prev_src->registerSink(m_logic_con_out, true);
   prev_src = 0;
@@ -440,6 +454,20 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
   cfg().getValue(name(), "UDP_HEARTBEAT_INTERVAL",
       m_udp_heartbeat_tx_cnt_reset);
 
+  if (cfg().getValue(name(), "UDP_FRAMES_PER_PACKET", m_udp_frames_per_packet))
+  {
+    if ((m_udp_frames_per_packet < 1) ||
+        (m_udp_frames_per_packet > MsgAudioFraming::MAX_FRAMES_PER_PACKET))
+    {
+      std::cerr << "*** ERROR[" << name() << "]: Illegal value ("
+                << m_udp_frames_per_packet << ") for UDP_FRAMES_PER_PACKET. "
+                << "Valid range is 1 to "
+                << unsigned(MsgAudioFraming::MAX_FRAMES_PER_PACKET) << "."
+                << std::endl;
+      return false;
+    }
+  }
+
   connect();
 
   return true;
@@ -762,6 +790,7 @@ void ReflectorLogic::onConnected(void)
             << " (" << (m_con.isPrimary() ? "primary" : "secondary") << ")"
             << std::endl;
   sendMsg(MsgProtoVer());
+  sendMsg(MsgNodeListSync(m_node_list_epoch, m_node_list_version));
   m_udp_heartbeat_tx_cnt = m_udp_heartbeat_tx_cnt_reset;
   m_udp_heartbeat_rx_cnt = UDP_HEARTBEAT_RX_CNT_RESET;
   m_tcp_heartbeat_tx_cnt = TCP_HEARTBEAT_TX_CNT_RESET;
@@ -769,6 +798,9 @@ void ReflectorLogic::onConnected(void)
   m_heartbeat_timer.setEnable(true);
   m_next_udp_tx_seq = 0;
   m_next_udp_rx_seq = 0;
+  m_tx_frames_per_packet = 1;
+  m_udp_tx_frames.clear();
+  m_udp_tx_flush_timer.setEnable(false);
   timerclear(&m_last_talker_timestamp);
   m_con_state = STATE_EXPECT_AUTH_CHALLENGE;
   m_con.setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
@@ -788,6 +820,9 @@ void ReflectorLogic::onDisconnected(TcpConnection *con,
   m_udp_sock = 0;
   m_next_udp_tx_seq = 0;
   m_next_udp_rx_seq = 0;
+  m_tx_frames_per_packet = 1;
+  m_udp_tx_frames.clear();
+  m_udp_tx_flush_timer.setEnable(false);
   m_heartbeat_timer.setEnable(false);
   if (m_flush_timeout_timer.isEnabled())
   {
@@ -869,6 +904,12 @@ void ReflectorLogic::onFrameReceived(FramedTcpConnection *con,
     case MsgRequestQsy::TYPE:
       handleMsgRequestQsy(ss);
       break;
+    case MsgAudioFraming::TYPE:
+      handleMsgAudioFraming(ss);
+      break;
+    case MsgNodeListUpdate::TYPE:
+      handleMsgNodeListUpdate(ss);
+      break;
     default:
       // Better just ignoring unknown messages for easier addition of protocol
       // messages while being backwards compatible
@@ -972,6 +1013,15 @@ void ReflectorLogic::handleMsgServerInfo(std::istream& is)
   }
   m_client_id = msg.clientId();
 
+    // A reflector supporting node list synchronization leave the node list
+    // empty and send a MsgNodeListUpdate instead. If we get a node list, or
+    // if our node list was not received through synchronization, the
+    // reflector list is used.
+  if (!msg.nodes().empty() || (m_node_list_epoch == 0))
+  {
+    setNodeList(msg.nodes());
+  }
+
   //cout << "### MsgServerInfo: clientId=" << msg.clientId()
   //     << " codecs=";
   //std::copy(msg.codecs().begin(), msg.codecs().end(),
@@ -1091,11 +1141,33 @@ void ReflectorLogic::handleMsgServerInfo(std::istream& is)
     sendMsg(MsgTgMonitor(
           std::set<uint32_t>(m_monitor_tgs.begin(), m_monitor_tgs.end())));
   }
+
+  if (m_udp_frames_per_packet > 1)
+  {
+    sendMsg(MsgAudioFraming(m_udp_frames_per_packet));
+  }
   sendUdpMsg(MsgUdpHeartbeat());
 
 } /* ReflectorLogic::handleMsgServerInfo */
 
 
+void ReflectorLogic::handleMsgAudioFraming(std::istream& is)
+{
+  MsgAudioFraming msg;
+  if (!msg.unpack(is))
+  {
+    cerr << "*** ERROR[" << name() << "]: Could not unpack MsgAudioFraming"
+         << endl;
+    disconnect();
+    return;
+  }
+  m_tx_frames_per_packet = std::max(1U, std::min(
+        unsigned(msg.framesPerPacket()), m_udp_frames_per_packet));
+  cout << name() << ": Using " << m_tx_frames_per_packet
+       << " audio frame(s) per UDP packet" << endl;
+} /* ReflectorLogic::handleMsgAudioFraming */
+
+
 void ReflectorLogic::handleMsgNodeList(std::istream& is)
 {
   MsgNodeList msg;
@@ -1105,6 +1177,7 @@ void ReflectorLogic::handleMsgNodeList(std::istream& is)
     disconnect();
     return;
   }
+  setNodeList(msg.nodes());
   cout << name() << ": Connected nodes: ";
   const vector<string>& nodes = msg.nodes();
   if (!nodes.empty())
@@ -1129,10 +1202,7 @@ void ReflectorLogic::handleMsgNodeJoined(std::istream& is)
     disconnect();
     return;
   }
-  if (m_verbose)
-  {
-    std::cout << name() << ": Node joined: " << msg.callsign() << std::endl;
-  }
+  nodeJoined(msg.callsign());
 } /* ReflectorLogic::handleMsgNodeJoined */
 
 
@@ -1145,11 +1215,111 @@ void ReflectorLogic::handleMsgNodeLeft(std::istream& is)
     disconnect();
     return;
   }
+  nodeLeft(msg.callsign());
+} /* ReflectorLogic::handleMsgNodeLeft */
+
+
+void ReflectorLogic::handleMsgNodeListUpdate(std::istream& is)
+{
+  MsgNodeListUpdate msg;
+  if (!msg.unpack(is))
+  {
+    cerr << "*** ERROR[" << name()
+         << "]: Could not unpack MsgNodeListUpdate\n";
+    disconnect();
+    return;
+  }
+
+  if (msg.isFull())
+  {
+    m_nodes.clear();
+    cout << name() << ": Connected nodes: ";
+    const char *sep = "";
+    for (const auto& rec : msg.records())
+    {
+      if (rec.joined() && (rec.callsign() != m_callsign))
+      {
+        m_nodes.insert(rec.callsign());
+        cout << sep << rec.callsign();
+        sep = ", ";
+      }
+    }
+    cout << endl;
+  }
+  else if ((msg.epoch() == m_node_list_epoch) &&
+           (msg.fromVersion() == m_node_list_version))
+  {
+    for (const auto& rec : msg.records())
+    {
+      if (rec.callsign() == m_callsign)
+      {
+        continue;
+      }
+      if (rec.joined())
+      {
+        nodeJoined(rec.callsign());
+      }
+      else
+      {
+        nodeLeft(rec.callsign());
+      }
+    }
+  }
+  else
+  {
+      // Ask for the full node list, unless we already have. Updates arriving
+      // before the full node list are ignored.
+    if (m_node_list_epoch != 0)
+    {
+      cerr << "*** WARNING[" << name() << "]: Node list out of sync "
+              "(version " << msg.fromVersion() << " received, "
+           << m_node_list_version << " expected). Requesting full node list."
+           << endl;
+      m_node_list_epoch = 0;
+      m_node_list_version = 0;
+      sendMsg(MsgNodeListSync());
+    }
+    return;
+  }
+  m_node_list_epoch = msg.epoch();
+  m_node_list_version = msg.version();
+  m_event_handler->setVariable(name() + "::connected_nodes", m_nodes.size());
+} /* ReflectorLogic::handleMsgNodeListUpdate */
+
+
+void ReflectorLogic::setNodeList(const std::vector<std::string>& nodes)
+{
+  m_node_list_epoch = 0;
+  m_node_list_version = 0;
+  m_nodes.clear();
+  for (const auto& callsign : nodes)
+  {
+    m_nodes.insert(callsign);
+  }
+  m_event_handler->setVariable(name() + "::connected_nodes", m_nodes.size());
+} /* ReflectorLogic::setNodeList */
+
+
+void ReflectorLogic::nodeJoined(const std::string& callsign)
+{
   if (m_verbose)
   {
-    std::cout << name() << ": Node left: " << msg.callsign() << std::endl;
+    std::cout << name() << ": Node joined: " << callsign << std::endl;
   }
-} /* ReflectorLogic::handleMsgNodeLeft */
+  m_nodes.insert(callsign);
+  m_event_handler->setVariable(name() + "::connected_nodes", m_nodes.size());
+} /* ReflectorLogic::nodeJoined */
+
+
+void ReflectorLogic::nodeLeft(const std::string& callsign)
+{
+  if (m_verbose)
+  {
+    std::cout << name() << ": Node left: " << callsign << std::endl;
+  }
+  m_nodes.erase(callsign);
+  m_event_handler->setVariable(name() + "::connected_nodes", m_nodes.size());
+} /* ReflectorLogic::nodeLeft */
 
 
 void ReflectorLogic::handleMsgTalkerStart(std::istream& is)
@@ -1289,6 +1459,21 @@ void ReflectorLogic::sendEncodedAudio(const void *buf, int count)
   {
     m_flush_timeout_timer.setEnable(false);
   }
+
+  if (m_tx_frames_per_packet > 1)
+  {
+    const uint8_t *bbuf = reinterpret_cast<const uint8_t*>(buf);
+    m_udp_tx_frames.push_back(std::vector<uint8_t>(bbuf, bbuf + count));
+    if (m_udp_tx_frames.size() >= m_tx_frames_per_packet)
+    {
+      sendPendingUdpAudio();
+      return;
+    }
+      // Do not hold back a partial packet if no more frames arrive
+    m_udp_tx_flush_timer.setEnable(true);
+    m_udp_tx_flush_timer.reset();
+    return;
+  }
   sendUdpMsg(MsgUdpAudio(buf, count));
 } /* ReflectorLogic::sendEncodedAudio */
 
@@ -1300,11 +1485,33 @@ void ReflectorLogic::flushEncodedAudio(void)
     flushTimeout();
     return;
   }
+  sendPendingUdpAudio();
   sendUdpMsg(MsgUdpFlushSamples());
   m_flush_timeout_timer.setEnable(true);
 } /* ReflectorLogic::flushEncodedAudio */
 
 
+void ReflectorLogic::sendPendingUdpAudio(void)
+{
+  m_udp_tx_flush_timer.setEnable(false);
+  if (m_udp_tx_frames.empty())
+  {
+    return;
+  }
+  if (m_udp_tx_frames.size() == 1)
+  {
+    sendUdpMsg(MsgUdpAudio(m_udp_tx_frames.front()));
+  }
+  else
+  {
+    MsgUdpAudioFrames msg;
+    msg.frames().swap(m_udp_tx_frames);
+    sendUdpMsg(msg);
+  }
+  m_udp_tx_frames.clear();
+} /* ReflectorLogic::sendPendingUdpAudio */
+
+
 void ReflectorLogic::udpDatagramReceived(const IpAddress& addr, uint16_t port,
                                          void *buf, int count)
 {
@@ -1390,6 +1597,26 @@ void ReflectorLogic::udpDatagramReceived(const IpAddress& addr, uint16_t port,
       break;
     }
 
+    case MsgUdpAudioFrames::TYPE:
+    {
+      MsgUdpAudioFrames msg;
+      if (!msg.unpack(ss))
+      {
+        cerr << "*** WARNING[" << name()
+             << "]: Could not unpack MsgUdpAudioFrames\n";
+        return;
+      }
+      for (auto& frame : msg.frames())
+      {
+        if (!frame.empty())
+        {
+          gettimeofday(&m_last_talker_timestamp, NULL);
+          m_dec->writeEncodedSamples(&frame.front(), frame.size());
+        }
+      }
+      break;
+    }
+
     case MsgUdpFlushSamples::TYPE:
       m_dec->flushEncodedSamples();
       timerclear(&m_last_talker_timestamp);
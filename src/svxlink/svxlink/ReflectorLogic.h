@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <sys/time.h>
 #include <string>
+#include <vector>
+#include <unordered_set>
 #include <json/json.h>
 
 
@@ -204,12 +206,15 @@ class ReflectorLogic : public LogicBase
     typedef Async::TcpPrioClient<Async::FramedTcpConnection> FramedTcpClient;
     typedef std::set<MonitorTgEntry> MonitorTgsSet;
 
+    typedef std::unordered_set<std::string> NodeSet;
+
     static const unsigned DEFAULT_UDP_HEARTBEAT_TX_CNT_RESET  = 15;
     static const unsigned UDP_HEARTBEAT_RX_CNT_RESET          = 60;
     static const unsigned TCP_HEARTBEAT_TX_CNT_RESET          = 10;
     static const unsigned TCP_HEARTBEAT_RX_CNT_RESET          = 15;
     static const unsigned DEFAULT_TG_SELECT_TIMEOUT           = 30;
     static const int      DEFAULT_TMP_MONITOR_TIMEOUT         = 3600;
+    static const int      UDP_AUDIO_FLUSH_TIME                = 100;
 
     std::string                       m_reflector_host;
     FramedTcpClient                   m_con;
@@ -256,6 +261,13 @@ class ReflectorLogic : public LogicBase
     bool                              m_use_prio;
     Async::Timer                      m_qsy_pending_timer;
     bool                              m_verbose;
+    unsigned                          m_udp_frames_per_packet;
+    unsigned                          m_tx_frames_per_packet;
+    std::vector<std::vector<uint8_t> > m_udp_tx_frames;
+    Async::Timer                      m_udp_tx_flush_timer;
+    NodeSet                           m_nodes;
+    uint32_t                          m_node_list_epoch;
+    uint32_t                          m_node_list_version;
 
     ReflectorLogic(const ReflectorLogic&);
     ReflectorLogic& operator=(const ReflectorLogic&);
@@ -275,9 +287,15 @@ class ReflectorLogic : public LogicBase
     void handleMsgRequestQsy(std::istream& is);
     void handleMsgAuthOk(void);
     void handleMsgServerInfo(std::istream& is);
+    void handleMsgAudioFraming(std::istream& is);
+    void handleMsgNodeListUpdate(std::istream& is);
+    void setNodeList(const std::vector<std::string>& nodes);
+    void nodeJoined(const std::string& callsign);
+    void nodeLeft(const std::string& callsign);
     void sendMsg(const ReflectorMsg& msg);
     void sendEncodedAudio(const void *buf, int count);
     void flushEncodedAudio(void);
+    void sendPendingUdpAudio(void);
     void udpDatagramReceived(const Async::IpAddress& addr, uint16_t port,
                              void *buf, int count);
     void sendUdpMsg(const ReflectorUdpMsg& msg);
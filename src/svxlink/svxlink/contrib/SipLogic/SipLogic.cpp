@@ -56,6 +56,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioCompressor.h>
 #include <AsyncAudioAmp.h>
 #include <AsyncAudioFilter.h>
+#include <AsyncAudioSampleConv.h>
 #include <AsyncTcpClient.h>
 #include <common.h>
 
@@ -327,7 +328,7 @@ bool SipLogic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   m_logic_con_out = new Async::AudioSelector;
 
    // Handler for audio stream from logic to sip
-  m_logic_con_in = new Async::AudioPassthrough;
+  m_logic_con_in = new Async::AudioPassthrough(true);
 
    // Init this LogicBase
   if (!LogicBase::initialize(cfgobj, logic_name))
@@ -621,7 +622,7 @@ bool SipLogic::initialize(Async::Config& cfgobj, const std::string& logic_name)
 
   /*************** incoming from sip ****************************/
   // handler for incoming sip audio stream
-  m_out_src = new AudioPassthrough;
+  m_out_src = new AudioPassthrough(true);
   AudioSource *prev_src = m_out_src;
 
    // Create jitter FIFO if jitter buffer delay > 0
@@ -638,7 +639,7 @@ bool SipLogic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   }
   else
   {
-    AudioPassthrough *passthrough = new AudioPassthrough;
+    AudioPassthrough *passthrough = new AudioPassthrough(true);
     prev_src->registerSink(passthrough, true);
     prev_src = passthrough;
   }
@@ -1158,12 +1159,7 @@ pj_status_t SipLogic::mediaPortGetFrame(pjmedia_port *port, pjmedia_frame *frame
 
   if ((got = m_ar->readSamples(smpl, count)) > 0)
   {
-    int i = 0;
-    for (float* s = smpl; s < smpl + sizeof(float)*got; s += sizeof(float))
-    {
-      samples[i] = (pj_int16_t)(smpl[i] * 32768);
-      i++;
-    }
+    AudioSampleConv::floatToS16(samples, smpl, got);
   }
 
   delete [] smpl;
@@ -1197,10 +1193,7 @@ pj_status_t SipLogic::mediaPortPutFrame(pjmedia_port *port, pjmedia_frame *frame
     pj_int16_t *samples = static_cast<pj_int16_t *>(frame->buf);
     frame->type = PJMEDIA_FRAME_TYPE_AUDIO;
     float* smpl = new float[count+1]();
-    for (int i=pos; i < count; i++)
-    {
-      smpl[i] = (float) (samples[i] / 32768.0);
-    }
+    AudioSampleConv::s16ToFloat(smpl, samples, count);
     do {
       int ret = m_out_src->writeSamples(smpl + pos, count - pos);
       pos += ret;
@@ -244,13 +244,13 @@ namespace {
       virtual int decFact(void) const { return d1.decFact() * d2.decFact(); }
       virtual void decimate(vector<T> &out, const vector<T> &in)
       {
-        vector<T> dec_samp1;
         d1.decimate(dec_samp1, in);
         d2.decimate(out, dec_samp1);
       }
 
     private:
       Decimator<T> &d1, &d2;
+      vector<T> dec_samp1;
   };
 
   template <class T>
@@ -266,7 +266,6 @@ namespace {
       }
       virtual void decimate(vector<T> &out, const vector<T> &in)
       {
-        vector<T> dec_samp1, dec_samp2;
         d1.decimate(dec_samp1, in);
         d2.decimate(dec_samp2, dec_samp1);
         d3.decimate(out, dec_samp2);
@@ -274,6 +273,7 @@ namespace {
 
     private:
       Decimator<T> &d1, &d2, &d3;
+      vector<T> dec_samp1, dec_samp2;
   };
 
   template <class T>
@@ -290,7 +290,6 @@ namespace {
       }
       virtual void decimate(vector<T> &out, const vector<T> &in)
       {
-        vector<T> dec_samp1, dec_samp2, dec_samp3;
         d1.decimate(dec_samp1, in);
         d2.decimate(dec_samp2, dec_samp1);
         d3.decimate(dec_samp3, dec_samp2);
@@ -299,6 +298,7 @@ namespace {
 
     private:
       Decimator<T> &d1, &d2, &d3, &d4;
+      vector<T> dec_samp1, dec_samp2, dec_samp3;
   };
 
   template <class T>
@@ -316,7 +316,6 @@ namespace {
       }
       virtual void decimate(vector<T> &out, const vector<T> &in)
       {
-        vector<T> dec_samp1, dec_samp2, dec_samp3, dec_samp4;
         d1.decimate(dec_samp1, in);
         d2.decimate(dec_samp2, dec_samp1);
         d3.decimate(dec_samp3, dec_samp2);
@@ -326,6 +325,7 @@ namespace {
 
     private:
       Decimator<T> &d1, &d2, &d3, &d4, &d5;
+      vector<T> dec_samp1, dec_samp2, dec_samp3, dec_samp4;
   };
 
 
@@ -356,18 +356,19 @@ namespace {
         }
       }
 
+      bool isEnabled(void) const { return !exp_lut.empty(); }
+
       void iq_received(vector<WbRxRtlSdr::Sample> &out,
                        const vector<WbRxRtlSdr::Sample> &in)
       {
         if (exp_lut.size() > 0)
         {
-          out.clear();
-          out.reserve(in.size());
-          vector<WbRxRtlSdr::Sample>::const_iterator it;
-          for (it = in.begin(); it != in.end(); ++it)
+          out.resize(in.size());
+          const size_t N = exp_lut.size();
+          for (size_t i=0; i<in.size(); ++i)
           {
-            out.push_back(*it * exp_lut[n]);
-            if (++n == exp_lut.size())
+            out[i] = in[i] * exp_lut[n];
+            if (++n == N)
             {
               n = 0;
             }
@@ -423,17 +424,14 @@ namespace {
       void iq_received(vector<WbRxRtlSdr::Sample> &out,
                        const vector<WbRxRtlSdr::Sample> &in)
       {
-        out.clear();
-        out.reserve(in.size());
+        out.resize(in.size());
         float P = 0.0f;
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = in.begin();
-             it != in.end();
-             ++it)
+        for (size_t idx=0; idx<in.size(); ++idx)
         {
-          const WbRxRtlSdr::Sample &samp = *it;
+          const WbRxRtlSdr::Sample &samp = in[idx];
           WbRxRtlSdr::Sample osamp = m_gain * samp;
           P = osamp.real() * osamp.real() + osamp.imag() * osamp.imag();
-          out.push_back(osamp);
+          out[idx] = osamp;
 
           float err = m_reference - P;
           float rate;
@@ -473,7 +471,7 @@ namespace {
     public:
       virtual ~Demodulator(void) {}
 
-      virtual void iq_received(vector<WbRxRtlSdr::Sample> samples) = 0;
+      virtual void iq_received(const vector<WbRxRtlSdr::Sample> &samples) = 0;
 
       /**
        * @brief Resume audio output to the sink
@@ -553,7 +551,7 @@ namespace {
         dec->setGain(adj_db);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
       {
           // From article-sdr-is-qs.pdf: Watch your Is and Qs:
           //   FM = (Qn.In-1 - In.Qn-1)/(In.In-1 + Qn.Qn-1)
@@ -561,7 +559,7 @@ namespace {
           // A more indepth report:
           //   Implementation of FM demodulator algorithms on a
           //   high performance digital signal processor
-        vector<float> audio;
+        audio.resize(samples.size());
         for (size_t idx=0; idx<samples.size(); ++idx)
         {
           complex<float> samp = samples[idx];
@@ -576,9 +574,8 @@ namespace {
           iold = i;
           qold = q;
 
-          audio.push_back(demod);
+          audio[idx] = demod;
         }
-        vector<float> dec_audio;
         dec->decimate(dec_audio, audio);
         sinkWriteSamples(&dec_audio[0], dec_audio.size());
       }
@@ -589,6 +586,8 @@ namespace {
       Decimator<float> audio_dec_wb;
       Decimator<float> audio_dec;
       DecimatorMS<float> *dec;
+      vector<float> audio;
+      vector<float> dec_audio;
   };
 
 
@@ -602,23 +601,24 @@ namespace {
         agc.setReference(1);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
         agc.iq_received(gain_adjusted, samples);
 
-        vector<float> audio;
+        audio.resize(gain_adjusted.size());
         for (size_t idx=0; idx<gain_adjusted.size(); ++idx)
         {
           complex<float> samp = gain_adjusted[idx];
           float demod = abs(samp);
-          audio.push_back(demod);
+          audio[idx] = demod;
         }
         sinkWriteSamples(&audio[0], audio.size());
       }
 
     private:
-      AGC              agc;
+      AGC                         agc;
+      vector<WbRxRtlSdr::Sample>  gain_adjusted;
+      vector<float>               audio;
   };
 
 
@@ -639,7 +639,7 @@ namespace {
         use_lsb = use;
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
       {
         vector<float> Q, Qh, audio;
         Q.reserve(samples.size());
@@ -690,29 +690,25 @@ namespace {
         trans.setOffset(lsb ? 2000 : -2000);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
         agc.iq_received(gain_adjusted, samples);
-
-        vector<WbRxRtlSdr::Sample> translated;
         trans.iq_received(translated, gain_adjusted);
 
-        vector<float> audio;
-        audio.reserve(gain_adjusted.size());
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = translated.begin();
-             it != translated.end();
-             ++it)
+        audio.resize(translated.size());
+        for (size_t idx=0; idx<translated.size(); ++idx)
         {
-          float demod = it->real();
-          audio.push_back(demod);
+          audio[idx] = translated[idx].real();
         }
         sinkWriteSamples(&audio[0], audio.size());
       }
 
     private:
-      Translate         trans;
-      AGC               agc;
+      Translate                   trans;
+      AGC                         agc;
+      vector<WbRxRtlSdr::Sample>  gain_adjusted;
+      vector<WbRxRtlSdr::Sample>  translated;
+      vector<float>               audio;
   };
 #endif
 
@@ -728,28 +724,25 @@ namespace {
         agc.setReference(0.05);
       }
 
-      void iq_received(vector<WbRxRtlSdr::Sample> samples)
+      void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
       {
-        vector<WbRxRtlSdr::Sample> gain_adjusted;
         agc.iq_received(gain_adjusted, samples);
-
-        vector<WbRxRtlSdr::Sample> translated;
         trans.iq_received(translated, gain_adjusted);
-        vector<float> audio;
-        audio.reserve(translated.size());
-        for (vector<WbRxRtlSdr::Sample>::const_iterator it = translated.begin();
-             it != translated.end();
-             ++it)
+
+        audio.resize(translated.size());
+        for (size_t idx=0; idx<translated.size(); ++idx)
         {
-          float demod = it->real();
-          audio.push_back(demod);
+          audio[idx] = translated[idx].real();
         }
         sinkWriteSamples(&audio[0], audio.size());
       }
 
     private:
-      Translate         trans;
-      AGC               agc;
+      Translate                   trans;
+      AGC                         agc;
+      vector<WbRxRtlSdr::Sample>  gain_adjusted;
+      vector<WbRxRtlSdr::Sample>  translated;
+      vector<float>               audio;
   };
 
 
@@ -970,7 +963,7 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       : sample_rate(sample_rate), channelizer(0),
         fm_demod(32000, 5000.0), ssb_demod(16000), cw_demod(16000), demod(0),
         trans(sample_rate, fq_offset), enabled(true), ch_offset(0),
-        fq_offset(fq_offset)
+        fq_offset(fq_offset), ch_bw(0)
     {
     }
 
@@ -1013,29 +1006,35 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       switch (mod)
       {
         case Modulation::MOD_FM:
+          ch_bw = 20000;
           channelizer->setBw(Channelizer::BW_20K);
           fm_demod.setDemodParams(channelizer->chSampRate(), 5000);
           demod = &fm_demod;
           break;
         case Modulation::MOD_NBFM:
+          ch_bw = 10000;
           channelizer->setBw(Channelizer::BW_10K);
           fm_demod.setDemodParams(channelizer->chSampRate(), 2500);
           demod = &fm_demod;
           break;
         case Modulation::MOD_WBFM:
+          ch_bw = 180000;
           channelizer->setBw(Channelizer::BW_WIDE);
           fm_demod.setDemodParams(channelizer->chSampRate(), 75000);
           demod = &fm_demod;
           break;
         case Modulation::MOD_AM:
+          ch_bw = 10000;
           channelizer->setBw(Channelizer::BW_10K);
           demod = &am_demod;
           break;
         case Modulation::MOD_NBAM:
+          ch_bw = 6000;
           channelizer->setBw(Channelizer::BW_6K);
           demod = &am_demod;
           break;
         case Modulation::MOD_USB:
+          ch_bw = 3000;
 #ifdef USE_SSB_PHASE_DEMOD
           channelizer->setBw(Channelizer::BW_6K);
 #else
@@ -1046,6 +1045,7 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
           demod = &ssb_demod;
           break;
         case Modulation::MOD_LSB:
+          ch_bw = 3000;
 #ifdef USE_SSB_PHASE_DEMOD
           channelizer->setBw(Channelizer::BW_6K);
 #else
@@ -1056,10 +1056,12 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
           demod = &ssb_demod;
           break;
         case Modulation::MOD_CW:
+          ch_bw = 500;
           channelizer->setBw(Channelizer::BW_500);
           demod = &cw_demod;
           break;
         case Modulation::MOD_WBCW:
+          ch_bw = 3000;
           channelizer->setBw(Channelizer::BW_3K);
           demod = &cw_demod;
           break;
@@ -1076,13 +1078,21 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       return channelizer->chSampRate();
     }
 
-    void iq_received(vector<WbRxRtlSdr::Sample> samples)
+    unsigned bandwidth(void) const { return ch_bw; }
+
+    int centerOffset(void) const { return fq_offset - ch_offset; }
+
+    void iq_received(const vector<WbRxRtlSdr::Sample> &samples)
     {
       if (enabled)
       {
-        vector<WbRxRtlSdr::Sample> translated, channelized;
-        trans.iq_received(translated, samples);
-        channelizer->iq_received(channelized, translated);
+        const vector<WbRxRtlSdr::Sample> *in = &samples;
+        if (trans.isEnabled())
+        {
+          trans.iq_received(translated, samples);
+          in = &translated;
+        }
+        channelizer->iq_received(channelized, *in);
         demod->iq_received(channelized);
       }
     };
@@ -1113,6 +1123,9 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
     bool enabled;
     int ch_offset;
     int fq_offset;
+    unsigned ch_bw;
+    vector<WbRxRtlSdr::Sample> translated;
+    vector<WbRxRtlSdr::Sample> channelized;
 }; /* Channel */
 
 
@@ -1160,7 +1173,9 @@ Ddr *Ddr::find(const std::string &name)
 
 Ddr::Ddr(Config &cfg, const std::string& name)
   : LocalRxBase(cfg, name), cfg(cfg), channel(0), rtl(0),
-    fq(0)
+    fq(0), park_enabled(false), park_thresh(0.0f),
+    park_delay(DEFAULT_PARK_DELAY), park_cnt(0), parked(false),
+    parked_blocks(0)
 {
 } /* Ddr::Ddr */
 
@@ -1228,7 +1243,7 @@ bool Ddr::initialize(void)
     return false;
   }
   channel->preDemod.connect(preDemod.make_slot());
-  rtl->iqReceived.connect(mem_fun(*channel, &Channel::iq_received));
+  rtl->iqReceived.connect(mem_fun(*this, &Ddr::iqReceived));
   rtl->readyStateChanged.connect(readyStateChanged.make_slot());
 
   string modstr("FM");
@@ -1247,6 +1262,13 @@ bool Ddr::initialize(void)
     return false;
   }
 
+  if (cfg.getValue(name(), "PARK_THRESH", park_thresh))
+  {
+    park_enabled = true;
+    cfg.getValue(name(), "PARK_DELAY", park_delay);
+    rtl->enableChannelPower();
+  }
+
   if (!LocalRxBase::initialize())
   {
     delete channel;
@@ -1353,6 +1375,52 @@ void Ddr::updateFqOffset(void)
 } /* Ddr::updateFqOffset */
 
 
+void Ddr::iqReceived(const RtlTcp::IqBlock &block)
+{
+  const std::vector<RtlTcp::Sample> &samples = *block;
+  if (park_enabled && channel->isEnabled())
+  {
+      // Park the channel, that is stop all processing, when the power in the
+      // channel has been below the threshold for a while. The channel is
+      // never parked while the squelch is open since it would then be stuck
+      // open. When the power goes above the threshold again, the blocks
+      // skipped while parked are run through the channel before the new
+      // samples so that nothing is lost.
+    float pwr = rtl->channelPower(channel->centerOffset(), channel->bandwidth());
+    if ((pwr >= park_thresh) || squelchIsOpen())
+    {
+      park_cnt = 0;
+      if (parked)
+      {
+        parked = false;
+        const WbRxRtlSdr::IqHistory& history = rtl->iqHistory();
+        size_t replay_cnt = std::min(parked_blocks, history.size());
+        for (WbRxRtlSdr::IqHistory::const_iterator it =
+               history.end() - replay_cnt;
+             it != history.end(); ++it)
+        {
+          channel->iq_received(**it);
+        }
+      }
+    }
+    else if (!parked)
+    {
+      park_cnt += samples.size();
+      parked = (park_cnt >= rtl->sampleRate() / 1000 * park_delay);
+      parked_blocks = 0;
+    }
+
+    if (parked)
+    {
+      ++parked_blocks;
+      return;
+    }
+  }
+
+  channel->iq_received(samples);
+} /* Ddr::iqReceived */
+
+
 
 /*
  * This file has not been truncated
@@ -230,14 +230,23 @@ class Ddr : public LocalRxBase
     class Channel;
     typedef std::map<std::string, Ddr*> DdrMap;
 
+    static const unsigned DEFAULT_PARK_DELAY = 1000;
+
     static DdrMap ddr_map;
 
     Async::Config           &cfg;
     Channel                 *channel;
     WbRxRtlSdr              *rtl;
     double                  fq;
+    bool                    park_enabled;
+    float                   park_thresh;
+    unsigned                park_delay;
+    size_t                  park_cnt;
+    bool                    parked;
+    size_t                  parked_blocks;
 
     void updateFqOffset(void);
+    void iqReceived(const RtlTcp::IqBlock &block);
     
 };  /* class Ddr */
 
@@ -3,6 +3,12 @@
 #include <fstream>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <algorithm>
 
 #include <AsyncConfig.h>
 #include <AsyncAudioNoiseAdder.h>
@@ -178,8 +184,319 @@ class PowerPlotter : public Async::AudioPassthrough
 }; /* class PowerPlotter */
 
 
-int main()
+/*
+ * Benchmark and detection test of the software DTMF decoders
+ *
+ * The software decoders that can run stand-alone (INTERNAL and DH1DM) are
+ * run against a corpus of synthetic signals. The AFSK decoder need a receiver
+ * and the other decoder types use external hardware. The corpus contain
+ * digits that must be detected (nominal level, noise, twist, frequency error
+ * and minimum duration according to the ETSI ES 201 235-3 requirements) and
+ * signals that must not cause a detection (excessive twist, frequency error
+ * and too short duration, and a talk-off test using a speech like signal).
+ * For each decoder the processing time per sample and the detection result
+ * for each test is reported.
+ *
+ * Run the benchmark using: DtmfDecoderTest --bench
+ */
+namespace {
+const float row_fqs[] = { 697.0f, 770.0f, 852.0f, 941.0f };
+const float col_fqs[] = { 1209.0f, 1336.0f, 1477.0f, 1633.0f };
+const char digit_map[4][4] =
+{
+  { '1', '2', '3', 'A' },
+  { '4', '5', '6', 'B' },
+  { '7', '8', '9', 'C' },
+  { '*', '0', '#', 'D' }
+};
+const string all_digits = "0123456789ABCD*#";
+
+struct BenchTest
+{
+  string        name;
+  vector<float> samples;
+  string        expected;
+};
+
+  // Power in dB relative to a full scale sine wave
+float powerToAmp(float pwr_db)
+{
+  return sqrtf(2.0f * 0.5f * powf(10.0f, pwr_db / 10.0f));
+}
+
+void addSilence(vector<float>& samples, int ms)
+{
+  samples.resize(samples.size() + ms * INTERNAL_SAMPLE_RATE / 1000, 0.0f);
+}
+
+  // Twist is the power of the low (row) tone relative to the high (column)
+  // tone. The frequency error is given as a fraction of the tone frequency.
+void addDigit(vector<float>& samples, char digit, int ms, float pwr_db=-10.0f,
+              float twist_db=0.0f, float row_fq_err=0.0f,
+              float col_fq_err=0.0f)
+{
+  float row_fq = 0.0f;
+  float col_fq = 0.0f;
+  for (int r=0; r<4; ++r)
+  {
+    for (int c=0; c<4; ++c)
+    {
+      if (digit_map[r][c] == digit)
+      {
+        row_fq = row_fqs[r] * (1.0f + row_fq_err);
+        col_fq = col_fqs[c] * (1.0f + col_fq_err);
+      }
+    }
+  }
+  const float twist = powf(10.0f, twist_db / 10.0f);
+  const float row_amp = powerToAmp(pwr_db + 10.0f * log10f(twist / (1+twist)));
+  const float col_amp = powerToAmp(pwr_db + 10.0f * log10f(1.0f / (1+twist)));
+  const size_t len = ms * INTERNAL_SAMPLE_RATE / 1000;
+  for (size_t n=0; n<len; ++n)
+  {
+    const float t = static_cast<float>(n) / INTERNAL_SAMPLE_RATE;
+    samples.push_back(row_amp * sinf(2.0f * M_PI * row_fq * t) +
+                      col_amp * sinf(2.0f * M_PI * col_fq * t));
+  }
+}
+
+void addNoise(vector<float>& samples, float pwr_db, std::mt19937& rng)
 {
+  std::normal_distribution<float> dist(0.0f, powerToAmp(pwr_db) / sqrtf(2.0f));
+  for (auto& sample : samples)
+  {
+    sample += dist(rng);
+  }
+}
+
+  // A crude speech like signal. A glottal pulse train with varying pitch is
+  // filtered through three resonators with randomly moving formant
+  // frequencies. Some segments are unvoiced (noise excited) and some are
+  // silent.
+void addSpeech(vector<float>& samples, int seconds, std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+  const float fs = INTERNAL_SAMPLE_RATE;
+  const float formant_lo[] = { 250.0f, 800.0f, 2000.0f };
+  const float formant_hi[] = { 900.0f, 2500.0f, 3500.0f };
+  float y1[3] = {0.0f, 0.0f, 0.0f};
+  float y2[3] = {0.0f, 0.0f, 0.0f};
+  float phase = 0.0f;
+  const size_t seg_len = 40 * INTERNAL_SAMPLE_RATE / 1000;
+  const size_t seg_cnt = seconds * 25;
+  vector<float> speech;
+  speech.reserve(seg_cnt * seg_len);
+  for (size_t seg=0; seg<seg_cnt; ++seg)
+  {
+    const float type = uni(rng);
+    const bool voiced = type < 0.7f;
+    const bool silent = type > 0.9f;
+    const float pitch = 80.0f + 220.0f * uni(rng);
+    float a1[3], a2[3];
+    for (int f=0; f<3; ++f)
+    {
+      const float fq = formant_lo[f] +
+                       (formant_hi[f] - formant_lo[f]) * uni(rng);
+      const float bw = 60.0f + 100.0f * uni(rng);
+      const float r = expf(-M_PI * bw / fs);
+      a1[f] = 2.0f * r * cosf(2.0f * M_PI * fq / fs);
+      a2[f] = -r * r;
+    }
+    for (size_t n=0; n<seg_len; ++n)
+    {
+      float x = 0.0f;
+      if (!silent)
+      {
+        if (voiced)
+        {
+          phase += pitch / fs;
+          if (phase >= 1.0f)
+          {
+            phase -= 1.0f;
+            x = 1.0f;
+          }
+        }
+        else
+        {
+          x = 0.1f * (uni(rng) - 0.5f);
+        }
+      }
+      float y = 0.0f;
+      for (int f=0; f<3; ++f)
+      {
+        const float yf = x + a1[f] * y1[f] + a2[f] * y2[f];
+        y2[f] = y1[f];
+        y1[f] = yf;
+        y += yf / (f + 1);
+      }
+      speech.push_back(y);
+    }
+  }
+
+    // Normalize to -15dB relative to a full scale sine wave
+  double pwr = 0.0;
+  for (float sample : speech)
+  {
+    pwr += static_cast<double>(sample) * sample;
+  }
+  pwr /= speech.size();
+  const float gain = sqrtf(0.5f * powf(10.0f, -15.0f / 10.0f) / pwr);
+  for (float sample : speech)
+  {
+    samples.push_back(gain * sample);
+  }
+}
+
+vector<BenchTest> createBenchCorpus(void)
+{
+  std::mt19937 rng(4711);
+  vector<BenchTest> corpus;
+
+  auto add_digits_test = [&](const string& name, bool expect, int ms,
+                             float pwr_db, float twist_db, float row_fq_err,
+                             float col_fq_err, float noise_db)
+  {
+    BenchTest test;
+    test.name = name;
+    addSilence(test.samples, 100);
+    for (char digit : all_digits)
+    {
+      addDigit(test.samples, digit, ms, pwr_db, twist_db, row_fq_err,
+               col_fq_err);
+      addSilence(test.samples, 100);
+    }
+    addNoise(test.samples, noise_db, rng);
+    test.expected = expect ? all_digits : "";
+    corpus.push_back(test);
+  };
+
+    // Digits that must be detected
+  add_digits_test("nominal",         true,  100, -10.0f,   0.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("low level",       true,  100, -30.0f,   0.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("noise -22dB",     true,  100, -10.0f,   0.0f,  0.0f,
+                  0.0f, -22.0f);
+  add_digits_test("twist +4dB",      true,  100, -10.0f,   4.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("twist -4dB",      true,  100, -10.0f,  -4.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("freq +1.5%",      true,  100, -10.0f,   0.0f,  0.015f,
+                  0.015f, -60.0f);
+  add_digits_test("freq -1.5%",      true,  100, -10.0f,   0.0f, -0.015f,
+                  -0.015f, -60.0f);
+  add_digits_test("duration 40ms",   true,  40, -10.0f,   0.0f,  0.0f,
+                  0.0f, -60.0f);
+
+    // Signals that must not be detected
+  add_digits_test("twist +12dB",     false, 100, -10.0f,  12.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("twist -12dB",     false, 100, -10.0f, -12.0f,  0.0f,
+                  0.0f, -60.0f);
+  add_digits_test("freq +3.5%",      false, 100, -10.0f,   0.0f,  0.035f,
+                  0.035f, -60.0f);
+  add_digits_test("freq -3.5%",      false, 100, -10.0f,   0.0f, -0.035f,
+                  -0.035f, -60.0f);
+  add_digits_test("duration 20ms",   false, 20, -10.0f,   0.0f,  0.0f,
+                  0.0f, -60.0f);
+
+  BenchTest talk_off;
+  talk_off.name = "talk-off 60s";
+  addSpeech(talk_off.samples, 60, rng);
+  addNoise(talk_off.samples, -40.0f, rng);
+  corpus.push_back(talk_off);
+
+  return corpus;
+}
+
+  // Count the number of expected digits received in order. All other
+  // received digits are counted as false detections.
+size_t countHits(const string& expected, const string& received)
+{
+  size_t hits = 0;
+  size_t pos = 0;
+  for (char digit : received)
+  {
+    if ((pos < expected.size()) && (expected[pos] == digit))
+    {
+      ++hits;
+      ++pos;
+    }
+  }
+  return hits;
+}
+
+int runBenchmark(void)
+{
+  const char *dec_types[] = { "INTERNAL", "DH1DM" };
+  const int chunk_size = 64;
+
+  vector<BenchTest> corpus = createBenchCorpus();
+
+  cout << "Decoder   Test              Detected    False" << endl;
+  for (const char *dec_type : dec_types)
+  {
+    Config cfg;
+    cfg.setValue("Bench", "DTMF_DEC_TYPE", dec_type);
+
+    size_t sample_cnt = 0;
+    std::chrono::steady_clock::duration proc_time(0);
+    size_t hits_tot = 0;
+    size_t expected_tot = 0;
+    size_t false_tot = 0;
+    for (const auto& test : corpus)
+    {
+      std::unique_ptr<DtmfDecoder> dec(DtmfDecoder::create(0, cfg, "Bench"));
+      if ((dec == nullptr) || !dec->initialize())
+      {
+        cout << "*** ERROR: Could not initialize DTMF decoder "
+             << dec_type << endl;
+        exit(1);
+      }
+      string received;
+      dec->digitActivated.connect(
+          [&received](char digit) { received += digit; });
+
+      auto start = std::chrono::steady_clock::now();
+      for (size_t pos=0; pos<test.samples.size(); pos+=chunk_size)
+      {
+        int cnt = std::min(static_cast<size_t>(chunk_size),
+                           test.samples.size() - pos);
+        dec->writeSamples(&test.samples[pos], cnt);
+      }
+      proc_time += std::chrono::steady_clock::now() - start;
+      sample_cnt += test.samples.size();
+
+      size_t hits = countHits(test.expected, received);
+      size_t false_cnt = received.size() - hits;
+      hits_tot += hits;
+      expected_tot += test.expected.size();
+      false_tot += false_cnt;
+      cout << setw(10) << left << dec_type << setw(18) << test.name << right
+           << setw(3) << hits << "/" << setw(2) << test.expected.size()
+           << setw(10) << false_cnt << endl;
+    }
+    double ns_per_sample =
+      std::chrono::duration<double, std::nano>(proc_time).count() / sample_cnt;
+    cout << setw(10) << left << dec_type << setw(18) << "TOTAL" << right
+         << setw(3) << hits_tot << "/" << setw(2) << expected_tot
+         << setw(10) << false_tot << "   " << fixed << setprecision(2)
+         << ns_per_sample << " ns/sample" << endl << endl;
+    cout.unsetf(ios::floatfield);
+  }
+
+  return 0;
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  if ((argc > 1) && (string(argv[1]) == "--bench"))
+  {
+    return runBenchmark();
+  }
+
   Config cfg;
   cfg.setValue("Test", "DTMF_DEC_TYPE", "INTERNAL");
   //cfg.setValue("Test", "DTMF_DEC_TYPE", "DH1DM");
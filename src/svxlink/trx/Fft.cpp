@@ -0,0 +1,204 @@
+/**
+@file   Fft.cpp
+@brief  A reusable radix-2 complex FFT plan
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cassert>
+#include <map>
+#include <utility>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "Fft.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+std::shared_ptr<const Fft> Fft::plan(size_t N)
+{
+  static std::map<size_t, std::weak_ptr<const Fft> > plans;
+  std::shared_ptr<const Fft> p = plans[N].lock();
+  if (!p)
+  {
+    p = std::make_shared<const Fft>(N);
+    plans[N] = p;
+  }
+  return p;
+} /* Fft::plan */
+
+
+Fft::Fft(size_t N)
+  : twiddle(N / 2), bitrev(N)
+{
+  assert(isPowerOfTwo(N));
+
+  for (size_t k=0; k<N/2; ++k)
+  {
+    twiddle[k] = polar(1.0f, static_cast<float>(-2.0 * M_PI * k / N));
+  }
+
+  for (size_t i=1, j=0; i<N; ++i)
+  {
+    size_t bit = N >> 1;
+    for (; (j & bit) != 0; bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+    bitrev[i] = j;
+  }
+} /* Fft::Fft */
+
+
+void Fft::transform(Sample *x) const
+{
+  const size_t N = size();
+
+    // Bit reversal permutation
+  for (size_t i=1; i<N; ++i)
+  {
+    if (i < bitrev[i])
+    {
+      std::swap(x[i], x[bitrev[i]]);
+    }
+  }
+
+    // Iterative radix-2 butterflies
+  for (size_t len=2; len<=N; len <<= 1)
+  {
+    const size_t half = len / 2;
+    const size_t step = N / len;
+    for (size_t i=0; i<N; i+=len)
+    {
+      for (size_t k=0; k<half; ++k)
+      {
+        Sample u = x[i + k];
+        Sample v = x[i + k + half] * twiddle[k * step];
+        x[i + k] = u + v;
+        x[i + k + half] = u - v;
+      }
+    }
+  }
+} /* Fft::transform */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
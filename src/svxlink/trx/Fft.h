@@ -0,0 +1,179 @@
+/**
+@file   Fft.h
+@brief  A reusable radix-2 complex FFT plan
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef FFT_INCLUDED
+#define FFT_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <complex>
+#include <vector>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A reusable radix-2 complex FFT plan
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class implement an in-place iterative radix-2 FFT. The twiddle factors
+and the bit reversal permutation are calculated once when the plan is created
+so that many transforms of the same size can be done cheaply. Use the plan
+function to get a plan that is shared with all other users of the same size.
+*/
+class Fft
+{
+  public:
+    typedef std::complex<float> Sample;
+
+    /**
+     * @brief   Get a shared plan for the given size
+     * @param   N The size of the transform, must be a power of two
+     * @return  Returns a plan that may be shared with other users
+     *
+     * Plans are cached as long as at least one user hold a reference to it.
+     * This function must only be called from the main thread.
+     */
+    static std::shared_ptr<const Fft> plan(size_t N);
+
+    /**
+     * @brief   Check if a number is a power of two
+     * @param   N The number to check
+     * @return  Returns \em true if N is a power of two larger than one
+     */
+    static bool isPowerOfTwo(size_t N) { return (N > 1) && ((N & (N-1)) == 0); }
+
+    /**
+     * @brief   Constructor
+     * @param   N The size of the transform, must be a power of two
+     */
+    explicit Fft(size_t N);
+
+    /**
+     * @brief   Get the size of the transform
+     * @return  Returns the number of points in the transform
+     */
+    size_t size(void) const { return twiddle.size() * 2; }
+
+    /**
+     * @brief   Do a forward transform in place
+     * @param   x The N samples to transform
+     */
+    void transform(Sample *x) const;
+
+    /**
+     * @brief   Do a forward transform in place
+     * @param   x The samples to transform, must be of size N
+     */
+    void transform(std::vector<Sample>& x) const { transform(x.data()); }
+
+  private:
+    std::vector<Sample>   twiddle;
+    std::vector<unsigned> bitrev;
+
+    Fft(const Fft&);
+    Fft& operator=(const Fft&);
+
+};  /* class Fft */
+
+
+//} /* namespace */
+
+#endif /* FFT_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
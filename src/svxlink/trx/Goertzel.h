@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cmath>
 #include <utility>
 #include <complex>
+#include <cstddef>
 
 
 /****************************************************************************
@@ -372,6 +373,95 @@ class Goertzel
 };  /* class Goertzel */
 
 
+/**
+@brief	A bank of Goertzel detectors processing whole blocks of samples
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class calculate N Goertzel bins over the same block of samples. The state
+of all detectors is kept in plain arrays so that the compiler can process all
+bins in parallel using SIMD instructions. Two samples are processed per
+iteration using the unrolled recurrence
+
+  q[n+1] = (a^2 - 1) * q[n-1] - a * q[n-2] + a * x[n] + x[n+1],  a = 2cos(w)
+
+which halve the length of the dependency chain compared to calculating one
+sample at a time. The result is the same as for the Goertzel class apart from
+rounding errors.
+*/
+template <size_t N>
+class GoertzelBank
+{
+  public:
+    GoertzelBank(void)
+    {
+      for (size_t i=0; i<N; ++i)
+      {
+        two_cosw[i] = 0.0f;
+        two_cosw_sq_m1[i] = -1.0f;
+      }
+      reset();
+    }
+
+    void initialize(size_t idx, float freq, unsigned sample_rate)
+    {
+      float w = 2.0f * M_PI * (freq / (float)sample_rate);
+      two_cosw[idx] = 2.0f * cosf(w);
+      two_cosw_sq_m1[idx] = two_cosw[idx] * two_cosw[idx] - 1.0f;
+    }
+
+    void reset(void)
+    {
+      for (size_t i=0; i<N; ++i)
+      {
+        q0[i] = q1[i] = 0.0f;
+      }
+    }
+
+    void calc(const float *samples, size_t count)
+    {
+      size_t n = 0;
+      for (; n+1 < count; n += 2)
+      {
+        const float x0 = samples[n];
+        const float x1 = samples[n+1];
+        for (size_t i=0; i<N; ++i)
+        {
+          const float a = two_cosw[i];
+          const float qa = a * q0[i] + (x0 - q1[i]);
+          const float qb = two_cosw_sq_m1[i] * q0[i] - a * q1[i] +
+                           (a * x0 + x1);
+          q1[i] = qa;
+          q0[i] = qb;
+        }
+      }
+      for (; n < count; ++n)
+      {
+        const float x = samples[n];
+        for (size_t i=0; i<N; ++i)
+        {
+          const float q2 = q1[i];
+          q1[i] = q0[i];
+          q0[i] = two_cosw[i] * q1[i] + (x - q2);
+        }
+      }
+    }
+
+    float magnitudeSquared(size_t idx) const
+    {
+      return q0[idx] * q0[idx] + q1[idx] * q1[idx] -
+             q0[idx] * q1[idx] * two_cosw[idx];
+    }
+
+  private:
+    alignas(32) float two_cosw[N];
+    alignas(32) float two_cosw_sq_m1[N];
+    alignas(32) float q0[N];
+    alignas(32) float q1[N];
+
+};  /* class GoertzelBank */
+
+
 //} /* namespace */
 
 #endif /* GOERTZEL_INCLUDED */
@@ -58,6 +58,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioPassthrough.h>
 #include <AsyncAudioDecimator.h>
 #include <AsyncAudioClipper.h>
+#include <AsyncAudioChannelStrip.h>
 #include <AsyncAudioCompressor.h>
 #include <AsyncAudioFifo.h>
 #include <AsyncAudioStreamStateDetector.h>
@@ -303,7 +304,7 @@ bool LocalRxBase::initialize(void)
   {
     AudioSplitter *raw_audio_splitter = new AudioSplitter;
     prev_src->registerSink(raw_audio_splitter, true);
-    AudioPassthrough *pass = new AudioPassthrough;
+    AudioPassthrough *pass = new AudioPassthrough(true);
     raw_audio_splitter->addSink(pass, true);
     prev_src = pass;
     AudioUdpSink *udp = new AudioUdpSink(IpAddress(raw_audio_fwd_dest.first),
@@ -363,7 +364,7 @@ bool LocalRxBase::initialize(void)
 
     // Add a passthrough element to use as a connector between the splitter and
     // the rest of the audio pipe
-  auto siglevdet_splitter_pass = new Async::AudioPassthrough;
+  auto siglevdet_splitter_pass = new Async::AudioPassthrough(true);
   siglevdet_splitter->addSink(siglevdet_splitter_pass, true);
   prev_src = siglevdet_splitter_pass;
 
@@ -617,11 +618,11 @@ bool LocalRxBase::initialize(void)
     prev_src = limit;
   }
 
-    // Clip audio to limit its amplitude
-  AudioClipper *clipper = new AudioClipper;
-  clipper->setClipLevel(0.98);
-  prev_src->registerSink(clipper, true);
-  prev_src = clipper;
+    // Clip audio to limit its amplitude. The clipper and the filter after
+    // it are run in a channel strip to avoid passing the audio through one
+    // pipe element for each stage.
+  AudioChannelStrip *channel_strip = new AudioChannelStrip;
+  channel_strip->addClipper(0.98);
 
     // Remove high frequencies generated by the previous clipping
 #if (INTERNAL_SAMPLE_RATE == 16000)
@@ -629,8 +630,9 @@ bool LocalRxBase::initialize(void)
 #else
   AudioFilter *splatter_filter = new AudioFilter("LpCh9/-0.05/3500");
 #endif
-  prev_src->registerSink(splatter_filter, true);
-  prev_src = splatter_filter;
+  channel_strip->addFilter(splatter_filter);
+  prev_src->registerSink(channel_strip, true);
+  prev_src = channel_strip;
   
     // Set the previous audio pipe object to handle audio distribution for
     // the LocalRxBase class
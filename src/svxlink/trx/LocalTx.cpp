@@ -60,6 +60,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioIO.h>
 #include <AsyncConfig.h>
 #include <AsyncAudioClipper.h>
+#include <AsyncAudioChannelStrip.h>
 #include <AsyncAudioCompressor.h>
 #include <AsyncAudioFilter.h>
 #include <AsyncAudioSelector.h>
@@ -443,7 +444,7 @@ bool LocalTx::initialize(void)
   AudioSource *prev_src = 0;
   
     // The input handler is where audio enters this TX object
-  input_handler = new AudioPassthrough;
+  input_handler = new AudioPassthrough(true);
   setHandler(input_handler);
   prev_src = input_handler;
   
@@ -458,6 +459,11 @@ bool LocalTx::initialize(void)
   prev_src = comp;
   */
   
+    // Directly connected emphasis, clipper and filter stages are run in a
+    // channel strip to avoid passing the audio through one pipe element for
+    // each stage
+  AudioChannelStrip *channel_strip = new AudioChannelStrip;
+
     // If preemphasis is enabled, create the preemphasis filter
   if (cfg.getValue(name(), "PREEMPHASIS", value) && (atoi(value.c_str()) != 0))
   {
@@ -473,9 +479,7 @@ bool LocalTx::initialize(void)
 #endif
     */
 
-    PreemphasisFilter *preemph = new PreemphasisFilter;
-    prev_src->registerSink(preemph, true);
-    prev_src = preemph;
+    channel_strip->addFilter(new PreemphasisFilter);
   }
 
     // Add a limiter to smoothly limit the audio before hard clipping it
@@ -483,6 +487,13 @@ bool LocalTx::initialize(void)
   cfg.getValue(name(), "LIMITER_THRESH", limiter_thresh);
   if (limiter_thresh != 0.0)
   {
+    if (!channel_strip->isEmpty())
+    {
+      prev_src->registerSink(channel_strip, true);
+      prev_src = channel_strip;
+      channel_strip = new AudioChannelStrip;
+    }
+
     AudioCompressor *limit = new AudioCompressor;
     limit->setThreshold(limiter_thresh);
     limit->setRatio(0.1);
@@ -494,9 +505,7 @@ bool LocalTx::initialize(void)
   }
 
     // Clip audio to limit its amplitude
-  AudioClipper *clipper = new AudioClipper;
-  prev_src->registerSink(clipper, true);
-  prev_src = clipper;
+  channel_strip->addClipper();
   
 #if 0
     // Filter out high frequencies generated by the previous clipping
@@ -517,8 +526,9 @@ bool LocalTx::initialize(void)
   AudioFilter *voiceband_filter =
     new AudioFilter("LpBu20/3500 x HpCh12/-0.05/300");
 #endif
-  prev_src->registerSink(voiceband_filter, true);
-  prev_src = voiceband_filter;
+  channel_strip->addFilter(voiceband_filter);
+  prev_src->registerSink(channel_strip, true);
+  prev_src = channel_strip;
 
     // Create a valve so that we can control when to transmit audio
   #if USE_AUDIO_VALVE
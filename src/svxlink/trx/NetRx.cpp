@@ -362,6 +362,7 @@ void NetRx::connectionReady(bool is_ready)
         << tcp_con->remoteHost() << ":" << tcp_con->remotePort() << "\n";
     
     log_disconnect = true;
+    telemetry_siglev.clear();
 
     if (mute_state != Rx::MUTE_ALL)
     {
@@ -479,6 +480,12 @@ void NetRx::handleMsg(Msg *msg)
       break;
     }
     
+    case MsgRxTelemetry::TYPE:
+    {
+      handleTelemetry(reinterpret_cast<MsgRxTelemetry*>(msg));
+      break;
+    }
+
     case MsgDtmf::TYPE:
     {
       if (mute_state == Rx::MUTE_NONE)
@@ -531,6 +538,67 @@ void NetRx::handleMsg(Msg *msg)
 } /* NetRx::handleMsg */
 
 
+void NetRx::handleTelemetry(MsgRxTelemetry *msg)
+{
+  if (msg->size() > sizeof(MsgRxTelemetry))
+  {
+    cerr << "*** WARNING[" << name() << "]: Malformed telemetry message "
+            "received" << endl;
+    return;
+  }
+
+  bool siglev_updated = false;
+  size_t pos = 0;
+  MsgRxTelemetry::Entry entry;
+  while (msg->nextEntry(pos, entry))
+  {
+    switch (entry.type)
+    {
+      case MsgRxTelemetry::ENTRY_SIGLEV:
+      case MsgRxTelemetry::ENTRY_SIGLEV_DELTA:
+      {
+        float& siglev = telemetry_siglev[entry.rx_id];
+        if (entry.type == MsgRxTelemetry::ENTRY_SIGLEV)
+        {
+          siglev = entry.siglev;
+        }
+        else
+        {
+          siglev += entry.siglev_delta * MsgRxTelemetry::SIGLEV_DELTA_STEP;
+        }
+        if (mute_state != Rx::MUTE_ALL)
+        {
+          last_signal_strength = siglev;
+          last_sql_rx_id = entry.rx_id;
+          signalLevelUpdated(last_signal_strength);
+          siglev_updated = true;
+        }
+        break;
+      }
+
+      case MsgRxTelemetry::ENTRY_DTMF:
+        if (mute_state == Rx::MUTE_NONE)
+        {
+          dtmfDigitDetected(entry.digit, entry.duration);
+        }
+        break;
+
+      case MsgRxTelemetry::ENTRY_TONE:
+        if (mute_state == Rx::MUTE_NONE)
+        {
+          toneDetected(entry.tone_fq);
+        }
+        break;
+    }
+  }
+
+  if (siglev_updated)
+  {
+    publishSquelchState();
+  }
+} /* NetRx::handleTelemetry */
+
+
 void NetRx::sendMsg(Msg *msg)
 {
   tcp_con->sendMsg(msg);
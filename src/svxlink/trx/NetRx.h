@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sigc++/sigc++.h>
 
 #include <string>
+#include <map>
 
 
 /****************************************************************************
@@ -68,6 +69,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace NetTrxMsg
 {
   class Msg;
+  class MsgRxTelemetry;
 };
 
 namespace Async
@@ -209,6 +211,7 @@ class NetRx : public Rx
     bool                log_disconnect;
     float     	      	last_signal_strength;
     char       	      	last_sql_rx_id;
+    std::map<char, float> telemetry_siglev;
     std::list<ToneDet*> tone_detectors;
     bool      	      	unflushed_samples;
     bool      	      	sql_is_open;
@@ -219,6 +222,7 @@ class NetRx : public Rx
 
     void connectionReady(bool is_ready);
     void handleMsg(NetTrxMsg::Msg *msg);
+    void handleTelemetry(NetTrxMsg::MsgRxTelemetry *msg);
     void sendMsg(NetTrxMsg::Msg *msg);
     void allEncodedSamplesFlushed(void);
     void publishSquelchState(void);
@@ -37,6 +37,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cassert>
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <utility>
@@ -174,9 +176,16 @@ class MsgProtoVer : public Msg
     static const unsigned TYPE  = 0;
     static const uint16_t MAJOR = 2;
     static const uint16_t MINOR = 8;
-    MsgProtoVer(void)
-      : Msg(TYPE, sizeof(MsgProtoVer)), m_major(MAJOR),
-        m_minor(MINOR) {}
+      // The lowest minor version that support MsgRxTelemetry. The server
+      // first announce MINOR so that older clients can connect and then
+      // this version in a second MsgProtoVer, which older clients ignore
+      // while waiting for authentication. A client that support batching
+      // announce this version back to the server when the connection is
+      // ready, but only if the server announced it.
+    static const uint16_t MINOR_TELEMETRY_BATCH = 9;
+    MsgProtoVer(uint16_t major=MAJOR, uint16_t minor=MINOR)
+      : Msg(TYPE, sizeof(MsgProtoVer)), m_major(major),
+        m_minor(minor) {}
     uint16_t majorVer(void) const { return m_major; }
     uint16_t minorVer(void) const { return m_minor; }
   
@@ -609,6 +618,163 @@ class MsgSiglevUpdate : public Msg
 }; /* MsgSiglevUpdate */
 
 
+/**
+@brief  A batch of receiver telemetry
+
+This message carry signal level updates, DTMF digits and detected tones for
+one or more receivers. It is sent instead of MsgSiglevUpdate, MsgDtmf and
+MsgTone when both ends have announced protocol version
+MsgProtoVer::MINOR_TELEMETRY_BATCH or later.
+
+Each entry start with a one byte entry type. Signal levels are delta encoded
+against the last level sent for the same receiver id, in steps of
+SIGLEV_DELTA_STEP. When there is no previous level or when the difference is
+too large, an absolute level is sent instead.
+*/
+class MsgRxTelemetry : public Msg
+{
+  public:
+    static const unsigned TYPE = 255;
+    static const int BUFSIZE = 256;
+    static constexpr float SIGLEV_DELTA_STEP = 0.25f;
+
+    typedef enum
+    {
+      ENTRY_SIGLEV=1,       ///< char rx_id, float siglev
+      ENTRY_SIGLEV_DELTA,   ///< char rx_id, int8_t delta steps
+      ENTRY_DTMF,           ///< char digit, uint16_t duration
+      ENTRY_TONE            ///< float tone_fq
+    } EntryType;
+
+    struct Entry
+    {
+      EntryType type;
+      char      rx_id;
+      float     siglev;
+      int       siglev_delta;
+      char      digit;
+      int       duration;
+      float     tone_fq;
+    };
+
+      // The size of the largest possible entry
+    static const size_t MAX_ENTRY_SIZE = 1 + 1 + sizeof(float);
+
+    MsgRxTelemetry(void)
+      : Msg(TYPE, sizeof(MsgRxTelemetry) - BUFSIZE) {}
+
+    bool isEmpty(void) const { return payloadSize() == 0; }
+    bool isFull(void) const
+    {
+      return payloadSize() + MAX_ENTRY_SIZE > BUFSIZE;
+    }
+
+    bool addSiglev(char rx_id, float siglev)
+    {
+      uint8_t entry[1 + 1 + sizeof(float)] = { ENTRY_SIGLEV,
+                                               static_cast<uint8_t>(rx_id) };
+      std::memcpy(entry + 2, &siglev, sizeof(float));
+      return append(entry, sizeof(entry));
+    }
+
+    bool addSiglevDelta(char rx_id, int8_t delta_steps)
+    {
+      uint8_t entry[3] = { ENTRY_SIGLEV_DELTA, static_cast<uint8_t>(rx_id),
+                           static_cast<uint8_t>(delta_steps) };
+      return append(entry, sizeof(entry));
+    }
+
+    bool addDtmf(char digit, int duration)
+    {
+      uint16_t dur = static_cast<uint16_t>(
+          std::min(std::max(duration, 0), 0xffff));
+      uint8_t entry[1 + 1 + sizeof(uint16_t)] = {
+        ENTRY_DTMF, static_cast<uint8_t>(digit) };
+      std::memcpy(entry + 2, &dur, sizeof(uint16_t));
+      return append(entry, sizeof(entry));
+    }
+
+    bool addTone(float tone_fq)
+    {
+      uint8_t entry[1 + sizeof(float)] = { ENTRY_TONE };
+      std::memcpy(entry + 1, &tone_fq, sizeof(float));
+      return append(entry, sizeof(entry));
+    }
+
+      /**
+       * @brief Decode the next entry
+       * @param pos The read position, zero for the first entry
+       * @param entry The decoded entry
+       * @return Returns \em false when there are no more entries or if the
+       *         message is malformed
+       *
+       * The received message size is used to find the end of the entries so
+       * it is safe to call this function on a message read from the network.
+       */
+    bool nextEntry(size_t& pos, Entry& entry) const
+    {
+      const size_t len = payloadSize();
+      if ((len > BUFSIZE) || (pos >= len))
+      {
+        return false;
+      }
+      entry.type = static_cast<EntryType>(m_buf[pos]);
+      switch (entry.type)
+      {
+        case ENTRY_SIGLEV:
+          if (pos + 2 + sizeof(float) > len) return false;
+          entry.rx_id = static_cast<char>(m_buf[pos+1]);
+          std::memcpy(&entry.siglev, m_buf + pos + 2, sizeof(float));
+          pos += 2 + sizeof(float);
+          return true;
+        case ENTRY_SIGLEV_DELTA:
+          if (pos + 3 > len) return false;
+          entry.rx_id = static_cast<char>(m_buf[pos+1]);
+          entry.siglev_delta = static_cast<int8_t>(m_buf[pos+2]);
+          pos += 3;
+          return true;
+        case ENTRY_DTMF:
+        {
+          if (pos + 2 + sizeof(uint16_t) > len) return false;
+          entry.digit = static_cast<char>(m_buf[pos+1]);
+          uint16_t dur;
+          std::memcpy(&dur, m_buf + pos + 2, sizeof(uint16_t));
+          entry.duration = dur;
+          pos += 2 + sizeof(uint16_t);
+          return true;
+        }
+        case ENTRY_TONE:
+          if (pos + 1 + sizeof(float) > len) return false;
+          std::memcpy(&entry.tone_fq, m_buf + pos + 1, sizeof(float));
+          pos += 1 + sizeof(float);
+          return true;
+      }
+      return false;
+    }
+
+  private:
+    uint8_t m_buf[BUFSIZE];
+
+    size_t payloadSize(void) const
+    {
+      return size() - (sizeof(MsgRxTelemetry) - BUFSIZE);
+    }
+
+    bool append(const uint8_t* entry, size_t len)
+    {
+      size_t pos = payloadSize();
+      if (pos + len > BUFSIZE)
+      {
+        return false;
+      }
+      std::memcpy(m_buf + pos, entry, len);
+      setSize(size() + len);
+      return true;
+    }
+
+}; /* MsgRxTelemetry */
+
+
 
 /******************************** TX Messages ********************************/
 
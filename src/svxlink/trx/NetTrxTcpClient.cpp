@@ -215,7 +215,8 @@ NetTrxTcpClient::NetTrxTcpClient(const std::string& remote_host,
       	      	      	      	 uint16_t remote_port, size_t recv_buf_len)
   : TcpClient<>(remote_host, remote_port, recv_buf_len), recv_cnt(0),
     recv_exp(0), reconnect_timer(0), last_msg_timestamp(), heartbeat_timer(0),
-    user_cnt(0), state(STATE_DISC), disc_reason(DR_SYSTEM_ERROR)
+    user_cnt(0), state(STATE_DISC), disc_reason(DR_SYSTEM_ERROR),
+    remote_telemetry_batch(false)
 {
   connected.connect(mem_fun(*this, &NetTrxTcpClient::tcpConnected));
   disconnected.connect(mem_fun(*this, &NetTrxTcpClient::tcpDisconnected));
@@ -254,6 +255,7 @@ void NetTrxTcpClient::tcpConnected(void)
   recv_exp = sizeof(Msg);
   gettimeofday(&last_msg_timestamp, NULL);
   heartbeat_timer->setEnable(true);
+  remote_telemetry_batch = false;
   state = STATE_VER_WAIT;
 } /* NetTx::tcpConnected */
 
@@ -380,7 +382,19 @@ void NetTrxTcpClient::handleMsg(Msg *msg)
       return;
     
     case STATE_AUTH_WAIT:
-      if (msg->type() == MsgAuthChallenge::TYPE)
+      if (msg->type() == MsgProtoVer::TYPE)
+      {
+          // A server supporting newer protocol features announce that in
+          // a second version message. Older clients ignore it.
+        MsgProtoVer *ver_msg = reinterpret_cast<MsgProtoVer *>(msg);
+        if ((msg->size() == sizeof(MsgProtoVer)) &&
+            (ver_msg->majorVer() == MsgProtoVer::MAJOR) &&
+            (ver_msg->minorVer() >= MsgProtoVer::MINOR_TELEMETRY_BATCH))
+        {
+          remote_telemetry_batch = true;
+        }
+      }
+      else if (msg->type() == MsgAuthChallenge::TYPE)
       {
         if (msg->size() != sizeof(MsgAuthChallenge))
         {
@@ -406,6 +420,14 @@ void NetTrxTcpClient::handleMsg(Msg *msg)
           return;
         }
         state = STATE_READY;
+          // Tell the server which protocol features we support. Older
+          // servers do not know about this message so only send it if the
+          // server have announced that it support batching.
+        if (remote_telemetry_batch)
+        {
+          sendMsgP(new MsgProtoVer(MsgProtoVer::MAJOR,
+                                   MsgProtoVer::MINOR_TELEMETRY_BATCH));
+        }
         isReady(true);
       }
       return;
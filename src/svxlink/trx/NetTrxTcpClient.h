@@ -223,6 +223,7 @@ class NetTrxTcpClient : public Async::TcpClient<>
     std::string     auth_key;
     State           state;
     DiscReason      disc_reason;
+    bool            remote_telemetry_batch;
     
     NetTrxTcpClient(const NetTrxTcpClient&);
     NetTrxTcpClient& operator=(const NetTrxTcpClient&);
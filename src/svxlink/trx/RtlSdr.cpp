@@ -280,8 +280,9 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
 {
   //cout << "RtlSdr::handleIq: samp_count=" << samp_count << endl;
 
-  vector<Sample> iq;
-  iq.reserve(samp_count);
+  std::shared_ptr<vector<Sample> > block = allocIqBlock();
+  vector<Sample> &iq = *block;
+  iq.resize(samp_count);
   for (int idx=0; idx<samp_count; ++idx)
   {
     if ((dist_print_cnt == 0) &&
@@ -293,7 +294,7 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
     i = i / 127.5f - 1.0f;
     float q = samples[idx].imag();
     q = q / 127.5f - 1.0f;
-    iq.push_back(complex<float>(i, q));
+    iq[idx] = complex<float>(i, q);
   }
 
   if (dist_print_cnt > 0)
@@ -310,7 +311,7 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
     }
   }
 
-  iqReceived(iq);
+  iqReceived(block);
 } /* RtlSdr::handleIq */
 
 
@@ -321,6 +322,24 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
  *
  ****************************************************************************/
 
+std::shared_ptr<vector<RtlSdr::Sample> > RtlSdr::allocIqBlock(void)
+{
+    // Reuse a block that no one else is referencing anymore
+  for (IqPool::iterator it=iq_pool.begin(); it!=iq_pool.end(); ++it)
+  {
+    if (it->use_count() == 1)
+    {
+      return *it;
+    }
+  }
+  std::shared_ptr<vector<Sample> > block(new vector<Sample>);
+  if (iq_pool.size() < MAX_IQ_POOL_SIZE)
+  {
+    iq_pool.push_back(block);
+  }
+  return block;
+} /* RtlSdr::allocIqBlock */
+
 void RtlSdr::updateSettings(void)
 {
   if (samp_rate_set)
@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <complex>
 #include <string>
 #include <vector>
+#include <memory>
 #include <stdint.h>
 
 
@@ -120,6 +121,21 @@ class RtlSdr : public sigc::trackable
   public:
     typedef std::complex<float> Sample;
 
+    /**
+     * @brief   A reference counted, immutable, block of I/Q samples
+     *
+     * Sample blocks are passed by reference to all receivers of the
+     * iqReceived signal so that no copies have to be made. A receiver may
+     * keep a reference to a block for later use. The block memory is reused
+     * for new blocks when no one is referencing it anymore.
+     */
+    typedef std::shared_ptr<const std::vector<Sample> > IqBlock;
+
+    /**
+     * @brief   The maximum number of sample blocks to keep for reuse
+     */
+    static const unsigned MAX_IQ_POOL_SIZE = 32;
+
     typedef enum {
       TUNER_UNKNOWN = 0,
       TUNER_E4000,
@@ -290,13 +306,13 @@ class RtlSdr : public sigc::trackable
 
     /**
      * @brief   A signal that is emitted when new samples have been received
-     * @param   samples A vector of received samples
+     * @param   samples A block of received samples
      *
      * Connecting to this signal is the way to get samples from the DVB-T
      * dongle. The format is a vector of complex floats (I/Q) with a range from
      * -1 to 1.
      */
-    sigc::signal<void, std::vector<Sample> > iqReceived;
+    sigc::signal<void, const IqBlock&> iqReceived;
     
     /**
      * @brief   A signal that is emitted when the ready state changes
@@ -400,6 +416,8 @@ class RtlSdr : public sigc::trackable
   private:
     static const unsigned MAX_IF_GAIN_STAGES = 10;
 
+    typedef std::vector<std::shared_ptr<std::vector<Sample> > > IqPool;
+
     uint32_t          samp_rate;
     size_t            block_size;
     TunerType         tuner_type;
@@ -416,6 +434,9 @@ class RtlSdr : public sigc::trackable
     bool              use_digital_agc_set;
     bool              use_digital_agc;
     int               dist_print_cnt;
+    IqPool            iq_pool;
+
+    std::shared_ptr<std::vector<Sample> > allocIqBlock(void);
 
     RtlSdr(const RtlSdr&);
     RtlSdr& operator=(const RtlSdr&);
@@ -32,8 +32,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+
 #include <cstring>
 #include <cstdlib>
+#include <cmath>
 #include <iterator>
 #include <algorithm>
 #include <sstream>
@@ -118,16 +124,21 @@ using namespace Async;
  ****************************************************************************/
 
 RtlTcp::RtlTcp(const string &remote_host, uint16_t remote_port)
-  : con(remote_host, remote_port, blockSize()),
-    reconnect_timer(1000, Timer::TYPE_PERIODIC)
+  : con(remote_host, remote_port, RECV_BUF_BLOCKS * blockSize()),
+    reconnect_timer(1000, Timer::TYPE_PERIODIC),
+    stats_timer(STATS_INTERVAL, Timer::TYPE_PERIODIC, false),
+    stats_started(false), stats_samp_cnt(0), stats_lost_cnt(0),
+    stats_backlog(0), stats_overrun_cnt(0), sock_buf_full(false), sock_rcvbuf(0)
 {
   con.dataReceived.connect(mem_fun(*this, &RtlTcp::dataReceived));
   con.connected.connect(mem_fun(*this, &RtlTcp::connected));
   con.disconnected.connect(mem_fun(*this, &RtlTcp::disconnected));
+  setSocketRecvBuf();
   con.connect();
 
   reconnect_timer.expired.connect(
       hide(mem_fun(con, &Async::TcpClient<>::connect)));
+  stats_timer.expired.connect(hide(mem_fun(*this, &RtlTcp::checkStats)));
 } /* RtlTcp::RtlTcp */
 
 
@@ -163,7 +174,9 @@ void RtlTcp::handleSetCenterFq(uint32_t fq)
 
 void RtlTcp::handleSetSampleRate(uint32_t rate)
 {
-  con.setRecvBufLen(blockSize());
+  con.setRecvBufLen(RECV_BUF_BLOCKS * blockSize());
+  setSocketRecvBuf();
+  resetStats();
   sendCommand(2, rate);
 } /* RtlTcp::handleSetSampleRate */
 
@@ -233,6 +246,9 @@ void RtlTcp::connected(void)
        << con.remotePort() << endl;
   */
   reconnect_timer.setEnable(false);
+  setSocketRecvBuf();
+  resetStats();
+  stats_timer.setEnable(true);
 } /* RtlTcp::connected */
 
 
@@ -240,6 +256,7 @@ void RtlTcp::disconnected(Async::TcpConnection *c,
                           Async::TcpConnection::DisconnectReason reason)
 {
   setTunerType(TUNER_UNKNOWN);
+  stats_timer.setEnable(false);
   if (!reconnect_timer.isEnabled())
   {
     /*
@@ -295,20 +312,137 @@ int RtlTcp::dataReceived(Async::TcpConnection *con, void *buf, int count)
     return 12;
   }
 
-  if (static_cast<size_t>(count) < blockSize())
+    // Process all whole blocks that have been received. Any trailing
+    // partial block is left in the receive buffer until the next read.
+  const size_t block_size = blockSize();
+  const size_t len = (static_cast<size_t>(count) / block_size) * block_size;
+  if (len == 0)
   {
     return 0;
   }
-  count = blockSize();
 
-  int samp_count = count / 2;
-  complex<uint8_t> *samples = reinterpret_cast<complex<uint8_t>*>(buf);
-  handleIq(samples, samp_count);
+  if (!stats_started)
+  {
+    gettimeofday(&stats_start, NULL);
+    stats_started = true;
+  }
+  stats_samp_cnt += len / 2;
+
+    // If the kernel socket buffer is close to full, rtl_tcp will soon have
+    // to start dropping samples. Count each such episode as an overrun.
+  const int backlog = socketBacklog();
+  const bool buf_full = (sock_rcvbuf > 0) && (backlog >= 3 * sock_rcvbuf / 4);
+  if (buf_full && !sock_buf_full)
+  {
+    ++stats_overrun_cnt;
+  }
+  sock_buf_full = buf_full;
+
+  const complex<uint8_t> *samples =
+    reinterpret_cast<const complex<uint8_t>*>(buf);
+  for (size_t pos=0; pos<len; pos+=block_size)
+  {
+    handleIq(samples + pos / 2, block_size / 2);
+  }
 
-  return 2 * samp_count;
+  return len;
 } /* RtlTcp::dataReceived */
 
 
+void RtlTcp::setSocketRecvBuf(void)
+{
+    // The size is set before connecting so that the TCP window scaling
+    // allow the whole buffer to be used. If the sample rate is changed while
+    // connected, the buffer is grown on the open socket as well.
+  int size = 2 * SOCK_RCVBUF_TIME * (sampleRate() / 1000);
+  con.setSocketRecvBufSize(size);
+  if (!con.isConnected())
+  {
+    return;
+  }
+
+  if (setsockopt(con.fd(), SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) == -1)
+  {
+    cerr << "*** WARNING: Could not set the socket receive buffer size for "
+         << "rtl_tcp at " << displayName() << ": " << strerror(errno) << endl;
+  }
+  socklen_t optlen = sizeof(sock_rcvbuf);
+  if (getsockopt(con.fd(), SOL_SOCKET, SO_RCVBUF, &sock_rcvbuf,
+                 &optlen) == -1)
+  {
+    sock_rcvbuf = 0;
+    return;
+  }
+    // Linux double the requested size to make room for bookkeeping
+    // overhead and report the doubled value
+  sock_rcvbuf /= 2;
+  if (sock_rcvbuf < size)
+  {
+    cerr << "*** WARNING: The socket receive buffer for rtl_tcp at "
+         << displayName() << " is limited to " << sock_rcvbuf
+         << " bytes (wanted " << size << "). Consider raising the "
+         << "net.core.rmem_max sysctl.\n";
+  }
+} /* RtlTcp::setSocketRecvBuf */
+
+
+int RtlTcp::socketBacklog(void) const
+{
+  int backlog = 0;
+  if (!con.isConnected() || (ioctl(con.fd(), FIONREAD, &backlog) == -1))
+  {
+    return 0;
+  }
+  return backlog;
+} /* RtlTcp::socketBacklog */
+
+
+void RtlTcp::resetStats(void)
+{
+  stats_started = false;
+  stats_samp_cnt = 0;
+  stats_lost_cnt = 0;
+  stats_backlog = 0;
+  stats_overrun_cnt = 0;
+  sock_buf_full = false;
+} /* RtlTcp::resetStats */
+
+
+void RtlTcp::checkStats(void)
+{
+  if (!stats_started)
+  {
+    return;
+  }
+
+  struct timeval now, diff;
+  gettimeofday(&now, NULL);
+  timersub(&now, &stats_start, &diff);
+  const double elapsed = diff.tv_sec + diff.tv_usec / 1000000.0;
+  const int backlog = socketBacklog() / 2;
+
+    // Each interval is checked on its own so that a small difference
+    // between the nominal and the actual sample rate does not accumulate
+    // over time. Samples still waiting in the socket buffer are not lost. A
+    // margin of 100ms worth of samples is used to absorb scheduling jitter.
+  const int64_t expected = llround(elapsed * sampleRate());
+  const int64_t lost = expected - static_cast<int64_t>(stats_samp_cnt) -
+                       (backlog - stats_backlog);
+  stats_start = now;
+  stats_samp_cnt = 0;
+  stats_backlog = backlog;
+  if (lost > static_cast<int64_t>(sampleRate() / 10))
+  {
+    stats_lost_cnt += lost;
+    cerr << "*** WARNING: " << lost
+         << " samples lost from rtl_tcp at " << displayName()
+         << " during the last " << (STATS_INTERVAL / 1000) << " seconds ("
+         << stats_lost_cnt << " samples lost in total, " << stats_overrun_cnt
+         << " socket buffer overruns)" << endl;
+  }
+} /* RtlTcp::checkStats */
+
+
 /*
  * This file has not been truncated
  */
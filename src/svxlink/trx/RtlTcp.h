@@ -34,6 +34,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <sys/time.h>
+#include <stdint.h>
+
 #include <string>
 
 
@@ -110,10 +113,34 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 @date   2014-07-16
 
 Use this class to open and use a network connection to the rtl_tcp utility.
+
+The sample stream is received into a buffer that can hold RECV_BUF_BLOCKS
+blocks of samples and all whole blocks available are processed each time the
+socket is read. The kernel socket receive buffer is enlarged to hold
+SOCK_RCVBUF_TIME milliseconds of samples so that short stalls in the main
+loop do not cause rtl_tcp to drop samples. Every STATS_INTERVAL milliseconds
+the number of samples received during the interval is compared to the number
+of samples that should have been received according to the sample rate and
+lost samples are reported.
 */
 class RtlTcp : public RtlSdr
 {
   public:
+    /**
+     * @brief   The size of the receive buffer, in number of sample blocks
+     */
+    static const unsigned RECV_BUF_BLOCKS   = 16;
+
+    /**
+     * @brief   The size of the kernel socket receive buffer in milliseconds
+     */
+    static const unsigned SOCK_RCVBUF_TIME  = 500;
+
+    /**
+     * @brief   How often to check for lost samples, in milliseconds
+     */
+    static const unsigned STATS_INTERVAL    = 10000;
+
     /**
      * @brief 	Constructor
      * @param   remote_host The remote host to connect to
@@ -222,8 +249,26 @@ class RtlTcp : public RtlSdr
 
     
   private:
-    Async::TcpClient<>  con;
+    class IqClient : public Async::TcpClient<>
+    {
+      public:
+        IqClient(const std::string& remote_host, uint16_t remote_port,
+                 size_t recv_buf_len)
+          : Async::TcpClient<>(remote_host, remote_port, recv_buf_len) {}
+        int fd(void) const { return socket(); }
+    };
+
+    IqClient            con;
     Async::Timer        reconnect_timer;
+    Async::Timer        stats_timer;
+    bool                stats_started;
+    struct timeval      stats_start;
+    uint64_t            stats_samp_cnt;
+    uint64_t            stats_lost_cnt;
+    int                 stats_backlog;
+    unsigned            stats_overrun_cnt;
+    bool                sock_buf_full;
+    int                 sock_rcvbuf;
 
     RtlTcp(const RtlTcp&);
     RtlTcp& operator=(const RtlTcp&);
@@ -232,6 +277,10 @@ class RtlTcp : public RtlSdr
     void disconnected(Async::TcpConnection *c,
                       Async::TcpConnection::DisconnectReason reason);
     int dataReceived(Async::TcpConnection *con, void *buf, int count);
+    void setSocketRecvBuf(void);
+    int socketBacklog(void) const;
+    void resetStats(void);
+    void checkStats(void);
     
 };  /* class RtlTcp */
 
@@ -32,7 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <iostream>
 #include <iterator>
-#include <set>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -78,20 +78,11 @@ using namespace std;
 class SquelchCombine::Node
 {
   public:
-    typedef std::set<std::string> SquelchStates;
     Node(const std::string& name) : m_name(name) {}
     virtual ~Node(void) {}
     const std::string name(void) const { return m_name; }
     virtual void print(std::ostream& os) = 0;
-    virtual bool initialize(Async::Config& cfg) = 0;
-    virtual void reset(void) = 0;
-    virtual void restart(void) = 0;
-    virtual void processSamples(const float *samples, int count) = 0;
-    virtual bool isOpen(void) const = 0;
-    virtual std::string activityInfo(void) const = 0;
-    virtual SquelchStates& squelchStates(SquelchStates& states) = 0;
-    sigc::signal<void, bool> squelchOpen;
-    sigc::signal<void, float> toneDetected;
+    virtual void compile(Program& prog) = 0;
 
   private:
     std::string m_name;
@@ -101,84 +92,17 @@ class SquelchCombine::Node
 class SquelchCombine::LeafNode : public SquelchCombine::Node
 {
   public:
-    LeafNode(const std::string n) : Node(n) {}
-
-    virtual ~LeafNode(void)
-    {
-      delete m_squelch;
-      m_squelch = nullptr;
-    }
+    LeafNode(const std::string n, unsigned idx) : Node(n), m_idx(idx) {}
 
     virtual void print(std::ostream& os) { os << name(); }
 
-    virtual bool initialize(Async::Config& cfg)
-    {
-      string sql_det_str;
-      if (!cfg.getValue(name(), "SQL_DET", sql_det_str))
-      {
-        cerr << "*** ERROR: Config variable " << name() << "/SQL_DET not set\n";
-        return false;
-      }
-      m_squelch = createSquelch(sql_det_str);
-      if ((m_squelch == nullptr) || !m_squelch->initialize(cfg, name()))
-      {
-        std::cerr << "*** ERROR: Squelch detector initialization failed for \""
-                  << name() << "\"\n";
-        return false;
-      }
-      m_squelch->squelchOpen.connect(squelchOpen.make_slot());
-      m_squelch->toneDetected.connect(toneDetected.make_slot());
-      return true;
-    }
-
-    virtual bool isOpen(void) const { return m_squelch->isOpen(); }
-
-    virtual std::string activityInfo(void) const
+    virtual void compile(Program& prog)
     {
-      std::string act_info = name();
-      if (m_squelch->isOpen())
-      {
-        act_info += "*";
-      }
-      if (!m_squelch->activityInfo().empty())
-      {
-        if (!m_squelch->isOpen())
-        {
-          act_info += "=";
-        }
-        act_info += m_squelch->activityInfo();
-      }
-      return act_info;
-    }
-
-    virtual void reset(void) { m_squelch->reset(); }
-
-    virtual void restart(void) { m_squelch->restart(); }
-
-    virtual void processSamples(const float *samples, int count)
-    {
-      int pos = 0;
-      do {
-        int ret = m_squelch->writeSamples(samples, count);
-        if (ret < 1)
-        {
-          std::cout << "*** WARNING: Failed to write samples to squelch "
-                       "detector \"" << name() << "\" in squelch combiner."
-                    << std::endl;
-          break;
-        }
-        pos += ret;
-      } while (pos < count);
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      states.emplace(activityInfo());
-      return states;
+      prog.push_back({OP_LEAF, m_idx});
     }
 
   private:
-    Squelch* m_squelch = nullptr;
+    unsigned m_idx;
 }; /* SquelchCombine::LeafNode */
 
 
@@ -186,11 +110,7 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
 {
   public:
     UnaryOpNode(const std::string& name, Node *node)
-      : Node(name), m_node(node)
-    {
-      m_node->squelchOpen.connect(squelchOpen.make_slot());
-      m_node->toneDetected.connect(toneDetected.make_slot());
-    }
+      : Node(name), m_node(node) {}
 
     virtual ~UnaryOpNode(void)
     {
@@ -205,36 +125,6 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
       os << ")";
     }
 
-    virtual bool initialize(Async::Config& cfg)
-    {
-      return m_node->initialize(cfg);
-    }
-
-    virtual void reset(void)
-    {
-      m_node->reset();
-    }
-
-    virtual void restart(void)
-    {
-      m_node->restart();
-    }
-
-    virtual void processSamples(const float *samples, int count)
-    {
-      m_node->processSamples(samples, count);
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      return m_node->squelchStates(states);
-    }
-
-    virtual std::string activityInfo(void) const
-    {
-      return name() + "(" + m_node->activityInfo() + ")";
-    }
-
   protected:
     Node* m_node;
 }; /* SquelchCombine::UnaryOpNode */
@@ -243,23 +133,19 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
 struct SquelchCombine::NegationOpNode : public SquelchCombine::UnaryOpNode
 {
   NegationOpNode(Node* node) : UnaryOpNode("NOT", node) {}
-  virtual bool isOpen(void) const { return !m_node->isOpen(); }
+  virtual void compile(Program& prog)
+  {
+    m_node->compile(prog);
+    prog.push_back({OP_NOT, 0});
+  }
 }; /* SquelchCombine::NegationOpNode */
 
 
 class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
 {
   public:
-    BinaryOpNode(const std::string& n, Node* l, Node* r)
-      : Node(n), m_left(l), m_right(r)
-    {
-      m_left->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
-      m_left->toneDetected.connect(toneDetected.make_slot());
-      m_right->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
-      m_right->toneDetected.connect(toneDetected.make_slot());
-    }
+    BinaryOpNode(const std::string& n, OpCode op, Node* l, Node* r)
+      : Node(n), m_op(op), m_left(l), m_right(r) {}
 
     virtual ~BinaryOpNode(void)
     {
@@ -278,72 +164,29 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
       os << ")";
     }
 
-    virtual bool initialize(Async::Config& cfg)
-    {
-      return m_left->initialize(cfg) && m_right->initialize(cfg);
-    }
-
-    virtual void reset(void)
-    {
-      m_left->reset();
-      m_right->reset();
-    }
-
-    virtual void restart(void)
-    {
-      m_left->restart();
-      m_right->restart();
-    }
-
-    virtual void processSamples(const float *samples, int count)
-    {
-      m_left->processSamples(samples, count);
-      m_right->processSamples(samples, count);
-    }
-
-    void onSquelchOpen(bool is_open)
-    {
-      squelchOpen(isOpen());
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      m_left->squelchStates(states);
-      m_right->squelchStates(states);
-      return states;
-    }
-
-    virtual std::string activityInfo(void) const
+    virtual void compile(Program& prog)
     {
-      return name() + "(" + m_left->activityInfo() + ", " +
-             m_right->activityInfo() + ")";
+      m_left->compile(prog);
+      m_right->compile(prog);
+      prog.push_back({m_op, 0});
     }
 
   protected:
-    Node* m_left;
-    Node* m_right;
+    OpCode  m_op;
+    Node*   m_left;
+    Node*   m_right;
 }; /* SquelchCombine::BinaryOpNode */
 
 
 struct SquelchCombine::OrOpNode : public SquelchCombine::BinaryOpNode
 {
-  OrOpNode(Node* l, Node* r) : BinaryOpNode("OR", l, r) {}
-
-  virtual bool isOpen(void) const
-  {
-    return m_left->isOpen() || m_right->isOpen();
-  }
+  OrOpNode(Node* l, Node* r) : BinaryOpNode("OR", OP_OR, l, r) {}
 }; /* SquelchCombine::OrOpNode */
 
 
 struct SquelchCombine::AndOpNode : public SquelchCombine::BinaryOpNode
 {
-  AndOpNode(Node* l, Node* r) : BinaryOpNode("AND", l, r) {}
-
-  virtual bool isOpen(void) const
-  {
-    return m_left->isOpen() && m_right->isOpen();
-  }
+  AndOpNode(Node* l, Node* r) : BinaryOpNode("AND", OP_AND, l, r) {}
 }; /* SquelchCombine::AndOpNode */
 
 
@@ -385,7 +228,11 @@ SquelchCombine::SquelchCombine(void)
 
 SquelchCombine::~SquelchCombine(void)
 {
-  delete m_comb;
+  for (auto& leaf : m_leaves)
+  {
+    delete leaf.squelch;
+    leaf.squelch = nullptr;
+  }
 } /* SquelchCombine::~SquelchCombine */
 
 
@@ -405,7 +252,7 @@ bool SquelchCombine::initialize(Async::Config& cfg,
     return false;
   }
 
-  m_comb = parseExpression();
+  Node* comb = parseExpression();
   if (!m_tokens.empty())
   {
     std::cout << "*** ERROR: Unparsed extra tokens in malformed squelch "
@@ -413,10 +260,17 @@ bool SquelchCombine::initialize(Async::Config& cfg,
     copy(m_tokens.begin(), m_tokens.end(),
         std::ostream_iterator<std::string>(std::cout, " "));
     std::cout << std::endl;
-    delete m_comb;
-    m_comb = nullptr;
+    delete comb;
+    comb = nullptr;
   }
-  if (m_comb == nullptr)
+  if ((comb != nullptr) && (m_leaves.size() > MAX_LEAVES))
+  {
+    std::cout << "*** ERROR: Too many squelch instances in squelch combiner "
+                 "expression. Max is " << MAX_LEAVES << "." << std::endl;
+    delete comb;
+    comb = nullptr;
+  }
+  if (comb == nullptr)
   {
     std::cout << "*** ERROR: Failed to create combined squelch for RX \""
               << rx_name << "\"" << std::endl;
@@ -424,27 +278,69 @@ bool SquelchCombine::initialize(Async::Config& cfg,
   }
 
   std::cout << rx_name << " combined squelch structure: ";
-  m_comb->print(std::cout);
+  comb->print(std::cout);
   std::cout << std::endl;
 
-  m_comb->squelchOpen.connect(
-      sigc::mem_fun(*this, &SquelchCombine::onSquelchOpen));
-  m_comb->toneDetected.connect(toneDetected.make_slot());
+  m_program.clear();
+  comb->compile(m_program);
+  delete comb;
+  m_stack.resize(m_program.size());
 
-  return m_comb->initialize(cfg) && Squelch::initialize(cfg, rx_name);
+  m_truth_table.clear();
+  if (m_leaves.size() <= MAX_TRUTH_TABLE_LEAVES)
+  {
+    const uint64_t combinations = uint64_t(1) << m_leaves.size();
+    m_truth_table.resize(combinations);
+    for (uint64_t states=0; states<combinations; ++states)
+    {
+      m_truth_table[states] = evaluate(states);
+    }
+  }
+
+  for (unsigned idx=0; idx<m_leaves.size(); ++idx)
+  {
+    Leaf& leaf = m_leaves[idx];
+    string sql_det_str;
+    if (!cfg.getValue(leaf.name, "SQL_DET", sql_det_str))
+    {
+      cerr << "*** ERROR: Config variable " << leaf.name
+           << "/SQL_DET not set\n";
+      return false;
+    }
+    leaf.squelch = createSquelch(sql_det_str);
+    if ((leaf.squelch == nullptr) || !leaf.squelch->initialize(cfg, leaf.name))
+    {
+      std::cerr << "*** ERROR: Squelch detector initialization failed for \""
+                << leaf.name << "\"\n";
+      return false;
+    }
+    leaf.squelch->squelchOpen.connect(sigc::bind(
+          sigc::mem_fun(*this, &SquelchCombine::onLeafSquelchOpen), idx));
+    leaf.squelch->toneDetected.connect(toneDetected.make_slot());
+  }
+
+  return Squelch::initialize(cfg, rx_name);
 } /* SquelchCombine::initialize */
 
 
 void SquelchCombine::reset(void)
 {
-  m_comb->reset();
+    // The leaves close silently when reset so their states are cleared here
+  for (auto& leaf : m_leaves)
+  {
+    leaf.squelch->reset();
+  }
+  m_leaf_states = 0;
   Squelch::reset();
 } /* SquelchCombine::reset */
 
 
 void SquelchCombine::restart(void)
 {
-  m_comb->restart();
+  for (auto& leaf : m_leaves)
+  {
+    leaf.squelch->restart();
+  }
   Squelch::restart();
 } /* SquelchCombine::restart */
 
@@ -457,7 +353,21 @@ void SquelchCombine::restart(void)
 
 int SquelchCombine::processSamples(const float *samples, int count)
 {
-  m_comb->processSamples(samples, count);
+  for (auto& leaf : m_leaves)
+  {
+    int pos = 0;
+    do {
+      int ret = leaf.squelch->writeSamples(samples + pos, count - pos);
+      if (ret < 1)
+      {
+        std::cout << "*** WARNING: Failed to write samples to squelch "
+                     "detector \"" << leaf.name << "\" in squelch combiner."
+                  << std::endl;
+        break;
+      }
+      pos += ret;
+    } while (pos < count);
+  }
   return count;
 } /* SquelchCombine::processSamples */
 
@@ -468,25 +378,95 @@ int SquelchCombine::processSamples(const float *samples, int count)
  *
  ****************************************************************************/
 
-void SquelchCombine::onSquelchOpen(bool is_open)
+void SquelchCombine::onLeafSquelchOpen(bool is_open, unsigned leaf_idx)
 {
-  if (is_open != signalDetected())
+  const uint64_t mask = uint64_t(1) << leaf_idx;
+  m_leaf_states = is_open ? (m_leaf_states | mask) : (m_leaf_states & ~mask);
+
+  const bool comb_is_open = m_truth_table.empty()
+    ? evaluate(m_leaf_states)
+    : m_truth_table[m_leaf_states];
+  if (comb_is_open == signalDetected())
   {
-    std::string info;
-    info.reserve(127);
-    SquelchCombine::Node::SquelchStates states;
-    for (const auto& state : m_comb->squelchStates(states))
+    return;
+  }
+
+    // The activity info is only built when the combined state change
+  std::vector<std::string> states;
+  states.reserve(m_leaves.size());
+  for (const auto& leaf : m_leaves)
+  {
+    const Squelch* sql = leaf.squelch;
+    std::string act_info = leaf.name;
+    if (sql->isOpen())
+    {
+      act_info += "*";
+    }
+    if (!sql->activityInfo().empty())
     {
-      if (!info.empty())
+      if (!sql->isOpen())
       {
-        info += " ";
+        act_info += "=";
       }
-      info += state;
+      act_info += sql->activityInfo();
+    }
+    states.push_back(std::move(act_info));
+  }
+  std::sort(states.begin(), states.end());
+
+  std::string info;
+  info.reserve(127);
+  for (const auto& state : states)
+  {
+    if (!info.empty())
+    {
+      info += " ";
+    }
+    info += state;
+  }
+  setSignalDetected(comb_is_open, info);
+} /* SquelchCombine::onLeafSquelchOpen */
+
+
+bool SquelchCombine::evaluate(uint64_t leaf_states) const
+{
+  size_t sp = 0;
+  for (const auto& ins : m_program)
+  {
+    switch (ins.op)
+    {
+      case OP_LEAF:
+        m_stack[sp++] = (leaf_states >> ins.leaf) & 1;
+        break;
+      case OP_NOT:
+        m_stack[sp-1] = !m_stack[sp-1];
+        break;
+      case OP_AND:
+        --sp;
+        m_stack[sp-1] = m_stack[sp-1] && m_stack[sp];
+        break;
+      case OP_OR:
+        --sp;
+        m_stack[sp-1] = m_stack[sp-1] || m_stack[sp];
+        break;
+    }
+  }
+  return (sp > 0) && m_stack[0];
+} /* SquelchCombine::evaluate */
+
+
+unsigned SquelchCombine::addLeaf(const std::string& name)
+{
+  for (unsigned idx=0; idx<m_leaves.size(); ++idx)
+  {
+    if (m_leaves[idx].name == name)
+    {
+      return idx;
     }
-    setSignalDetected(is_open, info);
-    //setSignalDetected(is_open, m_comb->activityInfo());
   }
-} /* SquelchCombine::onSquelchOpen */
+  m_leaves.push_back({name, nullptr});
+  return m_leaves.size() - 1;
+} /* SquelchCombine::addLeaf */
 
 
 bool SquelchCombine::tokenize(const std::string& expr)
@@ -564,7 +544,7 @@ SquelchCombine::Node* SquelchCombine::parseInstExpression(void)
   }
   m_tokens.pop_front();
 
-  return new LeafNode(inst);
+  return new LeafNode(inst, addLeaf(inst));
 } /* SquelchCombine::parseInstExpression */
 
 
@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <string>
 #include <deque>
+#include <vector>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -135,6 +137,12 @@ SIGLEV_CLOSE_THRESH=2
 SQL_DET=COMBINE
 SQL_COMBINE=Rx1:CTCSS | Rx1:SIGLEV
 ...
+
+The expression is compiled into a flat program working on a bitmask with one
+bit for each sub-squelch. If there are few enough sub-squelches, a truth
+table is precalculated so that the combined state can be found using a single
+lookup when one of the sub-squelches change state. A sub-squelch that is
+referenced multiple times in the expression is only instantiated once.
 */
 class SquelchCombine : public Squelch
 {
@@ -207,10 +215,38 @@ class SquelchCombine : public Squelch
     struct OrOpNode;
     struct AndOpNode;
 
-    Tokens  m_tokens;
-    Node*   m_comb    = nullptr;
-
-    void onSquelchOpen(bool is_open);
+    typedef enum
+    {
+      OP_LEAF, OP_NOT, OP_AND, OP_OR
+    } OpCode;
+
+    struct Instruction
+    {
+      OpCode    op;
+      unsigned  leaf;
+    };
+    typedef std::vector<Instruction> Program;
+
+    struct Leaf
+    {
+      std::string name;
+      Squelch*    squelch;
+    };
+    typedef std::vector<Leaf> Leaves;
+
+    static const unsigned MAX_LEAVES              = 64;
+    static const unsigned MAX_TRUTH_TABLE_LEAVES  = 12;
+
+    Tokens              m_tokens;
+    Leaves              m_leaves;
+    Program             m_program;
+    std::vector<bool>   m_truth_table;
+    mutable std::vector<bool> m_stack;
+    uint64_t            m_leaf_states = 0;
+
+    void onLeafSquelchOpen(bool is_open, unsigned leaf_idx);
+    bool evaluate(uint64_t leaf_states) const;
+    unsigned addLeaf(const std::string& name);
     bool tokenize(const std::string& expr);
     Node* parseInstExpression(void);
     Node* parseUnaryOpExpression(void);
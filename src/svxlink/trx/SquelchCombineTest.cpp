@@ -0,0 +1,108 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include <AsyncConfig.h>
+
+#include "SquelchCombine.h"
+
+using namespace std;
+using namespace Async;
+
+
+namespace {
+  void feed(Squelch& sql, float amp, int ms)
+  {
+    vector<float> samples(INTERNAL_SAMPLE_RATE * ms / 1000, amp);
+    int pos = 0;
+    while (pos < static_cast<int>(samples.size()))
+    {
+      int ret = sql.writeSamples(samples.data() + pos, samples.size() - pos);
+      if (ret <= 0)
+      {
+        cout << "*** ERROR: Squelch did not accept samples" << endl;
+        exit(1);
+      }
+      pos += ret;
+    }
+  }
+
+  void check(const Squelch& sql, bool expect_open, const string& what)
+  {
+    bool is_open = sql.isOpen();
+    if (is_open != expect_open)
+    {
+      cout << "*** ERROR: " << what << ": The squelch is "
+           << (is_open ? "open" : "closed") << endl;
+      exit(1);
+    }
+  }
+};
+
+
+// Verify that the combined squelch state follows the sub-squelches. Two VOX
+// squelches with different thresholds are combined so that their states can
+// be controlled using the signal amplitude.
+int main()
+{
+  Config cfg;
+  cfg.setValue("Rx1:HI", "SQL_DET", "VOX");
+  cfg.setValue("Rx1:HI", "VOX_FILTER_DEPTH", "20");
+  cfg.setValue("Rx1:HI", "VOX_THRESH", "5000");
+  cfg.setValue("Rx1:LO", "SQL_DET", "VOX");
+  cfg.setValue("Rx1:LO", "VOX_FILTER_DEPTH", "20");
+  cfg.setValue("Rx1:LO", "VOX_THRESH", "500");
+
+  const float loud = 0.8f;    // Opens both squelches
+  const float medium = 0.2f;  // Opens the LO squelch only
+  const float silence = 0.0f;
+
+  cfg.setValue("Rx1", "SQL_COMBINE", "Rx1:HI | Rx1:LO");
+  SquelchCombine sql_or;
+  if (!sql_or.initialize(cfg, "Rx1"))
+  {
+    cout << "*** ERROR: Could not initialize the OR squelch" << endl;
+    exit(1);
+  }
+  feed(sql_or, loud, 100);
+  check(sql_or, true, "HI | LO, both open");
+  feed(sql_or, medium, 100);
+  check(sql_or, true, "HI | LO, LO open");
+  feed(sql_or, silence, 100);
+  check(sql_or, false, "HI | LO, both closed");
+
+    // Reset with a sub-squelch open. The sub-squelches close silently so
+    // the combined state must not be built on the old sub-squelch states.
+  feed(sql_or, loud, 100);
+  sql_or.reset();
+  check(sql_or, false, "HI | LO, after reset");
+  feed(sql_or, medium, 100);
+  check(sql_or, true, "HI | LO, LO open after reset");
+  feed(sql_or, silence, 100);
+  check(sql_or, false, "HI | LO, both closed after reset");
+
+  cfg.setValue("Rx2:HI", "SQL_DET", "VOX");
+  cfg.setValue("Rx2:HI", "VOX_FILTER_DEPTH", "20");
+  cfg.setValue("Rx2:HI", "VOX_THRESH", "5000");
+  cfg.setValue("Rx2:LO", "SQL_DET", "VOX");
+  cfg.setValue("Rx2:LO", "VOX_FILTER_DEPTH", "20");
+  cfg.setValue("Rx2:LO", "VOX_THRESH", "500");
+  cfg.setValue("Rx2", "SQL_COMBINE", "Rx2:HI & !Rx2:LO | Rx2:LO & !Rx2:HI");
+  SquelchCombine sql_xor;
+  if (!sql_xor.initialize(cfg, "Rx2"))
+  {
+    cout << "*** ERROR: Could not initialize the XOR squelch" << endl;
+    exit(1);
+  }
+  feed(sql_xor, loud, 100);
+  check(sql_xor, false, "HI ^ LO, both open");
+  feed(sql_xor, medium, 100);
+  check(sql_xor, true, "HI ^ LO, LO open");
+  sql_xor.reset();
+  check(sql_xor, false, "HI ^ LO, after reset");
+  feed(sql_xor, medium, 100);
+  check(sql_xor, true, "HI ^ LO, LO open after reset");
+
+  return 0;
+}
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iomanip>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -139,6 +140,7 @@ SvxSwDtmfDecoder::SvxSwDtmfDecoder(Config &cfg, const string &name)
   {
     row[i].initialize(row_fqs[i]);
     row[i+4].initialize(3.0f * row_fqs[i]); // Third overtone
+    tone_bank.initialize(i, row_fqs[i], INTERNAL_SAMPLE_RATE);
   }
 
     // Column detectors
@@ -146,6 +148,7 @@ SvxSwDtmfDecoder::SvxSwDtmfDecoder(Config &cfg, const string &name)
   {
     col[i].initialize(col_fqs[i]);
     col[i+4].initialize(3.0f * col_fqs[i]); // Third overtone
+    tone_bank.initialize(i+4, col_fqs[i], INTERNAL_SAMPLE_RATE);
   }
 
     // Initialize window function
@@ -209,10 +212,15 @@ bool SvxSwDtmfDecoder::initialize(void)
 
 int SvxSwDtmfDecoder::writeSamples(const float *buf, int len)
 {
-  for (int i = 0; i < len; i++)
+  int i = 0;
+  while (i < len)
   {
-    block[block_pos] = buf[i];
-    if (++block_pos >= BLOCK_SIZE)
+    size_t cnt = std::min(static_cast<size_t>(len - i),
+                          BLOCK_SIZE - block_pos);
+    memcpy(block + block_pos, buf + i, cnt * sizeof(*buf));
+    block_pos += cnt;
+    i += cnt;
+    if (block_pos >= BLOCK_SIZE)
     {
       processBlock();
       if (STEP_SIZE < BLOCK_SIZE)
@@ -243,32 +251,18 @@ int SvxSwDtmfDecoder::writeSamples(const float *buf, int len)
 
 void SvxSwDtmfDecoder::processBlock(void)
 {
-    // Reset all Goertzel objects
-  row[0].reset();
-  row[1].reset();
-  row[2].reset();
-  row[3].reset();
-  col[0].reset();
-  col[1].reset();
-  col[2].reset();
-  col[3].reset();
-
-    // Calculate the total block energy and energy for all individual
-    // Goertzel detectors over the block
+    // Apply the window function and calculate the total block energy
   double block_energy = 0.0;
   for (size_t i=0; i<BLOCK_SIZE; ++i)
   {
-    float sample = block[i] * win[i];
-    block_energy += static_cast<double>(sample) * sample;
-    row[0].calc(sample);
-    row[1].calc(sample);
-    row[2].calc(sample);
-    row[3].calc(sample);
-    col[0].calc(sample);
-    col[1].calc(sample);
-    col[2].calc(sample);
-    col[3].calc(sample);
+    win_block[i] = block[i] * win[i];
+    block_energy += static_cast<double>(win_block[i]) * win_block[i];
   }
+
+    // Calculate the energy for all individual tone detectors over the block.
+    // The eight detectors are run in parallel over the whole block.
+  tone_bank.reset();
+  tone_bank.calc(win_block, BLOCK_SIZE);
   ios_base::fmtflags orig_cout_flags(cout.flags());
   if (debug)
   {
@@ -301,7 +295,7 @@ void SvxSwDtmfDecoder::processBlock(void)
     float col_sum = 0.0f;
     for (size_t i = 0; i < 4; ++i)
     {
-      const float row_ms = WIN_ENB * row[i].magnitudeSquared();
+      const float row_ms = WIN_ENB * tone_bank.magnitudeSquared(i);
       if (row_ms > max_row_ms)
       {
         max_row_ms = row_ms;
@@ -309,7 +303,7 @@ void SvxSwDtmfDecoder::processBlock(void)
       }
       row_sum += row_ms;
 
-      const float col_ms = WIN_ENB * col[i].magnitudeSquared();
+      const float col_ms = WIN_ENB * tone_bank.magnitudeSquared(i+4);
       if (col_ms > max_col_ms)
       {
         max_col_ms = col_ms;
@@ -389,7 +383,7 @@ void SvxSwDtmfDecoder::processBlock(void)
     col[max_col_idx+4].reset();
     for (size_t i=0; i<BLOCK_SIZE; ++i)
     {
-      float sample = block[i] * win[i];
+      const float sample = win_block[i];
       im.calc(sample);
       row[max_row_idx+4].calc(sample);
       col[max_col_idx+4].calc(sample);
@@ -200,7 +200,9 @@ class SvxSwDtmfDecoder : public DtmfDecoder
     float twist_rev_thresh;
     std::vector<DtmfGoertzel> row;
     std::vector<DtmfGoertzel> col;
+    GoertzelBank<8> tone_bank;
     float block[BLOCK_SIZE];
+    float win_block[BLOCK_SIZE];
     size_t block_size;
     size_t block_pos;
     size_t det_cnt;
@@ -344,6 +344,150 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
 };
 
 
+/**
+ * @brief The top state of the voter state machine
+ *
+ * The state objects are recreated on each transition so all state data is
+ * stored in the Voter object, which act as the state machine context.
+ */
+struct Voter::Top : Async::StateTopBase<Voter, Voter::Top>::Type
+{
+  static constexpr auto NAME = "Top";
+
+  void init(void);
+
+    // Machine's event protocol
+  virtual void timerExpired(void) {}
+  virtual void setMuteState(Rx::MuteState new_mute_state);
+  virtual void reset(void);
+  virtual void satSquelchOpen(SatRx *srx, bool is_open);
+  virtual void satSignalLevelUpdated(SatRx *srx, float siglev);
+  virtual float signalStrength(void) { return -100.0; }
+  virtual char sqlRxId(void) { return Rx::ID_UNKNOWN; }
+  virtual SatRx *activeSrx(void) { return 0; }
+
+  Voter &voter(void) { return ctx(); }
+  SatRx *bestSrx(void) { return voter().m_best_srx; }
+  Rx::MuteState muteState(void) { return voter().m_mute_state; }
+  unsigned votingDelay(void) { return voter().m_voting_delay; }
+  float hysteresis(void) { return voter().m_hysteresis; }
+  unsigned sqlCloseRevoteDelay(void)
+  {
+    return voter().m_sql_close_revote_delay;
+  }
+  unsigned rxSwitchDelay(void) { return voter().m_rx_switch_delay; }
+  unsigned revoteInterval(void) { return voter().m_revote_interval; }
+  void runTask(sigc::slot<void> task) { voter().runTask(task); }
+  void startTimer(unsigned time_ms);
+  void stopTimer(void);
+};
+
+
+struct Voter::Muted : Async::StateBase<Voter::Top, Voter::Muted>
+{
+  static constexpr auto NAME = "Muted";
+
+  void entry(void);
+
+  virtual void setMuteState(Rx::MuteState new_mute_state) override;
+  virtual void reset(void) override;
+
+  void doUnmute(void);
+};
+
+
+struct Voter::Idle : Async::StateBase<Voter::Top, Voter::Idle>
+{
+  static constexpr auto NAME = "Idle";
+
+  void entry(void);
+
+  virtual void satSquelchOpen(SatRx *srx, bool is_open) override;
+};
+
+
+struct Voter::VotingDelay : Async::StateBase<Voter::Top, Voter::VotingDelay>
+{
+  static constexpr auto NAME = "VotingDelay";
+
+  void init(SatRx *srx);
+  void exit(void);
+
+  virtual void timerExpired(void) override;
+  virtual void satSquelchOpen(SatRx *srx, bool is_open) override;
+};
+
+
+struct Voter::ActiveRxSelected
+  : Async::StateBase<Voter::Top, Voter::ActiveRxSelected>
+{
+  static constexpr auto NAME = "ActiveRxSelected";
+
+  void init(SatRx *srx);
+  void exit(void);
+
+  virtual void setMuteState(Rx::MuteState new_mute_state) override;
+  virtual char sqlRxId(void) override;
+  virtual SatRx *activeSrx(void) override { return voter().m_active_srx; }
+
+  virtual void changeActiveSrx(SatRx *srx);
+};
+
+
+struct Voter::SquelchOpen
+  : Async::StateBase<Voter::ActiveRxSelected, Voter::SquelchOpen>
+{
+  static constexpr auto NAME = "SquelchOpen";
+
+  void init(void);
+  void entry(void);
+  void exit(void);
+
+  virtual void satSquelchOpen(SatRx *srx, bool is_open) override;
+  virtual float signalStrength(void) override;
+  virtual void changeActiveSrx(SatRx *srx) override;
+};
+
+
+struct Voter::SqlCloseWait
+  : Async::StateBase<Voter::ActiveRxSelected, Voter::SqlCloseWait>
+{
+  static constexpr auto NAME = "SqlCloseWait";
+
+  void entry(void);
+  void exit(void);
+
+  virtual void timerExpired(void) override;
+  virtual void satSquelchOpen(SatRx *srx, bool is_open) override;
+};
+
+
+struct Voter::Receiving
+  : Async::StateBase<Voter::SquelchOpen, Voter::Receiving>
+{
+  static constexpr auto NAME = "Receiving";
+
+  void entry(void);
+  void exit(void);
+
+  virtual void timerExpired(void) override;
+};
+
+
+struct Voter::SwitchActiveRx
+  : Async::StateBase<Voter::SquelchOpen, Voter::SwitchActiveRx>
+{
+  static constexpr auto NAME = "SwitchActiveRx";
+
+  void init(SatRx *srx);
+  void entry(void);
+  void exit(void);
+
+  virtual void timerExpired(void) override;
+  virtual void setMuteState(Rx::MuteState new_mute_state) override;
+};
+
+
 
 /****************************************************************************
  *
@@ -377,10 +521,20 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
  ****************************************************************************/
 
 Voter::Voter(Config &cfg, const std::string& name)
-  : Rx(cfg, name), cfg(cfg), m_verbose(true), selector(0),
-    sm(Macho::State<Top>(this)), is_processing_event(false), command_pty(0),
-    m_print_sat_squelch(false)
+  : Rx(cfg, name), cfg(cfg), m_verbose(true), selector(0), sm(this),
+    is_processing_event(false), command_pty(0), m_print_sat_squelch(false),
+    m_voting_delay(DEFAULT_VOTING_DEALAY), m_hysteresis(DEFAULT_HYSTERESIS),
+    m_sql_close_revote_delay(DEFAULT_SQL_CLOSE_REVOTE_DELAY),
+    m_rx_switch_delay(DEFAULT_RX_SWITCH_DELAY),
+    m_revote_interval(DEFAULT_REVOTE_INTERVAL), m_best_srx(0),
+    m_active_srx(0), m_switch_to_srx(0), m_mute_state(MUTE_ALL),
+    m_event_timer(0, Timer::TYPE_ONESHOT, false),
+    m_task_timer(0, Timer::TYPE_ONESHOT, false)
 {
+  event_queue.reserve(EVENT_QUEUE_SIZE);
+  m_event_timer.expired.connect(mem_fun(*this, &Voter::eventTimerExpired));
+  m_task_timer.expired.connect(mem_fun(*this, &Voter::taskTimerExpired));
+  sm.start();
 } /* Voter::Voter */
 
 
@@ -444,7 +598,7 @@ bool Voter::initialize(void)
 	 << MAX_VOTING_DELAY << ".\n";
     return false;
   }
-  sm->setVotingDelay(voting_delay);
+  m_voting_delay = voting_delay;
   
   unsigned buffer_length = voting_delay;
   cfg.getValue(name(), "BUFFER_LENGTH", buffer_length);
@@ -466,7 +620,7 @@ bool Voter::initialize(void)
 	 << (100.0f * (MAX_HYSTERESIS - 1.0f)) << ".\n";
     return false;
   }
-  sm->setHysteresis(hysteresis / 100.0f + 1.0f);
+  m_hysteresis = hysteresis / 100.0f + 1.0f;
 
   unsigned sql_close_revote_delay = DEFAULT_SQL_CLOSE_REVOTE_DELAY;
   cfg.getValue(name(), "SQL_CLOSE_REVOTE_DELAY", sql_close_revote_delay);
@@ -478,7 +632,7 @@ bool Voter::initialize(void)
 	 << MAX_SQL_CLOSE_REVOTE_DELAY << ".\n";
     return false;
   }
-  sm->setSqlCloseRevoteDelay(sql_close_revote_delay);
+  m_sql_close_revote_delay = sql_close_revote_delay;
   
   unsigned revote_interval = DEFAULT_REVOTE_INTERVAL;
   cfg.getValue(name(), "REVOTE_INTERVAL", revote_interval);
@@ -494,7 +648,7 @@ bool Voter::initialize(void)
       return false;
     }
   }
-  sm->setRevoteInterval(revote_interval);
+  m_revote_interval = revote_interval;
   
   unsigned rx_switch_delay = DEFAULT_RX_SWITCH_DELAY;
   cfg.getValue(name(), "RX_SWITCH_DELAY", rx_switch_delay);
@@ -506,7 +660,7 @@ bool Voter::initialize(void)
 	 << MAX_RX_SWITCH_DELAY << ".\n";
     return false;
   }
-  sm->setRxSwitchDelay(rx_switch_delay);
+  m_rx_switch_delay = rx_switch_delay;
 
   cfg.getValue(name(), "VERBOSE", m_print_sat_squelch);
 
@@ -570,7 +724,7 @@ void Voter::setMuteState(MuteState new_mute_state)
 {
   //cout << "Voter::mute: do_mute=" << (do_mute ? "TRUE" : "FALSE") << endl;
   assert(!is_processing_event);
-  dispatchEvent(Macho::Event(&Top::setMuteState, new_mute_state));
+  dispatchEvent(Event(Event::SET_MUTE_STATE, 0, new_mute_state));
 } /* Voter::setMuteState */
 
 
@@ -593,20 +747,21 @@ float Voter::signalStrength(void) const
 {
     // Const cast needed since we cannot declare the signalStrength
     // method const due to how the state machine is implemented.
-  return const_cast<Macho::Machine<Top>&>(sm)->signalStrength();
+  return const_cast<Async::StateMachine<Voter, Top>&>(sm).state()
+      .signalStrength();
 } /* Voter::signalStrength */
 
 
 char Voter::sqlRxId(void) const
 {
-  return const_cast<Macho::Machine<Top>&>(sm)->sqlRxId();
+  return const_cast<Async::StateMachine<Voter, Top>&>(sm).state().sqlRxId();
 } /* Voter::sqlRxId */
 
 
 void Voter::reset(void)
 {
   assert(!is_processing_event);
-  dispatchEvent(Macho::Event(&Top::reset));
+  dispatchEvent(Event(Event::RESET));
 } /* Voter::reset */
 
 
@@ -626,16 +781,18 @@ void Voter::reset(void)
  *
  ****************************************************************************/
 
-void Voter::dispatchEvent(Macho::IEvent<Top> *event)
+void Voter::dispatchEvent(const Event &event)
 {
   if (!is_processing_event)
   {
     is_processing_event = true;
-    sm.dispatch(event);
-    EventQueue::iterator it;
-    for (it=event_queue.begin(); it!=event_queue.end(); ++it)
+    handleEvent(event);
+      // Events queued while handling an event may queue more events so the
+      // size must be checked on each iteration. The queue keep its capacity
+      // when cleared so no memory is allocated in the normal case.
+    for (EventQueue::size_type i=0; i<event_queue.size(); ++i)
     {
-      sm.dispatch(*it);
+      handleEvent(event_queue[i]);
     }
     event_queue.clear();
     is_processing_event = false;
@@ -647,6 +804,53 @@ void Voter::dispatchEvent(Macho::IEvent<Top> *event)
 } /* Voter::dispatchEvent */
 
 
+void Voter::handleEvent(const Event &event)
+{
+  switch (event.type)
+  {
+    case Event::SET_MUTE_STATE:
+      sm.state().setMuteState(event.mute_state);
+      break;
+    case Event::RESET:
+      sm.state().reset();
+      break;
+    case Event::SAT_SQUELCH_OPEN:
+      sm.state().satSquelchOpen(event.srx, event.is_open);
+      break;
+    case Event::SAT_SIGNAL_LEVEL_UPDATED:
+      sm.state().satSignalLevelUpdated(event.srx, event.siglev);
+      break;
+    case Event::TIMER_EXPIRED:
+      sm.state().timerExpired();
+      break;
+  }
+} /* Voter::handleEvent */
+
+
+void Voter::eventTimerExpired(Timer *t)
+{
+  dispatchEvent(Event(Event::TIMER_EXPIRED));
+} /* Voter::eventTimerExpired */
+
+
+void Voter::runTask(sigc::slot<void> task)
+{
+  m_task_list.push_back(task);
+  m_task_timer.setEnable(true);
+} /* Voter::runTask */
+
+
+void Voter::taskTimerExpired(Timer *t)
+{
+  m_task_timer.setEnable(false);
+  for (SlotList::size_type i=0; i<m_task_list.size(); ++i)
+  {
+    m_task_list[i]();
+  }
+  m_task_list.clear();
+} /* Voter::taskTimerExpired */
+
+
 void Voter::satSquelchOpen(bool is_open, SatRx *srx)
 {
   if (m_print_sat_squelch)
@@ -663,7 +867,7 @@ void Voter::satSquelchOpen(bool is_open, SatRx *srx)
     }
     std::cout << std::endl;
   }
-  dispatchEvent(Macho::Event(&Top::satSquelchOpen, srx, is_open));
+  dispatchEvent(Event(Event::SAT_SQUELCH_OPEN, srx, MUTE_ALL, is_open));
 } /* Voter::satSquelchOpen */
 
 
@@ -671,7 +875,8 @@ void Voter::satSignalLevelUpdated(float siglev, SatRx *srx)
 {
   if (srx->isEnabled())
   {
-    dispatchEvent(Macho::Event(&Top::satSignalLevelUpdated, srx, siglev));
+    dispatchEvent(
+        Event(Event::SAT_SIGNAL_LEVEL_UPDATED, srx, MUTE_ALL, false, siglev));
   }
 } /* Voter::satSignalLevelUpdated */
 
@@ -716,7 +921,7 @@ void Voter::printSquelchState(void)
     float siglev = srx->signalStrength();
     bool sql_is_open = srx->squelchIsOpen();
     bool is_enabled = srx->isEnabled();
-    bool is_active = sql_is_open && ((*it) == sm->activeSrx());
+    bool is_active = sql_is_open && ((*it) == sm.state().activeSrx());
     Json::Value rx(Json::objectValue);
     rx["name"] = srx->name();
     char rx_id = srx->id();
@@ -768,21 +973,12 @@ Voter::SatRx *Voter::findBestRx(void) const
  *
  ****************************************************************************/
 
-void Voter::Top::init(Voter *voter)
+void Voter::Top::init(void)
 {
-  box().voter = voter;
-  box().event_timer.expired.connect(mem_fun(*this, &Top::eventTimerExpired));
   setState<Muted>();
 } /* Voter::Top::init */
 
 
-void Voter::Top::exit(void)
-{
-  delete box().task_timer;
-  box().task_timer = 0;
-} /* Voter::Top::exit */
-
-
 void Voter::Top::reset(void)
 {
   voter().resetAll();
@@ -797,6 +993,8 @@ void Voter::Top::setMuteState(Rx::MuteState new_mute_state)
     return;
   }
 
+    // The new mute state must be set before a possible state transition
+  voter().m_mute_state = new_mute_state;
   switch (new_mute_state)
   {
     case MUTE_NONE:
@@ -811,7 +1009,6 @@ void Voter::Top::setMuteState(Rx::MuteState new_mute_state)
       setState<Muted>();
       break;
   }
-  box().mute_state = new_mute_state;
 } /* Voter::Top::setMuteState */
 
 
@@ -822,13 +1019,13 @@ void Voter::Top::satSquelchOpen(SatRx *srx, bool is_open)
   if (bestSrx() == 0)
   {
     assert(is_open);
-    box().best_srx = srx;
+    voter().m_best_srx = srx;
   }
   else if (srx == bestSrx())
   {
     if (!is_open)
     {
-      box().best_srx = voter().findBestRx();
+      voter().m_best_srx = voter().findBestRx();
     }
   }
   else
@@ -836,7 +1033,7 @@ void Voter::Top::satSquelchOpen(SatRx *srx, bool is_open)
     if (is_open &&
         (srx->signalStrength() > bestSrx()->signalStrength()))
     {
-      box().best_srx = srx;
+      voter().m_best_srx = srx;
     }
   }
 } /* Voter::Top::satSquelchOpen */
@@ -851,7 +1048,7 @@ void Voter::Top::satSignalLevelUpdated(SatRx *srx, float siglev)
   if (!bestSrx()->squelchIsOpen() ||
       (siglev > bestSrx()->signalStrength()))
   {
-    box().best_srx = srx;
+    voter().m_best_srx = srx;
   }
 
   if (srx == activeSrx())
@@ -861,51 +1058,19 @@ void Voter::Top::satSignalLevelUpdated(SatRx *srx, float siglev)
 } /* Voter::Top::satSignalLevelUpdated */
 
 
-void Voter::Top::runTask(sigc::slot<void> task)
-{
-  box().task_list.push_back(task);
-  
-  if (box().task_timer == 0)
-  {
-    Timer *t = new Timer(0);
-    t->expired.connect(mem_fun(*this, &Voter::Top::taskTimerExpired));
-  }
-} /* Voter::Top::runTask */
-
-
-void Voter::Top::taskTimerExpired(Timer *t)
-{
-  SlotList::iterator it;
-  for (it=box().task_list.begin(); it!=box().task_list.end(); ++it)
-  {
-    (*it)();
-  }
-  box().task_list.clear();
-  
-  delete box().task_timer;
-  box().task_timer = 0;
-} /* Voter::Top::taskTimerExpired */
-
-
 void Voter::Top::startTimer(unsigned time_ms)
 {
-  box().event_timer.setTimeout(time_ms);
-  box().event_timer.setEnable(true);
+  voter().m_event_timer.setTimeout(time_ms);
+  voter().m_event_timer.setEnable(true);
 } /* Voter::Top::startTimer */
 
 
 void Voter::Top::stopTimer(void)
 {
-  box().event_timer.setEnable(false);
+  voter().m_event_timer.setEnable(false);
 } /* Voter::Top::stopTimer */
 
 
-void Voter::Top::eventTimerExpired(Timer *t)
-{ 
-  voter().dispatchEvent(Macho::Event(&Top::timerExpired));
-} /* Voter::Top::eventTimerExpired */
-
-
 
 /****************************************************************************
  *
@@ -922,15 +1087,25 @@ void Voter::Muted::entry(void)
 
 void Voter::Muted::setMuteState(Rx::MuteState new_mute_state)
 {
+    // The new mute state must be set before a possible state transition
+  voter().m_mute_state = new_mute_state;
   if ((new_mute_state == Rx::MUTE_NONE)
       || (new_mute_state == Rx::MUTE_CONTENT))
   {
     doUnmute();
   }
-  TOP::box().mute_state = new_mute_state;
 } /* Voter::Muted::setMuteState */
 
 
+void Voter::Muted::reset(void)
+{
+    // Transitions to the current state are ignored so redo what the entry
+    // function do instead
+  voter().resetAll();
+  voter().muteAll(MUTE_ALL);
+} /* Voter::Muted::reset */
+
+
 void Voter::Muted::doUnmute(void)
 {
   if (bestSrx() != 0)
@@ -964,7 +1139,7 @@ void Voter::Idle::entry(void)
 
 void Voter::Idle::satSquelchOpen(SatRx *srx, bool is_open)
 {
-  SUPER::satSquelchOpen(srx, is_open);
+  Top::satSquelchOpen(srx, is_open);
   if (is_open)
   {
     if (srx->signalStrength() * hysteresis() > 100.0f)
@@ -986,13 +1161,6 @@ void Voter::Idle::satSquelchOpen(SatRx *srx, bool is_open)
  *
  ****************************************************************************/
 
-void Voter::VotingDelay::entry(void)
-{
-  //cout << "### VotingDelay::entry\n";
-  //startTimer(votingDelay());
-} /* Voter::VotingDelay::entry */
-
-
 void Voter::VotingDelay::init(SatRx *srx)
 {
   //cout << "### VotingDelay::init\n";
@@ -1009,7 +1177,7 @@ void Voter::VotingDelay::exit(void)
 
 void Voter::VotingDelay::satSquelchOpen(SatRx *srx, bool is_open)
 {
-  SUPER::satSquelchOpen(srx, is_open);
+  Top::satSquelchOpen(srx, is_open);
   if (is_open)
   {
     if (srx->signalStrength() * hysteresis() > 100.0f)
@@ -1045,7 +1213,7 @@ void Voter::VotingDelay::timerExpired(void)
 void Voter::ActiveRxSelected::init(SatRx *srx)
 {
   assert(srx != 0);
-  box().active_srx = srx;
+  voter().m_active_srx = srx;
   if (muteState() == MUTE_CONTENT)
   {
     voter().muteAll(MUTE_CONTENT);
@@ -1068,17 +1236,17 @@ void Voter::ActiveRxSelected::setMuteState(Rx::MuteState new_mute_state)
 {
   if (new_mute_state != Rx::MUTE_NONE)
   {
-    SUPER::setMuteState(new_mute_state);
+    Top::setMuteState(new_mute_state);
     return;
   }
   activeSrx()->setMuteState(MUTE_NONE);
-  TOP::box().mute_state = Rx::MUTE_NONE;
+  voter().m_mute_state = Rx::MUTE_NONE;
 } /* Voter::ActiveRxSelected::setMuteState */
 
 
 char Voter::ActiveRxSelected::sqlRxId(void)
 {
-  return box().active_srx->id();
+  return voter().m_active_srx->id();
 } /* Voter::ActiveRxSelected::sqlRxId */
 
 
@@ -1086,7 +1254,7 @@ void Voter::ActiveRxSelected::changeActiveSrx(SatRx *srx)
 {
   voter().selector->selectSource(srx);
   activeSrx()->setMuteState(MUTE_CONTENT);
-  box().active_srx = srx;
+  voter().m_active_srx = srx;
   if (muteState() == Rx::MUTE_NONE)
   {
     activeSrx()->setMuteState(MUTE_NONE);
@@ -1140,7 +1308,7 @@ void Voter::SquelchOpen::exit(void)
 
 void Voter::SquelchOpen::satSquelchOpen(SatRx *srx, bool is_open)
 {
-  SUPER::satSquelchOpen(srx, is_open);
+  ActiveRxSelected::satSquelchOpen(srx, is_open);
   if (!is_open && (srx == activeSrx()))
   {
     setState<SqlCloseWait>();
@@ -1157,7 +1325,7 @@ float Voter::SquelchOpen::signalStrength(void)
 void Voter::SquelchOpen::changeActiveSrx(SatRx *srx)
 {
   runTask(bind(mem_fun(activeSrx(), &SatRx::stopOutput), true));
-  SUPER::changeActiveSrx(srx);
+  ActiveRxSelected::changeActiveSrx(srx);
   runTask(bind(mem_fun(activeSrx(), &SatRx::stopOutput), false));  
 } /* Voter::SquelchOpen::changeActiveSrx */
 
@@ -1185,7 +1353,7 @@ void Voter::SqlCloseWait::exit(void)
 
 void Voter::SqlCloseWait::satSquelchOpen(SatRx *srx, bool is_open)
 {
-  SUPER::satSquelchOpen(srx, is_open);
+  ActiveRxSelected::satSquelchOpen(srx, is_open);
   if (is_open && (srx == activeSrx()))
   {
     setState<SquelchOpen>();
@@ -1271,7 +1439,7 @@ void Voter::SwitchActiveRx::entry(void)
 
 void Voter::SwitchActiveRx::init(SatRx *srx)
 {
-  box().switch_to_srx = srx;
+  voter().m_switch_to_srx = srx;
   if (muteState() == Rx::MUTE_NONE)
   {
     srx->setMuteState(MUTE_NONE);
@@ -1282,9 +1450,9 @@ void Voter::SwitchActiveRx::init(SatRx *srx)
 void Voter::SwitchActiveRx::exit(void)
 {
   //cout << "### SwitchActiveRx::exit\n";
-  if (box().switch_to_srx != 0)
+  if (voter().m_switch_to_srx != 0)
   {
-    box().switch_to_srx->setMuteState(MUTE_CONTENT);
+    voter().m_switch_to_srx->setMuteState(MUTE_CONTENT);
   }
 
   stopTimer();
@@ -1295,18 +1463,18 @@ void Voter::SwitchActiveRx::setMuteState(Rx::MuteState new_mute_state)
 {
   if (new_mute_state != Rx::MUTE_NONE)
   {
-    SUPER::setMuteState(new_mute_state);
+    SquelchOpen::setMuteState(new_mute_state);
     return;
   }
   activeSrx()->setMuteState(MUTE_NONE);
-  box().switch_to_srx->setMuteState(MUTE_NONE);
-  TOP::box().mute_state = Rx::MUTE_NONE;
+  voter().m_switch_to_srx->setMuteState(MUTE_NONE);
+  voter().m_mute_state = Rx::MUTE_NONE;
 } /* Voter::SwitchActiveRx::setMuteState */
 
 
 void Voter::SwitchActiveRx::timerExpired(void)
 {
-  SatRx *switch_to_srx = box().switch_to_srx;
+  SatRx *switch_to_srx = voter().m_switch_to_srx;
   
   assert(activeSrx() != 0);
   assert(switch_to_srx != 0);
@@ -1326,7 +1494,7 @@ void Voter::SwitchActiveRx::timerExpired(void)
     }
     
     changeActiveSrx(switch_to_srx);
-    box().switch_to_srx = 0;
+    voter().m_switch_to_srx = 0;
   }
   setState<Receiving>();
 } /* Voter::SwitchActiveRx::timerExpired */
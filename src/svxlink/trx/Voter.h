@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <list>
+#include <vector>
 
 
 /****************************************************************************
@@ -45,6 +46,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncStateMachine.h>
 #include <CppStdCompat.h>
 
 
@@ -55,7 +58,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "Rx.h"
-#include "Macho.hpp"
 
 
 /****************************************************************************
@@ -66,7 +68,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 namespace Async
 {
-  class Timer;
   class AudioSelector;
   class Pty;
 };
@@ -200,222 +201,76 @@ class Voter : public Rx
     static CONSTEXPR unsigned MAX_REVOTE_INTERVAL            = 60000;
     static CONSTEXPR unsigned MAX_RX_SWITCH_DELAY            = 3000;
 
+    static CONSTEXPR size_t   EVENT_QUEUE_SIZE               = 16;
+
     class SatRx;
 
-    TOPSTATE(Top)
+      // State machine states. They are defined in Voter.cpp.
+    struct Top;
+    struct Muted;
+    struct Idle;
+    struct VotingDelay;
+    struct ActiveRxSelected;
+    struct SquelchOpen;
+    struct SqlCloseWait;
+    struct Receiving;
+    struct SwitchActiveRx;
+
+    struct Event
     {
-      typedef std::list<sigc::slot<void> > SlotList;
-      
-	// Top state variables (visible to all substates)
-      struct Box {
-	Box(void)
-	  : voting_delay(DEFAULT_VOTING_DEALAY), hysteresis(DEFAULT_HYSTERESIS),
-	    sql_close_revote_delay(DEFAULT_SQL_CLOSE_REVOTE_DELAY),
-	    rx_switch_delay(DEFAULT_RX_SWITCH_DELAY),
-	    revote_interval(DEFAULT_REVOTE_INTERVAL), voter(0), best_srx(0),
-	    mute_state(MUTE_ALL), task_timer(0), event_timer(0)
-	{
-	  event_timer.setEnable(false);
-	}
-	
-	unsigned	voting_delay;
-	float		hysteresis;
-	unsigned	sql_close_revote_delay;
-	unsigned	rx_switch_delay;
-	unsigned	revote_interval;
-	Voter		*voter;
-	SatRx		*best_srx;
-        Rx::MuteState   mute_state;
-	Async::Timer	*task_timer;
-	SlotList	task_list;
-	Async::Timer	event_timer;
-      };
-
-      STATE(Top)
-
-      void setVotingDelay(unsigned delay_ms)
-      {
-        box().voting_delay = delay_ms;
-      }
-      unsigned votingDelay(void) { return box().voting_delay; }
-      void setHysteresis(float hysteresis) { box().hysteresis = hysteresis; }
-      float hysteresis(void) { return box().hysteresis; }
-      void setSqlCloseRevoteDelay(unsigned delay_ms)
+      typedef enum
       {
-	box().sql_close_revote_delay = delay_ms;
-      }
-      unsigned sqlCloseRevoteDelay(void)
-      {
-        return box().sql_close_revote_delay;
-      }
-      void setRxSwitchDelay(unsigned delay_ms)
+        SET_MUTE_STATE, RESET, SAT_SQUELCH_OPEN, SAT_SIGNAL_LEVEL_UPDATED,
+        TIMER_EXPIRED
+      } Type;
+
+      Type            type;
+      SatRx           *srx;
+      Rx::MuteState   mute_state;
+      bool            is_open;
+      float           siglev;
+
+      Event(Type type, SatRx *srx=0, Rx::MuteState mute_state=Rx::MUTE_ALL,
+            bool is_open=false, float siglev=0.0f)
+        : type(type), srx(srx), mute_state(mute_state), is_open(is_open),
+          siglev(siglev)
       {
-        box().rx_switch_delay = delay_ms;
       }
-      unsigned rxSwitchDelay(void) { return box().rx_switch_delay; }
-      void setRevoteInterval(unsigned interval_ms)
-      {
-	box().revote_interval = interval_ms;
-      }
-      unsigned revoteInterval(void) { return box().revote_interval; }
-      
-	// Machine's event protocol
-      virtual void timerExpired(void) { }
-      virtual void setMuteState(Rx::MuteState new_mute_state);
-      virtual void reset(void);
-      virtual void satSquelchOpen(SatRx *srx, bool is_open);
-      virtual void satSignalLevelUpdated(SatRx *srx, float siglev);
-      virtual float signalStrength(void) { return -100.0; }
-      virtual char sqlRxId(void) { return Rx::ID_UNKNOWN; }
-      virtual SatRx *activeSrx(void) { return 0; }
-      
-      protected:
-	Voter &voter(void) { return *box().voter; }
-	SatRx *bestSrx(void) { return box().best_srx; }
-	bool muteState(void) { return box().mute_state; }
-	void runTask(sigc::slot<void> task);
-	void taskTimerExpired(Async::Timer *t);
-	void startTimer(unsigned time_ms);
-	void stopTimer(void);
-	
-      private:
-	void entry() {}
-	void init(Voter *voter);
-	void exit(void);
-	
-	void eventTimerExpired(Async::Timer *t);
-    };
-
-    SUBSTATE(Muted, Top)
-    {
-      STATE(Muted)
-      
-      virtual void setMuteState(Rx::MuteState new_mute_state);
-      
-      private:
-	void entry(void);
-	
-	void doUnmute(void);
-    };
-
-    SUBSTATE(Idle, Top)
-    {
-      STATE(Idle)
-
-      virtual void satSquelchOpen(SatRx *srx, bool is_open);
-
-      private:
-	void entry(void);
-    };
-
-    SUBSTATE(VotingDelay, Top)
-    {
-      STATE(VotingDelay)
-
-      virtual void timerExpired(void);
-      virtual void satSquelchOpen(SatRx *srx, bool is_open);
-
-      private:
-	void entry(void);
-	void init(SatRx *srx);
-	void exit(void);
-	
     };
 
-    SUBSTATE(ActiveRxSelected, Top) {
-      struct Box
-      {
-	Box(void) : active_srx(0) {}
-	SatRx *active_srx;
-      };
-      
-      STATE(ActiveRxSelected)
-
-      virtual void setMuteState(Rx::MuteState new_mute_state);
-      virtual char sqlRxId(void);
-      virtual SatRx *activeSrx(void) { return box().active_srx; }
-
-      protected:
-	virtual void changeActiveSrx(SatRx *srx);
-	
-      private:
-	void init(SatRx *srx);
-	void exit(void);
-    };
-
-    SUBSTATE(SquelchOpen, ActiveRxSelected) {
-      STATE(SquelchOpen)
-
-      virtual void satSquelchOpen(SatRx *srx, bool is_open);
-      virtual float signalStrength(void);
-
-      protected:
-	virtual void changeActiveSrx(SatRx *srx);
-	
-      private:
-	void entry(void);
-	void init(void);
-	void exit(void);
-    };
-
-    SUBSTATE(SqlCloseWait, ActiveRxSelected)
-    {
-      STATE(SqlCloseWait)
-
-      virtual void timerExpired(void);
-      virtual void satSquelchOpen(SatRx *srx, bool is_open);
-      
-      private:
-	void entry(void);
-	void exit(void);
-    };
-
-    SUBSTATE(Receiving, SquelchOpen)
-    {
-      STATE(Receiving)
-      
-      virtual void timerExpired(void);
+    typedef std::vector<Event> EventQueue;
+    typedef std::vector<sigc::slot<void> > SlotList;
 
-      private:
-	void entry(void);
-	void exit(void);
-    };
-
-    SUBSTATE(SwitchActiveRx, SquelchOpen)
-    {
-      struct Box
-      {
-	Box(void) : switch_to_srx(0) {}
-	SatRx *switch_to_srx;
-      };
-      
-      STATE(SwitchActiveRx)
-
-      virtual void setMuteState(Rx::MuteState new_mute_state);
-
-      protected:
-	virtual void timerExpired(void);
-
-      private:
-	void entry(void);
-	void init(SatRx *srx);
-	void exit(void);
-    };
-    
-    typedef std::list<Macho::IEvent<Top>*> EventQueue;
-    
     Async::Config     	  &cfg;
     std::list<SatRx *>	  rxs;
     bool	      	  m_verbose;
     Async::AudioSelector  *selector;
-    Macho::Machine<Top>   sm;
+    Async::StateMachine<Voter, Top> sm;
     bool		  is_processing_event;
     EventQueue		  event_queue;
     Async::Pty            *command_pty;
     std::string           command_buf;
     bool                  m_print_sat_squelch;
 
-    void dispatchEvent(Macho::IEvent<Top> *event);
+      // State machine context variables
+    unsigned              m_voting_delay;
+    float                 m_hysteresis;
+    unsigned              m_sql_close_revote_delay;
+    unsigned              m_rx_switch_delay;
+    unsigned              m_revote_interval;
+    SatRx                 *m_best_srx;
+    SatRx                 *m_active_srx;
+    SatRx                 *m_switch_to_srx;
+    Rx::MuteState         m_mute_state;
+    Async::Timer          m_event_timer;
+    Async::Timer          m_task_timer;
+    SlotList              m_task_list;
+
+    void dispatchEvent(const Event &event);
+    void handleEvent(const Event &event);
+    void eventTimerExpired(Async::Timer *t);
+    void runTask(sigc::slot<void> task);
+    void taskTimerExpired(Async::Timer *t);
     void satSquelchOpen(bool is_open, SatRx *rx);
     void satSignalLevelUpdated(float siglev, SatRx *srx);
     void muteAllBut(SatRx *srx, Rx::MuteState mute_state);
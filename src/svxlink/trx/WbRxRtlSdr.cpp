@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <stdint.h>
+#include <cmath>
 #include <cassert>
 #include <limits>
 #include <algorithm>
@@ -137,7 +138,8 @@ WbRxRtlSdr *WbRxRtlSdr::instance(Async::Config &cfg, const string &name)
 
 
 WbRxRtlSdr::WbRxRtlSdr(Async::Config &cfg, const string &name)
-  : auto_tune_enabled(true), m_name(name), xvrtr_offset(0)
+  : auto_tune_enabled(true), m_name(name), xvrtr_offset(0),
+    chpwr_enabled(false), iq_history_len(0)
 {
   //cout << "### Initializing WBRX " << name << endl;
 
@@ -173,7 +175,7 @@ WbRxRtlSdr::WbRxRtlSdr(Async::Config &cfg, const string &name)
   cfg.getValue(name, "SAMPLE_RATE", sample_rate);
   //cout << "###   SAMPLE_RATE = " << sample_rate << endl;
   rtl->setSampleRate(sample_rate);
-  rtl->iqReceived.connect(iqReceived.make_slot());
+  rtl->iqReceived.connect(mem_fun(*this, &WbRxRtlSdr::rtlIqReceived));
   rtl->readyStateChanged.connect(
       mem_fun(*this, &WbRxRtlSdr::rtlReadyStateChanged));
 
@@ -286,6 +288,43 @@ bool WbRxRtlSdr::isReady(void) const
 } /* WbRxRtlSdr::isReady */
 
 
+void WbRxRtlSdr::enableChannelPower(void)
+{
+  if (chpwr_enabled)
+  {
+    return;
+  }
+  chpwr_enabled = true;
+
+  const unsigned N = SPECTRUM_FFT_SIZE;
+  fft = Fft::plan(N);
+  fft_buf.resize(N);
+  fft_window.resize(N);
+  for (unsigned n=0; n<N; ++n)
+  {
+    fft_window[n] = 0.5f - 0.5f * cos(2.0 * M_PI * n / N);
+  }
+  spectrum.assign(N, 0.0f);
+} /* WbRxRtlSdr::enableChannelPower */
+
+
+float WbRxRtlSdr::channelPower(int fq_offset, unsigned bw) const
+{
+  assert(chpwr_enabled);
+  const int N = SPECTRUM_FFT_SIZE;
+  const float bin_bw = static_cast<float>(rtl->sampleRate()) / N;
+  int first_bin = lround((fq_offset - 0.5f * bw) / bin_bw);
+  int last_bin = max(first_bin, static_cast<int>(
+        lround((fq_offset + 0.5f * bw) / bin_bw)));
+  float pwr = 0.0f;
+  for (int bin=first_bin; bin<=last_bin; ++bin)
+  {
+    pwr += spectrum[(bin % N + N) % N];
+  }
+  return 10.0f * log10f(pwr + 1.0e-12f);
+} /* WbRxRtlSdr::channelPower */
+
+
 
 /****************************************************************************
  *
@@ -403,6 +442,62 @@ void WbRxRtlSdr::rtlReadyStateChanged(void)
 } /* WbRxRtlSdr::rtlReadyStateChanged */
 
 
+void WbRxRtlSdr::rtlIqReceived(const IqBlock& block)
+{
+  if (!chpwr_enabled)
+  {
+    iqReceived(block);
+    return;
+  }
+
+  updateSpectrum(*block);
+  iqReceived(block);
+
+    // Keeping a reference to the block is enough to keep it in the history
+  iq_history_len += block->size();
+  iq_history.push_back(block);
+  const size_t max_len = rtl->sampleRate() * IQ_HISTORY_TIME / 1000;
+  while ((iq_history.size() > 1) &&
+         (iq_history_len - iq_history.front()->size() >= max_len))
+  {
+    iq_history_len -= iq_history.front()->size();
+    iq_history.pop_front();
+  }
+} /* WbRxRtlSdr::rtlIqReceived */
+
+
+void WbRxRtlSdr::updateSpectrum(const std::vector<Sample>& samples)
+{
+  const unsigned N = SPECTRUM_FFT_SIZE;
+  unsigned fft_cnt = min(static_cast<unsigned>(samples.size() / N),
+                         SPECTRUM_FFTS_PER_BLOCK);
+  if (fft_cnt == 0)
+  {
+    return;
+  }
+
+    // Spread the FFT:s evenly over the block and average the power spectra.
+    // The scaling, which include the window gain, make a full scale tone
+    // read about 0dB.
+  const size_t stride = samples.size() / fft_cnt;
+  const float scale = 4.0f / (static_cast<float>(N) * N * fft_cnt);
+  std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+  for (unsigned i=0; i<fft_cnt; ++i)
+  {
+    const Sample *in = &samples[i * stride];
+    for (unsigned n=0; n<N; ++n)
+    {
+      fft_buf[n] = in[n] * fft_window[n];
+    }
+    fft->transform(fft_buf);
+    for (unsigned k=0; k<N; ++k)
+    {
+      spectrum[k] += norm(fft_buf[k]) * scale;
+    }
+  }
+} /* WbRxRtlSdr::updateSpectrum */
+
+
 
 /*
  * This file has not been truncated
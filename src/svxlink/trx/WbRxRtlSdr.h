@@ -41,6 +41,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <vector>
 #include <complex>
 #include <set>
+#include <deque>
+#include <memory>
 
 
 /****************************************************************************
@@ -57,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "Fft.h"
 
 
 /****************************************************************************
@@ -125,6 +128,23 @@ class WbRxRtlSdr : public sigc::trackable
 {
   public:
     typedef std::complex<float> Sample;
+    typedef std::shared_ptr<const std::vector<Sample> > IqBlock;
+    typedef std::deque<IqBlock> IqHistory;
+
+    /**
+     * @brief   The FFT size used when measuring channel power
+     */
+    static const unsigned SPECTRUM_FFT_SIZE = 256;
+
+    /**
+     * @brief   The maximum number of FFT:s to average for each sample block
+     */
+    static const unsigned SPECTRUM_FFTS_PER_BLOCK = 4;
+
+    /**
+     * @brief   The length of the I/Q history buffer in milliseconds
+     */
+    static const unsigned IQ_HISTORY_TIME = 120;
 
     static WbRxRtlSdr *instance(Async::Config &cfg, const std::string &name);
 
@@ -195,15 +215,50 @@ class WbRxRtlSdr : public sigc::trackable
      */
     bool isReady(void) const;
 
+    /**
+     * @brief   Enable the wideband channel power measurement
+     *
+     * When enabled, the power spectrum of each received block of samples is
+     * measured using a small FFT so that the power in any channel can be
+     * read using the channelPower function. The most recently received
+     * samples are also saved in a history buffer, available through the
+     * iqHistory function. Once enabled it stays enabled.
+     */
+    void enableChannelPower(void);
+
+    /**
+     * @brief   Get the power within a channel in the latest sample block
+     * @param   fq_offset The channel center frequency offset from the tuner
+     *                    center frequency in Hz
+     * @param   bw The bandwidth of the channel in Hz
+     * @returns Returns the channel power in dB relative to full scale
+     *
+     * The channel power measurement must have been enabled using the
+     * enableChannelPower function. The resolution is limited by the FFT
+     * size so the channel will be at least one FFT bin wide.
+     */
+    float channelPower(int fq_offset, unsigned bw) const;
+
+    /**
+     * @brief   Get the history of previously received sample blocks
+     * @returns Returns about IQ_HISTORY_TIME milliseconds of sample blocks
+     *
+     * The history contain the blocks received before the one currently being
+     * emitted by the iqReceived signal. It is only maintained when the channel
+     * power measurement has been enabled.
+     */
+    const IqHistory& iqHistory(void) const { return iq_history; }
+
     /**
      * @brief   A signal that is emitted when new samples have been received
-     * @param   samples A vector of received samples
+     * @param   samples A block of received samples
      *
      * Connecting to this signal is the way to get samples from the DVB-T
      * dongle. The format is a vector of complex floats (I/Q) with a range from
-     * -1 to 1.
+     * -1 to 1. The block is shared between all receivers of the signal and
+     * must not be modified (@see RtlSdr::IqBlock).
      */
-    sigc::signal<void, std::vector<Sample> > iqReceived;
+    sigc::signal<void, const IqBlock&> iqReceived;
     
     /**
      * @brief   A signal that is emitted when the ready state changes
@@ -223,11 +278,20 @@ class WbRxRtlSdr : public sigc::trackable
     bool auto_tune_enabled;
     std::string m_name;
     int xvrtr_offset;
+    bool chpwr_enabled;
+    std::shared_ptr<const Fft> fft;
+    std::vector<Sample> fft_buf;
+    std::vector<float> fft_window;
+    std::vector<float> spectrum;
+    IqHistory iq_history;
+    size_t iq_history_len;
 
     WbRxRtlSdr(const WbRxRtlSdr&);
     WbRxRtlSdr& operator=(const WbRxRtlSdr&);
     void findBestCenterFq(void);
     void rtlReadyStateChanged(void);
+    void rtlIqReceived(const IqBlock& block);
+    void updateSpectrum(const std::vector<Sample>& samples);
     
 };  /* class WbRxRtlSdr */
 
@@ -0,0 +1,255 @@
+/**
+@file   WelchPsd.cpp
+@brief  Power spectrum estimation using the Welch method
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "WelchPsd.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+WelchPsd::WelchPsd(unsigned sample_rate, size_t N, WindowType window_type)
+  : sample_rate(sample_rate), fft(Fft::plan(N)),
+    window(createWindow(N, window_type)), buf(N), buf_cnt(0), fft_buf(N),
+    pwr(N / 2 + 1, 0.0), seg_cnt(0)
+{
+} /* WelchPsd::WelchPsd */
+
+
+size_t WelchPsd::fqToBin(float fq) const
+{
+  long k = lround(fq * size() / sample_rate);
+  return static_cast<size_t>(
+      std::min(std::max(k, 0L), static_cast<long>(binCount() - 1)));
+} /* WelchPsd::fqToBin */
+
+
+void WelchPsd::writeSamples(const float *samples, int count)
+{
+  const size_t N = size();
+  while (count > 0)
+  {
+    size_t cnt = std::min(N - buf_cnt, static_cast<size_t>(count));
+    std::memcpy(&buf[buf_cnt], samples, cnt * sizeof(*samples));
+    buf_cnt += cnt;
+    samples += cnt;
+    count -= cnt;
+    if (buf_cnt == N)
+    {
+      processSegment();
+
+        // Keep the last half of the segment for the next one (50% overlap)
+      std::memcpy(&buf[0], &buf[N/2], (N/2) * sizeof(buf[0]));
+      buf_cnt = N / 2;
+    }
+  }
+} /* WelchPsd::writeSamples */
+
+
+void WelchPsd::reset(void)
+{
+  std::fill(pwr.begin(), pwr.end(), 0.0);
+  seg_cnt = 0;
+} /* WelchPsd::reset */
+
+
+double WelchPsd::toneAmplitude(float fq) const
+{
+  return sqrt(2.0 * binPower(fqToBin(fq)));
+} /* WelchPsd::toneAmplitude */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+std::shared_ptr<const WelchPsd::Window> WelchPsd::createWindow(size_t N,
+    WindowType type)
+{
+  static std::map<std::pair<int, size_t>, std::weak_ptr<const Window> > cache;
+  std::weak_ptr<const Window>& cached = cache[std::make_pair(type, N)];
+  std::shared_ptr<const Window> w = cached.lock();
+  if (w)
+  {
+    return w;
+  }
+
+  std::shared_ptr<Window> new_w = std::make_shared<Window>(N);
+  Window& win = *new_w;
+  for (size_t n=0; n<N; ++n)
+  {
+    switch (type)
+    {
+      case WINDOW_HANN:
+        win[n] = 0.5 - 0.5 * cos(2.0 * M_PI * n / N);
+        break;
+      case WINDOW_FLATTOP:
+        win[n] = 0.21557895
+               - 0.41663158 * cos(2.0 * M_PI * n / (N-1))
+               + 0.277263158 * cos(4.0 * M_PI * n / (N-1))
+               - 0.083578947 * cos(6.0 * M_PI * n / (N-1))
+               + 0.006947368 * cos(8.0 * M_PI * n / (N-1));
+        break;
+    }
+  }
+
+    // Normalize the window to a mean value of one so that the coherent gain
+    // of the window does not affect the measured tone levels.
+  double mean = 0.0;
+  for (size_t n=0; n<N; ++n)
+  {
+    mean += win[n];
+  }
+  mean /= N;
+  for (size_t n=0; n<N; ++n)
+  {
+    win[n] /= mean;
+  }
+
+  cached = new_w;
+  return new_w;
+} /* WelchPsd::createWindow */
+
+
+void WelchPsd::processSegment(void)
+{
+  const size_t N = size();
+  const Window& win = *window;
+  for (size_t n=0; n<N; ++n)
+  {
+    fft_buf[n] = Fft::Sample(buf[n] * win[n], 0.0f);
+  }
+  fft->transform(fft_buf);
+
+  const double scale = 2.0 / (static_cast<double>(N) * N);
+  for (size_t k=0; k<pwr.size(); ++k)
+  {
+    pwr[k] += norm(fft_buf[k]) * scale;
+  }
+  ++seg_cnt;
+} /* WelchPsd::processSegment */
+
+
+
+/*
+ * This file has not been truncated
+ */
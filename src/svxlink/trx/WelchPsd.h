@@ -0,0 +1,239 @@
+/**
+@file   WelchPsd.h
+@brief  Power spectrum estimation using the Welch method
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef WELCH_PSD_INCLUDED
+#define WELCH_PSD_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "Fft.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Power spectrum estimation using the Welch method
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class estimate the power spectrum of a real signal using the Welch
+method. The signal is split up in segments of N samples overlapping by 50%.
+Each segment is windowed and transformed using an FFT and the power in each
+bin is averaged over all segments since the last reset.
+
+The power in a bin is scaled so that a sine wave with amplitude A, falling
+exactly in the bin, read A²/2. With the flat top window, the scalloping loss
+is so small that this also hold for tones that fall in between two bins,
+which make it suitable for measuring tone levels. The Hann window give better
+frequency resolution.
+
+The FFT plan and the window are shared between all instances using the same
+size and window type, so running many instances in parallel is cheap in terms
+of memory.
+*/
+class WelchPsd
+{
+  public:
+    /**
+     * @brief   The window function to apply to each segment
+     */
+    typedef enum
+    {
+      WINDOW_HANN,    ///< Hann window
+      WINDOW_FLATTOP  ///< Flat top window
+    } WindowType;
+
+    /**
+     * @brief   Constructor
+     * @param   sample_rate The sample rate of the signal
+     * @param   N The segment length, must be a power of two
+     * @param   window The window function to use
+     */
+    WelchPsd(unsigned sample_rate, size_t N, WindowType window=WINDOW_HANN);
+
+    /**
+     * @brief   Get the segment length
+     * @return  Returns the number of samples in each segment
+     */
+    size_t size(void) const { return fft->size(); }
+
+    /**
+     * @brief   Get the number of bins in the power spectrum
+     * @return  Returns N/2+1
+     */
+    size_t binCount(void) const { return pwr.size(); }
+
+    /**
+     * @brief   Get the center frequency of a bin
+     * @param   k The bin index
+     * @return  Returns the center frequency of the bin in Hz
+     */
+    float binFq(size_t k) const
+    {
+      return static_cast<float>(k) * sample_rate / size();
+    }
+
+    /**
+     * @brief   Find the bin closest to a frequency
+     * @param   fq The frequency in Hz
+     * @return  Returns the index of the closest bin
+     */
+    size_t fqToBin(float fq) const;
+
+    /**
+     * @brief   Write samples to the estimator
+     * @param   samples The samples to add
+     * @param   count The number of samples
+     */
+    void writeSamples(const float *samples, int count);
+
+    /**
+     * @brief   Restart the averaging
+     *
+     * The averaged power spectrum is cleared. The samples that the next
+     * segment will overlap with are kept.
+     */
+    void reset(void);
+
+    /**
+     * @brief   Get the number of segments averaged since the last reset
+     * @return  Returns the number of segments
+     */
+    unsigned segmentCount(void) const { return seg_cnt; }
+
+    /**
+     * @brief   Get the power in a bin
+     * @param   k The bin index
+     * @return  Returns the average power in the bin
+     */
+    double binPower(size_t k) const
+    {
+      return (seg_cnt > 0) ? pwr[k] / seg_cnt : 0.0;
+    }
+
+    /**
+     * @brief   Get the amplitude of a tone
+     * @param   fq The frequency of the tone in Hz
+     * @return  Returns the estimated amplitude of the tone
+     */
+    double toneAmplitude(float fq) const;
+
+  private:
+    typedef std::vector<float> Window;
+
+    unsigned                      sample_rate;
+    std::shared_ptr<const Fft>    fft;
+    std::shared_ptr<const Window> window;
+    std::vector<float>            buf;
+    size_t                        buf_cnt;
+    std::vector<Fft::Sample>      fft_buf;
+    std::vector<double>           pwr;
+    unsigned                      seg_cnt;
+
+    static std::shared_ptr<const Window> createWindow(size_t N,
+                                                      WindowType type);
+    void processSegment(void);
+
+};  /* class WelchPsd */
+
+
+//} /* namespace */
+
+#endif /* WELCH_PSD_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */